@@ -0,0 +1,592 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ *
+ *  bench.c
+ *  microbenchmark of the lauxh_* helpers against an embedded lua_State.
+ *
+ *  usage: bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+// lua
+#define LAUXHLIB_USED_IN_LUA
+#include "lauxhlib.h"
+
+#define BENCH_DEFAULT_ITERATIONS 1000000
+#define BENCH_UDATA_MT           "lauxhlib.bench.udata"
+
+/* fixed layout of the stack that is prepared before each case */
+#define IDX_INT    1
+#define IDX_NIL    2
+#define IDX_FLOAT  3
+#define IDX_STR    4
+#define IDX_TBL    5
+#define IDX_UDATA  6
+#define IDX_NESTED 7
+#define IDX_DST    8
+#define IDX_UDTYPE 9
+#define IDX_KEYS   10
+#define IDX_FIELDS 11
+#define IDX_TEXT   12
+#define IDX_OPTION 13
+#define IDX_FLAGS  14
+
+static const char *const BENCH_KEYS[] = {"key", "a", NULL};
+
+typedef struct {
+    size_t nalloc;
+} bench_alloc_t;
+
+static bench_alloc_t ALLOC = {0};
+
+static void *bench_alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+    bench_alloc_t *a = (bench_alloc_t *)ud;
+
+    if (nsize == 0) {
+        free(ptr);
+        return NULL;
+    } else if (!ptr || nsize > osize) {
+        // count the allocations that acquire new memory
+        a->nalloc++;
+    }
+    return realloc(ptr, nsize);
+}
+
+static lua_State *bench_newstate(void)
+{
+    lua_State *L = lua_newstate(bench_alloc, &ALLOC);
+
+    // LuaJIT on 64-bit platforms may not support the custom allocator
+    if (!L) {
+        L = luaL_newstate();
+    }
+    return L;
+}
+
+static uint64_t bench_nsec(void)
+{
+    struct timespec ts = {0};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static volatile lua_Integer SINK_INT = 0;
+static volatile lua_Number SINK_NUM  = 0;
+static volatile size_t SINK_SIZE     = 0;
+static volatile const void *SINK_PTR = NULL;
+
+static lua_State *XCOPY_DST = NULL;
+static const void *UDATA_MT  = NULL;
+
+static const lauxh_udtype_t UDTYPE_BASE = {BENCH_UDATA_MT ".base", 1, NULL};
+static const lauxh_udtype_t UDTYPE      = {BENCH_UDATA_MT, 2, &UDTYPE_BASE};
+
+#define BENCH_LOOP(n, ...)                                                     \
+    do {                                                                       \
+        for (size_t i = 0; i < (n); i++) {                                     \
+            __VA_ARGS__;                                                       \
+        }                                                                      \
+    } while (0)
+
+static void isint(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_isint(L, IDX_INT));
+}
+
+static void isint_in_range(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_isint_in_range(L, IDX_INT, 0, 100));
+}
+
+static void isint8(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_isint8(L, IDX_INT));
+}
+
+static void isuserdataof(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n,
+               SINK_INT += lauxh_isuserdataof(L, IDX_UDATA, BENCH_UDATA_MT));
+}
+
+static void isuserdataptr(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_isuserdataptr(L, IDX_UDATA, UDATA_MT));
+}
+
+static void checkint(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_checkint(L, IDX_INT));
+}
+
+static void checkint8(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_checkint8(L, IDX_INT));
+}
+
+static void checkuint64(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += (lua_Integer)lauxh_checkuint64(L, IDX_INT));
+}
+
+static void checkint_in_range(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_checkint_in_range(L, IDX_INT, 0, 100));
+}
+
+static void checknum_in_range(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_NUM += lauxh_checknum_in_range(L, IDX_FLOAT, 0, 100));
+}
+
+static void checknum(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_NUM += lauxh_checknum(L, IDX_FLOAT));
+}
+
+static void checkfinite(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_NUM += lauxh_checkfinite(L, IDX_FLOAT));
+}
+
+static void optint(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_optint(L, IDX_NIL, 1));
+}
+
+static void optstr(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_PTR = lauxh_optstr(L, IDX_NIL, "default"));
+}
+
+static void checklstr(lua_State *L, size_t n)
+{
+    size_t len = 0;
+    BENCH_LOOP(n, SINK_PTR = lauxh_checklstr(L, IDX_STR, &len);
+               SINK_SIZE += len);
+}
+
+static void checkudata(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_PTR = lauxh_checkudata(L, IDX_UDATA, BENCH_UDATA_MT));
+}
+
+static void checkudataptr(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_PTR = lauxh_checkudataptr(L, IDX_UDATA, UDATA_MT,
+                                                 BENCH_UDATA_MT));
+}
+
+static void checkudtype(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_PTR = lauxh_checkudtype(L, IDX_UDTYPE, &UDTYPE));
+}
+
+static void checkudtype_base(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_PTR = lauxh_checkudtype(L, IDX_UDTYPE, &UDTYPE_BASE));
+}
+
+static void checkintegerof(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_checkintegerof(L, IDX_TBL, "a"));
+}
+
+static void checkintegerofk(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_checkintegerofk(L, IDX_TBL, IDX_KEYS, 1));
+}
+
+static void checkintegerat(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_checkintegerat(L, IDX_TBL, 1));
+}
+
+static void toarray_int64(lua_State *L, size_t n)
+{
+    int64_t buf[3] = {0};
+    BENCH_LOOP(n, SINK_SIZE += lauxh_toarray_int64(L, IDX_TBL, buf, 3);
+               SINK_INT += buf[2]);
+}
+
+static void tolstr_int(lua_State *L, size_t n)
+{
+    size_t len = 0;
+    BENCH_LOOP(n, lauxh_tolstr(L, IDX_INT, &len); SINK_SIZE += len;
+               lua_pop(L, 1));
+}
+
+static void tolstr_float(lua_State *L, size_t n)
+{
+    size_t len = 0;
+    BENCH_LOOP(n, lauxh_tolstr(L, IDX_FLOAT, &len); SINK_SIZE += len;
+               lua_pop(L, 1));
+}
+
+static void tolstr_str(lua_State *L, size_t n)
+{
+    size_t len = 0;
+    BENCH_LOOP(n, lauxh_tolstr(L, IDX_STR, &len); SINK_SIZE += len;
+               lua_pop(L, 1));
+}
+
+static void tolstr_table(lua_State *L, size_t n)
+{
+    size_t len = 0;
+    BENCH_LOOP(n, lauxh_tolstr(L, IDX_TBL, &len); SINK_SIZE += len;
+               lua_pop(L, 1));
+}
+
+static void isutf8(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_isutf8(L, IDX_TEXT));
+}
+
+static void isprintable(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_isprintable(L, IDX_STR));
+}
+
+static const char *const OPTION_NAMES[] = {
+    "GET",   "HEAD",      "POST",  "PUT",  "DELETE", "CONNECT", "OPTIONS",
+    "TRACE", "PATCH",     "MKCOL", "COPY", "MOVE",   "LOCK",    "UNLOCK",
+    "BIND",  "UNBIND",    "ACL",   "LINK", "UNLINK", "PURGE",   "SEARCH",
+    "QUERY", "PROPPATCH", NULL};
+static lauxh_optionset_t OPTIONS = LAUXH_OPTIONSET_INIT(
+    "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE",
+    "PATCH", "MKCOL", "COPY", "MOVE", "LOCK", "UNLOCK", "BIND", "UNBIND", "ACL",
+    "LINK", "UNLINK", "PURGE", "SEARCH", "QUERY", "PROPPATCH");
+
+static void checkoption(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_checkoption(L, IDX_OPTION, &OPTIONS));
+}
+
+static void luaL_checkoption_linear(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT +=
+                  luaL_checkoption(L, IDX_OPTION, NULL, OPTION_NAMES));
+}
+
+static lauxh_flagset_t FLAGS = {
+    LAUXH_OPTIONSET_INIT("read", "write", "create", "trunc", "append",
+                         "nonblock", "cloexec"),
+    {0x1, 0x2, 0x40, 0x200, 0x400, 0x800, 0x80000},
+};
+
+static void optflagset(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += (lua_Integer)lauxh_optflagset(L, IDX_FLAGS,
+                                                            &FLAGS));
+}
+
+static void join(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_PTR = lauxh_join(L, IDX_FIELDS, " "); lua_pop(L, 1));
+}
+
+static lauxh_strbuf_t STRBUF = LAUXH_STRBUF_INIT;
+
+static void strbuf_appendtostr(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, lauxh_strbuf_reset(&STRBUF);
+               lauxh_strbuf_appendtostr(L, &STRBUF, IDX_INT);
+               lauxh_strbuf_appendtostr(L, &STRBUF, IDX_FLOAT);
+               lauxh_strbuf_appendtostr(L, &STRBUF, IDX_STR);
+               SINK_SIZE += STRBUF.len);
+}
+
+static void ref_unref(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, lauxh_unref(L, lauxh_refat(L, IDX_TBL)));
+}
+
+static lauxh_refpool_t *REFPOOL = NULL;
+
+static void refpool_ref_unref(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, int ref = lauxh_refpool_refat(L, REFPOOL, IDX_TBL);
+               lauxh_refpool_unref(L, REFPOOL, ref));
+}
+
+static void weakref_unweakref(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, lauxh_unweakref(L, lauxh_weakrefat(L, IDX_TBL)));
+}
+
+static lauxh_refhandle_t REFHANDLE = LAUXH_REFHANDLE_NONE;
+
+static void pushref_checked(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_pushref_checked(L, REFPOOL, REFHANDLE);
+               lua_pop(L, 1));
+}
+
+static void pushstr2tblat(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, lauxh_pushstr2tblat(L, "key", "value", IDX_DST));
+}
+
+static void pushint2tblat(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, lauxh_pushint2tblat(L, "key", (lua_Integer)i, IDX_DST));
+}
+
+static void pushint2tblkat(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n,
+               lauxh_pushint2tblkat(L, IDX_KEYS, 0, (lua_Integer)i, IDX_DST));
+}
+
+static void pushint2arrat(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, lauxh_pushint2arrat(L, 1, (lua_Integer)i, IDX_DST));
+}
+
+static void xcopy(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_xcopy(L, XCOPY_DST, IDX_NESTED, 0);
+               lua_settop(XCOPY_DST, 0));
+}
+
+static lauxh_xbuf_t XBUF = LAUXH_XBUF_INIT;
+
+static void xencode(lua_State *L, size_t n)
+{
+    BENCH_LOOP(n, SINK_INT += lauxh_xencode(L, IDX_NESTED, &XBUF));
+}
+
+typedef struct {
+    const char *name;
+    void (*run)(lua_State *L, size_t n);
+    double nsec;
+    double nalloc;
+} bench_case_t;
+
+#define BENCH_CASE(fn)                                                         \
+    {                                                                          \
+        "lauxh_" #fn, fn, 0, 0                                                 \
+    }
+
+static bench_case_t CASES[] = {
+    BENCH_CASE(isint),
+    BENCH_CASE(isint_in_range),
+    BENCH_CASE(isint8),
+    BENCH_CASE(isuserdataof),
+    BENCH_CASE(isuserdataptr),
+    BENCH_CASE(isutf8),
+    BENCH_CASE(isprintable),
+    BENCH_CASE(checkint),
+    BENCH_CASE(checkint8),
+    BENCH_CASE(checkuint64),
+    BENCH_CASE(checkint_in_range),
+    BENCH_CASE(checknum_in_range),
+    BENCH_CASE(checknum),
+    BENCH_CASE(checkfinite),
+    BENCH_CASE(optint),
+    BENCH_CASE(optstr),
+    BENCH_CASE(checklstr),
+    BENCH_CASE(checkudata),
+    BENCH_CASE(checkudataptr),
+    BENCH_CASE(checkudtype),
+    BENCH_CASE(checkudtype_base),
+    BENCH_CASE(checkintegerof),
+    BENCH_CASE(checkintegerofk),
+    BENCH_CASE(checkintegerat),
+    BENCH_CASE(checkoption),
+    {"luaL_checkoption", luaL_checkoption_linear, 0, 0},
+    BENCH_CASE(optflagset),
+    BENCH_CASE(toarray_int64),
+    BENCH_CASE(tolstr_int),
+    BENCH_CASE(tolstr_float),
+    BENCH_CASE(tolstr_str),
+    BENCH_CASE(tolstr_table),
+    BENCH_CASE(strbuf_appendtostr),
+    BENCH_CASE(join),
+    BENCH_CASE(ref_unref),
+    BENCH_CASE(refpool_ref_unref),
+    BENCH_CASE(weakref_unweakref),
+    BENCH_CASE(pushref_checked),
+    BENCH_CASE(pushstr2tblat),
+    BENCH_CASE(pushint2tblat),
+    BENCH_CASE(pushint2tblkat),
+    BENCH_CASE(pushint2arrat),
+    BENCH_CASE(xcopy),
+    BENCH_CASE(xencode),
+    {NULL, NULL, 0, 0},
+};
+
+#undef BENCH_CASE
+
+static void bench_setup(lua_State *L)
+{
+    lua_settop(L, 0);
+    // IDX_INT
+    lua_pushinteger(L, 42);
+    // IDX_NIL
+    lua_pushnil(L);
+    // IDX_FLOAT
+    lua_pushnumber(L, 1.5);
+    // IDX_STR
+    lua_pushliteral(L, "hello world");
+    // IDX_TBL
+    lua_createtable(L, 3, 1);
+    lauxh_pushint2arr(L, 1, 1);
+    lauxh_pushint2arr(L, 2, 2);
+    lauxh_pushint2arr(L, 3, 3);
+    lauxh_pushint2tbl(L, "a", 1);
+    // IDX_UDATA
+    lua_newuserdata(L, sizeof(int));
+    lauxh_setmetatable(L, BENCH_UDATA_MT);
+    // IDX_NESTED
+    lua_createtable(L, 0, 3);
+    lauxh_pushstr2tbl(L, "name", "bench");
+    lauxh_pushnum2tbl(L, "value", 1.5);
+    lua_pushliteral(L, "list");
+    lua_pushvalue(L, IDX_TBL);
+    lua_rawset(L, -3);
+    // IDX_DST
+    lua_newtable(L);
+    // IDX_UDTYPE
+    lauxh_newudtype(L, &UDTYPE, sizeof(int));
+    // IDX_KEYS
+    lauxh_newkeyatlas(L, BENCH_KEYS);
+    // IDX_FIELDS: log fields of the mixed values
+    lua_createtable(L, 20, 0);
+    for (int i = 1; i <= 20; i += 4) {
+        lauxh_pushstr2arr(L, i, "field");
+        lauxh_pushint2arr(L, i + 1, i * 1000);
+        lauxh_pushnum2arr(L, i + 2, i / 3.0);
+        lauxh_pushbool2arr(L, i + 3, i & 1);
+    }
+    // IDX_TEXT: 1KB of the mostly ASCII text
+    lua_pushliteral(L, "\xe3\x81\x82");
+    for (int i = 0; i < 16; i++) {
+        lua_pushliteral(L, "abcdefghijklmnopqrstuvwxyz0123456789"
+                           "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 {}");
+    }
+    lua_concat(L, 17);
+    // IDX_OPTION: one of the last options of the list
+    lua_pushliteral(L, "UNLOCK");
+    // IDX_FLAGS: the flag names to the top of the stack
+    lua_pushliteral(L, "write");
+    lua_pushliteral(L, "create");
+    lua_pushliteral(L, "trunc");
+}
+
+static int bench_run_lua(lua_State *L)
+{
+    bench_case_t *c = (bench_case_t *)lua_touserdata(L, lua_upvalueindex(1));
+    size_t n        = (size_t)lua_tointeger(L, lua_upvalueindex(2));
+    uint64_t nsec   = 0;
+    size_t nalloc   = 0;
+
+    bench_setup(L);
+    // warm up
+    c->run(L, n / 10 + 1);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    nalloc = ALLOC.nalloc;
+    nsec   = bench_nsec();
+    c->run(L, n);
+    nsec   = bench_nsec() - nsec;
+    nalloc = ALLOC.nalloc - nalloc;
+
+    c->nsec   = (double)nsec / (double)n;
+    c->nalloc = (double)nalloc / (double)n;
+    return 0;
+}
+
+static void print_version(lua_State *L)
+{
+    // LuaJIT exports the version string as the `jit.version`
+    lauxh_getglobal(L, "jit");
+    if (lauxh_istable(L, -1)) {
+        lua_getfield(L, -1, "version");
+        if (lauxh_isstr(L, -1)) {
+            printf("%s", lua_tostring(L, -1));
+        }
+    } else {
+        printf("%s", LUA_RELEASE);
+    }
+    lua_settop(L, 0);
+}
+
+int main(int argc, char *argv[])
+{
+    lua_State *L = bench_newstate();
+    size_t n     = BENCH_DEFAULT_ITERATIONS;
+
+    if (!L || !(XCOPY_DST = bench_newstate())) {
+        fprintf(stderr, "failed to create lua_State\n");
+        return EXIT_FAILURE;
+    } else if (argc > 1 && (n = strtoul(argv[1], NULL, 10)) == 0) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    luaL_openlibs(L);
+    UDATA_MT = lauxh_newmetatable(L, BENCH_UDATA_MT);
+    lua_pop(L, 1);
+    if (!(REFPOOL = lauxh_refpool_new(L, 1024, LAUXH_REFPOOL_GENERATION))) {
+        fprintf(stderr, "failed to create the reference pool\n");
+        lua_close(XCOPY_DST);
+        lua_close(L);
+        return EXIT_FAILURE;
+    }
+    lua_pushliteral(L, "callback");
+    REFHANDLE = lauxh_refpool_refhandle(L, REFPOOL);
+    if (lauxh_optionset_init(&OPTIONS) != 0 ||
+        lauxh_optionset_init(&FLAGS.opts) != 0) {
+        fprintf(stderr, "failed to build the option set\n");
+        lauxh_refpool_free(L, REFPOOL);
+        lua_close(XCOPY_DST);
+        lua_close(L);
+        return EXIT_FAILURE;
+    }
+
+    print_version(L);
+    printf(" - %zu iterations\n", n);
+    printf("%-32s %12s %12s\n", "name", "ns/op", "allocs/op");
+    for (bench_case_t *c = CASES; c->name; c++) {
+        lua_pushlightuserdata(L, (void *)c);
+        lua_pushinteger(L, (lua_Integer)n);
+        lua_pushcclosure(L, bench_run_lua, 2);
+        if (lua_pcall(L, 0, 0, 0) != 0) {
+            fprintf(stderr, "%s: %s\n", c->name, lua_tostring(L, -1));
+            lauxh_refpool_free(L, REFPOOL);
+            lua_close(XCOPY_DST);
+            lua_close(L);
+            return EXIT_FAILURE;
+        }
+        printf("%-32s %12.2f %12.2f\n", c->name, c->nsec, c->nalloc);
+    }
+
+    lauxh_xbuf_free(&XBUF);
+    lauxh_strbuf_free(&STRBUF);
+    lauxh_refpool_free(L, REFPOOL);
+    lua_close(XCOPY_DST);
+    lua_close(L);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,593 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ *
+ *  footprint.c
+ *  reference module that wraps each lauxh_* helper in an out-of-line function
+ *  so that `make size-report` can measure the code inlined into a call site.
+ */
+
+#include <stdio.h>
+// lua
+#define LAUXHLIB_USED_IN_LUA
+#define LAUXHLIB_USE_CHANNEL
+#include "lauxhlib.h"
+
+/**
+ * each wrapper is named `footprint_<helper>` and is exported so that the
+ * compiler cannot drop it; the wrapper itself only forwards the arguments.
+ */
+#define FOOTPRINT(rtype, fn, params, args)                                     \
+    rtype footprint_##fn params;                                               \
+    rtype footprint_##fn params                                                \
+    {                                                                          \
+        return fn args;                                                        \
+    }
+
+#define FOOTPRINT_VOID(fn, params, args)                                       \
+    void footprint_##fn params;                                                \
+    void footprint_##fn params                                                 \
+    {                                                                          \
+        fn args;                                                               \
+    }
+
+FOOTPRINT(size_t, lauxh_fmtint, (char *buf, lua_Integer v), (buf, v))
+FOOTPRINT(size_t, lauxh_fmtnum, (char *buf, lua_Number v), (buf, v))
+FOOTPRINT(size_t, lauxh_fmtptr, (char *buf, const char *tname, const void *ptr),
+          (buf, tname, ptr))
+FOOTPRINT(const char *, lauxh_tolstr, (lua_State *L, int idx, size_t *len),
+          (L, idx, len))
+FOOTPRINT_VOID(lauxh_strbuf_init, (lauxh_strbuf_t *b, char *mem, size_t size),
+               (b, mem, size))
+FOOTPRINT_VOID(lauxh_strbuf_free, (lauxh_strbuf_t *b), (b))
+FOOTPRINT_VOID(lauxh_strbuf_reset, (lauxh_strbuf_t *b), (b))
+FOOTPRINT(char *, lauxh_strbuf_reserve, (lauxh_strbuf_t *b, size_t n), (b, n))
+FOOTPRINT(int, lauxh_strbuf_append,
+          (lauxh_strbuf_t *b, const void *s, size_t n), (b, s, n))
+FOOTPRINT(int, lauxh_strbuf_appendint, (lauxh_strbuf_t *b, lua_Integer v),
+          (b, v))
+FOOTPRINT(int, lauxh_strbuf_appendnum, (lauxh_strbuf_t *b, lua_Number v),
+          (b, v))
+FOOTPRINT(int, lauxh_strbuf_appendtostr,
+          (lua_State *L, lauxh_strbuf_t *b, int idx), (L, b, idx))
+FOOTPRINT(const char *, lauxh_strbuf_push, (lua_State *L, lauxh_strbuf_t *b),
+          (L, b))
+FOOTPRINT(int, lauxh_optionset_isready, (const lauxh_optionset_t *set),
+          (set))
+FOOTPRINT(int, lauxh_optionset_init, (lauxh_optionset_t *set), (set))
+FOOTPRINT(int, lauxh_optionset_find,
+          (const lauxh_optionset_t *set, const char *name, size_t len),
+          (set, name, len))
+FOOTPRINT(int, lauxh_checkoption,
+          (lua_State *L, int idx, const lauxh_optionset_t *set), (L, idx, set))
+FOOTPRINT(int, lauxh_optoption,
+          (lua_State *L, int idx, const lauxh_optionset_t *set, int def),
+          (L, idx, set, def))
+FOOTPRINT(int, lauxh_isref, (int ref), (ref))
+FOOTPRINT(int, lauxh_ref, (lua_State *L), (L))
+FOOTPRINT(int, lauxh_refat, (lua_State *L, int idx), (L, idx))
+FOOTPRINT_VOID(lauxh_pushref, (lua_State *L, int ref), (L, ref))
+FOOTPRINT(int, lauxh_unref, (lua_State *L, int ref), (L, ref))
+FOOTPRINT(lauxh_refpool_t *, lauxh_refpool_new,
+          (lua_State *L, int capacity, int flags), (L, capacity, flags))
+FOOTPRINT_VOID(lauxh_refpool_free, (lua_State *L, lauxh_refpool_t *pool),
+               (L, pool))
+FOOTPRINT(int, lauxh_refpool_isref, (lauxh_refpool_t *pool, int ref),
+          (pool, ref))
+FOOTPRINT(int, lauxh_refpool_ref, (lua_State *L, lauxh_refpool_t *pool),
+          (L, pool))
+FOOTPRINT(int, lauxh_refpool_refat,
+          (lua_State *L, lauxh_refpool_t *pool, int idx), (L, pool, idx))
+FOOTPRINT_VOID(lauxh_refpool_pushref,
+               (lua_State *L, lauxh_refpool_t *pool, int ref), (L, pool, ref))
+FOOTPRINT(int, lauxh_refpool_unref,
+          (lua_State *L, lauxh_refpool_t *pool, int ref), (L, pool, ref))
+FOOTPRINT(unsigned int, lauxh_refpool_gen, (lauxh_refpool_t *pool, int ref),
+          (pool, ref))
+FOOTPRINT(int, lauxh_refpool_len, (lauxh_refpool_t *pool), (pool))
+FOOTPRINT(lauxh_refhandle_t, lauxh_refpool_handle,
+          (lauxh_refpool_t *pool, int ref), (pool, ref))
+FOOTPRINT(int, lauxh_refpool_ishandle,
+          (lauxh_refpool_t *pool, lauxh_refhandle_t h), (pool, h))
+FOOTPRINT(lauxh_refhandle_t, lauxh_refpool_refhandle,
+          (lua_State *L, lauxh_refpool_t *pool), (L, pool))
+FOOTPRINT(int, lauxh_pushref_checked,
+          (lua_State *L, lauxh_refpool_t *pool, lauxh_refhandle_t h),
+          (L, pool, h))
+FOOTPRINT(lauxh_refhandle_t, lauxh_refpool_unrefhandle,
+          (lua_State *L, lauxh_refpool_t *pool, lauxh_refhandle_t h),
+          (L, pool, h))
+FOOTPRINT_VOID(lauxh_refpool_clear, (lua_State *L, lauxh_refpool_t *pool),
+               (L, pool))
+FOOTPRINT(int, lauxh_refpool_sweep, (lua_State *L, lauxh_refpool_t *pool),
+          (L, pool))
+FOOTPRINT(int, lauxh_refpool_ref_tbl,
+          (lua_State *L, lauxh_refpool_t *pool, int tbl), (L, pool, tbl))
+FOOTPRINT_VOID(lauxh_refpool_pushref_tbl,
+               (lua_State *L, lauxh_refpool_t *pool, int tbl, int ref),
+               (L, pool, tbl, ref))
+FOOTPRINT(int, lauxh_refpool_unref_tbl,
+          (lua_State *L, lauxh_refpool_t *pool, int tbl, int ref),
+          (L, pool, tbl, ref))
+FOOTPRINT(int, lauxh_refpool_sweep_tbl,
+          (lua_State *L, lauxh_refpool_t *pool, int tbl), (L, pool, tbl))
+FOOTPRINT(lauxh_refpool_t *, lauxh_refpool_newudata,
+          (lua_State *L, int capacity, int flags, const char *tname),
+          (L, capacity, flags, tname))
+FOOTPRINT_VOID(lauxh_refpool_clearudata,
+               (lua_State *L, lauxh_refpool_t *pool, int idx), (L, pool, idx))
+FOOTPRINT(lauxh_refpool_t *, lauxh_weakref_pool, (lua_State *L), (L))
+FOOTPRINT(lauxh_refhandle_t, lauxh_weakref, (lua_State *L), (L))
+FOOTPRINT(lauxh_refhandle_t, lauxh_weakrefat, (lua_State *L, int idx),
+          (L, idx))
+FOOTPRINT(int, lauxh_pushweakref, (lua_State *L, lauxh_refhandle_t h), (L, h))
+FOOTPRINT(lauxh_refhandle_t, lauxh_unweakref,
+          (lua_State *L, lauxh_refhandle_t h), (L, h))
+FOOTPRINT(int, lauxh_weakref_sweep, (lua_State *L), (L))
+FOOTPRINT_VOID(lauxh_gettblof, (lua_State *L, const char *k, int idx),
+               (L, k, idx))
+FOOTPRINT_VOID(lauxh_pushnil2tblat, (lua_State *L, const char *k, int at),
+               (L, k, at))
+FOOTPRINT_VOID(lauxh_pushnil2arrat, (lua_State *L, int idx, int at),
+               (L, idx, at))
+FOOTPRINT_VOID(lauxh_pushfn2tblat,
+               (lua_State *L, const char *k, lua_CFunction v, int at),
+               (L, k, v, at))
+FOOTPRINT_VOID(lauxh_pushfn2arrat,
+               (lua_State *L, int idx, lua_CFunction v, int at),
+               (L, idx, v, at))
+FOOTPRINT_VOID(lauxh_pushstr2tblat,
+               (lua_State *L, const char *k, const char *v, int at),
+               (L, k, v, at))
+FOOTPRINT_VOID(lauxh_pushstr2arrat,
+               (lua_State *L, int idx, const char *v, int at), (L, idx, v, at))
+FOOTPRINT_VOID(lauxh_pushlstr2tblat,
+               (lua_State *L, const char *k, const char *v, size_t l, int at),
+               (L, k, v, l, at))
+FOOTPRINT_VOID(lauxh_pushlstr2arrat,
+               (lua_State *L, int idx, const char *v, size_t l, int at),
+               (L, idx, v, l, at))
+FOOTPRINT_VOID(lauxh_pushnum2tblat,
+               (lua_State *L, const char *k, lua_Number v, int at),
+               (L, k, v, at))
+FOOTPRINT_VOID(lauxh_pushnum2arrat,
+               (lua_State *L, int idx, lua_Number v, int at), (L, idx, v, at))
+FOOTPRINT_VOID(lauxh_pushint2tblat,
+               (lua_State *L, const char *k, lua_Integer v, int at),
+               (L, k, v, at))
+FOOTPRINT_VOID(lauxh_pushint2arrat,
+               (lua_State *L, int idx, lua_Integer v, int at), (L, idx, v, at))
+FOOTPRINT_VOID(lauxh_pushbool2tblat,
+               (lua_State *L, const char *k, int v, int at), (L, k, v, at))
+FOOTPRINT_VOID(lauxh_pushbool2arrat, (lua_State *L, int idx, int v, int at),
+               (L, idx, v, at))
+FOOTPRINT_VOID(lauxh_gettblat, (lua_State *L, int idx, int at), (L, idx, at))
+FOOTPRINT(const char *, lauxh_join, (lua_State *L, int idx, const char *sep),
+          (L, idx, sep))
+FOOTPRINT_VOID(lauxh_newkeyatlas, (lua_State *L, const char *const *keys),
+               (L, keys))
+FOOTPRINT_VOID(lauxh_pushkey, (lua_State *L, int atlas, int kid),
+               (L, atlas, kid))
+FOOTPRINT_VOID(lauxh_gettblofk, (lua_State *L, int atlas, int kid, int idx),
+               (L, atlas, kid, idx))
+FOOTPRINT_VOID(lauxh_pushnil2tblkat, (lua_State *L, int atlas, int kid, int at),
+               (L, atlas, kid, at))
+FOOTPRINT_VOID(lauxh_pushfn2tblkat,
+               (lua_State *L, int atlas, int kid, lua_CFunction v, int at),
+               (L, atlas, kid, v, at))
+FOOTPRINT_VOID(lauxh_pushstr2tblkat,
+               (lua_State *L, int atlas, int kid, const char *v, int at),
+               (L, atlas, kid, v, at))
+FOOTPRINT_VOID(lauxh_pushlstr2tblkat,
+               (lua_State *L, int atlas, int kid, const char *v, size_t l,
+                int at),
+               (L, atlas, kid, v, l, at))
+FOOTPRINT_VOID(lauxh_pushnum2tblkat,
+               (lua_State *L, int atlas, int kid, lua_Number v, int at),
+               (L, atlas, kid, v, at))
+FOOTPRINT_VOID(lauxh_pushint2tblkat,
+               (lua_State *L, int atlas, int kid, lua_Integer v, int at),
+               (L, atlas, kid, v, at))
+FOOTPRINT_VOID(lauxh_pushbool2tblkat,
+               (lua_State *L, int atlas, int kid, int v, int at),
+               (L, atlas, kid, v, at))
+FOOTPRINT_VOID(lauxh_getglobal, (lua_State *L, const char *k), (L, k))
+FOOTPRINT_VOID(lauxh_setmetatable, (lua_State *L, const char *tname),
+               (L, tname))
+FOOTPRINT(const void *, lauxh_newmetatable, (lua_State *L, const char *tname),
+          (L, tname))
+FOOTPRINT(const void *, lauxh_getmetatableptr,
+          (lua_State *L, const char *tname), (L, tname))
+FOOTPRINT_VOID(lauxh_setfuncs_mtptr,
+               (lua_State *L, const luaL_Reg *regs, const void *mt),
+               (L, regs, mt))
+FOOTPRINT(const void *, lauxh_newmetatable_mtptr,
+          (lua_State *L, const char *tname, const luaL_Reg *mmethods,
+           const luaL_Reg *methods),
+          (L, tname, mmethods, methods))
+FOOTPRINT(int, lauxh_ismetatableof, (lua_State *L, int idx, const char *tname),
+          (L, idx, tname))
+FOOTPRINT(int, lauxh_ismetatableptr, (lua_State *L, int idx, const void *mt),
+          (L, idx, mt))
+FOOTPRINT(int, lauxh_isnil, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isstr, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isbool, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_istable, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isfunc, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_iscfunc, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isthread, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isuserdata, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isuserdataof, (lua_State *L, int idx, const char *tname),
+          (L, idx, tname))
+FOOTPRINT(int, lauxh_isuserdataptr, (lua_State *L, int idx, const void *mt),
+          (L, idx, mt))
+FOOTPRINT(int, lauxh_ispointer, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isfile, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_iscallable, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isnum, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isnum_ge, (lua_State *L, int idx, lua_Number n),
+          (L, idx, n))
+FOOTPRINT(int, lauxh_isnum_le, (lua_State *L, int idx, lua_Number n),
+          (L, idx, n))
+FOOTPRINT(int, lauxh_isnum_in_range,
+          (lua_State *L, int idx, lua_Number min, lua_Number max),
+          (L, idx, min, max))
+FOOTPRINT(int, lauxh_isfinite, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isfinite_ge, (lua_State *L, int idx, lua_Number n),
+          (L, idx, n))
+FOOTPRINT(int, lauxh_isfinite_le, (lua_State *L, int idx, lua_Number n),
+          (L, idx, n))
+FOOTPRINT(int, lauxh_isfinite_in_range,
+          (lua_State *L, int idx, lua_Number min, lua_Number max),
+          (L, idx, min, max))
+FOOTPRINT(lua_Number, lauxh_isunsigned, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isunsigned_ge, (lua_State *L, int idx, lua_Number n),
+          (L, idx, n))
+FOOTPRINT(int, lauxh_isunsigned_le, (lua_State *L, int idx, lua_Number n),
+          (L, idx, n))
+FOOTPRINT(int, lauxh_isunsigned_in_range,
+          (lua_State *L, int idx, lua_Number min, lua_Number max),
+          (L, idx, min, max))
+FOOTPRINT(int, lauxh_isint, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isint_ge, (lua_State *L, int idx, lua_Integer n),
+          (L, idx, n))
+FOOTPRINT(int, lauxh_isint_le, (lua_State *L, int idx, lua_Integer n),
+          (L, idx, n))
+FOOTPRINT(int, lauxh_isint_in_range,
+          (lua_State *L, int idx, lua_Integer min, lua_Integer max),
+          (L, idx, min, max))
+FOOTPRINT(int, lauxh_isuint, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isuint_ge, (lua_State *L, int idx, uintmax_t n),
+          (L, idx, n))
+FOOTPRINT(int, lauxh_isuint_le, (lua_State *L, int idx, uintmax_t n),
+          (L, idx, n))
+FOOTPRINT(int, lauxh_isuint_in_range,
+          (lua_State *L, int idx, uintmax_t min, uintmax_t max),
+          (L, idx, min, max))
+FOOTPRINT(int, lauxh_ispint, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_ispint_ge, (lua_State *L, int idx, uintmax_t n),
+          (L, idx, n))
+FOOTPRINT(int, lauxh_ispint_le, (lua_State *L, int idx, uintmax_t n),
+          (L, idx, n))
+FOOTPRINT(int, lauxh_ispint_in_range,
+          (lua_State *L, int idx, uintmax_t min, uintmax_t max),
+          (L, idx, min, max))
+FOOTPRINT_VOID(lauxh_checktype, (lua_State *L, int arg, int t), (L, arg, t))
+FOOTPRINT(FILE **, lauxh_checkfilep, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(FILE *, lauxh_checkfile, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(FILE *, lauxh_optfile, (lua_State *L, int idx, FILE *def),
+          (L, idx, def))
+FOOTPRINT_VOID(lauxh_checkcallable, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_optcallable, (lua_State *L, int idx, int def),
+          (L, idx, def))
+FOOTPRINT_VOID(lauxh_checkfunc, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_optfunc, (lua_State *L, int idx, int def), (L, idx, def))
+FOOTPRINT(lua_CFunction, lauxh_checkcfunc, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(lua_CFunction, lauxh_optcfunc,
+          (lua_State *L, int idx, lua_CFunction def), (L, idx, def))
+FOOTPRINT(lua_State *, lauxh_checkthread, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(lua_State *, lauxh_optthread, (lua_State *L, int idx, lua_State *def),
+          (L, idx, def))
+FOOTPRINT(const void *, lauxh_checkpointer, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(const void *, lauxh_optpointer,
+          (lua_State *L, int idx, const void *def), (L, idx, def))
+FOOTPRINT(void *, lauxh_checkuserdata, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(void *, lauxh_optuserdata, (lua_State *L, int idx, void *def),
+          (L, idx, def))
+FOOTPRINT(void *, lauxh_checkudata, (lua_State *L, int idx, const char *tname),
+          (L, idx, tname))
+FOOTPRINT(void *, lauxh_optudata,
+          (lua_State *L, int idx, const char *tname, void *def),
+          (L, idx, tname, def))
+FOOTPRINT(void *, lauxh_checkudataptr,
+          (lua_State *L, int idx, const void *mt, const char *tname),
+          (L, idx, mt, tname))
+FOOTPRINT(void *, lauxh_checkudataupv,
+          (lua_State *L, int idx, const char *tname), (L, idx, tname))
+FOOTPRINT(void *, lauxh_optudataptr,
+          (lua_State *L, int idx, const void *mt, const char *tname, void *def),
+          (L, idx, mt, tname, def))
+FOOTPRINT(void *, lauxh_newudtype,
+          (lua_State *L, const lauxh_udtype_t *type, size_t size),
+          (L, type, size))
+FOOTPRINT(int64_t, lauxh_udtypeid, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isudtype,
+          (lua_State *L, int idx, const lauxh_udtype_t *type), (L, idx, type))
+FOOTPRINT(void *, lauxh_toudtype,
+          (lua_State *L, int idx, const lauxh_udtype_t *type), (L, idx, type))
+FOOTPRINT(void *, lauxh_checkudtype,
+          (lua_State *L, int idx, const lauxh_udtype_t *type), (L, idx, type))
+FOOTPRINT(void *, lauxh_optudtype,
+          (lua_State *L, int idx, const lauxh_udtype_t *type, void *def),
+          (L, idx, type, def))
+FOOTPRINT(int, lauxh_checkbool, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_optbool, (lua_State *L, int idx, int def), (L, idx, def))
+FOOTPRINT(const char *, lauxh_checklstr, (lua_State *L, int idx, size_t *len),
+          (L, idx, len))
+FOOTPRINT(const char *, lauxh_optlstr,
+          (lua_State *L, int idx, const char *def, size_t *len),
+          (L, idx, def, len))
+FOOTPRINT(size_t, lauxh_spanascii, (const char *s, size_t len), (s, len))
+FOOTPRINT(size_t, lauxh_spanprintable, (const char *s, size_t len), (s, len))
+FOOTPRINT(size_t, lauxh_spanutf8, (const char *s, size_t len), (s, len))
+FOOTPRINT(int, lauxh_isascii, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isprintable, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_isutf8, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(const char *, lauxh_checkasciilstr,
+          (lua_State *L, int idx, size_t *len), (L, idx, len))
+FOOTPRINT(const char *, lauxh_checkprintablelstr,
+          (lua_State *L, int idx, size_t *len), (L, idx, len))
+FOOTPRINT(const char *, lauxh_checkutf8lstr,
+          (lua_State *L, int idx, size_t *len), (L, idx, len))
+FOOTPRINT(lua_Number, lauxh_checknum, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(lua_Number, lauxh_optnum, (lua_State *L, int idx, lua_Number def),
+          (L, idx, def))
+FOOTPRINT(lua_Integer, lauxh_checkint, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(lua_Integer, lauxh_optint, (lua_State *L, int idx, lua_Integer def),
+          (L, idx, def))
+FOOTPRINT(lua_Number, lauxh_checkfinite, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(lua_Number, lauxh_optfinite, (lua_State *L, int idx, lua_Number def),
+          (L, idx, def))
+FOOTPRINT(lua_Number, lauxh_checkunsigned, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(lua_Number, lauxh_optunsigned,
+          (lua_State *L, int idx, lua_Number def), (L, idx, def))
+FOOTPRINT(lua_Integer, lauxh_checkuint, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(lua_Integer, lauxh_optuint, (lua_State *L, int idx, lua_Integer def),
+          (L, idx, def))
+FOOTPRINT(lua_Integer, lauxh_checkpint, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(lua_Integer, lauxh_optpint, (lua_State *L, int idx, lua_Integer def),
+          (L, idx, def))
+FOOTPRINT(int8_t, lauxh_checkint8, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int8_t, lauxh_optint8, (lua_State *L, int idx, int8_t def),
+          (L, idx, def))
+FOOTPRINT(uint8_t, lauxh_checkuint8, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(uint8_t, lauxh_optuint8, (lua_State *L, int idx, uint8_t def),
+          (L, idx, def))
+FOOTPRINT(int16_t, lauxh_checkint16, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int16_t, lauxh_optint16, (lua_State *L, int idx, int16_t def),
+          (L, idx, def))
+FOOTPRINT(uint16_t, lauxh_checkuint16, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(uint16_t, lauxh_optuint16, (lua_State *L, int idx, uint16_t def),
+          (L, idx, def))
+FOOTPRINT(int32_t, lauxh_checkint32, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int32_t, lauxh_optint32, (lua_State *L, int idx, int32_t def),
+          (L, idx, def))
+FOOTPRINT(uint32_t, lauxh_checkuint32, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(uint32_t, lauxh_optuint32, (lua_State *L, int idx, uint32_t def),
+          (L, idx, def))
+FOOTPRINT(int64_t, lauxh_checkint64, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int64_t, lauxh_optint64, (lua_State *L, int idx, int64_t def),
+          (L, idx, def))
+FOOTPRINT(uint64_t, lauxh_checkuint64, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(uint64_t, lauxh_optuint64, (lua_State *L, int idx, uint64_t def),
+          (L, idx, def))
+FOOTPRINT(lua_Number, lauxh_checknum_ge, (lua_State *L, int idx, lua_Number n),
+          (L, idx, n))
+FOOTPRINT(lua_Number, lauxh_checknum_le, (lua_State *L, int idx, lua_Number n),
+          (L, idx, n))
+FOOTPRINT(lua_Number, lauxh_optnum_ge,
+          (lua_State *L, int idx, lua_Number n, lua_Number def),
+          (L, idx, n, def))
+FOOTPRINT(lua_Number, lauxh_optnum_le,
+          (lua_State *L, int idx, lua_Number n, lua_Number def),
+          (L, idx, n, def))
+FOOTPRINT(lua_Integer, lauxh_checkint_ge,
+          (lua_State *L, int idx, lua_Integer n), (L, idx, n))
+FOOTPRINT(lua_Integer, lauxh_checkint_le,
+          (lua_State *L, int idx, lua_Integer n), (L, idx, n))
+FOOTPRINT(lua_Integer, lauxh_optint_ge,
+          (lua_State *L, int idx, lua_Integer n, lua_Integer def),
+          (L, idx, n, def))
+FOOTPRINT(lua_Integer, lauxh_optint_le,
+          (lua_State *L, int idx, lua_Integer n, lua_Integer def),
+          (L, idx, n, def))
+FOOTPRINT(lua_Number, lauxh_checkfinite_ge,
+          (lua_State *L, int idx, lua_Number n), (L, idx, n))
+FOOTPRINT(lua_Number, lauxh_checkfinite_le,
+          (lua_State *L, int idx, lua_Number n), (L, idx, n))
+FOOTPRINT(lua_Number, lauxh_optfinite_ge,
+          (lua_State *L, int idx, lua_Number n, lua_Number def),
+          (L, idx, n, def))
+FOOTPRINT(lua_Number, lauxh_optfinite_le,
+          (lua_State *L, int idx, lua_Number n, lua_Number def),
+          (L, idx, n, def))
+FOOTPRINT(lua_Number, lauxh_checknum_in_range,
+          (lua_State *L, int idx, lua_Number min, lua_Number max),
+          (L, idx, min, max))
+FOOTPRINT(lua_Number, lauxh_optnum_in_range,
+          (lua_State *L, int idx, lua_Number min, lua_Number max,
+           lua_Number def),
+          (L, idx, min, max, def))
+FOOTPRINT(lua_Integer, lauxh_checkint_in_range,
+          (lua_State *L, int idx, lua_Integer min, lua_Integer max),
+          (L, idx, min, max))
+FOOTPRINT(lua_Integer, lauxh_optint_in_range,
+          (lua_State *L, int idx, lua_Integer min, lua_Integer max,
+           lua_Integer def),
+          (L, idx, min, max, def))
+FOOTPRINT(lua_Number, lauxh_checkfinite_in_range,
+          (lua_State *L, int idx, lua_Number min, lua_Number max),
+          (L, idx, min, max))
+FOOTPRINT(lua_Number, lauxh_optfinite_in_range,
+          (lua_State *L, int idx, lua_Number min, lua_Number max,
+           lua_Number def),
+          (L, idx, min, max, def))
+FOOTPRINT(uint64_t, lauxh_optflags, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_flagset_find,
+          (const lauxh_flagset_t *set, const char *name, size_t len,
+           uint64_t *bits),
+          (set, name, len, bits))
+FOOTPRINT(uint64_t, lauxh_optflagset,
+          (lua_State *L, int idx, const lauxh_flagset_t *set), (L, idx, set))
+FOOTPRINT_VOID(lauxh_checktable, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(int, lauxh_opttable, (lua_State *L, int idx, int def), (L, idx, def))
+FOOTPRINT_VOID(lauxh_checktableof, (lua_State *L, int idx, const char *k),
+               (L, idx, k))
+FOOTPRINT(const char *, lauxh_checklstringof,
+          (lua_State *L, int idx, const char *k, size_t *len), (L, idx, k, len))
+FOOTPRINT(const char *, lauxh_optlstringof,
+          (lua_State *L, int idx, const char *k, const char *def, size_t *len),
+          (L, idx, k, def, len))
+FOOTPRINT(const char *, lauxh_checkstringof,
+          (lua_State *L, int idx, const char *k), (L, idx, k))
+FOOTPRINT(const char *, lauxh_optstringof,
+          (lua_State *L, int idx, const char *k, const char *def),
+          (L, idx, k, def))
+FOOTPRINT(lua_Number, lauxh_checknumberof,
+          (lua_State *L, int idx, const char *k), (L, idx, k))
+FOOTPRINT(lua_Number, lauxh_optnumberof,
+          (lua_State *L, int idx, const char *k, lua_Number def),
+          (L, idx, k, def))
+FOOTPRINT(lua_Integer, lauxh_checkintegerof,
+          (lua_State *L, int idx, const char *k), (L, idx, k))
+FOOTPRINT(lua_Integer, lauxh_optintegerof,
+          (lua_State *L, int idx, const char *k, lua_Integer def),
+          (L, idx, k, def))
+FOOTPRINT(int, lauxh_checkbooleanof, (lua_State *L, int idx, const char *k),
+          (L, idx, k))
+FOOTPRINT(int, lauxh_optbooleanof,
+          (lua_State *L, int idx, const char *k, int def), (L, idx, k, def))
+FOOTPRINT_VOID(lauxh_checktableofk,
+               (lua_State *L, int idx, int atlas, int kid),
+               (L, idx, atlas, kid))
+FOOTPRINT(const char *, lauxh_checklstringofk,
+          (lua_State *L, int idx, int atlas, int kid, size_t *len),
+          (L, idx, atlas, kid, len))
+FOOTPRINT(const char *, lauxh_optlstringofk,
+          (lua_State *L, int idx, int atlas, int kid, const char *def,
+           size_t *len),
+          (L, idx, atlas, kid, def, len))
+FOOTPRINT(const char *, lauxh_checkstringofk,
+          (lua_State *L, int idx, int atlas, int kid), (L, idx, atlas, kid))
+FOOTPRINT(const char *, lauxh_optstringofk,
+          (lua_State *L, int idx, int atlas, int kid, const char *def),
+          (L, idx, atlas, kid, def))
+FOOTPRINT(lua_Number, lauxh_checknumberofk,
+          (lua_State *L, int idx, int atlas, int kid), (L, idx, atlas, kid))
+FOOTPRINT(lua_Number, lauxh_optnumberofk,
+          (lua_State *L, int idx, int atlas, int kid, lua_Number def),
+          (L, idx, atlas, kid, def))
+FOOTPRINT(lua_Integer, lauxh_checkintegerofk,
+          (lua_State *L, int idx, int atlas, int kid), (L, idx, atlas, kid))
+FOOTPRINT(lua_Integer, lauxh_optintegerofk,
+          (lua_State *L, int idx, int atlas, int kid, lua_Integer def),
+          (L, idx, atlas, kid, def))
+FOOTPRINT(int, lauxh_checkbooleanofk,
+          (lua_State *L, int idx, int atlas, int kid), (L, idx, atlas, kid))
+FOOTPRINT(int, lauxh_optbooleanofk,
+          (lua_State *L, int idx, int atlas, int kid, int def),
+          (L, idx, atlas, kid, def))
+FOOTPRINT_VOID(lauxh_checktableat, (lua_State *L, int idx, int row),
+               (L, idx, row))
+FOOTPRINT(const char *, lauxh_checklstringat,
+          (lua_State *L, int idx, int row, size_t *len), (L, idx, row, len))
+FOOTPRINT(const char *, lauxh_optlstringat,
+          (lua_State *L, int idx, int row, const char *def, size_t *len),
+          (L, idx, row, def, len))
+FOOTPRINT(const char *, lauxh_checkstringat, (lua_State *L, int idx, int row),
+          (L, idx, row))
+FOOTPRINT(const char *, lauxh_optstringat,
+          (lua_State *L, int idx, int row, const char *def), (L, idx, row, def))
+FOOTPRINT(lua_Number, lauxh_checknumberat, (lua_State *L, int idx, int row),
+          (L, idx, row))
+FOOTPRINT(lua_Number, lauxh_optnumberat,
+          (lua_State *L, int idx, int row, lua_Number def), (L, idx, row, def))
+FOOTPRINT(lua_Integer, lauxh_checkintegerat, (lua_State *L, int idx, int row),
+          (L, idx, row))
+FOOTPRINT(lua_Integer, lauxh_optintegerat,
+          (lua_State *L, int idx, int row, lua_Integer def), (L, idx, row, def))
+FOOTPRINT(int, lauxh_checkbooleanat, (lua_State *L, int idx, int row),
+          (L, idx, row))
+FOOTPRINT(int, lauxh_optbooleanat, (lua_State *L, int idx, int row, int def),
+          (L, idx, row, def))
+FOOTPRINT_VOID(lauxh_pushstruct,
+               (lua_State *L, const lauxh_field_t *fields, const void *src),
+               (L, fields, src))
+FOOTPRINT(int, lauxh_tostruct,
+          (lua_State *L, int idx, const lauxh_field_t *fields, void *dst,
+           char *errbuf, size_t errlen),
+          (L, idx, fields, dst, errbuf, errlen))
+FOOTPRINT_VOID(lauxh_checkstruct,
+               (lua_State *L, int idx, const lauxh_field_t *fields, void *dst),
+               (L, idx, fields, dst))
+FOOTPRINT(int, lauxh_fileno, (lua_State *L, int idx), (L, idx))
+FOOTPRINT(FILE *, lauxh_tofile,
+          (lua_State *L, int fd, const char *mode, const char *fname),
+          (L, fd, mode, fname))
+FOOTPRINT(int, lauxh_xcopy,
+          (lua_State *from, lua_State *to, int idx, const int allow_nil),
+          (from, to, idx, allow_nil))
+FOOTPRINT_VOID(lauxh_xbuf_free, (lauxh_xbuf_t *buf), (buf))
+FOOTPRINT(int, lauxh_xencode, (lua_State *L, int idx, lauxh_xbuf_t *buf),
+          (L, idx, buf))
+FOOTPRINT(int, lauxh_xdecode, (lua_State *L, const void *data, size_t len),
+          (L, data, len))
+FOOTPRINT(lauxh_channel_t *, lauxh_channel_new, (size_t capacity), (capacity))
+FOOTPRINT(lauxh_channel_t *, lauxh_channel_retain, (lauxh_channel_t *ch), (ch))
+FOOTPRINT_VOID(lauxh_channel_release, (lauxh_channel_t *ch), (ch))
+FOOTPRINT(size_t, lauxh_channel_cap, (lauxh_channel_t *ch), (ch))
+FOOTPRINT(int, lauxh_channel_trysend, (lauxh_channel_t *ch, lauxh_xbuf_t *buf),
+          (ch, buf))
+FOOTPRINT(int, lauxh_channel_tryrecv, (lauxh_channel_t *ch, lauxh_xbuf_t *buf),
+          (ch, buf))
+FOOTPRINT(int, lauxh_channel_send,
+          (lauxh_channel_t *ch, lauxh_xbuf_t *buf, int msec), (ch, buf, msec))
+FOOTPRINT(int, lauxh_channel_recv,
+          (lauxh_channel_t *ch, lauxh_xbuf_t *buf, int msec), (ch, buf, msec))
+FOOTPRINT(size_t, lauxh_toarray_int64,
+          (lua_State *L, int idx, int64_t *buf, size_t n), (L, idx, buf, n))
+FOOTPRINT_VOID(lauxh_checkarray_int64,
+               (lua_State *L, int idx, int64_t *buf, size_t n),
+               (L, idx, buf, n))
+FOOTPRINT_VOID(lauxh_pusharray_int64,
+               (lua_State *L, const int64_t *buf, size_t n), (L, buf, n))
+FOOTPRINT(size_t, lauxh_toarray_double,
+          (lua_State *L, int idx, double *buf, size_t n), (L, idx, buf, n))
+FOOTPRINT_VOID(lauxh_checkarray_double,
+               (lua_State *L, int idx, double *buf, size_t n), (L, idx, buf, n))
+FOOTPRINT_VOID(lauxh_pusharray_double,
+               (lua_State *L, const double *buf, size_t n), (L, buf, n))
+FOOTPRINT(size_t, lauxh_toarray_uint8,
+          (lua_State *L, int idx, uint8_t *buf, size_t n), (L, idx, buf, n))
+FOOTPRINT_VOID(lauxh_checkarray_uint8,
+               (lua_State *L, int idx, uint8_t *buf, size_t n),
+               (L, idx, buf, n))
+FOOTPRINT_VOID(lauxh_pusharray_uint8,
+               (lua_State *L, const uint8_t *buf, size_t n), (L, buf, n))
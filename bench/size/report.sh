@@ -0,0 +1,78 @@
+#!/bin/sh
+#
+# usage: report.sh <object>
+#
+# prints the text size (bytes) and the number of instructions of each function
+# in the object file. the part of the function that the compiler moved to the
+# cold section (`<name>.cold`) is reported in the separate columns, so the hot
+# columns show the footprint of the fast path.
+#
+set -e
+
+OBJ="$1"
+NM=${NM:-nm}
+OBJDUMP=${OBJDUMP:-objdump}
+INSNS=$(mktemp)
+trap 'rm -f "$INSNS"' EXIT
+
+# count the instructions of each symbol
+$OBJDUMP -d --no-show-raw-insn "$OBJ" | awk '
+    /^[0-9a-f]+ <[^>]+>:$/ {
+        name = substr($2, 2, length($2) - 3)
+        next
+    }
+    /^ +[0-9a-f]+:\t/ && name != "" {
+        ninsn[name]++
+    }
+    END {
+        for (name in ninsn) {
+            print name, ninsn[name]
+        }
+    }
+' > "$INSNS"
+
+$NM -S -t d "$OBJ" | awk -v insns="$INSNS" '
+    BEGIN {
+        while ((getline line < insns) > 0) {
+            split(line, f, " ")
+            ninsn[f[1]] = f[2]
+        }
+    }
+    $3 ~ /^[tT]$/ {
+        sym  = $4
+        name = sym
+        cold = (name ~ /\.cold/)
+        sub(/^footprint_/, "", name)
+        sub(/\..*$/, "", name)
+        if (cold) {
+            csize[name] += $2 + 0
+            cinsn[name] += ninsn[sym]
+        } else {
+            size[name] += $2 + 0
+            insn[name] += ninsn[sym]
+        }
+        seen[name] = 1
+    }
+    END {
+        for (name in seen) {
+            printf "%-32s %8d %8d %8d %8d\n", name, size[name], insn[name],
+                   csize[name], cinsn[name]
+        }
+    }
+' | sort | awk '
+    BEGIN {
+        printf "%-32s %8s %8s %8s %8s\n", "function", "bytes", "insns",
+               "cold", "insns"
+    }
+    {
+        print
+        bytes += $2
+        insns += $3
+        cbytes += $4
+        cinsns += $5
+    }
+    END {
+        printf "%-32s %8d %8d %8d %8d\n", "total", bytes, insns, cbytes,
+               cinsns
+    }
+'
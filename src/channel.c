@@ -0,0 +1,417 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+
+#define LAUXHLIB_USED_IN_LUA
+#define LAUXHLIB_USE_CHANNEL
+#include "lauxhlib.h"
+
+#define LAUXHLIB_CHANNEL_MT       "lauxhlib.channel"
+#define LAUXHLIB_CHANNEL_EXPORTER "lauxhlib.channel.exporter"
+#ifdef LAUXHLIB_TEST
+# define LAUXHLIB_CHANNEL_RELAY_MT "lauxhlib.channel.relay"
+#endif
+
+#define checkself(L)                                                           \
+    ((lauxh_channel_t **)lauxh_checkudataupv((L), 1, LAUXHLIB_CHANNEL_MT))
+
+static int send_lua(lua_State *L)
+{
+    lauxh_channel_t *ch = *checkself(L);
+    int msec            = (int)lauxh_optint(L, 3, -1);
+    lauxh_xbuf_t buf    = LAUXH_XBUF_INIT;
+
+    lua_settop(L, 2);
+    if (lauxh_xencode(L, 2, &buf) == LUA_TNONE) {
+        int err = errno;
+        lauxh_xbuf_free(&buf);
+        return lauxh_argerror(L, 2, "%s", strerror(err));
+    } else if (lauxh_channel_send(ch, &buf, msec) != 0) {
+        lauxh_xbuf_free(&buf);
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+static int recv_lua(lua_State *L)
+{
+    lauxh_channel_t *ch = *checkself(L);
+    int msec            = (int)lauxh_optint(L, 2, -1);
+    lauxh_xbuf_t buf    = LAUXH_XBUF_INIT;
+    int t               = LUA_TNONE;
+
+    if (lauxh_channel_recv(ch, &buf, msec) != 0) {
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+    lua_settop(L, 0);
+    lua_pushboolean(L, 1);
+    t = lauxh_xdecode(L, buf.data, buf.len);
+    lauxh_xbuf_free(&buf);
+    if (t == LUA_TNONE) {
+        return luaL_error(L, "failed to decode the message: %s",
+                          strerror(errno));
+    }
+    return 2;
+}
+
+static int cap_lua(lua_State *L)
+{
+    lauxh_channel_t *ch = *checkself(L);
+    lua_pushinteger(L, (lua_Integer)lauxh_channel_cap(ch));
+    return 1;
+}
+
+static int tostring_lua(lua_State *L)
+{
+    lauxh_channel_t *ch = *checkself(L);
+    lua_pushfstring(L, LAUXHLIB_CHANNEL_MT ": %p", ch);
+    return 1;
+}
+
+static int gc_lua(lua_State *L)
+{
+    lauxh_channel_t **ptr = checkself(L);
+    if (*ptr) {
+        lauxh_channel_release(*ptr);
+        *ptr = NULL;
+    }
+    return 0;
+}
+
+static lauxh_channel_t **new_channel(lua_State *L)
+{
+    lauxh_channel_t **ptr =
+        (lauxh_channel_t **)lua_newuserdata(L, sizeof(lauxh_channel_t *));
+    *ptr = NULL;
+    lauxh_setmetatable(L, LAUXHLIB_CHANNEL_MT);
+    return ptr;
+}
+
+/**
+ * the exported channels waiting to be imported. the export table is shared by
+ * all states in the process, and the token is the key of the entry that is
+ * never reused. the token is a plain integer, so it can be passed to the state
+ * on the other thread, and the import method never dereferences the value
+ * passed from Lua.
+ */
+typedef struct export_st {
+    lua_Integer token;
+    lauxh_channel_t *ch;
+    // identity of the exporting state
+    const void *owner;
+    struct export_st *next;
+} export_t;
+
+static pthread_mutex_t EXPORTS_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+static export_t *EXPORTS             = NULL;
+static lua_Integer EXPORTS_TOKEN     = 0;
+
+// remove the entry of the token, or the entries of the owner if the token is 0
+static lauxh_channel_t *take_export(lua_Integer token, const void *owner)
+{
+    lauxh_channel_t *ch = NULL;
+    export_t **prev     = &EXPORTS;
+
+    pthread_mutex_lock(&EXPORTS_MUTEX);
+    while (*prev) {
+        export_t *e = *prev;
+        if (token ? e->token != token : e->owner != owner) {
+            prev = &e->next;
+            continue;
+        }
+        *prev = e->next;
+        if (token) {
+            ch = e->ch;
+            free(e);
+            break;
+        }
+        lauxh_channel_release(e->ch);
+        free(e);
+    }
+    pthread_mutex_unlock(&EXPORTS_MUTEX);
+
+    return ch;
+}
+
+// cancel the exports that are not imported when the exporting state is closed
+static int exporter_gc(lua_State *L)
+{
+    take_export(0, lua_touserdata(L, 1));
+    return 0;
+}
+
+static const void *get_exporter(lua_State *L)
+{
+    const void *owner = NULL;
+
+    lua_getfield(L, LUA_REGISTRYINDEX, LAUXHLIB_CHANNEL_EXPORTER);
+    if ((owner = lua_touserdata(L, -1))) {
+        lua_pop(L, 1);
+        return owner;
+    }
+    lua_pop(L, 1);
+    owner = lua_newuserdata(L, 1);
+    lua_newtable(L);
+    lauxh_pushfn2tbl(L, "__gc", exporter_gc);
+    lua_setmetatable(L, -2);
+    lua_setfield(L, LUA_REGISTRYINDEX, LAUXHLIB_CHANNEL_EXPORTER);
+    return owner;
+}
+
+static int export_lua(lua_State *L)
+{
+    lauxh_channel_t *ch = *checkself(L);
+    const void *owner   = get_exporter(L);
+    export_t *e         = (export_t *)malloc(sizeof(export_t));
+    lua_Integer token   = 0;
+
+    if (!e) {
+        return luaL_error(L, "failed to export the channel: %s",
+                          strerror(errno));
+    }
+    e->ch    = lauxh_channel_retain(ch);
+    e->owner = owner;
+    pthread_mutex_lock(&EXPORTS_MUTEX);
+    token    = ++EXPORTS_TOKEN;
+    e->token = token;
+    e->next  = EXPORTS;
+    EXPORTS  = e;
+    pthread_mutex_unlock(&EXPORTS_MUTEX);
+
+    lua_pushinteger(L, token);
+    return 1;
+}
+
+static int import_lua(lua_State *L)
+{
+    lua_Integer token     = lauxh_checkpint(L, 1);
+    lauxh_channel_t **ptr = new_channel(L);
+
+    // take over the reference that retained by the export method
+    if (!(*ptr = take_export(token, NULL))) {
+        return lauxh_argerror(L, 1, "unknown or already imported token");
+    }
+    return 1;
+}
+
+static int new_lua(lua_State *L)
+{
+    lua_Integer cap       = lauxh_optpint(L, 1, 1);
+    lauxh_channel_t **ptr = new_channel(L);
+
+    if (!(*ptr = lauxh_channel_new((size_t)cap))) {
+        return luaL_error(L, "failed to create a channel: %s",
+                          strerror(errno));
+    }
+    return 1;
+}
+
+static void create_mt(lua_State *L)
+{
+    struct luaL_Reg mmethod[] = {
+        {"__gc",       gc_lua      },
+        {"__tostring", tostring_lua},
+        {NULL,         NULL        }
+    };
+    struct luaL_Reg method[] = {
+        {"send",   send_lua  },
+        {"recv",   recv_lua  },
+        {"cap",    cap_lua   },
+        {"export", export_lua},
+        {NULL,     NULL      }
+    };
+
+    lauxh_newmetatable_mtptr(L, LAUXHLIB_CHANNEL_MT, mmethod, method);
+    lua_pop(L, 1);
+}
+
+#ifdef LAUXHLIB_TEST
+/**
+ * the relay thread forwards the messages from the src channel to the dst
+ * channel in its own state until it forwards nil. it is used to test the
+ * channel between the threads, and is built only with LAUXHLIB_TEST.
+ */
+typedef struct {
+    lua_Integer src;
+    lua_Integer dst;
+    // delay in milliseconds before forwarding each message
+    int delay;
+} relay_arg_t;
+
+typedef struct {
+    pthread_t tid;
+    int joined;
+} relay_t;
+
+static lauxh_channel_t *relay_import(lua_State *L, lua_Integer token)
+{
+    lua_pushcfunction(L, import_lua);
+    lua_pushinteger(L, token);
+    if (lua_pcall(L, 1, 1, 0) != 0) {
+        return NULL;
+    }
+    // the channel is kept on the stack until the state is closed
+    return *(lauxh_channel_t **)lua_touserdata(L, -1);
+}
+
+static void *relay_thread(void *arg)
+{
+    relay_arg_t *r       = (relay_arg_t *)arg;
+    lua_State *L         = luaL_newstate();
+    lauxh_channel_t *src = NULL;
+    lauxh_channel_t *dst = NULL;
+    lauxh_xbuf_t buf     = LAUXH_XBUF_INIT;
+    const char *err      = NULL;
+    int t                = LUA_TNONE;
+
+    if (!L) {
+        free(r);
+        return (void *)"failed to create a state";
+    }
+    create_mt(L);
+    if (!(src = relay_import(L, r->src)) || !(dst = relay_import(L, r->dst))) {
+        err = "failed to import the channels";
+    }
+    while (!err && t != LUA_TNIL) {
+        if (lauxh_channel_recv(src, &buf, -1) != 0) {
+            err = "failed to receive the message";
+        } else if ((t = lauxh_xdecode(L, buf.data, buf.len)) == LUA_TNONE) {
+            err = "failed to decode the message";
+        } else {
+            if (r->delay > 0) {
+                usleep(r->delay * 1000);
+            }
+            lauxh_xbuf_free(&buf);
+            if (lauxh_xencode(L, lua_gettop(L), &buf) == LUA_TNONE ||
+                lauxh_channel_send(dst, &buf, -1) != 0) {
+                err = "failed to forward the message";
+            }
+            lua_pop(L, 1);
+        }
+    }
+    lauxh_xbuf_free(&buf);
+    lua_close(L);
+    free(r);
+    return (void *)err;
+}
+
+static int relay_join_lua(lua_State *L)
+{
+    relay_t *relay = lauxh_checkudata(L, 1, LAUXHLIB_CHANNEL_RELAY_MT);
+    void *err      = NULL;
+
+    if (relay->joined) {
+        return luaL_error(L, "relay thread is already joined");
+    }
+    relay->joined = 1;
+    pthread_join(relay->tid, &err);
+    if (err) {
+        lua_pushboolean(L, 0);
+        lua_pushstring(L, (const char *)err);
+        return 2;
+    }
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+static int relay_gc_lua(lua_State *L)
+{
+    relay_t *relay = (relay_t *)lua_touserdata(L, 1);
+
+    if (!relay->joined) {
+        relay->joined = 1;
+        pthread_detach(relay->tid);
+    }
+    return 0;
+}
+
+static int relay_lua(lua_State *L)
+{
+    lua_Integer src  = lauxh_checkpint(L, 1);
+    lua_Integer dst  = lauxh_checkpint(L, 2);
+    int delay        = (int)lauxh_optuint16(L, 3, 0);
+    relay_t *relay   = (relay_t *)lua_newuserdata(L, sizeof(relay_t));
+    relay_arg_t *arg = NULL;
+    int rc           = 0;
+
+    relay->joined = 1;
+    lauxh_setmetatable(L, LAUXHLIB_CHANNEL_RELAY_MT);
+    if (!(arg = (relay_arg_t *)malloc(sizeof(relay_arg_t)))) {
+        return luaL_error(L, "failed to create a relay thread: %s",
+                          strerror(errno));
+    }
+    arg->src   = src;
+    arg->dst   = dst;
+    arg->delay = delay;
+    if ((rc = pthread_create(&relay->tid, NULL, relay_thread, arg)) != 0) {
+        free(arg);
+        return luaL_error(L, "failed to create a relay thread: %s",
+                          strerror(rc));
+    }
+    relay->joined = 0;
+    return 1;
+}
+
+static void create_relay_mt(lua_State *L)
+{
+    lauxh_newmetatable(L, LAUXHLIB_CHANNEL_RELAY_MT);
+    lauxh_pushfn2tbl(L, "__gc", relay_gc_lua);
+    lua_newtable(L);
+    lauxh_pushfn2tbl(L, "join", relay_join_lua);
+    lua_setfield(L, -2, "__index");
+    lua_pop(L, 1);
+}
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+LUALIB_API int luaopen_lauxhlib_channel(lua_State *L)
+{
+    struct luaL_Reg method[] = {
+        {"new",    new_lua   },
+        {"import", import_lua},
+#ifdef LAUXHLIB_TEST
+        {"relay",  relay_lua },
+#endif
+        {NULL,     NULL      }
+    };
+
+    create_mt(L);
+#ifdef LAUXHLIB_TEST
+    create_relay_mt(L);
+#endif
+    lua_newtable(L);
+    for (struct luaL_Reg *ptr = method; ptr->name; ptr++) {
+        lauxh_pushfn2tbl(L, ptr->name, ptr->func);
+    }
+
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
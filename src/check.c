@@ -50,6 +50,135 @@
         return 1;                                                              \
     } while (0)
 
+#define ARGS_MAX 16
+
+static int args_lua(lua_State *L)
+{
+    size_t len           = 0;
+    const char *str      = lauxh_checklstr(L, 1, &len);
+    lauxh_argspec_t spec = LAUXH_ARGSPEC_INIT;
+    char fmt[256]        = {0};
+    union {
+        int b;
+        lua_Number n;
+        lua_Integer i;
+        int8_t i8;
+        int16_t i16;
+        int32_t i32;
+        int64_t i64;
+        uint8_t u8;
+        uint16_t u16;
+        uint32_t u32;
+        uint64_t u64;
+        const char *s;
+        lua_State *th;
+        const void *p;
+        void *u;
+    } val[ARGS_MAX];
+    size_t lens[ARGS_MAX] = {0};
+    void *o[ARGS_MAX * 2] = {0};
+    int n                 = 0;
+
+    lauxh_argcheck(L, len < sizeof(fmt), 1, "format string too long");
+    memcpy(fmt, str, len);
+    lua_remove(L, 1);
+    lauxh_argspec_compile(L, &spec, fmt);
+    if (spec.nitem > ARGS_MAX) {
+        return luaL_error(L, "too many items in the argument format");
+    }
+
+    // output pointers
+    for (int i = 0; i < spec.nitem; i++) {
+        o[n++] = &val[i];
+        if (spec.item[i].type == LAUXH_ARG_LSTR) {
+            o[n++] = &lens[i];
+        }
+    }
+    lauxh_checkargspec(L, &spec, o[0], o[1], o[2], o[3], o[4], o[5], o[6],
+                       o[7], o[8], o[9], o[10], o[11], o[12], o[13], o[14],
+                       o[15], o[16], o[17], o[18], o[19], o[20], o[21], o[22],
+                       o[23], o[24], o[25], o[26], o[27], o[28], o[29], o[30],
+                       o[31]);
+
+    // push the extracted values
+    for (int i = 0; i < spec.nitem; i++) {
+        int idx = i + 1;
+
+        if (lua_isnoneornil(L, idx) && spec.item[i].opt) {
+            lua_pushnil(L);
+            continue;
+        }
+
+        switch (spec.item[i].type) {
+        case LAUXH_ARG_BOOL:
+            lua_pushboolean(L, val[i].b);
+            break;
+        case LAUXH_ARG_NUM:
+        case LAUXH_ARG_FINITE:
+            lua_pushnumber(L, val[i].n);
+            break;
+        case LAUXH_ARG_INT:
+        case LAUXH_ARG_UINT:
+            lua_pushinteger(L, val[i].i);
+            break;
+        case LAUXH_ARG_INT8:
+            lua_pushinteger(L, val[i].i8);
+            break;
+        case LAUXH_ARG_INT16:
+            lua_pushinteger(L, val[i].i16);
+            break;
+        case LAUXH_ARG_INT32:
+            lua_pushinteger(L, val[i].i32);
+            break;
+        case LAUXH_ARG_INT64:
+            lua_pushinteger(L, (lua_Integer)val[i].i64);
+            break;
+        case LAUXH_ARG_UINT8:
+            lua_pushinteger(L, val[i].u8);
+            break;
+        case LAUXH_ARG_UINT16:
+            lua_pushinteger(L, val[i].u16);
+            break;
+        case LAUXH_ARG_UINT32:
+            lua_pushinteger(L, (lua_Integer)val[i].u32);
+            break;
+        case LAUXH_ARG_UINT64:
+            lua_pushinteger(L, (lua_Integer)val[i].u64);
+            break;
+        case LAUXH_ARG_STR:
+            lua_pushstring(L, val[i].s);
+            break;
+        case LAUXH_ARG_LSTR:
+            lua_pushlstring(L, val[i].s, lens[i]);
+            break;
+        case LAUXH_ARG_POINTER:
+            lua_pushlightuserdata(L, (void *)val[i].p);
+            break;
+        case LAUXH_ARG_THREAD:
+            if (lua_tothread(L, idx) != val[i].th) {
+                return luaL_error(L, "unexpected thread at %d", idx);
+            }
+            lua_pushvalue(L, idx);
+            break;
+        case LAUXH_ARG_USERDATA:
+        case LAUXH_ARG_UDATA:
+            if (lua_touserdata(L, idx) != val[i].u) {
+                return luaL_error(L, "unexpected userdata at %d", idx);
+            }
+            lua_pushvalue(L, idx);
+            break;
+        default:
+            // LAUXH_ARG_ANY, LAUXH_ARG_TABLE, LAUXH_ARG_FUNC and
+            // LAUXH_ARG_CALLABLE
+            lua_pushvalue(L, idx);
+        }
+    }
+
+    return spec.nitem;
+}
+
+#undef ARGS_MAX
+
 static int none_lua(lua_State *L)
 {
     if (!lua_isnoneornil(L, 1)) {
@@ -69,6 +198,33 @@ static int flags_lua(lua_State *L)
     return 1;
 }
 
+// open flags
+static lauxh_flagset_t FLAGSET = {
+    LAUXH_OPTIONSET_INIT("read", "write", "create", "trunc", "append",
+                         "nonblock"),
+    {0x1, 0x2, 0x40, 0x200, 0x400, 0x800},
+};
+
+static int flagset_lua(lua_State *L)
+{
+    uint64_t flags = lauxh_optflagset(L, 1, &FLAGSET);
+    lua_settop(L, 0);
+    lua_pushinteger(L, flags);
+    return 1;
+}
+
+// the flag set that is not built by lauxh_optionset_init()
+static lauxh_flagset_t NOINIT_FLAGSET = {
+    LAUXH_OPTIONSET_INIT("read"),
+    {0x1},
+};
+
+static int noinitflagset_lua(lua_State *L)
+{
+    lua_pushinteger(L, lauxh_optflagset(L, 1, &NOINIT_FLAGSET));
+    return 1;
+}
+
 static int callable_lua(lua_State *L)
 {
     CHECK_VALUE(lauxh_checkcallable);
@@ -195,6 +351,70 @@ static int userdata_lua(lua_State *L)
     CHECK_VALUE(lauxh_checkuserdata);
 }
 
+// typed userdata; the derived type has the same id as the other type
+static const lauxh_udtype_t UDTYPE_BASE    = {"lauxhlib.check.base", 1, NULL};
+static const lauxh_udtype_t UDTYPE_OTHER   = {"lauxhlib.check.other", 2, NULL};
+static const lauxh_udtype_t UDTYPE_DERIVED = {"lauxhlib.check.derived", 2,
+                                              &UDTYPE_BASE};
+
+static const lauxh_udtype_t *const UDTYPES[] = {&UDTYPE_BASE, &UDTYPE_DERIVED,
+                                                &UDTYPE_OTHER};
+static const char *const UDTYPE_NAMES[] = {"base", "derived", "other", NULL};
+
+static int newudtype_lua(lua_State *L)
+{
+    const lauxh_udtype_t *type =
+        UDTYPES[luaL_checkoption(L, 1, NULL, UDTYPE_NAMES)];
+    lua_Integer v  = lauxh_optinteger(L, 2, 0);
+    lua_Integer *p = lauxh_newudtype(L, type, sizeof(lua_Integer));
+
+    *p = v;
+    return 1;
+}
+
+// userdata that has the magic value and the specified depth and ids
+static int rawudtype_lua(lua_State *L)
+{
+    uint32_t depth = lauxh_checkuint32(L, 1);
+    size_t size    = lauxh_checkuint8(L, 2);
+    uint32_t id    = lauxh_checkuint32(L, 3);
+    uint32_t *p    = NULL;
+
+    lauxh_argcheck(L, size >= sizeof(lauxh_udhdr_t), 2, "too small");
+    p    = lua_newuserdata(L, size);
+    p[0] = LAUXH_UDTYPE_MAGIC;
+    p[1] = depth;
+    for (size_t i = 2; i < size / sizeof(uint32_t); i++) {
+        p[i] = id;
+    }
+    return 1;
+}
+
+static int udtype_lua(lua_State *L)
+{
+    const lauxh_udtype_t *type =
+        UDTYPES[luaL_checkoption(L, 2, NULL, UDTYPE_NAMES)];
+    lua_Integer *p = lauxh_checkudtype(L, 1, type);
+
+    lua_pushinteger(L, *p);
+    return 1;
+}
+
+static int isudtype_lua(lua_State *L)
+{
+    const lauxh_udtype_t *type =
+        UDTYPES[luaL_checkoption(L, 2, NULL, UDTYPE_NAMES)];
+
+    lua_pushboolean(L, lauxh_isudtype(L, 1, type));
+    return 1;
+}
+
+static int udtypeid_lua(lua_State *L)
+{
+    lua_pushinteger(L, (lua_Integer)lauxh_udtypeid(L, 1));
+    return 1;
+}
+
 static int cfunc_lua(lua_State *L)
 {
     CHECK_VALUE(lauxh_checkcfunc);
@@ -215,6 +435,72 @@ static int str_lua(lua_State *L)
     CHECK_VALUE(lauxh_checkstr);
 }
 
+static int ascii_lua(lua_State *L)
+{
+    CHECK_VALUE(lauxh_checkasciistr);
+}
+
+static int printable_lua(lua_State *L)
+{
+    CHECK_VALUE(lauxh_checkprintable);
+}
+
+static int utf8_lua(lua_State *L)
+{
+    CHECK_VALUE(lauxh_checkutf8str);
+}
+
+// file modes and HTTP methods
+static lauxh_optionset_t OPTIONS = LAUXH_OPTIONSET_INIT(
+    "r", "w", "rw", "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT",
+    "OPTIONS", "TRACE", "PATCH", "PROPFIND", "PROPPATCH", "MKCOL", "COPY",
+    "MOVE", "LOCK", "UNLOCK", "SEARCH", "BIND", "UNBIND", "REBIND", "ACL");
+
+static int option_lua(lua_State *L)
+{
+    int opt = 0;
+
+    CHECK_ERROPTS(2, 3);
+    opt = lauxh_checkoption(L, 1, &OPTIONS);
+    lua_pushinteger(L, opt);
+    return 1;
+}
+
+// the single-letter names that differ only in the lowest bits of the hash
+static lauxh_optionset_t SHORT_OPTIONS = LAUXH_OPTIONSET_INIT(
+    "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m", "n", "o",
+    "p");
+
+static int shortopt_lua(lua_State *L)
+{
+    lua_pushinteger(L, lauxh_checkoption(L, 1, &SHORT_OPTIONS));
+    return 1;
+}
+
+// the maximum number of the two-letter names from "a0" to "g3"
+static lauxh_optionset_t WIDE_OPTIONS = LAUXH_OPTIONSET_INIT(
+    "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7", "a8", "a9", "b0", "b1",
+    "b2", "b3", "b4", "b5", "b6", "b7", "b8", "b9", "c0", "c1", "c2", "c3",
+    "c4", "c5", "c6", "c7", "c8", "c9", "d0", "d1", "d2", "d3", "d4", "d5",
+    "d6", "d7", "d8", "d9", "e0", "e1", "e2", "e3", "e4", "e5", "e6", "e7",
+    "e8", "e9", "f0", "f1", "f2", "f3", "f4", "f5", "f6", "f7", "f8", "f9",
+    "g0", "g1", "g2", "g3");
+
+static int wideopt_lua(lua_State *L)
+{
+    lua_pushinteger(L, lauxh_checkoption(L, 1, &WIDE_OPTIONS));
+    return 1;
+}
+
+// the option set that is not built by lauxh_optionset_init()
+static lauxh_optionset_t NOINIT_OPTIONS = LAUXH_OPTIONSET_INIT("foo");
+
+static int noinitopt_lua(lua_State *L)
+{
+    lua_pushinteger(L, lauxh_checkoption(L, 1, &NOINIT_OPTIONS));
+    return 1;
+}
+
 static int pointer_lua(lua_State *L)
 {
     CHECK_VALUE(lauxh_checkpointer);
@@ -225,6 +511,64 @@ static int bool_lua(lua_State *L)
     CHECK_VALUE(lauxh_checkbool);
 }
 
+typedef struct {
+    char name[16];
+    int32_t port;
+    double timeout;
+    int verbose;
+    uint8_t level;
+    const char *tag;
+} struct_conf_t;
+
+static const lauxh_field_t STRUCT_CONF_FIELDS[] = {
+    LAUXH_FIELD(struct_conf_t, name, CHARS),
+    LAUXH_FIELD_RANGE(struct_conf_t, port, INT32, 1, 65535),
+    LAUXH_FIELD_OPT(struct_conf_t, timeout, DOUBLE),
+    LAUXH_FIELD_OPT(struct_conf_t, verbose, BOOL),
+    LAUXH_FIELD_OPT(struct_conf_t, level, UINT8),
+    LAUXH_FIELD_OPT(struct_conf_t, tag, STR),
+    LAUXH_FIELD_END,
+};
+
+static int struct_lua(lua_State *L)
+{
+    struct_conf_t conf = {
+        .timeout = 1.5,
+        .level   = 1,
+    };
+
+    lauxh_checkstruct(L, 1, STRUCT_CONF_FIELDS, &conf);
+    lauxh_pushstruct(L, STRUCT_CONF_FIELDS, &conf);
+    return 1;
+}
+
+static int array_lua(lua_State *L)
+{
+    static const char *const types[] = {"int64", "double", "uint8", NULL};
+    size_t n                         = 0;
+    void *buf                        = NULL;
+
+    lauxh_checktable(L, 1);
+    n = lauxh_rawlen(L, 1);
+    switch (luaL_checkoption(L, 2, NULL, types)) {
+    case 0:
+        buf = lua_newuserdata(L, sizeof(int64_t) * n);
+        lauxh_checkarray_int64(L, 1, buf, n);
+        lauxh_pusharray_int64(L, buf, n);
+        break;
+    case 1:
+        buf = lua_newuserdata(L, sizeof(double) * n);
+        lauxh_checkarray_double(L, 1, buf, n);
+        lauxh_pusharray_double(L, buf, n);
+        break;
+    default:
+        buf = lua_newuserdata(L, sizeof(uint8_t) * n);
+        lauxh_checkarray_uint8(L, 1, buf, n);
+        lauxh_pusharray_uint8(L, buf, n);
+    }
+    return 1;
+}
+
 #undef CHECK_VALUE
 #undef CHECK_ERROPTS
 
@@ -235,35 +579,59 @@ extern "C" {
 LUALIB_API int luaopen_lauxhlib_check(lua_State *L)
 {
     struct luaL_Reg method[] = {
-        {"none",     none_lua    },
-        {"bool",     bool_lua    },
-        {"pointer",  pointer_lua },
-        {"num",      num_lua     },
-        {"str",      str_lua     },
-        {"table",    table_lua   },
-        {"func",     func_lua    },
-        {"cfunc",    cfunc_lua   },
-        {"userdata", userdata_lua},
-        {"thread",   thread_lua  },
-        {"finite",   finite_lua  },
-        {"unsigned", unsigned_lua},
-        {"int",      int_lua     },
-        {"uint",     uint_lua    },
-        {"pint",     pint_lua    },
-        {"int8",     int8_lua    },
-        {"int16",    int16_lua   },
-        {"int32",    int32_lua   },
-        {"int64",    int64_lua   },
-        {"uint8",    uint8_lua   },
-        {"uint16",   uint16_lua  },
-        {"uint32",   uint32_lua  },
-        {"uint64",   uint64_lua  },
-        {"file",     file_lua    },
-        {"callable", callable_lua},
-        {"flags",    flags_lua   },
-        {NULL,       NULL        }
+        {"none",          none_lua         },
+        {"bool",          bool_lua         },
+        {"pointer",       pointer_lua      },
+        {"num",           num_lua          },
+        {"str",           str_lua          },
+        {"ascii",         ascii_lua        },
+        {"printable",     printable_lua    },
+        {"utf8",          utf8_lua         },
+        {"option",        option_lua       },
+        {"shortopt",      shortopt_lua     },
+        {"wideopt",       wideopt_lua      },
+        {"noinitopt",     noinitopt_lua    },
+        {"table",         table_lua        },
+        {"func",          func_lua         },
+        {"cfunc",         cfunc_lua        },
+        {"userdata",      userdata_lua     },
+        {"newudtype",     newudtype_lua    },
+        {"rawudtype",     rawudtype_lua    },
+        {"udtype",        udtype_lua       },
+        {"isudtype",      isudtype_lua     },
+        {"udtypeid",      udtypeid_lua     },
+        {"thread",        thread_lua       },
+        {"finite",        finite_lua       },
+        {"unsigned",      unsigned_lua     },
+        {"int",           int_lua          },
+        {"uint",          uint_lua         },
+        {"pint",          pint_lua         },
+        {"int8",          int8_lua         },
+        {"int16",         int16_lua        },
+        {"int32",         int32_lua        },
+        {"int64",         int64_lua        },
+        {"uint8",         uint8_lua        },
+        {"uint16",        uint16_lua       },
+        {"uint32",        uint32_lua       },
+        {"uint64",        uint64_lua       },
+        {"file",          file_lua         },
+        {"callable",      callable_lua     },
+        {"flags",         flags_lua        },
+        {"flagset",       flagset_lua      },
+        {"noinitflagset", noinitflagset_lua},
+        {"args",          args_lua         },
+        {"struct",        struct_lua       },
+        {"array",         array_lua        },
+        {NULL,            NULL             }
     };
 
+    // build the hash table of the option sets at load time
+    if (lauxh_optionset_init(&OPTIONS) != 0 ||
+        lauxh_optionset_init(&SHORT_OPTIONS) != 0 ||
+        lauxh_optionset_init(&WIDE_OPTIONS) != 0 ||
+        lauxh_optionset_init(&FLAGSET.opts) != 0) {
+        return luaL_error(L, "invalid option set: %s", strerror(errno));
+    }
     lua_newtable(L);
     for (struct luaL_Reg *ptr = method; ptr->name; ptr++) {
         lauxh_pushfn2tbl(L, ptr->name, ptr->func);
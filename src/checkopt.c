@@ -307,6 +307,21 @@ static int num_lua(lua_State *L)
     CHECK_OPT_RANGEVAL(def, lauxh_checknum, lauxh_optnum);
 }
 
+// file modes and HTTP methods
+static lauxh_optionset_t OPTIONS = LAUXH_OPTIONSET_INIT(
+    "r", "w", "rw", "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT",
+    "OPTIONS", "TRACE", "PATCH", "PROPFIND", "PROPPATCH", "MKCOL", "COPY",
+    "MOVE", "LOCK", "UNLOCK", "SEARCH", "BIND", "UNBIND", "REBIND", "ACL");
+
+static int option_lua(lua_State *L)
+{
+    int def = (int)lauxh_optint(L, 2, -1);
+
+    CHECK_ERROPTS(3, 4);
+    lua_pushinteger(L, lauxh_optoption(L, 1, &OPTIONS, def));
+    return 1;
+}
+
 #undef CHECK_OPT_RANGEVAL_GLE
 #undef CHECK_OPT_RANGEVAL
 #undef CHECK_OPT_VAL_EX
@@ -323,6 +338,7 @@ LUALIB_API int luaopen_lauxhlib_checkopt(lua_State *L)
         {"pointer",  pointer_lua },
         {"num",      num_lua     },
         {"str",      str_lua     },
+        {"option",   option_lua  },
         {"table",    table_lua   },
         {"func",     func_lua    },
         {"cfunc",    cfunc_lua   },
@@ -346,6 +362,9 @@ LUALIB_API int luaopen_lauxhlib_checkopt(lua_State *L)
         {NULL,       NULL        }
     };
 
+    if (lauxh_optionset_init(&OPTIONS) != 0) {
+        return luaL_error(L, "invalid option set: %s", strerror(errno));
+    }
     lua_newtable(L);
     for (struct luaL_Reg *ptr = method; ptr->name; ptr++) {
         lauxh_pushfn2tbl(L, ptr->name, ptr->func);
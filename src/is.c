@@ -184,6 +184,21 @@ static int str_lua(lua_State *L)
     RET_BOOLEAN(lauxh_isstr);
 }
 
+static int ascii_lua(lua_State *L)
+{
+    RET_BOOLEAN(lauxh_isascii);
+}
+
+static int printable_lua(lua_State *L)
+{
+    RET_BOOLEAN(lauxh_isprintable);
+}
+
+static int utf8_lua(lua_State *L)
+{
+    RET_BOOLEAN(lauxh_isutf8);
+}
+
 static int pointer_lua(lua_State *L)
 {
     RET_BOOLEAN(lauxh_ispointer);
@@ -208,36 +223,39 @@ extern "C" {
 LUALIB_API int luaopen_lauxhlib_is(lua_State *L)
 {
     struct luaL_Reg funcs[] = {
-        {"none",     none_lua    },
-        {"bool",     bool_lua    },
-        {"pointer",  pointer_lua },
-        {"str",      str_lua     },
-        {"table",    table_lua   },
-        {"func",     func_lua    },
-        {"cfunc",    cfunc_lua   },
-        {"userdata", userdata_lua},
-        {"thread",   thread_lua  },
-        {"file",     file_lua    },
-        {"callable", callable_lua},
-        {"num",      num_lua     },
-        {"unsigned", unsigned_lua},
-        {"finite",   finite_lua  },
-        {"int",      int_lua     },
-        {"uint",     uint_lua    },
-        {"pint",     pint_lua    },
-        {"int8",     int8_lua    },
-        {"int16",    int16_lua   },
-        {"int32",    int32_lua   },
-        {"int64",    int64_lua   },
-        {"uint8",    uint8_lua   },
-        {"uint16",   uint16_lua  },
-        {"uint32",   uint32_lua  },
-        {"uint64",   uint64_lua  },
-        {"pint8",    pint8_lua   },
-        {"pint16",   pint16_lua  },
-        {"pint32",   pint32_lua  },
-        {"pint64",   pint64_lua  },
-        {NULL,       NULL        }
+        {"none",      none_lua     },
+        {"bool",      bool_lua     },
+        {"pointer",   pointer_lua  },
+        {"str",       str_lua      },
+        {"ascii",     ascii_lua    },
+        {"printable", printable_lua},
+        {"utf8",      utf8_lua     },
+        {"table",     table_lua    },
+        {"func",      func_lua     },
+        {"cfunc",     cfunc_lua    },
+        {"userdata",  userdata_lua },
+        {"thread",    thread_lua   },
+        {"file",      file_lua     },
+        {"callable",  callable_lua },
+        {"num",       num_lua      },
+        {"unsigned",  unsigned_lua },
+        {"finite",    finite_lua   },
+        {"int",       int_lua      },
+        {"uint",      uint_lua     },
+        {"pint",      pint_lua     },
+        {"int8",      int8_lua     },
+        {"int16",     int16_lua    },
+        {"int32",     int32_lua    },
+        {"int64",     int64_lua    },
+        {"uint8",     uint8_lua    },
+        {"uint16",    uint16_lua   },
+        {"uint32",    uint32_lua   },
+        {"uint64",    uint64_lua   },
+        {"pint8",     pint8_lua    },
+        {"pint16",    pint16_lua   },
+        {"pint32",    pint32_lua   },
+        {"pint64",    pint64_lua   },
+        {NULL,        NULL         }
     };
 
     lua_newtable(L);
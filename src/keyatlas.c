@@ -0,0 +1,200 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#define LAUXHLIB_USED_IN_LUA
+#include "lauxhlib.h"
+
+// the key atlas is held in the first upvalue of the functions
+#define ATLAS lua_upvalueindex(1)
+
+enum {
+    KEY_STR = 0,
+    KEY_LSTR,
+    KEY_NUM,
+    KEY_INT,
+    KEY_BOOL,
+    KEY_FN,
+    KEY_TBL,
+    KEY_NIL
+};
+
+static const char *const KEYS[] = {"str", "lstr", "num", "int", "bool",
+                                   "fn",  "tbl",  "nil", NULL};
+
+#define checkkid(L, idx) luaL_checkoption((L), (idx), NULL, KEYS)
+
+static int key_lua(lua_State *L)
+{
+    lauxh_pushkey(L, ATLAS, checkkid(L, 1));
+    return 1;
+}
+
+static int fill_lua(lua_State *L)
+{
+    lua_settop(L, 1);
+    lauxh_checktable(L, 1);
+    lauxh_pushstr2tblk(L, ATLAS, KEY_STR, "foo");
+    lauxh_pushlstr2tblk(L, ATLAS, KEY_LSTR, "bar\0baz", 7);
+    lauxh_pushnum2tblk(L, ATLAS, KEY_NUM, 1.5);
+    lauxh_pushint2tblk(L, ATLAS, KEY_INT, 123);
+    lauxh_pushbool2tblk(L, ATLAS, KEY_BOOL, 1);
+    lauxh_pushfn2tblk(L, ATLAS, KEY_FN, fill_lua);
+    lauxh_pushnil2tblk(L, ATLAS, KEY_NIL);
+    // the relative index of the table
+    lua_newtable(L);
+    lauxh_pushkey(L, ATLAS, KEY_TBL);
+    lua_pushvalue(L, -2);
+    lua_rawset(L, 1);
+    lauxh_pushint2tblkat(L, ATLAS, KEY_INT, 1, -1);
+    lua_pop(L, 1);
+    return 1;
+}
+
+static int get_lua(lua_State *L)
+{
+    int kid = checkkid(L, 2);
+
+    lauxh_checktable(L, 1);
+    lua_settop(L, 1);
+    lauxh_gettblofk(L, ATLAS, kid, -1);
+    return 1;
+}
+
+static int checktable_lua(lua_State *L)
+{
+    lauxh_checktableofk(L, 1, ATLAS, checkkid(L, 2));
+    return 1;
+}
+
+static int checkstring_lua(lua_State *L)
+{
+    lua_pushstring(L, lauxh_checkstringofk(L, 1, ATLAS, checkkid(L, 2)));
+    return 1;
+}
+
+static int optstring_lua(lua_State *L)
+{
+    const char *def = lauxh_optstr(L, 3, NULL);
+    lua_pushstring(L, lauxh_optstringofk(L, 1, ATLAS, checkkid(L, 2), def));
+    return 1;
+}
+
+static int checklstring_lua(lua_State *L)
+{
+    size_t len      = 0;
+    const char *str = lauxh_checklstringofk(L, 1, ATLAS, checkkid(L, 2), &len);
+
+    lua_pushlstring(L, str, len);
+    lua_pushinteger(L, (lua_Integer)len);
+    return 2;
+}
+
+static int optlstring_lua(lua_State *L)
+{
+    const char *def = lauxh_optstr(L, 3, NULL);
+    size_t len      = 0;
+    const char *str =
+        lauxh_optlstringofk(L, 1, ATLAS, checkkid(L, 2), def, &len);
+
+    lua_pushstring(L, str);
+    return 1;
+}
+
+static int checknumber_lua(lua_State *L)
+{
+    lua_pushnumber(L, lauxh_checknumberofk(L, 1, ATLAS, checkkid(L, 2)));
+    return 1;
+}
+
+static int optnumber_lua(lua_State *L)
+{
+    lua_Number def = lauxh_optnum(L, 3, 0);
+    lua_pushnumber(L, lauxh_optnumberofk(L, 1, ATLAS, checkkid(L, 2), def));
+    return 1;
+}
+
+static int checkinteger_lua(lua_State *L)
+{
+    lua_pushinteger(L, lauxh_checkintegerofk(L, 1, ATLAS, checkkid(L, 2)));
+    return 1;
+}
+
+static int optinteger_lua(lua_State *L)
+{
+    lua_Integer def = lauxh_optint(L, 3, 0);
+    lua_pushinteger(L, lauxh_optintegerofk(L, 1, ATLAS, checkkid(L, 2), def));
+    return 1;
+}
+
+static int checkboolean_lua(lua_State *L)
+{
+    lua_pushboolean(L, lauxh_checkbooleanofk(L, 1, ATLAS, checkkid(L, 2)));
+    return 1;
+}
+
+static int optboolean_lua(lua_State *L)
+{
+    int def = lauxh_optbool(L, 3, 0);
+    lua_pushboolean(L, lauxh_optbooleanofk(L, 1, ATLAS, checkkid(L, 2), def));
+    return 1;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+LUALIB_API int luaopen_lauxhlib_keyatlas(lua_State *L)
+{
+    struct luaL_Reg method[] = {
+        {"key",          key_lua         },
+        {"fill",         fill_lua        },
+        {"get",          get_lua         },
+        {"checktable",   checktable_lua  },
+        {"checkstring",  checkstring_lua },
+        {"optstring",    optstring_lua   },
+        {"checklstring", checklstring_lua},
+        {"optlstring",   optlstring_lua  },
+        {"checknumber",  checknumber_lua },
+        {"optnumber",    optnumber_lua   },
+        {"checkinteger", checkinteger_lua},
+        {"optinteger",   optinteger_lua  },
+        {"checkboolean", checkboolean_lua},
+        {"optboolean",   optboolean_lua  },
+        {NULL,           NULL            }
+    };
+
+    lua_newtable(L);
+    // share the key atlas with all functions
+    lauxh_newkeyatlas(L, KEYS);
+    for (struct luaL_Reg *ptr = method; ptr->name; ptr++) {
+        lua_pushstring(L, ptr->name);
+        lua_pushvalue(L, -2);
+        lua_pushcclosure(L, ptr->func, 1);
+        lua_rawset(L, -4);
+    }
+    lua_pop(L, 1);
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -32,7 +32,10 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <math.h>
+#include <sched.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -46,10 +49,300 @@
 # include <lualib.h>
 #endif
 
+/**
+ * NOTE: for the compiler hints
+ *
+ * LAUXH_COLD and LAUXH_NOINLINE move the error reporting functions out of the
+ * inlined fast path of the check functions. the function declared with
+ * LAUXH_NOINLINE must be `static` instead of `static inline`.
+ *
+ * LAUXH_LIKELY and LAUXH_UNLIKELY tell the compiler which way the branch is
+ * expected to go, so that the error branch is laid out after the fast path.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+# define LAUXH_COLD          __attribute__((cold))
+# define LAUXH_NOINLINE      __attribute__((noinline, unused))
+# define LAUXH_LIKELY(x)     __builtin_expect(!!(x), 1)
+# define LAUXH_UNLIKELY(x)   __builtin_expect(!!(x), 0)
+#elif defined(_MSC_VER)
+# define LAUXH_COLD
+# define LAUXH_NOINLINE      __declspec(noinline)
+# define LAUXH_LIKELY(x)     (x)
+# define LAUXH_UNLIKELY(x)   (x)
+#else
+# define LAUXH_COLD
+# define LAUXH_NOINLINE
+# define LAUXH_LIKELY(x)     (x)
+# define LAUXH_UNLIKELY(x)   (x)
+#endif
+
+/**
+ * LAUXH_CONSTEXPR marks the function that can be evaluated at compile time in
+ * C++14 or later, so the same code builds the tables at compile time in C++
+ * and at runtime in C.
+ */
+#if defined(__cplusplus) && __cplusplus >= 201402L
+# define LAUXH_CONSTEXPR constexpr
+#else
+# define LAUXH_CONSTEXPR
+#endif
+
 /**
  * NOTE: for string conversions.
  */
 
+/**
+ * @brief size of the buffer that is large enough to hold the string
+ * representation of the number or the pointer.
+ */
+#define LAUXH_NUMBUF_SIZE 64
+
+/**
+ * @brief writes the decimal representation of the integer to the buffer.
+ * the buffer must be at least `LAUXH_NUMBUF_SIZE` bytes. the result is not
+ * null-terminated.
+ *
+ * @param buf buffer
+ * @param v integer value
+ * @return size_t length of the string
+ */
+static inline size_t lauxh_fmtint(char *buf, lua_Integer v)
+{
+    static const char DIGITS[] = "0001020304050607080910111213141516171819"
+                                 "2021222324252627282930313233343536373839"
+                                 "4041424344454647484950515253545556575859"
+                                 "6061626364656667686970717273747576777879"
+                                 "8081828384858687888990919293949596979899";
+    char tmp[24];
+    char *p    = tmp + sizeof(tmp);
+    uint64_t u = (v < 0) ? (uint64_t)0 - (uint64_t)v : (uint64_t)v;
+    size_t len = 0;
+
+    // write two digits at a time from the end of the buffer
+    while (u >= 100) {
+        const char *d = DIGITS + (u % 100) * 2;
+        u /= 100;
+        *--p = d[1];
+        *--p = d[0];
+    }
+    if (u >= 10) {
+        const char *d = DIGITS + u * 2;
+        *--p          = d[1];
+        *--p          = d[0];
+    } else {
+        *--p = (char)('0' + u);
+    }
+    if (v < 0) {
+        *--p = '-';
+    }
+
+    len = (size_t)(tmp + sizeof(tmp) - p);
+    memcpy(buf, p, len);
+    return len;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ *
+ * @brief writes the double value in the same format as "%.14g" without the
+ * printf family. the value is scaled to the 14 digits integer by the exact
+ * power of 10, so the result is rounded correctly unless the scaled value is
+ * close to the half. in that case, or if the value is out of the supported
+ * range, it returns 0 and the caller should use snprintf instead.
+ */
+static inline size_t lauxh_fmtdbl14g(char *buf, double v)
+{
+    static const double POW10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    char digits[LAUXH_NUMBUF_SIZE];
+    double a     = fabs(v);
+    double s     = 0;
+    double f     = 0;
+    uint64_t r   = 0;
+    int e        = 0;
+    int p        = 0;
+    int ndigit   = 14;
+    size_t len   = 0;
+    int i        = 0;
+
+    // supports the value that can be scaled by the exact power of 10
+    if (!(a >= 1e-8 && a < 1e21)) {
+        return 0;
+    }
+
+    e = (int)floor(log10(a));
+    for (i = 0; i < 2; i++) {
+        p = 13 - e;
+        s = (p >= 0) ? a * POW10[p] : a / POW10[-p];
+        if (s >= 1e14) {
+            e++;
+        } else if (s < 1e13) {
+            e--;
+        } else {
+            break;
+        }
+    }
+    if (i == 2) {
+        return 0;
+    }
+
+    f = floor(s);
+    // the error of the scaled value is less than 0.01
+    if (fabs(s - f - 0.5) < 0.01) {
+        return 0;
+    }
+    r = (uint64_t)f + (s - f > 0.5);
+    if (r == 100000000000000ULL) {
+        r = 10000000000000ULL;
+        e++;
+    }
+
+    // remove the trailing zeros
+    lauxh_fmtint(digits, (lua_Integer)r);
+    while (ndigit > 1 && digits[ndigit - 1] == '0') {
+        ndigit--;
+    }
+
+    if (v < 0) {
+        buf[len++] = '-';
+    }
+    if (e < -4 || e >= 14) {
+        // d.ddde+XX
+        buf[len++] = digits[0];
+        if (ndigit > 1) {
+            buf[len++] = '.';
+            memcpy(buf + len, digits + 1, ndigit - 1);
+            len += ndigit - 1;
+        }
+        buf[len++] = 'e';
+        buf[len++] = (e < 0) ? '-' : '+';
+        if (e < 0) {
+            e = -e;
+        }
+        if (e < 10) {
+            buf[len++] = '0';
+        }
+        len += lauxh_fmtint(buf + len, e);
+    } else if (e < 0) {
+        // 0.000ddd
+        buf[len++] = '0';
+        buf[len++] = '.';
+        for (i = -1; i > e; i--) {
+            buf[len++] = '0';
+        }
+        memcpy(buf + len, digits, ndigit);
+        len += ndigit;
+    } else {
+        // ddd.ddd
+        memcpy(buf + len, digits, e + 1);
+        len += e + 1;
+        if (ndigit > e + 1) {
+            buf[len++] = '.';
+            memcpy(buf + len, digits + e + 1, ndigit - e - 1);
+            len += ndigit - e - 1;
+        }
+    }
+
+    return len;
+}
+
+/**
+ * @brief writes the string representation of the number to the buffer in the
+ * same format as `tostring()`. the buffer must be at least `LAUXH_NUMBUF_SIZE`
+ * bytes. the result is not null-terminated.
+ *
+ * @param buf buffer
+ * @param v number value
+ * @return size_t length of the string
+ */
+static inline size_t lauxh_fmtnum(char *buf, lua_Number v)
+{
+    size_t len = 0;
+    int n      = 0;
+
+    // the integral value that has 14 digits or less is printed as an integer
+    // by LUA_NUMBER_FMT ("%.14g"), so it can skip the printf family.
+    if (sizeof(lua_Number) == sizeof(double) && v > -1e14 && v < 1e14 &&
+        v == (lua_Number)(int64_t)v && !(v == 0 && signbit(v))) {
+        len = lauxh_fmtint(buf, (lua_Integer)v);
+#if LUA_VERSION_NUM >= 503
+        buf[len++] = '.';
+        buf[len++] = '0';
+#endif
+        return len;
+    }
+
+    if (sizeof(lua_Number) != sizeof(double) ||
+        !(len = lauxh_fmtdbl14g(buf, (double)v))) {
+        n   = snprintf(buf, LAUXH_NUMBUF_SIZE, LUA_NUMBER_FMT,
+                       (LUAI_UACNUMBER)v);
+        len = (n < 0) ? 0 : (size_t)n;
+    }
+#if LUA_VERSION_NUM >= 503
+    // looks like an int? then add '.0' like lua does
+    for (n = 0; (size_t)n < len; n++) {
+        if (buf[n] != '-' && (buf[n] < '0' || buf[n] > '9')) {
+            break;
+        }
+    }
+    if ((size_t)n == len && len + 2 < LAUXH_NUMBUF_SIZE) {
+        buf[len++] = '.';
+        buf[len++] = '0';
+    }
+#endif
+
+    return len;
+}
+
+/**
+ * @brief writes the string in the form of `<tname>: <pointer>` to the buffer.
+ * the buffer must be at least `LAUXH_NUMBUF_SIZE` bytes. the result is not
+ * null-terminated.
+ *
+ * @param buf buffer
+ * @param tname type name
+ * @param ptr pointer
+ * @return size_t length of the string, or 0 if the pointer can not be
+ * formatted without the printf family.
+ */
+static inline size_t lauxh_fmtptr(char *buf, const char *tname,
+                                  const void *ptr)
+{
+#if defined(_WIN32)
+    // the format of "%p" differs on windows
+    (void)buf;
+    (void)tname;
+    (void)ptr;
+    return 0;
+#else
+    static const char HEX[] = "0123456789abcdef";
+    uintptr_t v             = (uintptr_t)ptr;
+    size_t len              = strlen(tname);
+    size_t ndigit           = 0;
+    uintptr_t x             = v;
+
+    if (!v || len > LAUXH_NUMBUF_SIZE - sizeof(uintptr_t) * 2 - 4) {
+        return 0;
+    }
+    memcpy(buf, tname, len);
+    buf[len++] = ':';
+    buf[len++] = ' ';
+    buf[len++] = '0';
+    buf[len++] = 'x';
+    while (x) {
+        ndigit++;
+        x >>= 4;
+    }
+    len += ndigit;
+    for (x = 1; x <= ndigit; x++, v >>= 4) {
+        buf[len - x] = HEX[v & 0xf];
+    }
+    return len;
+#endif
+}
+
 /**
  * @brief converts the value at the specified index to a string.
  *
@@ -68,8 +361,22 @@ static inline const char *lauxh_tolstr(lua_State *L, int idx, size_t *len)
             luaL_error(L, "\"__tostring\" metamethod must return a string");
         }
     } else {
+        char buf[LAUXH_NUMBUF_SIZE];
+        size_t n = 0;
+
         switch (type) {
         case LUA_TNUMBER:
+#if LUA_VERSION_NUM >= 503
+            if (lua_isinteger(L, idx)) {
+                n = lauxh_fmtint(buf, lua_tointeger(L, idx));
+            } else
+#endif
+            {
+                n = lauxh_fmtnum(buf, lua_tonumber(L, idx));
+            }
+            lua_pushlstring(L, buf, n);
+            break;
+
         case LUA_TSTRING:
             lua_pushvalue(L, idx);
             break;
@@ -96,8 +403,13 @@ static inline const char *lauxh_tolstr(lua_State *L, int idx, size_t *len)
         // case LUA_TUSERDATA:
         // case LUA_TLIGHTUSERDATA:
         default:
-            lua_pushfstring(L, "%s: %p", lua_typename(L, type),
-                            lua_topointer(L, idx));
+            n = lauxh_fmtptr(buf, lua_typename(L, type), lua_topointer(L, idx));
+            if (n) {
+                lua_pushlstring(L, buf, n);
+            } else {
+                lua_pushfstring(L, "%s: %p", lua_typename(L, type),
+                                lua_topointer(L, idx));
+            }
         }
     }
 
@@ -135,6 +447,343 @@ static inline const char *lauxh_tolstr(lua_State *L, int idx, size_t *len)
  */
 #define lauxh_tostring(L, idx) lauxh_tolstr((L), (idx), NULL)
 
+/**
+ * NOTE: for the string builder
+ *
+ * lauxh_strbuf_t builds a string in C memory, and pushes it to the lua stack
+ * at once. the buffer can start with the caller-provided memory (e.g. the
+ * array on the C stack); when it runs out, the contents are moved to the heap
+ * memory that grows twice. `lauxh_strbuf_reset()` keeps the memory, so the
+ * same buffer can be reused across calls without reallocation.
+ *
+ *  char mem[256];
+ *  lauxh_strbuf_t b = LAUXH_STRBUF_INIT;
+ *
+ *  lauxh_strbuf_init(&b, mem, sizeof(mem));
+ *  lauxh_strbuf_append(&b, "id=", 3);
+ *  lauxh_strbuf_appendint(&b, 123);
+ *  lauxh_strbuf_push(L, &b);
+ *  lauxh_strbuf_free(&b);
+ *
+ * the append functions return 0 on success, or -1 with errno ENOMEM if the
+ * memory could not be allocated.
+ */
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+    // caller-provided memory that must not be freed
+    char *mem;
+    size_t memsize;
+} lauxh_strbuf_t;
+
+#define LAUXH_STRBUF_INIT                                                      \
+    {                                                                          \
+        NULL, 0, 0, NULL, 0                                                    \
+    }
+
+/**
+ * @brief initializes the buffer with the caller-provided memory. the memory
+ * must be alive until the buffer is freed.
+ *
+ * @param b buffer
+ * @param mem initial memory, or NULL
+ * @param size size of the memory
+ */
+static inline void lauxh_strbuf_init(lauxh_strbuf_t *b, char *mem, size_t size)
+{
+    b->data    = (mem && size) ? mem : NULL;
+    b->len     = 0;
+    b->cap     = (b->data) ? size : 0;
+    b->mem     = b->data;
+    b->memsize = b->cap;
+}
+
+/**
+ * @brief release the heap memory of the buffer. the buffer returns to the
+ * initialized state with the caller-provided memory.
+ *
+ * @param b buffer
+ */
+static inline void lauxh_strbuf_free(lauxh_strbuf_t *b)
+{
+    if (b->data != b->mem) {
+        free(b->data);
+        b->data = b->mem;
+        b->cap  = b->memsize;
+    }
+    b->len = 0;
+}
+
+/**
+ * @brief empties the buffer without releasing the memory.
+ *
+ * @param b buffer
+ */
+static inline void lauxh_strbuf_reset(lauxh_strbuf_t *b)
+{
+    b->len = 0;
+}
+
+/**
+ * @brief ensures that the buffer has the space for the n bytes more and the
+ * null terminator.
+ *
+ * @param b buffer
+ * @param n number of bytes
+ * @return char* pointer to the end of the contents, or NULL with errno ENOMEM.
+ */
+static inline char *lauxh_strbuf_reserve(lauxh_strbuf_t *b, size_t n)
+{
+    if (LAUXH_UNLIKELY(b->cap - b->len <= n)) {
+        size_t cap = (b->cap) ? b->cap : 64;
+        char *data = NULL;
+
+        while (cap - b->len <= n) {
+            if (cap > SIZE_MAX / 2) {
+                errno = ENOMEM;
+                return NULL;
+            }
+            cap *= 2;
+        }
+
+        if (b->data == b->mem) {
+            // move the contents from the caller-provided memory
+            if ((data = (char *)malloc(cap)) && b->len) {
+                memcpy(data, b->data, b->len);
+            }
+        } else {
+            data = (char *)realloc(b->data, cap);
+        }
+        if (!data) {
+            errno = ENOMEM;
+            return NULL;
+        }
+        b->data = data;
+        b->cap  = cap;
+    }
+    return b->data + b->len;
+}
+
+/**
+ * @brief appends the bytes to the buffer.
+ *
+ * @param b buffer
+ * @param s bytes
+ * @param n number of bytes
+ * @return int 0 on success, or -1 on failure.
+ */
+static inline int lauxh_strbuf_append(lauxh_strbuf_t *b, const void *s,
+                                      size_t n)
+{
+    char *p = lauxh_strbuf_reserve(b, n);
+
+    if (!p) {
+        return -1;
+    }
+    memcpy(p, s, n);
+    b->len += n;
+    return 0;
+}
+
+/**
+ * @brief appends the null-terminated string to the buffer.
+ */
+#define lauxh_strbuf_appendstr(b, s)                                           \
+    lauxh_strbuf_append((b), (s), strlen((s)))
+
+/**
+ * @brief appends the formatted string to the buffer.
+ *
+ * @param b buffer
+ * @param fmt format string of the vsnprintf
+ * @param ap arguments for the format string
+ * @return int 0 on success, or -1 on failure.
+ */
+static inline int lauxh_strbuf_vappendf(lauxh_strbuf_t *b, const char *fmt,
+                                        va_list ap)
+{
+    va_list aq;
+    int n = 0;
+
+    if (!lauxh_strbuf_reserve(b, 0)) {
+        return -1;
+    }
+
+    // try to write to the remaining space first
+    va_copy(aq, ap);
+    n = vsnprintf(b->data + b->len, b->cap - b->len, fmt, aq);
+    va_end(aq);
+    if (n < 0) {
+        return -1;
+    } else if ((size_t)n >= b->cap - b->len) {
+        if (!lauxh_strbuf_reserve(b, (size_t)n)) {
+            return -1;
+        }
+        va_copy(aq, ap);
+        vsnprintf(b->data + b->len, b->cap - b->len, fmt, aq);
+        va_end(aq);
+    }
+    b->len += (size_t)n;
+    return 0;
+}
+
+/**
+ * @brief appends the formatted string to the buffer.
+ *
+ * @param b buffer
+ * @param fmt format string of the vsnprintf
+ * @param ... arguments for the format string
+ * @return int 0 on success, or -1 on failure.
+ */
+static inline int lauxh_strbuf_appendf(lauxh_strbuf_t *b, const char *fmt, ...)
+{
+    va_list ap;
+    int rv = 0;
+
+    va_start(ap, fmt);
+    rv = lauxh_strbuf_vappendf(b, fmt, ap);
+    va_end(ap);
+    return rv;
+}
+
+/**
+ * @brief appends the decimal representation of the integer to the buffer.
+ *
+ * @param b buffer
+ * @param v integer value
+ * @return int 0 on success, or -1 on failure.
+ */
+static inline int lauxh_strbuf_appendint(lauxh_strbuf_t *b, lua_Integer v)
+{
+    char *p = lauxh_strbuf_reserve(b, LAUXH_NUMBUF_SIZE);
+
+    if (!p) {
+        return -1;
+    }
+    b->len += lauxh_fmtint(p, v);
+    return 0;
+}
+
+/**
+ * @brief appends the string representation of the number to the buffer in the
+ * same format as `tostring()`.
+ *
+ * @param b buffer
+ * @param v number value
+ * @return int 0 on success, or -1 on failure.
+ */
+static inline int lauxh_strbuf_appendnum(lauxh_strbuf_t *b, lua_Number v)
+{
+    char *p = lauxh_strbuf_reserve(b, LAUXH_NUMBUF_SIZE);
+
+    if (!p) {
+        return -1;
+    }
+    b->len += lauxh_fmtnum(p, v);
+    return 0;
+}
+
+/**
+ * @brief appends the value at the specified index to the buffer in the same
+ * way as `lauxh_tolstr()`. the strings, numbers, booleans and nil are appended
+ * without pushing the intermediate string to the stack.
+ *
+ * @note this function calls the `__tostring` metamethod. if it raises an error,
+ * the heap memory of the buffer is not released.
+ * @param L lua state
+ * @param b buffer
+ * @param idx index of the value
+ * @return int 0 on success, or -1 on failure.
+ */
+static inline int lauxh_strbuf_appendtostr(lua_State *L, lauxh_strbuf_t *b,
+                                           int idx)
+{
+    const char *s = NULL;
+    size_t len    = 0;
+    int rv        = 0;
+
+    switch (lua_type(L, idx)) {
+    case LUA_TSTRING:
+        s = lua_tolstring(L, idx, &len);
+        return lauxh_strbuf_append(b, s, len);
+
+    case LUA_TNUMBER:
+#if LUA_VERSION_NUM >= 503
+        if (lua_isinteger(L, idx)) {
+            return lauxh_strbuf_appendint(b, lua_tointeger(L, idx));
+        }
+#endif
+        return lauxh_strbuf_appendnum(b, lua_tonumber(L, idx));
+
+    case LUA_TNIL:
+        return lauxh_strbuf_append(b, "nil", 3);
+
+    case LUA_TBOOLEAN:
+        if (lua_toboolean(L, idx)) {
+            return lauxh_strbuf_append(b, "true", 4);
+        }
+        return lauxh_strbuf_append(b, "false", 5);
+
+    case LUA_TNONE:
+        return 0;
+
+    default:
+        s  = lauxh_tolstr(L, idx, &len);
+        rv = lauxh_strbuf_append(b, s, len);
+        lua_pop(L, 1);
+        return rv;
+    }
+}
+
+#if LUA_VERSION_NUM >= 505
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline void *lauxh_strbuf_release(void *ud, void *ptr, size_t osize,
+                                         size_t nsize)
+{
+    (void)ud;
+    (void)osize;
+    (void)nsize;
+    free(ptr);
+    return NULL;
+}
+#endif
+
+/**
+ * @brief pushes the contents of the buffer to the stack as a string, and
+ * empties the buffer.
+ *
+ * @note on lua 5.5 or later, the heap memory of the buffer is handed over to
+ * the string without copying, and the buffer returns to the initialized state.
+ * @param L lua state
+ * @param b buffer
+ * @return const char* pointer to the pushed string
+ */
+static inline const char *lauxh_strbuf_push(lua_State *L, lauxh_strbuf_t *b)
+{
+#if LUA_VERSION_NUM >= 505
+    if (b->data && b->data != b->mem) {
+        const char *s = NULL;
+
+        // the memory always has the space for the null terminator
+        b->data[b->len] = 0;
+        s = lua_pushexternalstring(L, b->data, b->len, lauxh_strbuf_release,
+                                   NULL);
+        b->data = b->mem;
+        b->cap  = b->memsize;
+        b->len  = 0;
+        return s;
+    }
+#endif
+
+    lua_pushlstring(L, (b->data) ? b->data : "", b->len);
+    b->len = 0;
+    return lua_tostring(L, -1);
+}
+
 /**
  * NOTE: for the reference management.
  */
@@ -203,3497 +852,8804 @@ static inline int lauxh_unref(lua_State *L, int ref)
 }
 
 /**
- * NOTE: for the table manipulation.
+ * NOTE: for the reference tracking
+ *
+ * define `LAUXHLIB_REF_TRACKING` before including this header to record the
+ * call site and the creation time of each reference created by `lauxh_ref()`
+ * and `lauxh_refat()` until it is released by `lauxh_unref()`. the records are
+ * kept in the hash table of each module, so the statistics show the references
+ * held by the module that includes this header.
+ *
+ *  lauxh_reftrack_pushstats(L);
+ *  // { ["src/foo.c:123"] = { count = 2, oldest = 1700000000 }, ... }
+ *
+ * the hash table is private to the translation unit by default. if the module
+ * consists of the multiple translation units, define
+ * `LAUXHLIB_REF_TRACKING_SHARED` in all of them and
+ * `LAUXHLIB_REF_TRACKING_IMPL` in exactly one of them, so they share one hash
+ * table and the reference created in one file can be released in another file.
+ * the shared table has the hidden visibility, so it is not shared with the
+ * other modules.
  */
+#if defined(LAUXHLIB_REF_TRACKING)
+
+# include <time.h>
+
+typedef struct {
+    // registry of the state that holds the reference
+    const void *registry;
+    int ref;
+    int line;
+    const char *file;
+    time_t ctime;
+} lauxh_reftrack_entry_t;
+
+typedef struct {
+    int lock;
+    size_t len;
+    // number of the entries, always the power of 2
+    size_t cap;
+    lauxh_reftrack_entry_t *entries;
+} lauxh_reftrack_t;
+
+# if defined(LAUXHLIB_REF_TRACKING_IMPL)
+__attribute__((visibility("hidden"))) lauxh_reftrack_t LAUXH_REFTRACK = {
+    0, 0, 0, NULL};
+# elif defined(LAUXHLIB_REF_TRACKING_SHARED)
+extern __attribute__((visibility("hidden"))) lauxh_reftrack_t LAUXH_REFTRACK;
+# else
+static lauxh_reftrack_t LAUXH_REFTRACK = {0, 0, 0, NULL};
+# endif
 
 /**
- * @brief get the value associated with the specified key from the table at the
- * specified index. similar to lua_gettable().
- *
- * @note this function does not call the metamethod.
- * @param L lua state
- * @param k key string
- * @param idx index of the table
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  */
-static inline void lauxh_gettblof(lua_State *L, const char *k, int idx)
+static inline void lauxh_reftrack_lock(void)
 {
-    lua_pushstring(L, k);
-    lua_rawget(L, idx);
+    while (__atomic_exchange_n(&LAUXH_REFTRACK.lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&LAUXH_REFTRACK.lock, __ATOMIC_RELAXED)) {
+        }
+    }
 }
 
 /**
- * @brief push the nil value to the specified key of the table at the
- * specified index.
- *
- * @note this function does not call the metamethod.
- * @param L lua state
- * @param k key string
- * @param idx index of the table
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  */
-static inline void lauxh_pushnil2tblat(lua_State *L, const char *k, int at)
+static inline void lauxh_reftrack_unlock(void)
 {
-    if (at < 0) {
-        at -= 2;
-    }
-    lua_pushstring(L, k);
-    lua_pushnil(L);
-    lua_rawset(L, at);
+    __atomic_store_n(&LAUXH_REFTRACK.lock, 0, __ATOMIC_RELEASE);
 }
 
 /**
- * @brief push the nil value to the specified key of the table at the top of the
- * stack. it is same as a `lauxh_pushnil2tblat(L, k, -1)`.
+ * @brief get the home index of the specified reference in the hash table.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
- * @param L lua state
- * @param k key string
- * @param v function
- * @param idx index of the table
+ * @param registry registry of the state
+ * @param ref reference
+ * @return size_t index of the entry
  */
-#define lauxh_pushnil2tbl(L, k) lauxh_pushnil2tblat(L, k, -1)
+static inline size_t lauxh_reftrack_hash(const void *registry, int ref)
+{
+    return ((size_t)(uintptr_t)registry >> 4 ^ (size_t)ref * 0x9E3779B1u) &
+           (LAUXH_REFTRACK.cap - 1);
+}
 
 /**
- * @brief push the nil value to the specified array index of the table at the
- * specified index.
+ * @brief find the entry of the specified reference, or the empty entry where
+ * it should be inserted.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
- * @note this function does not call the metamethod.
- * @param L lua state
- * @param idx array index
- * @param at index of the table
+ * @param registry registry of the state
+ * @param ref reference
+ * @return size_t index of the entry
  */
-static inline void lauxh_pushnil2arrat(lua_State *L, int idx, int at)
+static inline size_t lauxh_reftrack_find(const void *registry, int ref)
 {
-    if (at < 0) {
-        at--;
+    size_t mask = LAUXH_REFTRACK.cap - 1;
+    size_t i    = lauxh_reftrack_hash(registry, ref);
+
+    while (LAUXH_REFTRACK.entries[i].registry &&
+           (LAUXH_REFTRACK.entries[i].registry != registry ||
+            LAUXH_REFTRACK.entries[i].ref != ref)) {
+        i = (i + 1) & mask;
     }
-    lua_pushnil(L);
-    lua_rawseti(L, at, idx);
+    return i;
 }
 
 /**
- * @brief push the nil value to the specified array index of the table at the
- * top of the stack. it is equivalent to `lauxh_pushnil2arrat(L, idx, -1)`.
- *
- * @param L lua state
- * @param idx array index
- */
-#define lauxh_pushnil2arr(L, idx) lauxh_pushnil2arrat(L, idx, -1)
-
-/**
- * @brief push the function to the specified key of the table at the specified
- * index.
+ * @brief double the number of the entries of the hash table.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
- * @note this function does not call the metamethod.
- * @param L lua state
- * @param k key string
- * @param v function
- * @param at index of the table
+ * @return int 0 on success, or -1 on failure.
  */
-static inline void lauxh_pushfn2tblat(lua_State *L, const char *k,
-                                      lua_CFunction v, int at)
+static LAUXH_COLD LAUXH_NOINLINE int lauxh_reftrack_grow(void)
 {
-    if (at < 0) {
-        // adjust the index of the table
-        at -= 2;
+    lauxh_reftrack_entry_t *entries = LAUXH_REFTRACK.entries;
+    size_t cap                      = LAUXH_REFTRACK.cap;
+    size_t i                        = 0;
+
+    LAUXH_REFTRACK.cap = cap ? cap << 1 : 64;
+    if (!(LAUXH_REFTRACK.entries = (lauxh_reftrack_entry_t *)calloc(
+              LAUXH_REFTRACK.cap, sizeof(lauxh_reftrack_entry_t)))) {
+        LAUXH_REFTRACK.entries = entries;
+        LAUXH_REFTRACK.cap     = cap;
+        return -1;
     }
-    lua_pushstring(L, k);
-    lua_pushcfunction(L, v);
-    lua_rawset(L, at);
+    for (; i < cap; i++) {
+        if (entries[i].registry) {
+            LAUXH_REFTRACK.entries[lauxh_reftrack_find(
+                entries[i].registry, entries[i].ref)] = entries[i];
+        }
+    }
+    free(entries);
+    return 0;
 }
 
 /**
- * @brief push the function to the specified key of the table at the top of the
- * stack. it is equivalent to `lauxh_pushfn2tblat(L, k, v, -1)`.
+ * @brief record the reference. the reference is not recorded if the hash table
+ * cannot be allocated.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
  * @param L lua state
- * @param k key string
- * @param v function
+ * @param ref reference
+ * @param file file name of the call site
+ * @param line line number of the call site
+ * @return int ref
  */
-#define lauxh_pushfn2tbl(L, k, v) lauxh_pushfn2tblat(L, k, v, -1)
+static inline int lauxh_reftrack_add(lua_State *L, int ref, const char *file,
+                                     int line)
+{
+    lauxh_reftrack_entry_t *e = NULL;
+    const void *registry      = NULL;
+
+    if (!lauxh_isref(ref)) {
+        return ref;
+    }
+    registry = lua_topointer(L, LUA_REGISTRYINDEX);
+    lauxh_reftrack_lock();
+    if ((LAUXH_REFTRACK.len + 1) * 4 <= LAUXH_REFTRACK.cap * 3 ||
+        lauxh_reftrack_grow() == 0) {
+        e = LAUXH_REFTRACK.entries + lauxh_reftrack_find(registry, ref);
+        if (!e->registry) {
+            LAUXH_REFTRACK.len++;
+        }
+        e->registry = registry;
+        e->ref      = ref;
+        e->line     = line;
+        e->file     = file;
+        e->ctime    = time(NULL);
+    }
+    lauxh_reftrack_unlock();
+    return ref;
+}
 
 /**
- * @brief push the function to the specified array index of the table at the
- * specified index.
+ * @brief remove the record of the reference.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
- * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx array index
- * @param v function
- * @param at index of the table
+ * @param ref reference
  */
-static inline void lauxh_pushfn2arrat(lua_State *L, int idx, lua_CFunction v,
-                                      int at)
+static inline void lauxh_reftrack_del(lua_State *L, int ref)
 {
-    if (at < 0) {
-        at--;
+    const void *registry = NULL;
+    size_t mask          = 0;
+    size_t i             = 0;
+    size_t j             = 0;
+    size_t k             = 0;
+
+    if (!lauxh_isref(ref)) {
+        return;
     }
-    lua_pushcfunction(L, v);
-    lua_rawseti(L, at, idx);
+    registry = lua_topointer(L, LUA_REGISTRYINDEX);
+    lauxh_reftrack_lock();
+    if (!LAUXH_REFTRACK.len ||
+        !LAUXH_REFTRACK.entries[i = lauxh_reftrack_find(registry, ref)]
+             .registry) {
+        lauxh_reftrack_unlock();
+        return;
+    }
+    // shift the following entries back to fill the hole instead of leaving
+    // the tombstone
+    mask = LAUXH_REFTRACK.cap - 1;
+    j    = i;
+    while (1) {
+        j = (j + 1) & mask;
+        if (!LAUXH_REFTRACK.entries[j].registry) {
+            break;
+        }
+        k = lauxh_reftrack_hash(LAUXH_REFTRACK.entries[j].registry,
+                                LAUXH_REFTRACK.entries[j].ref);
+        // move the entry if its home slot is not in the range (i, j]
+        if (i <= j ? (k <= i || k > j) : (k <= i && k > j)) {
+            LAUXH_REFTRACK.entries[i] = LAUXH_REFTRACK.entries[j];
+            i                         = j;
+        }
+    }
+    LAUXH_REFTRACK.entries[i].registry = NULL;
+    LAUXH_REFTRACK.len--;
+    lauxh_reftrack_unlock();
 }
 
 /**
- * @brief push the function to the specified array index of the table at the
- * top of the stack. it is equivalent to `lauxh_pushfn2arrat(L, idx, v, -1)`.
+ * @brief same as the `lauxh_ref()`, but records the call site of the
+ * reference.
  *
  * @param L lua state
- * @param idx array index
- * @param v function
+ * @param file file name of the call site
+ * @param line line number of the call site
+ * @return int reference
  */
-#define lauxh_pushfn2arr(L, idx, v) lauxh_pushfn2arrat(L, idx, v, -1)
+static inline int lauxh_ref_tracked(lua_State *L, const char *file, int line)
+{
+    return lauxh_reftrack_add(L, luaL_ref(L, LUA_REGISTRYINDEX), file, line);
+}
 
 /**
- * @brief push the string to the specified key of the table at the specified
- * index.
+ * @brief same as the `lauxh_refat()`, but records the call site of the
+ * reference.
  *
- * @note this function does not call the metamethod.
  * @param L lua state
- * @param k key string
- * @param v string
- * @param at index of the table
+ * @param idx index of the value
+ * @param file file name of the call site
+ * @param line line number of the call site
+ * @return int reference
  */
-static inline void lauxh_pushstr2tblat(lua_State *L, const char *k,
-                                       const char *v, int at)
+static inline int lauxh_refat_tracked(lua_State *L, int idx, const char *file,
+                                      int line)
 {
-    if (at < 0) {
-        // adjust the index of the table
-        at -= 2;
-    }
-    lua_pushstring(L, k);
-    lua_pushstring(L, v);
-    lua_rawset(L, at);
+    lua_pushvalue(L, idx);
+    return lauxh_ref_tracked(L, file, line);
 }
 
 /**
- * @brief push the string to the specified key of the table at the top of the
- * stack. it is equivalent to `lauxh_pushstr2tblat(L, k, v, -1)`.
+ * @brief same as the `lauxh_unref()`, but removes the record of the reference.
  *
  * @param L lua state
- * @param k key string
- * @param v string
+ * @param ref reference
+ * @return int LUA_NOREF
  */
-#define lauxh_pushstr2tbl(L, k, v) lauxh_pushstr2tblat(L, k, v, -1)
+static inline int lauxh_unref_tracked(lua_State *L, int ref)
+{
+    lauxh_reftrack_del(L, ref);
+    luaL_unref(L, LUA_REGISTRYINDEX, ref);
+    return LUA_NOREF;
+}
+
+# define lauxh_ref(L) lauxh_ref_tracked((L), __FILE__, __LINE__)
+# define lauxh_refat(L, idx)                                                  \
+     lauxh_refat_tracked((L), (idx), __FILE__, __LINE__)
+# define lauxh_unref(L, ref) lauxh_unref_tracked((L), (ref))
 
 /**
- * @brief push the string to the specified array index of the table at the
- * specified index.
+ * @brief copy the records of the references held by the specified state.
  *
- * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx array index
- * @param v string
- * @param at index of the table
+ * @param buf buffer to store the records, or NULL to count the records
+ * @param n number of the records that can be stored in the buffer
+ * @return size_t number of the records held by the state, that may be greater
+ * than n.
  */
-static inline void lauxh_pushstr2arrat(lua_State *L, int idx, const char *v,
-                                       int at)
+static inline size_t lauxh_reftrack_snapshot(lua_State *L,
+                                             lauxh_reftrack_entry_t *buf,
+                                             size_t n)
 {
-    if (at < 0) {
-        at--;
+    const void *registry = lua_topointer(L, LUA_REGISTRYINDEX);
+    size_t len           = 0;
+    size_t i             = 0;
+
+    lauxh_reftrack_lock();
+    for (; i < LAUXH_REFTRACK.cap; i++) {
+        if (LAUXH_REFTRACK.entries[i].registry == registry) {
+            if (len < n) {
+                buf[len] = LAUXH_REFTRACK.entries[i];
+            }
+            len++;
+        }
     }
-    lua_pushstring(L, v);
-    lua_rawseti(L, at, idx);
+    lauxh_reftrack_unlock();
+    return len;
 }
 
 /**
- * @brief push the string to the specified array index of the table at the top
- * of the stack. it is equivalent to `lauxh_pushstr2arrat(L, idx, v, -1)`.
+ * @brief get the number of the references held by the specified state.
  *
  * @param L lua state
- * @param idx array index
- * @param v string
+ * @return size_t number of the references
  */
-#define lauxh_pushstr2arr(L, idx, v) lauxh_pushstr2arrat(L, idx, v, -1)
+static inline size_t lauxh_reftrack_len(lua_State *L)
+{
+    return lauxh_reftrack_snapshot(L, NULL, 0);
+}
 
 /**
- * @brief push the string with length to the specified key of the table at the
- * specified index.
+ * @brief push the table of the references held by the specified state
+ * grouped by the call site onto the stack. each field of the table is keyed by
+ * `<file>:<line>`, and its value is the table that has the `count` of the
+ * references and the creation time of the `oldest` reference.
  *
- * @note this function does not call the metamethod.
  * @param L lua state
- * @param k key string
- * @param v string
- * @param l length of the string
- * @param at index of the table
  */
-static inline void lauxh_pushlstr2tblat(lua_State *L, const char *k,
-                                        const char *v, size_t l, int at)
+static inline void lauxh_reftrack_pushstats(lua_State *L)
 {
-    if (at < 0) {
-        // adjust the index of the table
-        at -= 2;
+    lauxh_reftrack_entry_t *buf = NULL;
+    size_t len                  = 0;
+    size_t n                    = 0;
+    size_t i                    = 0;
+
+    // the buffer is allocated as the userdata, so it is released by the GC
+    // even if the following API calls raise an error. the references may be
+    // created while allocating the buffer.
+    lua_pushnil(L);
+    while ((len = lauxh_reftrack_snapshot(L, buf, n)) > n) {
+        n = len;
+        lua_pop(L, 1);
+        buf = (lauxh_reftrack_entry_t *)lua_newuserdata(
+            L, sizeof(lauxh_reftrack_entry_t) * n);
     }
-    lua_pushstring(L, k);
-    lua_pushlstring(L, v, l);
-    lua_rawset(L, at);
+
+    lua_newtable(L);
+    for (; i < len; i++) {
+        lua_pushfstring(L, "%s:%d", buf[i].file, buf[i].line);
+        lua_pushvalue(L, -1);
+        lua_rawget(L, -3);
+        if (lua_isnil(L, -1)) {
+            lua_pop(L, 1);
+            lua_createtable(L, 0, 2);
+            lua_pushinteger(L, 0);
+            lua_setfield(L, -2, "count");
+            lua_pushinteger(L, (lua_Integer)buf[i].ctime);
+            lua_setfield(L, -2, "oldest");
+            // result[site] = stat
+            lua_pushvalue(L, -2);
+            lua_pushvalue(L, -2);
+            lua_rawset(L, -5);
+        }
+        lua_getfield(L, -1, "count");
+        lua_pushinteger(L, lua_tointeger(L, -1) + 1);
+        lua_setfield(L, -3, "count");
+        lua_getfield(L, -2, "oldest");
+        if (buf[i].ctime < (time_t)lua_tointeger(L, -1)) {
+            lua_pushinteger(L, (lua_Integer)buf[i].ctime);
+            lua_setfield(L, -4, "oldest");
+        }
+        lua_pop(L, 4);
+    }
+    // remove the buffer
+    lua_remove(L, -2);
 }
 
+#endif
+
 /**
- * @brief push the string with length to the specified key of the table at the
- * top of the stack.
+ * NOTE: for the reference pool
  *
- * @param L lua state
- * @param k key string
- * @param v string
- * @param l length of the string
+ * the reference pool is the dedicated reference table that can be used instead
+ * of the `LUA_REGISTRYINDEX`. the values are stored in the array part of the
+ * table owned by the pool, and the free slots are chained in the C array, so
+ * unlike the `luaL_ref()`, the ref/unref does not read or write the free list
+ * in the table and does not compute the length of the table.
+ *
+ *  lauxh_refpool_t *pool = lauxh_refpool_new(L, 1024, 0);
+ *  int ref = lauxh_refpool_refat(L, pool, 1);
+ *  lauxh_refpool_pushref(L, pool, ref);
+ *  ref = lauxh_refpool_unref(L, pool, ref);
+ *  lauxh_refpool_free(L, pool);
  */
-#define lauxh_pushlstr2tbl(L, k, v, l) lauxh_pushlstr2tblat(L, k, v, l, -1)
+
+// increment the generation counter of the slot at every unref
+#define LAUXH_REFPOOL_GENERATION 0x1
+// hold the values weakly, so the referenced values can be collected
+#define LAUXH_REFPOOL_WEAK       0x2
+
+// the slot is in use
+#define LAUXH_REFPOOL_INUSE -1
+
+typedef struct {
+    // reference of the value table in the registry
+    int tbl;
+    int flags;
+    // number of the allocated slots
+    int cap;
+    // highest slot number that has ever been used
+    int top;
+    // number of the slots in use
+    int used;
+    // head of the free list, or 0 if empty
+    int head;
+    // next free slot of each slot, or LAUXH_REFPOOL_INUSE
+    int *next;
+    // generation counter of each slot, or NULL
+    unsigned int *gen;
+} lauxh_refpool_t;
 
 /**
- * @brief push the string with length to the specified array index of the table
- * at the specified index.
+ * @brief allocate the pool without the value table.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
- * @note this function does not call the metamethod.
- * @param L lua state
- * @param idx array index
- * @param v string
- * @param l length of the string
- * @param at index of the table
+ * @param capacity number of the preallocated slots
+ * @param flags flags of the pool
+ * @return lauxh_refpool_t* pointer to the pool, or NULL with errno on failure.
  */
-static inline void lauxh_pushlstr2arrat(lua_State *L, int idx, const char *v,
-                                        size_t l, int at)
+static inline lauxh_refpool_t *lauxh_refpool_alloc(int capacity, int flags)
 {
-    if (at < 0) {
-        at--;
+    lauxh_refpool_t *pool = NULL;
+
+    if (capacity < 1) {
+        capacity = 1;
     }
-    lua_pushlstring(L, v, l);
-    lua_rawseti(L, at, idx);
+    if (!(pool = (lauxh_refpool_t *)calloc(1, sizeof(lauxh_refpool_t)))) {
+        return NULL;
+    } else if (!(pool->next = (int *)malloc(sizeof(int) *
+                                            ((size_t)capacity + 1)))) {
+        free(pool);
+        return NULL;
+    } else if ((flags & LAUXH_REFPOOL_GENERATION) &&
+               !(pool->gen = (unsigned int *)calloc((size_t)capacity + 1,
+                                                    sizeof(unsigned int)))) {
+        free(pool->next);
+        free(pool);
+        return NULL;
+    }
+    pool->tbl   = LUA_NOREF;
+    pool->flags = flags;
+    pool->cap   = capacity;
+    return pool;
 }
 
 /**
- * @brief push the string with length to the specified array index of the table
- * at the top of the stack. it is equivalent to `lauxh_pushlstr2arrat(L, idx, v,
- * l, -1)`.
+ * @brief push the new value table of the pool onto the stack.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
  * @param L lua state
- * @param idx array index
- * @param v string
- * @param l length of the string
+ * @param pool reference pool
  */
-#define lauxh_pushlstr2arr(L, idx, v, l) lauxh_pushlstr2arrat(L, idx, v, l, -1)
+static inline void lauxh_refpool_newtbl(lua_State *L, lauxh_refpool_t *pool)
+{
+    lua_createtable(L, pool->cap, 0);
+    if (pool->flags & LAUXH_REFPOOL_WEAK) {
+        lua_createtable(L, 0, 1);
+        lua_pushliteral(L, "v");
+        lua_setfield(L, -2, "__mode");
+        lua_setmetatable(L, -2);
+    }
+}
 
 /**
- * @brief push the number to the specified key of the table at the specified
- * index.
+ * @brief create a new reference pool that can hold the specified number of
+ * references without reallocation. the pool grows when all slots are in use.
+ * the value table of the pool is held in the registry.
  *
- * @note this function does not call the metamethod.
  * @param L lua state
- * @param k key string
- * @param v number
- * @param at index of the table
+ * @param capacity number of the preallocated slots
+ * @param flags 0, or the bitwise OR of LAUXH_REFPOOL_GENERATION and
+ * LAUXH_REFPOOL_WEAK
+ * @return lauxh_refpool_t* pointer to the pool, or NULL with errno on failure.
  */
-static inline void lauxh_pushnum2tblat(lua_State *L, const char *k,
-                                       lua_Number v, int at)
+static inline lauxh_refpool_t *lauxh_refpool_new(lua_State *L, int capacity,
+                                                 int flags)
 {
-    if (at < 0) {
-        at -= 2;
+    lauxh_refpool_t *pool = lauxh_refpool_alloc(capacity, flags);
+
+    if (pool) {
+        lauxh_refpool_newtbl(L, pool);
+        pool->tbl = luaL_ref(L, LUA_REGISTRYINDEX);
     }
-    lua_pushstring(L, k);
-    lua_pushnumber(L, v);
-    lua_rawset(L, at);
+    return pool;
 }
 
 /**
- * @brief push the number to the specified key of the table at the top of the
- * stack.
+ * @brief release the pool and all values referenced by the pool. the value
+ * table of the pool created by `lauxh_refpool_newudata()` is released with the
+ * userdata.
  *
  * @param L lua state
- * @param k key string
- * @param v number
+ * @param pool reference pool
  */
-#define lauxh_pushnum2tbl(L, k, v) lauxh_pushnum2tblat(L, k, v, -1)
+static inline void lauxh_refpool_free(lua_State *L, lauxh_refpool_t *pool)
+{
+    luaL_unref(L, LUA_REGISTRYINDEX, pool->tbl);
+    free(pool->next);
+    free(pool->gen);
+    free(pool);
+}
 
 /**
- * @brief push the number to the specified array index of the table at the
- * specified index.
+ * @brief double the number of the slots of the pool.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
- * @note this function does not call the metamethod.
- * @param L lua state
- * @param idx array index
- * @param v number
- * @param at index of the table
+ * @param pool reference pool
+ * @return int 0 on success, or -1 with errno on failure.
  */
-static inline void lauxh_pushnum2arrat(lua_State *L, int idx, lua_Number v,
-                                       int at)
+static LAUXH_COLD LAUXH_NOINLINE int
+lauxh_refpool_grow(lauxh_refpool_t *pool)
 {
-    if (at < 0) {
-        at--;
+    int cap           = pool->cap;
+    int *next         = NULL;
+    unsigned int *gen = NULL;
+
+    if (cap > INT_MAX / 2 - 1) {
+        errno = ENOMEM;
+        return -1;
     }
-    lua_pushnumber(L, v);
-    lua_rawseti(L, at, idx);
+    cap <<= 1;
+    if (!(next = (int *)realloc(pool->next, sizeof(int) * ((size_t)cap + 1)))) {
+        return -1;
+    }
+    pool->next = next;
+    if (pool->gen) {
+        if (!(gen = (unsigned int *)realloc(
+                  pool->gen, sizeof(unsigned int) * ((size_t)cap + 1)))) {
+            return -1;
+        }
+        memset(gen + pool->cap + 1, 0,
+               sizeof(unsigned int) * (size_t)(cap - pool->cap));
+        pool->gen = gen;
+    }
+    pool->cap = cap;
+    return 0;
 }
 
 /**
- * @brief push the number to the specified array index of the table at the top
- * of the stack. it is equivalent to `lauxh_pushnum2arrat(L, idx, v, -1)`.
+ * @brief take the free slot from the pool.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
- * @param L lua state
- * @param idx array index
- * @param v number
+ * @param pool reference pool
+ * @return int slot number, or LUA_NOREF with errno on failure.
  */
-#define lauxh_pushnum2arr(L, idx, v) lauxh_pushnum2arrat(L, idx, v, -1)
+static inline int lauxh_refpool_acquire(lauxh_refpool_t *pool)
+{
+    int ref = pool->head;
+
+    if (ref) {
+        // reuse the most recently released slot
+        pool->head = pool->next[ref];
+    } else if (LAUXH_LIKELY(pool->top < pool->cap) ||
+               lauxh_refpool_grow(pool) == 0) {
+        ref = ++pool->top;
+    } else {
+        return LUA_NOREF;
+    }
+    pool->next[ref] = LAUXH_REFPOOL_INUSE;
+    pool->used++;
+    return ref;
+}
 
 /**
- * @brief push the integer to the specified key of the table at the specified
- * index.
+ * @brief return the slot to the free list.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
- * @note this function does not call the metamethod.
- * @param L lua state
- * @param k key string
- * @param v integer
- * @param at index of the table
+ * @param pool reference pool
+ * @param ref reference in use
  */
-static inline void lauxh_pushint2tblat(lua_State *L, const char *k,
-                                       lua_Integer v, int at)
+static inline void lauxh_refpool_release(lauxh_refpool_t *pool, int ref)
 {
-    if (at < 0) {
-        at -= 2;
+    pool->next[ref] = pool->head;
+    pool->head      = ref;
+    pool->used--;
+    if (pool->gen) {
+        pool->gen[ref]++;
     }
-    lua_pushstring(L, k);
-    lua_pushinteger(L, v);
-    lua_rawset(L, at);
 }
 
 /**
- * @brief push the integer to the specified key of the table at the top of the
- * stack.
+ * @brief determine whether the specified reference is in use in the pool.
  *
- * @param L lua state
- * @param k key string
- * @param v integer
+ * @param pool reference pool
+ * @param ref reference
+ * @return int 1 if in use, otherwise 0.
  */
-#define lauxh_pushint2tbl(L, k, v) lauxh_pushint2tblat(L, k, v, -1)
+static inline int lauxh_refpool_isref(lauxh_refpool_t *pool, int ref)
+{
+    return ref > 0 && ref <= pool->top &&
+           pool->next[ref] == LAUXH_REFPOOL_INUSE;
+}
 
 /**
- * @brief push the integer to the specified array index of the table at the
- * specified index.
+ * NOTE: the functions with the `_tbl` suffix take the index of the value table
+ * of the pool instead of getting it from the registry. they are used for the
+ * pool whose value table is held elsewhere, such as the pool created by
+ * `lauxh_refpool_newudata()`.
+ */
+
+/**
+ * @brief create a reference of the value at the top of the stack in the pool
+ * with the value table at the specified index, and remove the value from the
+ * stack. and return the reference. the negative index of the table is
+ * relative to the stack that contains the value.
  *
- * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx array index
- * @param v integer
- * @param at index of the table
+ * @param pool reference pool
+ * @param tbl index of the value table
+ * @return int reference, LUA_REFNIL if the value is nil, or LUA_NOREF with
+ * errno on failure.
  */
-static inline void lauxh_pushint2arrat(lua_State *L, int idx, lua_Integer v,
-                                       int at)
+static inline int lauxh_refpool_ref_tbl(lua_State *L, lauxh_refpool_t *pool,
+                                        int tbl)
 {
-    if (at < 0) {
-        at--;
+    int ref = LUA_REFNIL;
+
+    if (lua_isnil(L, -1)) {
+        lua_pop(L, 1);
+        return LUA_REFNIL;
+    } else if ((ref = lauxh_refpool_acquire(pool)) == LUA_NOREF) {
+        lua_pop(L, 1);
+        return LUA_NOREF;
     }
-    lua_pushinteger(L, v);
-    lua_rawseti(L, at, idx);
+    lua_rawseti(L, tbl, ref);
+    return ref;
 }
 
 /**
- * @brief push the integer to the specified array index of the table at the top
- * of the stack. it is equivalent to `lauxh_pushint2arrat(L, idx, v, -1)`.
+ * @brief create a reference of the value at the top of the stack in the pool,
+ * and remove the value from the stack. and return the reference.
  *
  * @param L lua state
- * @param idx array index
- * @param v integer
+ * @param pool reference pool
+ * @return int reference, LUA_REFNIL if the value is nil, or LUA_NOREF with
+ * errno on failure.
  */
-#define lauxh_pushint2arr(L, idx, v) lauxh_pushint2arrat(L, idx, v, -1)
+static inline int lauxh_refpool_ref(lua_State *L, lauxh_refpool_t *pool)
+{
+    int ref = LUA_REFNIL;
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, pool->tbl);
+    lua_insert(L, -2);
+    ref = lauxh_refpool_ref_tbl(L, pool, -2);
+    lua_pop(L, 1);
+    return ref;
+}
 
 /**
- * @brief push the boolean to the specified key of the table at the specified
- * index.
+ * @brief create a reference of the value at the specified index in the pool,
+ * and return the reference.
  *
- * @note this function does not call the metamethod.
  * @param L lua state
- * @param k key string
- * @param v boolean
- * @param at index of the table
+ * @param pool reference pool
+ * @param idx index of the value
+ * @return int reference, LUA_REFNIL if the value is nil, or LUA_NOREF with
+ * errno on failure.
  */
-static inline void lauxh_pushbool2tblat(lua_State *L, const char *k, int v,
-                                        int at)
+static inline int lauxh_refpool_refat(lua_State *L, lauxh_refpool_t *pool,
+                                      int idx)
 {
-    if (at < 0) {
-        at -= 2;
-    }
-    lua_pushstring(L, k);
-    lua_pushboolean(L, v);
-    lua_rawset(L, at);
+    lua_pushvalue(L, idx);
+    return lauxh_refpool_ref(L, pool);
 }
 
 /**
- * @brief push the boolean to the specified key of the table at the top of the
- * stack. it is equivalent to `lauxh_pushbool2tblat(L, k, v, -1)`.
+ * @brief push the value associated with the specified reference onto the
+ * stack. nil is pushed if the reference is not in use.
  *
  * @param L lua state
- * @param k key string
- * @param v boolean
+ * @param pool reference pool
+ * @param ref reference
  */
-#define lauxh_pushbool2tbl(L, k, v) lauxh_pushbool2tblat(L, k, v, -1)
+static inline void lauxh_refpool_pushref(lua_State *L, lauxh_refpool_t *pool,
+                                         int ref)
+{
+    lua_rawgeti(L, LUA_REGISTRYINDEX, pool->tbl);
+    lua_rawgeti(L, -1, ref);
+    lua_replace(L, -2);
+}
 
 /**
- * @brief push the boolean to the specified array index of the table at the
- * specified index.
+ * @brief push the value associated with the specified reference in the pool
+ * with the value table at the specified index onto the stack. nil is pushed if
+ * the reference is not in use.
  *
- * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx array index
- * @param v boolean
- * @param at index of the table
+ * @param pool reference pool
+ * @param tbl index of the value table
+ * @param ref reference
  */
-static inline void lauxh_pushbool2arrat(lua_State *L, int idx, int v, int at)
+static inline void lauxh_refpool_pushref_tbl(lua_State *L,
+                                             lauxh_refpool_t *pool, int tbl,
+                                             int ref)
 {
-    if (at < 0) {
-        at--;
-    }
-    lua_pushboolean(L, v);
-    lua_rawseti(L, at, idx);
+    (void)pool;
+    lua_rawgeti(L, tbl, ref);
 }
 
 /**
- * @brief push the boolean to the specified array index of the table at the top
- * of the stack. it is equivalent to `lauxh_pushbool2arrat(L, idx, v, -1)`.
+ * @brief remove the reference from the pool. the slot is reused by the next
+ * ref, and its generation counter is incremented if the pool is created with
+ * the `LAUXH_REFPOOL_GENERATION` flag. it does nothing if the reference is not
+ * in use.
  *
  * @param L lua state
- * @param idx array index
- * @param v boolean
+ * @param pool reference pool
+ * @param ref reference
+ * @return int LUA_NOREF
  */
-#define lauxh_pushbool2arr(L, idx, v) lauxh_pushbool2arrat(L, idx, v, -1)
+static inline int lauxh_refpool_unref(lua_State *L, lauxh_refpool_t *pool,
+                                      int ref)
+{
+    if (lauxh_refpool_isref(pool, ref)) {
+        lua_rawgeti(L, LUA_REGISTRYINDEX, pool->tbl);
+        lua_pushnil(L);
+        lua_rawseti(L, -2, ref);
+        lua_pop(L, 1);
+        lauxh_refpool_release(pool, ref);
+    }
+    return LUA_NOREF;
+}
 
 /**
- * @brief get the value associated with the specified array index for the table
- * at the specified index.
+ * @brief remove the reference from the pool with the value table at the
+ * specified index. it does nothing if the reference is not in use.
  *
- * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx array index
- * @param at index of the table
+ * @param pool reference pool
+ * @param tbl index of the value table
+ * @param ref reference
+ * @return int LUA_NOREF
  */
-static inline void lauxh_gettblat(lua_State *L, int idx, int at)
+static inline int lauxh_refpool_unref_tbl(lua_State *L, lauxh_refpool_t *pool,
+                                          int tbl, int ref)
 {
-    lua_rawgeti(L, at, idx);
+    if (lauxh_refpool_isref(pool, ref)) {
+        lua_pushnil(L);
+        lua_rawseti(L, (tbl < 0 && tbl > LUA_REGISTRYINDEX) ? tbl - 1 : tbl,
+                    ref);
+        lauxh_refpool_release(pool, ref);
+    }
+    return LUA_NOREF;
 }
 
 /**
- * @brief get the length of the table at the specified index.
+ * @brief release all slots of the pool, and increment the generation counters
+ * of the slots in use.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
- * @param L lua state
- * @param idx index of the table
+ * @param pool reference pool
  */
-#if LUA_VERSION_NUM >= 502
-# define lauxh_rawlen(L, idx) lua_rawlen(L, idx)
-#else
-# define lauxh_rawlen(L, idx) lua_objlen(L, idx)
-#endif
+static inline void lauxh_refpool_reset(lauxh_refpool_t *pool)
+{
+    int ref = 1;
+
+    if (pool->gen) {
+        for (; ref <= pool->top; ref++) {
+            if (pool->next[ref] == LAUXH_REFPOOL_INUSE) {
+                pool->gen[ref]++;
+            }
+        }
+    }
+    pool->head = 0;
+    pool->top  = 0;
+    pool->used = 0;
+}
 
 /**
- * NOTE: helper functions and macros
+ * @brief release all references in the pool at once. the value table is
+ * replaced with the new one instead of removing the values one by one, and
+ * the generation counters of the released slots are incremented.
+ *
+ * @param L lua state
+ * @param pool reference pool
  */
+static inline void lauxh_refpool_clear(lua_State *L, lauxh_refpool_t *pool)
+{
+    lauxh_refpool_reset(pool);
+    lauxh_refpool_newtbl(L, pool);
+    lua_rawseti(L, LUA_REGISTRYINDEX, pool->tbl);
+}
 
 /**
- * @brief push the value associated with the specified key from the global scope
- * onto the top of the stack. if the value is not found, then place the `nil`
- * value.
+ * @brief release all references whose values have been collected from the
+ * pool with the value table at the specified index.
  *
  * @param L lua state
- * @param k key string
+ * @param pool reference pool
+ * @param tbl index of the value table
+ * @return int number of the released references
  */
-static inline void lauxh_getglobal(lua_State *L, const char *k)
+static inline int lauxh_refpool_sweep_tbl(lua_State *L, lauxh_refpool_t *pool,
+                                          int tbl)
 {
-#if defined(LUA_RIDX_GLOBALS)
-    lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
-    lua_getfield(L, -1, k);
+    int n   = 0;
+    int ref = 1;
 
-#else
-    lua_getfield(L, LUA_GLOBALSINDEX, k);
+    if (tbl < 0 && tbl > LUA_REGISTRYINDEX) {
+        tbl = lua_gettop(L) + tbl + 1;
+    }
+    for (; ref <= pool->top; ref++) {
+        if (pool->next[ref] == LAUXH_REFPOOL_INUSE) {
+            lua_rawgeti(L, tbl, ref);
+            if (lua_isnil(L, -1)) {
+                lauxh_refpool_release(pool, ref);
+                n++;
+            }
+            lua_pop(L, 1);
+        }
+    }
+    return n;
+}
 
-#endif
+/**
+ * @brief release all references whose values have been collected. it is
+ * useful for the pool created with the `LAUXH_REFPOOL_WEAK` flag, since the
+ * slot of the collected value remains in use until it is released.
+ *
+ * @param L lua state
+ * @param pool reference pool
+ * @return int number of the released references
+ */
+static inline int lauxh_refpool_sweep(lua_State *L, lauxh_refpool_t *pool)
+{
+    int n = 0;
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, pool->tbl);
+    n = lauxh_refpool_sweep_tbl(L, pool, -1);
+    lua_pop(L, 1);
+    return n;
 }
 
 /**
- * NOTE: for metatable handling.
+ * @brief get the generation counter of the slot of the specified reference.
+ *
+ * @param pool reference pool
+ * @param ref reference
+ * @return unsigned int generation counter, or 0 if the pool is created without
+ * the `LAUXH_REFPOOL_GENERATION` flag.
  */
+static inline unsigned int lauxh_refpool_gen(lauxh_refpool_t *pool, int ref)
+{
+    if (pool->gen && ref > 0 && ref <= pool->top) {
+        return pool->gen[ref];
+    }
+    return 0;
+}
 
 /**
- * @brief set the metatable to the value at the top of the stack.
+ * @brief get the number of the references in use in the pool.
  *
- * @param L lua state
- * @param tname metatable name
+ * @param pool reference pool
+ * @return int number of the references
  */
-static inline void lauxh_setmetatable(lua_State *L, const char *tname)
+static inline int lauxh_refpool_len(lauxh_refpool_t *pool)
 {
-    luaL_getmetatable(L, tname);
-    lua_setmetatable(L, -2);
+    return pool->used;
 }
 
 /**
- * NOTE: for the comparison.
+ * NOTE: for the reference pool userdata
+ *
+ * the registry holds the value table of the pool created by
+ * `lauxh_refpool_new()`, so the values that refer to the object owning the
+ * pool keep the object alive forever. `lauxh_refpool_newudata()` creates the
+ * pool in the userdata and holds the value table in the user value of the
+ * userdata instead, so the userdata and the values that refer to it are
+ * collected together. the methods of the userdata push the value table with
+ * `lauxh_getuservalue()` and pass it to the functions with the `_tbl` suffix.
+ *
+ *  lauxh_refpool_t *pool = *(lauxh_refpool_t **)lua_touserdata(L, 1);
+ *  lauxh_getuservalue(L, 1);
+ *  lua_pushvalue(L, 2);
+ *  ref = lauxh_refpool_ref_tbl(L, pool, -2);
  */
 
+#if LUA_VERSION_NUM >= 502
+# define lauxh_getuservalue(L, idx) lua_getuservalue((L), (idx))
+# define lauxh_setuservalue(L, idx) lua_setuservalue((L), (idx))
+#else
+# define lauxh_getuservalue(L, idx) lua_getfenv((L), (idx))
+# define lauxh_setuservalue(L, idx) lua_setfenv((L), (idx))
+#endif
+
 /**
- * @brief determine whether the value at the specified index has a metatable of
- * the specified name.
+ * @brief create a new reference pool in the userdata that has the metatable
+ * of the specified name, and push the userdata onto the stack. the userdata
+ * holds the pointer to the pool, and the `__gc` metamethod must release it by
+ * `lauxh_refpool_free()`.
  *
  * @param L lua state
- * @param idx index of the value
- * @param tname metatable name
- * @return int 1 if true, otherwise 0.
+ * @param capacity number of the preallocated slots
+ * @param flags 0, or the bitwise OR of LAUXH_REFPOOL_GENERATION and
+ * LAUXH_REFPOOL_WEAK
+ * @param tname name of the metatable
+ * @return lauxh_refpool_t* pointer to the pool, or NULL with errno on failure.
+ * the userdata is pushed even on failure.
  */
-static inline int lauxh_ismetatableof(lua_State *L, int idx, const char *tname)
+static inline lauxh_refpool_t *lauxh_refpool_newudata(lua_State *L,
+                                                      int capacity, int flags,
+                                                      const char *tname)
 {
-    int rc = 0;
+    lauxh_refpool_t **ptr =
+        (lauxh_refpool_t **)lua_newuserdata(L, sizeof(lauxh_refpool_t *));
 
-    // idx value is wrapped by metatable
-    if (lua_getmetatable(L, idx)) {
-        // get metatable from registry
-        lua_pushstring(L, tname);
-        lua_rawget(L, LUA_REGISTRYINDEX);
-        // compare
-        rc = lua_rawequal(L, -1, -2);
-        lua_pop(L, 2);
+    *ptr = NULL;
+    luaL_getmetatable(L, tname);
+    lua_setmetatable(L, -2);
+    if ((*ptr = lauxh_refpool_alloc(capacity, flags))) {
+        lauxh_refpool_newtbl(L, *ptr);
+        lauxh_setuservalue(L, -2);
     }
-
-    return rc;
+    return *ptr;
 }
 
-#if LUA_VERSION_NUM >= 502
 /**
- * @brief compare the values of the specified indices. it is equivalent to
- * `lua_compare(L, idx1, idx2, LUA_OPEQ)`.
+ * @brief release all references in the pool of the userdata at the specified
+ * index at once. the user value of the userdata is replaced with the new value
+ * table.
  *
  * @param L lua state
- * @param idx1 index of the value
- * @param idx2 index of the value
- * @return int 1 if true, otherwise 0.
+ * @param pool reference pool
+ * @param idx index of the userdata
  */
-# define lauxh_equal(L, idx1, idx2) lua_compare(L, idx1, idx2, LUA_OPEQ)
+static inline void lauxh_refpool_clearudata(lua_State *L, lauxh_refpool_t *pool,
+                                            int idx)
+{
+    if (idx < 0 && idx > LUA_REGISTRYINDEX) {
+        idx = lua_gettop(L) + idx + 1;
+    }
+    lauxh_refpool_reset(pool);
+    lauxh_refpool_newtbl(L, pool);
+    lauxh_setuservalue(L, idx);
+}
 
-#else
 /**
- * @brief compare the values of the specified indices.  it is equivalent to
- * `lua_equal(L, idx1, idx2)`.
+ * the reference handle is the 53-bit value that packs the slot number of the
+ * reference in the lower 32 bits and the lower 21 bits of the generation
+ * counter of the slot in the upper bits. since the generation counter is
+ * incremented when the slot is released, the handle of the released reference
+ * never matches the handle of the new reference that reuses the same slot, and
+ * it can be detected in O(1) by comparing the generation counter stored
+ * alongside the value. the handle is always positive and less than 2^53, so it
+ * can be passed to lua as the number without losing the precision.
  *
- * @param L lua state
- * @param idx1 index of the value
- * @param idx2 index of the value
- * @return int 1 if true, otherwise 0.
+ * @note the pool must be created with the `LAUXH_REFPOOL_GENERATION` flag,
+ * otherwise no handle is created. the counter of the handle wraps around after
+ * 2^21 reuses of the same slot.
  */
-# define lauxh_equal(L, idx1, idx2) lua_equal(L, idx1, idx2)
-#endif
+typedef uint64_t lauxh_refhandle_t;
+
+// the handle that never refers to any value
+#define LAUXH_REFHANDLE_NONE    ((lauxh_refhandle_t)0)
+// number of the bits of the generation counter in the handle
+#define LAUXH_REFHANDLE_GENBITS 21
+#define LAUXH_REFHANDLE_GENMASK ((1U << LAUXH_REFHANDLE_GENBITS) - 1)
 
 /**
- * NOTE: for the type checking.
+ * @brief get the reference of the specified handle.
+ *
+ * @param h reference handle
+ * @return int reference
  */
+static inline int lauxh_refhandle_ref(lauxh_refhandle_t h)
+{
+    return (int)(uint32_t)h;
+}
 
 /**
- * @brief determine whether the value at the specified index is `LUA_TNIL` or
- * `LUA_TNONE`.
+ * @brief get the generation counter of the specified handle.
  *
- * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @param h reference handle
+ * @return unsigned int lower 21 bits of the generation counter
  */
-static inline int lauxh_isnil(lua_State *L, int idx)
+static inline unsigned int lauxh_refhandle_gen(lauxh_refhandle_t h)
 {
-    return lua_isnoneornil(L, idx);
+    return (unsigned int)(h >> 32) & LAUXH_REFHANDLE_GENMASK;
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TSSTRING`.
+ * @brief get the handle of the specified reference in the pool.
  *
- * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @param pool reference pool
+ * @param ref reference
+ * @return lauxh_refhandle_t handle, or LAUXH_REFHANDLE_NONE if the reference
+ * is not in use, or with errno EINVAL if the pool is created without the
+ * `LAUXH_REFPOOL_GENERATION` flag.
  */
-static inline int lauxh_isstr(lua_State *L, int idx)
+static inline lauxh_refhandle_t lauxh_refpool_handle(lauxh_refpool_t *pool,
+                                                     int ref)
 {
-    return lua_type(L, idx) == LUA_TSTRING;
+    lauxh_refhandle_t gen = 0;
+
+    if (LAUXH_UNLIKELY(!pool->gen)) {
+        errno = EINVAL;
+        return LAUXH_REFHANDLE_NONE;
+    } else if (lauxh_refpool_isref(pool, ref)) {
+        gen = pool->gen[ref] & LAUXH_REFHANDLE_GENMASK;
+        return gen << 32 | (uint32_t)ref;
+    }
+    return LAUXH_REFHANDLE_NONE;
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TSTRING`. it is equivalent to `lauxh_isstr(L, idx)`.
+ * @brief determine whether the specified handle refers to the reference in use
+ * in the pool.
  *
- * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @param pool reference pool
+ * @param h reference handle
+ * @return int 1 if valid, otherwise 0.
  */
-#define lauxh_isstring(L, idx) lauxh_isstr((L), (idx))
+static inline int lauxh_refpool_ishandle(lauxh_refpool_t *pool,
+                                         lauxh_refhandle_t h)
+{
+    int ref = lauxh_refhandle_ref(h);
+    return pool->gen && lauxh_refpool_isref(pool, ref) &&
+           (pool->gen[ref] & LAUXH_REFHANDLE_GENMASK) ==
+               lauxh_refhandle_gen(h);
+}
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TBOLLEAN`.
+ * @brief create a reference of the value at the top of the stack in the pool,
+ * and remove the value from the stack. and return the handle of the reference.
  *
  * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @param pool reference pool
+ * @return lauxh_refhandle_t handle, or LAUXH_REFHANDLE_NONE if the value is
+ * nil or with errno on failure. errno is EINVAL if the pool is created without
+ * the `LAUXH_REFPOOL_GENERATION` flag.
  */
-static inline int lauxh_isbool(lua_State *L, int idx)
+static inline lauxh_refhandle_t lauxh_refpool_refhandle(lua_State *L,
+                                                        lauxh_refpool_t *pool)
 {
-    return lua_type(L, idx) == LUA_TBOOLEAN;
+    if (LAUXH_UNLIKELY(!pool->gen)) {
+        lua_pop(L, 1);
+        errno = EINVAL;
+        return LAUXH_REFHANDLE_NONE;
+    }
+    return lauxh_refpool_handle(pool, lauxh_refpool_ref(L, pool));
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TBOLLEAN`. it is equivalent to `lauxh_isbool(L, idx)`.
+ * @brief create a reference of the value at the specified index in the pool,
+ * and return the handle of the reference.
  *
  * @param L lua state
+ * @param pool reference pool
  * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @return lauxh_refhandle_t handle, or LAUXH_REFHANDLE_NONE if the value is
+ * nil or with errno on failure.
  */
-#define lauxh_isboolean(L, idx) lauxh_isbool((L), (idx))
+static inline lauxh_refhandle_t
+lauxh_refpool_refhandleat(lua_State *L, lauxh_refpool_t *pool, int idx)
+{
+    lua_pushvalue(L, idx);
+    return lauxh_refpool_refhandle(L, pool);
+}
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TTABLE`.
+ * @brief push the value associated with the specified handle onto the stack.
+ * unlike the `lauxh_refpool_pushref()`, nil is pushed if the handle is stale,
+ * even if the slot is reused by another reference.
  *
  * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @param pool reference pool
+ * @param h reference handle
+ * @return int 1 if the value is pushed, or 0 if nil is pushed for the stale
+ * handle.
  */
-static inline int lauxh_istable(lua_State *L, int idx)
+static inline int lauxh_pushref_checked(lua_State *L, lauxh_refpool_t *pool,
+                                        lauxh_refhandle_t h)
 {
-    return lua_type(L, idx) == LUA_TTABLE;
+    if (LAUXH_LIKELY(lauxh_refpool_ishandle(pool, h))) {
+        lauxh_refpool_pushref(L, pool, lauxh_refhandle_ref(h));
+        return 1;
+    }
+    lua_pushnil(L);
+    return 0;
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TFUNCTION`.
+ * @brief remove the reference of the specified handle from the pool. it does
+ * nothing if the handle is stale, so the stale handle never releases the
+ * reference that reuses the same slot.
  *
  * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @param pool reference pool
+ * @param h reference handle
+ * @return lauxh_refhandle_t LAUXH_REFHANDLE_NONE
  */
-static inline int lauxh_isfunc(lua_State *L, int idx)
+static inline lauxh_refhandle_t lauxh_refpool_unrefhandle(lua_State *L,
+                                                          lauxh_refpool_t *pool,
+                                                          lauxh_refhandle_t h)
 {
-    return lua_type(L, idx) == LUA_TFUNCTION;
+    if (lauxh_refpool_ishandle(pool, h)) {
+        lauxh_refpool_unref(L, pool, lauxh_refhandle_ref(h));
+    }
+    return LAUXH_REFHANDLE_NONE;
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TFUNCTION`. it is equivalent to `lauxh_isfunc(L, idx)`.
+ * @brief push the specified handle onto the stack. the handle is pushed as the
+ * integer on lua 5.3 or later, otherwise as the number that represents the
+ * handle exactly.
  *
  * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @param h reference handle
  */
-#define lauxh_isfunction(L, idx) lauxh_isfunc((L), (idx))
+static inline void lauxh_pushrefhandle(lua_State *L, lauxh_refhandle_t h)
+{
+#if LUA_VERSION_NUM >= 503
+    lua_pushinteger(L, (lua_Integer)h);
+#else
+    lua_pushnumber(L, (lua_Number)h);
+#endif
+}
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `lua_CFunction` type. it is equivalent to `lua_iscfunction(L, idx)`.
+ * NOTE: for the weak reference
  *
- * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * the weak reference is the reference handle of the per-state pool created
+ * with the `LAUXH_REFPOOL_WEAK` and `LAUXH_REFPOOL_GENERATION` flags. unlike
+ * the `lauxh_ref()`, it does not prevent the value from being collected, and
+ * `lauxh_pushweakref()` pushes nil once the value has been collected. the slots
+ * of the collected values are reclaimed by `lauxh_weakref_sweep()`, or
+ * automatically before the pool grows. since the handle carries the generation
+ * counter of the slot, the handle of the reclaimed slot keeps pushing nil even
+ * after the slot is reused by another value.
+ *
+ * @note the strings, numbers and booleans are never collected from the weak
+ * table, so they are held until the reference is released.
  */
-static inline int lauxh_iscfunc(lua_State *L, int idx)
-{
-    return lua_iscfunction(L, idx);
-}
+
+// registry key and metatable name of the per-state weak reference pool
+#define LAUXH_WEAKREF_POOL     "lauxhlib.weakref.pool"
+// initial capacity of the per-state weak reference pool
+#define LAUXH_WEAKREF_CAPACITY 64
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `lua_CFunction`. it is equivalent to `lauxh_iscfunc(L, idx)`.
+ * @brief release the per-state weak reference pool.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
  * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @return int 0
  */
-#define lauxh_iscfunction(L, idx) lauxh_iscfunc((L), (idx))
+static inline int lauxh_weakref_gc(lua_State *L)
+{
+    lauxh_refpool_t **ptr = (lauxh_refpool_t **)lua_touserdata(L, 1);
+
+    if (*ptr) {
+        lauxh_refpool_free(L, *ptr);
+        *ptr = NULL;
+    }
+    return 0;
+}
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TTHREAD`.
+ * @brief create the per-state weak reference pool and save it in the registry.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  *
  * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @return lauxh_refpool_t* pointer to the pool
  */
-static inline int lauxh_isthread(lua_State *L, int idx)
+static LAUXH_COLD LAUXH_NOINLINE lauxh_refpool_t *
+lauxh_weakref_newpool(lua_State *L)
 {
-    return lua_type(L, idx) == LUA_TTHREAD;
+    lauxh_refpool_t **ptr =
+        (lauxh_refpool_t **)lua_newuserdata(L, sizeof(lauxh_refpool_t *));
+
+    *ptr = NULL;
+    if (luaL_newmetatable(L, LAUXH_WEAKREF_POOL)) {
+        lua_pushcfunction(L, lauxh_weakref_gc);
+        lua_setfield(L, -2, "__gc");
+    }
+    lua_setmetatable(L, -2);
+    if (!(*ptr = lauxh_refpool_new(L, LAUXH_WEAKREF_CAPACITY,
+                                   LAUXH_REFPOOL_WEAK |
+                                       LAUXH_REFPOOL_GENERATION))) {
+        luaL_error(L, "failed to create the weak reference pool: %s",
+                   strerror(errno));
+    }
+    lua_setfield(L, LUA_REGISTRYINDEX, LAUXH_WEAKREF_POOL);
+    return *ptr;
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TUSERDATA`.
+ * @brief get the per-state weak reference pool. the pool is created at the
+ * first call, and released when the state is closed.
  *
  * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @return lauxh_refpool_t* pointer to the pool
  */
-static inline int lauxh_isuserdata(lua_State *L, int idx)
+static inline lauxh_refpool_t *lauxh_weakref_pool(lua_State *L)
 {
-    return lua_type(L, idx) == LUA_TUSERDATA;
+    lauxh_refpool_t *pool = NULL;
+
+    lua_getfield(L, LUA_REGISTRYINDEX, LAUXH_WEAKREF_POOL);
+    if (LAUXH_LIKELY(lua_type(L, -1) == LUA_TUSERDATA)) {
+        pool = *(lauxh_refpool_t **)lua_touserdata(L, -1);
+        lua_pop(L, 1);
+        return pool;
+    }
+    lua_pop(L, 1);
+    return lauxh_weakref_newpool(L);
 }
 
 /**
- * @brief determine whether the value at the specified index is a userdata that
- * has the metatable of the specified name.
+ * @brief create a weak reference of the value at the top of the stack, and
+ * remove the value from the stack. and return the handle of the reference.
  *
  * @param L lua state
- * @param idx index of the value
- * @param tname metatable name
- * @return int 1 if true, otherwise 0.
+ * @return lauxh_refhandle_t handle, or LAUXH_REFHANDLE_NONE if the value is
+ * nil or with errno on failure.
  */
-static inline int lauxh_isuserdataof(lua_State *L, int idx, const char *tname)
+static inline lauxh_refhandle_t lauxh_weakref(lua_State *L)
 {
-    return lauxh_isuserdata(L, idx) && lauxh_ismetatableof(L, idx, tname);
+    lauxh_refpool_t *pool = lauxh_weakref_pool(L);
+
+    // reclaim the slots of the collected values before the pool grows
+    if (!pool->head && pool->top == pool->cap) {
+        lauxh_refpool_sweep(L, pool);
+    }
+    return lauxh_refpool_refhandle(L, pool);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TLIGHTUSERDATA`.
+ * @brief create a weak reference of the value at the specified index, and
+ * return the handle of the reference.
  *
  * @param L lua state
  * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @return lauxh_refhandle_t handle, or LAUXH_REFHANDLE_NONE if the value is
+ * nil or with errno on failure.
  */
-static inline int lauxh_ispointer(lua_State *L, int idx)
+static inline lauxh_refhandle_t lauxh_weakrefat(lua_State *L, int idx)
 {
-    return lua_type(L, idx) == LUA_TLIGHTUSERDATA;
+    lua_pushvalue(L, idx);
+    return lauxh_weakref(L);
 }
 
 /**
- * @brief determine whether the value at the specified index has a metatable of
- * the `LUA_FILEHANDLE`.
+ * @brief push the value associated with the specified weak reference onto the
+ * stack. nil is pushed if the value has been collected or the reference has
+ * been released.
  *
  * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @param h handle of the weak reference
+ * @return int 1 if the reference is in use, or 0 if nil is pushed for the
+ * stale handle.
  */
-static inline int lauxh_isfile(lua_State *L, int idx)
+static inline int lauxh_pushweakref(lua_State *L, lauxh_refhandle_t h)
 {
-    return lauxh_ismetatableof(L, idx, LUA_FILEHANDLE);
+    return lauxh_pushref_checked(L, lauxh_weakref_pool(L), h);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * function or it has a metatable that contains the
- * `__call` metamethod.
+ * @brief remove the weak reference. it does nothing if the handle is stale.
  *
  * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @param h handle of the weak reference
+ * @return lauxh_refhandle_t LAUXH_REFHANDLE_NONE
  */
-static inline int lauxh_iscallable(lua_State *L, int idx)
+static inline lauxh_refhandle_t lauxh_unweakref(lua_State *L,
+                                                lauxh_refhandle_t h)
 {
-    if (lauxh_isfunc(L, idx)) {
-        return 1;
-    } else if (lua_getmetatable(L, idx)) {
-        int isfunc = 0;
-        lua_pushliteral(L, "__call");
-        lua_rawget(L, -2);
-        isfunc = lauxh_isfunc(L, -1);
-        lua_pop(L, 2);
-        return isfunc;
-    }
-    return 0;
+    return lauxh_refpool_unrefhandle(L, lauxh_weakref_pool(L), h);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * number type.
+ * @brief release all weak references whose values have been collected.
  *
  * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @return int number of the released references
  */
-static inline int lauxh_isnum(lua_State *L, int idx)
+static inline int lauxh_weakref_sweep(lua_State *L)
 {
-    return lua_type(L, idx) == LUA_TNUMBER;
+    return lauxh_refpool_sweep(L, lauxh_weakref_pool(L));
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * number type. it is equivalent to `lauxh_isnum(L, idx)`.
- *
- * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * NOTE: for the table manipulation.
  */
-#define lauxh_isnumber(L, idx) lauxh_isnum((L), idx)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TNUMBER` and is greater than or equal to the specified number.
+ * @brief get the value associated with the specified key from the table at the
+ * specified index. similar to lua_gettable().
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param n value is greater than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param k key string
+ * @param idx index of the table
  */
-static inline int lauxh_isnum_ge(lua_State *L, int idx, lua_Number n)
+static inline void lauxh_gettblof(lua_State *L, const char *k, int idx)
 {
-    return lauxh_isnum(L, idx) && lua_tonumber(L, idx) >= n;
+    lua_pushstring(L, k);
+    lua_rawget(L, idx);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TNUMBER` and is less than or equal to the specified number.
+ * @brief push the nil value to the specified key of the table at the
+ * specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param n value is less than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param k key string
+ * @param idx index of the table
  */
-static inline int lauxh_isnum_le(lua_State *L, int idx, lua_Number n)
+static inline void lauxh_pushnil2tblat(lua_State *L, const char *k, int at)
 {
-    return lauxh_isnum(L, idx) && lua_tonumber(L, idx) <= n;
+    if (at < 0) {
+        at -= 2;
+    }
+    lua_pushstring(L, k);
+    lua_pushnil(L);
+    lua_rawset(L, at);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TNUMBER` and is in the specified range of numbers.
+ * @brief push the nil value to the specified key of the table at the top of the
+ * stack. it is same as a `lauxh_pushnil2tblat(L, k, -1)`.
  *
  * @param L lua state
- * @param idx index of the value
- * @param min value is greater than or equal to this number
- * @param max value is less than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param k key string
+ * @param v function
+ * @param idx index of the table
  */
-static inline int lauxh_isnum_in_range(lua_State *L, int idx, lua_Number min,
-                                       lua_Number max)
-{
-    if (!isfinite(min) || !isfinite(max) || min > max) {
-        luaL_error(L,
-                   "min and max must be finite numbers, and min %f must be "
-                   "less than or equal to max %f",
-                   min, max);
-    }
-
-    if (lauxh_isnum(L, idx)) {
-        lua_Number v = lua_tonumber(L, idx);
-        return v >= min && v <= max;
-    }
-    return 0;
-}
+#define lauxh_pushnil2tbl(L, k) lauxh_pushnil2tblat(L, k, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * `LUA_TNUMBER` and is a finite number with `isfinite()` function.
+ * @brief push the nil value to the specified array index of the table at the
+ * specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param n value is greater than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param idx array index
+ * @param at index of the table
  */
-static inline int lauxh_isfinite(lua_State *L, int idx)
+static inline void lauxh_pushnil2arrat(lua_State *L, int idx, int at)
 {
-    return lauxh_isnum(L, idx) && isfinite(lua_tonumber(L, idx));
+    if (at < 0) {
+        at--;
+    }
+    lua_pushnil(L);
+    lua_rawseti(L, at, idx);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * finite number and is greater than or equal to the specified number.
+ * @brief push the nil value to the specified array index of the table at the
+ * top of the stack. it is equivalent to `lauxh_pushnil2arrat(L, idx, -1)`.
  *
  * @param L lua state
- * @param idx index of the value
- * @param n value is greater than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param idx array index
  */
-static inline int lauxh_isfinite_ge(lua_State *L, int idx, lua_Number n)
-{
-    return lauxh_isfinite(L, idx) && lua_tonumber(L, idx) >= n;
-}
+#define lauxh_pushnil2arr(L, idx) lauxh_pushnil2arrat(L, idx, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * finite number and is less than or equal to the specified number.
+ * @brief push the function to the specified key of the table at the specified
+ * index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param n value is less than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param k key string
+ * @param v function
+ * @param at index of the table
  */
-static inline int lauxh_isfinite_le(lua_State *L, int idx, lua_Number n)
+static inline void lauxh_pushfn2tblat(lua_State *L, const char *k,
+                                      lua_CFunction v, int at)
 {
-    return lauxh_isfinite(L, idx) && lua_tonumber(L, idx) <= n;
+    if (at < 0) {
+        // adjust the index of the table
+        at -= 2;
+    }
+    lua_pushstring(L, k);
+    lua_pushcfunction(L, v);
+    lua_rawset(L, at);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * finite number and is in the specified range of numbers.
+ * @brief push the function to the specified key of the table at the top of the
+ * stack. it is equivalent to `lauxh_pushfn2tblat(L, k, v, -1)`.
  *
  * @param L lua state
- * @param idx index of the value
- * @param min value is greater than or equal to this number
- * @param max value is less than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param k key string
+ * @param v function
  */
-static inline int lauxh_isfinite_in_range(lua_State *L, int idx, lua_Number min,
-                                          lua_Number max)
-{
-    if (!isfinite(min) || !isfinite(max) || min > max) {
-        luaL_error(L,
-                   "min and max must be finite numbers, and min %f must be "
-                   "less than or equal to max %f",
-                   min, max);
-    }
-    if (lauxh_isfinite(L, idx)) {
-        lua_Number v = lua_tonumber(L, idx);
-        return v >= min && v <= max;
-    }
-    return 0;
-}
+#define lauxh_pushfn2tbl(L, k, v) lauxh_pushfn2tblat(L, k, v, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * unsigned number.
- *
- * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @brief push the function to the specified array index of the table at the
+ * specified index.
  *
  * @note this function does not call the metamethod.
+ * @param L lua state
+ * @param idx array index
+ * @param v function
+ * @param at index of the table
  */
-static inline lua_Number lauxh_isunsigned(lua_State *L, int idx)
+static inline void lauxh_pushfn2arrat(lua_State *L, int idx, lua_CFunction v,
+                                      int at)
 {
-    return lauxh_isnum(L, idx) && lua_tonumber(L, idx) >= 0;
+    if (at < 0) {
+        at--;
+    }
+    lua_pushcfunction(L, v);
+    lua_rawseti(L, at, idx);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * unsigned number and is greater than or equal to the specified number.
+ * @brief push the function to the specified array index of the table at the
+ * top of the stack. it is equivalent to `lauxh_pushfn2arrat(L, idx, v, -1)`.
  *
  * @param L lua state
- * @param idx index of the value
- * @param n value is greater than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param idx array index
+ * @param v function
  */
-static inline int lauxh_isunsigned_ge(lua_State *L, int idx, lua_Number n)
-{
-    return lauxh_isunsigned(L, idx) && lua_tonumber(L, idx) >= n;
-}
+#define lauxh_pushfn2arr(L, idx, v) lauxh_pushfn2arrat(L, idx, v, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * unsigned number and is less than or equal to the specified number.
+ * @brief push the string to the specified key of the table at the specified
+ * index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param n value is less than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param k key string
+ * @param v string
+ * @param at index of the table
  */
-static inline int lauxh_isunsigned_le(lua_State *L, int idx, lua_Number n)
+static inline void lauxh_pushstr2tblat(lua_State *L, const char *k,
+                                       const char *v, int at)
 {
-    return lauxh_isunsigned(L, idx) && lua_tonumber(L, idx) <= n;
+    if (at < 0) {
+        // adjust the index of the table
+        at -= 2;
+    }
+    lua_pushstring(L, k);
+    lua_pushstring(L, v);
+    lua_rawset(L, at);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * unsigned number and is in the specified range of numbers.
+ * @brief push the string to the specified key of the table at the top of the
+ * stack. it is equivalent to `lauxh_pushstr2tblat(L, k, v, -1)`.
  *
  * @param L lua state
- * @param idx index of the value
- * @param min value is greater than or equal to this number
- * @param max value is less than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param k key string
+ * @param v string
  */
-static inline int lauxh_isunsigned_in_range(lua_State *L, int idx,
-                                            lua_Number min, lua_Number max)
-{
-    if (!isfinite(min) || !isfinite(max) || min > max) {
-        luaL_error(L,
-                   "min and max must be finite numbers, and min %f must be "
-                   "less than or equal to max %f",
-                   min, max);
-    }
-    if (lauxh_isunsigned(L, idx)) {
-        lua_Number v = lua_tonumber(L, idx);
-        return v >= min && v <= max;
-    }
-    return 0;
-}
+#define lauxh_pushstr2tbl(L, k, v) lauxh_pushstr2tblat(L, k, v, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * integer.
+ * @brief push the string to the specified array index of the table at the
+ * specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @param idx array index
+ * @param v string
+ * @param at index of the table
  */
-static inline int lauxh_isint(lua_State *L, int idx)
+static inline void lauxh_pushstr2arrat(lua_State *L, int idx, const char *v,
+                                       int at)
 {
-#if LUA_VERSION_NUM >= 503
-    return lua_isinteger(L, idx);
-#else
-    return lauxh_isnum(L, idx) &&
-           (lua_Number)lua_tointeger(L, idx) == lua_tonumber(L, idx);
-#endif
+    if (at < 0) {
+        at--;
+    }
+    lua_pushstring(L, v);
+    lua_rawseti(L, at, idx);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * integer. it is equivalent to `lauxh_isint(L, idx)`.
+ * @brief push the string to the specified array index of the table at the top
+ * of the stack. it is equivalent to `lauxh_pushstr2arrat(L, idx, v, -1)`.
  *
  * @param L lua state
- * @param idx index of the value
+ * @param idx array index
+ * @param v string
  */
-#define lauxh_isinteger(L, idx) lauxh_isint((L), (idx))
+#define lauxh_pushstr2arr(L, idx, v) lauxh_pushstr2arrat(L, idx, v, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * integer and is greater than or equal to the specified number.
+ * @brief push the string with length to the specified key of the table at the
+ * specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param n value is greater than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param k key string
+ * @param v string
+ * @param l length of the string
+ * @param at index of the table
  */
-static inline int lauxh_isint_ge(lua_State *L, int idx, lua_Integer n)
+static inline void lauxh_pushlstr2tblat(lua_State *L, const char *k,
+                                        const char *v, size_t l, int at)
 {
-    return lauxh_isint(L, idx) && lua_tointeger(L, idx) >= n;
+    if (at < 0) {
+        // adjust the index of the table
+        at -= 2;
+    }
+    lua_pushstring(L, k);
+    lua_pushlstring(L, v, l);
+    lua_rawset(L, at);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * integer and is less than or equal to the specified number.
+ * @brief push the string with length to the specified key of the table at the
+ * top of the stack.
  *
  * @param L lua state
- * @param idx index of the value
- * @param n value is less than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param k key string
+ * @param v string
+ * @param l length of the string
  */
-static inline int lauxh_isint_le(lua_State *L, int idx, lua_Integer n)
-{
-    return lauxh_isint(L, idx) && lua_tointeger(L, idx) <= n;
-}
+#define lauxh_pushlstr2tbl(L, k, v, l) lauxh_pushlstr2tblat(L, k, v, l, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * integer and is in the specified range of numbers.
+ * @brief push the string with length to the specified array index of the table
+ * at the specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param min value is greater than or equal to this number
- * @param max value is less than or equal to this number
- * @return int 1 if true, otherwise 0.
+ * @param idx array index
+ * @param v string
+ * @param l length of the string
+ * @param at index of the table
  */
-static inline int lauxh_isint_in_range(lua_State *L, int idx, lua_Integer min,
-                                       lua_Integer max)
+static inline void lauxh_pushlstr2arrat(lua_State *L, int idx, const char *v,
+                                        size_t l, int at)
 {
-    if (min > max) {
-        luaL_error(L, "min %d must be less than or equal to max %d", min, max);
-    }
-    if (lauxh_isint(L, idx)) {
-        lua_Integer v = lua_tointeger(L, idx);
-        return v >= min && v <= max;
+    if (at < 0) {
+        at--;
     }
-    return 0;
+    lua_pushlstring(L, v, l);
+    lua_rawseti(L, at, idx);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * integer and is in the range of the `int8_t` type. it is equivalent to
- * `lauxh_isint_in_range(L, idx, INT8_MIN, INT8_MAX)`.
+ * @brief push the string with length to the specified array index of the table
+ * at the top of the stack. it is equivalent to `lauxh_pushlstr2arrat(L, idx, v,
+ * l, -1)`.
  *
  * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
+ * @param idx array index
+ * @param v string
+ * @param l length of the string
  */
-#define lauxh_isint8(L, idx)                                                   \
-    lauxh_isint_in_range((L), (idx), INT8_MIN, INT8_MAX)
+#define lauxh_pushlstr2arr(L, idx, v, l) lauxh_pushlstr2arrat(L, idx, v, l, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * integer and is in the range of the `int16_t` type. it is equivalent to
- * `lauxh_isint_in_range(L, idx, INT16_MIN, INT16_MAX)`.
+ * @brief push the number to the specified key of the table at the specified
+ * index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
+ * @param k key string
+ * @param v number
+ * @param at index of the table
  */
-#define lauxh_isint16(L, idx)                                                  \
-    lauxh_isint_in_range((L), (idx), INT16_MIN, INT16_MAX)
+static inline void lauxh_pushnum2tblat(lua_State *L, const char *k,
+                                       lua_Number v, int at)
+{
+    if (at < 0) {
+        at -= 2;
+    }
+    lua_pushstring(L, k);
+    lua_pushnumber(L, v);
+    lua_rawset(L, at);
+}
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * integer and is in the range of the `int32_t` type. it is equivalent to
- * `lauxh_isint_in_range(L, idx, INT32_MIN, INT32_MAX)`.
+ * @brief push the number to the specified key of the table at the top of the
+ * stack.
  *
  * @param L lua state
- * @param idx index of the value
+ * @param k key string
+ * @param v number
  */
-#define lauxh_isint32(L, idx)                                                  \
-    lauxh_isint_in_range((L), (idx), INT32_MIN, INT32_MAX)
+#define lauxh_pushnum2tbl(L, k, v) lauxh_pushnum2tblat(L, k, v, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * integer and is in the range of the `int64_t` type. it is equivalent to the
- * `lauxh_isint_in_range(L, idx, INT64_MIN, INT64_MAX)`.
+ * @brief push the number to the specified array index of the table at the
+ * specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
+ * @param idx array index
+ * @param v number
+ * @param at index of the table
  */
-#define lauxh_isint64(L, idx)                                                  \
-    lauxh_isint_in_range((L), (idx), INT64_MIN, INT64_MAX)
-
-/**
- * @brief determine whether the type of the value at the specified index is the
- * unsigned integer.
- *
- * @param L lua state
- * @param idx index of the value
- * @return int 1 if true, otherwise 0.
- */
-static inline int lauxh_isuint(lua_State *L, int idx)
+static inline void lauxh_pushnum2arrat(lua_State *L, int idx, lua_Number v,
+                                       int at)
 {
-    return lauxh_isint(L, idx) && lua_tointeger(L, idx) >= 0;
+    if (at < 0) {
+        at--;
+    }
+    lua_pushnumber(L, v);
+    lua_rawseti(L, at, idx);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * unsigned integer and is greater than or equal to the specified number.
+ * @brief push the number to the specified array index of the table at the top
+ * of the stack. it is equivalent to `lauxh_pushnum2arrat(L, idx, v, -1)`.
  *
  * @param L lua state
- * @param idx index of the value
- * @param n value is greater than or equal to this number
+ * @param idx array index
+ * @param v number
  */
-static inline int lauxh_isuint_ge(lua_State *L, int idx, uintmax_t n)
-{
-    return lauxh_isuint(L, idx) && (uintmax_t)lua_tointeger(L, idx) >= n;
-}
+#define lauxh_pushnum2arr(L, idx, v) lauxh_pushnum2arrat(L, idx, v, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * unsigned integer and is less than or equal to the specified number.
+ * @brief push the integer to the specified key of the table at the specified
+ * index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param n value is less than or equal to this number
+ * @param k key string
+ * @param v integer
+ * @param at index of the table
  */
-static inline int lauxh_isuint_le(lua_State *L, int idx, uintmax_t n)
+static inline void lauxh_pushint2tblat(lua_State *L, const char *k,
+                                       lua_Integer v, int at)
 {
-    return lauxh_isuint(L, idx) && (uintmax_t)lua_tointeger(L, idx) <= n;
+    if (at < 0) {
+        at -= 2;
+    }
+    lua_pushstring(L, k);
+    lua_pushinteger(L, v);
+    lua_rawset(L, at);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * unsigned integer and is in the specified range of numbers.
+ * @brief push the integer to the specified key of the table at the top of the
+ * stack.
  *
  * @param L lua state
- * @param idx index of the value
- * @param min value is greater than or equal to this number
- * @param max value is less than or equal to this number
+ * @param k key string
+ * @param v integer
  */
-static inline int lauxh_isuint_in_range(lua_State *L, int idx, uintmax_t min,
-                                        uintmax_t max)
-{
-    if (min > max) {
-        luaL_error(L, "min %d must be less than or equal to max %d", min, max);
-    }
-    if (lauxh_isuint(L, idx)) {
-        uintmax_t v = (uintmax_t)lua_tointeger(L, idx);
-        return v >= min && v <= max;
-    }
-    return 0;
-}
+#define lauxh_pushint2tbl(L, k, v) lauxh_pushint2tblat(L, k, v, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * unsigned integer and is in the range of the `uint8_t` type. it is equivalent
- * to the `lauxh_isuint_in_range(L, idx, 0, UINT8_MAX)`.
+ * @brief push the integer to the specified array index of the table at the
+ * specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
+ * @param idx array index
+ * @param v integer
+ * @param at index of the table
  */
-#define lauxh_isuint8(L, idx) lauxh_isuint_in_range((L), (idx), 0, UINT8_MAX)
+static inline void lauxh_pushint2arrat(lua_State *L, int idx, lua_Integer v,
+                                       int at)
+{
+    if (at < 0) {
+        at--;
+    }
+    lua_pushinteger(L, v);
+    lua_rawseti(L, at, idx);
+}
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * unsigned integer and is in the range of the `uint16_t` type. it is equivalent
- * to the `lauxh_isuint_in_range(L, idx, 0, UINT16_MAX)`.
+ * @brief push the integer to the specified array index of the table at the top
+ * of the stack. it is equivalent to `lauxh_pushint2arrat(L, idx, v, -1)`.
  *
  * @param L lua state
- * @param idx index of the value
+ * @param idx array index
+ * @param v integer
  */
-#define lauxh_isuint16(L, idx) lauxh_isuint_in_range((L), (idx), 0, UINT16_MAX)
+#define lauxh_pushint2arr(L, idx, v) lauxh_pushint2arrat(L, idx, v, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * unsigned integer and is in the range of the `uint32_t` type. it is equivalent
- * to the `lauxh_isuint_in_range(L, idx, 0, UINT32_MAX)`.
+ * @brief push the boolean to the specified key of the table at the specified
+ * index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
+ * @param k key string
+ * @param v boolean
+ * @param at index of the table
  */
-#define lauxh_isuint32(L, idx) lauxh_isuint_in_range((L), (idx), 0, UINT32_MAX)
+static inline void lauxh_pushbool2tblat(lua_State *L, const char *k, int v,
+                                        int at)
+{
+    if (at < 0) {
+        at -= 2;
+    }
+    lua_pushstring(L, k);
+    lua_pushboolean(L, v);
+    lua_rawset(L, at);
+}
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * unsigned integer and is in the range of the `uint64_t` type. it is equivalent
- * to the `lauxh_isuint_in_range(L, idx, 0, UINT64_MAX)`.
+ * @brief push the boolean to the specified key of the table at the top of the
+ * stack. it is equivalent to `lauxh_pushbool2tblat(L, k, v, -1)`.
  *
  * @param L lua state
- * @param idx index of the value
+ * @param k key string
+ * @param v boolean
  */
-#define lauxh_isuint64(L, idx) lauxh_isuint_in_range((L), (idx), 0, UINT64_MAX)
+#define lauxh_pushbool2tbl(L, k, v) lauxh_pushbool2tblat(L, k, v, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * positive integer.
+ * @brief push the boolean to the specified array index of the table at the
+ * specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
+ * @param idx array index
+ * @param v boolean
+ * @param at index of the table
  */
-static inline int lauxh_ispint(lua_State *L, int idx)
+static inline void lauxh_pushbool2arrat(lua_State *L, int idx, int v, int at)
 {
-    return lauxh_isint(L, idx) && lua_tointeger(L, idx) > 0;
+    if (at < 0) {
+        at--;
+    }
+    lua_pushboolean(L, v);
+    lua_rawseti(L, at, idx);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * positive integer and is greater than or equal to the specified number.
+ * @brief push the boolean to the specified array index of the table at the top
+ * of the stack. it is equivalent to `lauxh_pushbool2arrat(L, idx, v, -1)`.
  *
  * @param L lua state
- * @param idx index of the value
- * @param n value is greater than or equal to this number
+ * @param idx array index
+ * @param v boolean
  */
-static inline int lauxh_ispint_ge(lua_State *L, int idx, uintmax_t n)
-{
-    return lauxh_ispint(L, idx) && (uintmax_t)lua_tointeger(L, idx) >= n;
-}
+#define lauxh_pushbool2arr(L, idx, v) lauxh_pushbool2arrat(L, idx, v, -1)
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * positive integer and is less than or equal to the specified number.
+ * @brief get the value associated with the specified array index for the table
+ * at the specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param n value is less than or equal to this number
+ * @param idx array index
+ * @param at index of the table
  */
-static inline int lauxh_ispint_le(lua_State *L, int idx, uintmax_t n)
+static inline void lauxh_gettblat(lua_State *L, int idx, int at)
 {
-    return lauxh_ispint(L, idx) && (uintmax_t)lua_tointeger(L, idx) <= n;
+    lua_rawgeti(L, at, idx);
 }
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * positive integer and is in the specified range of numbers.
+ * @brief get the length of the table at the specified index.
  *
  * @param L lua state
- * @param idx index of the value
- * @param min value is greater than or equal to this number
- * @param max value is less than or equal to this number
+ * @param idx index of the table
  */
-static inline int lauxh_ispint_in_range(lua_State *L, int idx, uintmax_t min,
-                                        uintmax_t max)
-{
-    if (min > max) {
-        luaL_error(L, "min %d must be less than or equal to max %d", min, max);
-    }
-    if (lauxh_ispint(L, idx)) {
-        uintmax_t v = (uintmax_t)lua_tointeger(L, idx);
-        return v >= min && v <= max;
-    }
-    return 0;
-}
+#if LUA_VERSION_NUM >= 502
+# define lauxh_rawlen(L, idx) lua_rawlen(L, idx)
+#else
+# define lauxh_rawlen(L, idx) lua_objlen(L, idx)
+#endif
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * positive integer and is in the range of the `uint8_t` type. it is equivalent
- * to the `lauxh_ispint_in_range(L, idx, 0, UINT8_MAX)`.
- *
- * @param L lua state
- * @param idx index of the value
+ * @brief size of the stack memory that `lauxh_join()` uses before it falls
+ * back to the userdata memory.
  */
-#define lauxh_ispint8(L, idx) lauxh_ispint_in_range((L), (idx), 0, UINT8_MAX)
+#define LAUXH_JOIN_MEMSIZE 512
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * positive integer and is in the range of the `uint16_t` type. it is equivalent
- * to the `lauxh_ispint_in_range(L, idx, 0, UINT16_MAX)`.
- *
- * @param L lua state
- * @param idx index of the value
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  */
-#define lauxh_ispint16(L, idx) lauxh_ispint_in_range((L), (idx), 0, UINT16_MAX)
+static LAUXH_COLD LAUXH_NOINLINE void
+lauxh_join_grow(lua_State *L, int slot, lauxh_strbuf_t *b, size_t size)
+{
+    size_t len = b->len;
+    size_t cap = b->cap * 2;
+    char *data = NULL;
+
+    if (cap <= size) {
+        cap = size + 1;
+    }
+    // the memory is owned by the GC, so it is released even if the
+    // `__tostring` metamethod raises an error.
+    data = (char *)lua_newuserdata(L, cap);
+    if (len) {
+        memcpy(data, b->data, len);
+    }
+    lua_replace(L, slot);
+    lauxh_strbuf_init(b, data, cap);
+    b->len = len;
+}
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * positive integer and is in the range of the `uint32_t` type. it is equivalent
- * to the `lauxh_ispint_in_range(L, idx, 0, UINT32_MAX)`.
- *
- * @param L lua state
- * @param idx index of the value
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  */
-#define lauxh_ispint32(L, idx) lauxh_ispint_in_range((L), (idx), 0, UINT32_MAX)
+static inline char *lauxh_join_reserve(lua_State *L, int slot,
+                                       lauxh_strbuf_t *b, size_t n)
+{
+    if (LAUXH_UNLIKELY(b->cap - b->len <= n)) {
+        lauxh_join_grow(L, slot, b, b->len + n);
+    }
+    return b->data + b->len;
+}
 
 /**
- * @brief determine whether the type of the value at the specified index is the
- * positive integer and is in the range of the `uint64_t` type. it is equivalent
- * to the `lauxh_ispint_in_range(L, idx, 0, UINT64_MAX)`.
+ * @brief joins the elements of the array table at the specified index with the
+ * separator, and pushes the result to the stack. each element is converted in
+ * the same way as `lauxh_tolstr()`.
+ *
+ * the size of the result is estimated from the strings and the numbers in the
+ * first pass, so the buffer is allocated at most once unless the `__tostring`
+ * metamethod of the element returns a long string or changes the elements.
+ * every write is checked against the space of the buffer. the strings,
+ * numbers, booleans and nil are copied without creating the intermediate
+ * strings.
  *
+ * the buffer that exceeds the stack memory is allocated as the userdata, so
+ * nothing leaks if the `__tostring` metamethod raises an error.
+ *
+ * @note this function does not call the `__tostring` metamethod of the
+ * strings, numbers and booleans.
+ * @note this function can run the garbage collector, so the caller must keep
+ * the string of the separator reachable (e.g. on the stack).
  * @param L lua state
- * @param idx index of the value
- */
-#define lauxh_ispint64(L, idx) lauxh_ispint_in_range((L), (idx), 0, UINT64_MAX)
-
-/**
- * NOTE: for the value checking.
- */
+ * @param idx index of the table
+ * @param sep separator, or NULL
+ * @return const char* pointer to the pushed string
+ */
+static inline const char *lauxh_join(lua_State *L, int idx, const char *sep)
+{
+    char mem[LAUXH_JOIN_MEMSIZE];
+    char num[LAUXH_NUMBUF_SIZE];
+    lauxh_strbuf_t b = LAUXH_STRBUF_INIT;
+    const char *s    = NULL;
+    char *p          = NULL;
+    size_t len       = 0;
+    size_t seplen    = 0;
+    size_t size      = 0;
+    int slot         = 0;
+    int n            = 0;
+    int i            = 0;
 
-/**
- * @warning DO NOT USE THIS MACRO DIRECTLY.
- */
-#if defined(LAUXHLIB_USED_IN_LUA)
+    if (idx < 0) {
+        idx = lua_gettop(L) + idx + 1;
+    }
+    if (!sep) {
+        sep = "";
+    }
+    seplen = strlen(sep);
+    n      = (int)lauxh_rawlen(L, idx);
+    if (n == 0) {
+        lua_pushliteral(L, "");
+        return lua_tostring(L, -1);
+    }
 
-static const char *LAUXH_ARGERR_NAME = NULL;
-static int LAUXH_ARGERR_INDEX        = 0;
-static int LAUXH_ARGERR_STACK        = 1;
+    // estimate the size of the result. the number is counted as the maximum
+    // length of "%.14g" (or int64).
+    size = seplen * (size_t)(n - 1);
+    for (i = 1; i <= n; i++) {
+        lua_rawgeti(L, idx, i);
+        switch (lua_type(L, -1)) {
+        case LUA_TSTRING:
+            size += lauxh_rawlen(L, -1);
+            break;
+        case LUA_TNUMBER:
+            size += 24;
+            break;
+        case LUA_TBOOLEAN:
+            size += 5;
+            break;
+        default:
+            size += 3;
+        }
+        lua_pop(L, 1);
+    }
 
-# define lauxh_push_argerror_init()                                            \
-     do {                                                                      \
-         LAUXH_ARGERR_NAME  = NULL;                                            \
-         LAUXH_ARGERR_INDEX = 0;                                               \
-         LAUXH_ARGERR_STACK = 1;                                               \
-     } while (0)
-
-/**
- * @brief raises an error reporting a problem with the argument at the specified
- * index.
- *
- * @param L lua state
- * @param arg index of the argument
- * @param extra extra error message
- * @return int 1 if true, otherwise 0.
- */
-static inline int lauxh_push_argerror(lua_State *L, int arg, const char *extra)
-{
-    //
-    // NOTE: porting from lua source code
-    // https://github.com/lua/lua/blob/master/lauxlib.c
-    //
-    lua_Debug ar     = {};
-    int stack        = LAUXH_ARGERR_STACK;
-    const char *name = NULL;
-
-    LAUXH_ARGERR_STACK = 1;
-    if (LAUXH_ARGERR_NAME) {
-        name = lua_pushfstring(L, "'%s'", LAUXH_ARGERR_NAME);
-    } else if (LAUXH_ARGERR_INDEX > 0) {
-        name = lua_pushfstring(L, "#%d", LAUXH_ARGERR_INDEX);
-    } else {
-        name = lua_pushfstring(L, "#%d", arg);
+    // the slot holds the userdata memory of the buffer
+    lua_pushnil(L);
+    slot = lua_gettop(L);
+    lauxh_strbuf_init(&b, mem, sizeof(mem));
+    if (size >= b.cap) {
+        lauxh_join_grow(L, slot, &b, size);
     }
-    LAUXH_ARGERR_NAME  = NULL;
-    LAUXH_ARGERR_INDEX = 0;
-
-    if (!lua_getstack(L, stack, &ar)) { // no stack frame?
-        return luaL_error(L, "bad argument %s (%s)", name, extra);
+    for (i = 1; i <= n; i++) {
+        if (i > 1 && seplen) {
+            p = lauxh_join_reserve(L, slot, &b, seplen);
+            memcpy(p, sep, seplen);
+            b.len += seplen;
+        }
+        lua_rawgeti(L, idx, i);
+        switch (lua_type(L, -1)) {
+        case LUA_TSTRING:
+            s = lua_tolstring(L, -1, &len);
+            break;
+        case LUA_TNUMBER:
+            s = num;
+#if LUA_VERSION_NUM >= 503
+            if (lua_isinteger(L, -1)) {
+                len = lauxh_fmtint(num, lua_tointeger(L, -1));
+                break;
+            }
+#endif
+            len = lauxh_fmtnum(num, lua_tonumber(L, -1));
+            break;
+        case LUA_TBOOLEAN:
+            s   = lua_toboolean(L, -1) ? "true" : "false";
+            len = strlen(s);
+            break;
+        case LUA_TNIL:
+            s   = "nil";
+            len = 3;
+            break;
+        default:
+            // the `__tostring` metamethod can change the later elements, so
+            // the size estimated in the first pass is not trusted.
+            s = lauxh_tolstr(L, -1, &len);
+            lua_replace(L, -2);
+        }
+        p = lauxh_join_reserve(L, slot, &b, len);
+        memcpy(p, s, len);
+        b.len += len;
+        lua_pop(L, 1);
     }
 
-    lua_getinfo(L, "n", &ar);
-    return luaL_error(L, "bad argument %s to '%s' (%s)", name,
-                      (ar.name == NULL) ? "?" : ar.name, extra);
+    lua_pushlstring(L, b.data, b.len);
+    lua_replace(L, slot);
+    return lua_tostring(L, -1);
 }
 
 /**
- * @brief raises an error reporting a problem if the argument at the specified
- * index is not the specified type.
+ * NOTE: for the key atlas
  *
- * @param L lua state
- * @param arg index of the argument
- * @param t type of the argument (LUA_TXXX)
+ * the key atlas is an array table of the interned key strings that declared
+ * once per module. the `*2tblk` functions push the key string from the atlas
+ * with the `lua_rawgeti()` instead of hashing and interning the C string on
+ * every call. the atlas is usually held in the upvalue of the functions.
+ *
+ *  enum { KEY_NAME = 0, KEY_VALUE };
+ *  static const char *const KEYS[] = {"name", "value", NULL};
+ *
+ *  lauxh_newkeyatlas(L, KEYS);
+ *  lua_pushcclosure(L, fn, 1);
+ *  ...
+ *  // in the function
+ *  lua_createtable(L, 0, 2);
+ *  lauxh_pushstr2tblk(L, lua_upvalueindex(1), KEY_NAME, "foo");
+ *  lauxh_pushint2tblk(L, lua_upvalueindex(1), KEY_VALUE, 1);
+ *
+ * @note the index of the atlas must be an absolute index or a pseudo-index.
  */
-static inline void lauxh_checktype(lua_State *L, int arg, int t)
-{
-    //
-    // NOTE: porting from lua source code
-    // https://github.com/lua/lua/blob/master/lauxlib.c
-    //
-    if (lua_type(L, arg) != t) {
-        const char *tname    = lua_typename(L, t);
-        const char *extramsg = NULL;
-        const char *typearg; // name for the type of the actual argument
-
-        if (luaL_getmetafield(L, arg, "__name") == LUA_TSTRING) {
-            typearg = lua_tostring(L, -1); // use the given type name
-        } else if (lua_type(L, arg) == LUA_TLIGHTUSERDATA) {
-            typearg = "light userdata"; // special name for messages
-        } else {
-            typearg = luaL_typename(L, arg); // standard name
-        }
-
-        extramsg = lua_pushfstring(L, "%s expected, got %s", tname, typearg);
-        lauxh_push_argerror(L, arg, extramsg);
-    }
-    lauxh_push_argerror_init();
-}
-
-#else
-
-# define lauxh_push_argerror_init()
-# define lauxh_push_argerror luaL_argerror
-# define lauxh_checktype     luaL_checktype
-
-#endif
 
 /**
- * @brief raises an error reporting a problem.
+ * @brief create a new key atlas from the NULL-terminated array of the key
+ * strings and push it onto the stack. the key id is the index of the key
+ * string in the array.
  *
  * @param L lua state
- * @param idx index of the argument
- * @param fmt format string for the extra error message
- * @param ... arguments for the format string
+ * @param keys NULL-terminated array of the key strings
  */
-static inline int lauxh_argerror(lua_State *L, int idx, const char *fmt, ...)
+static inline void lauxh_newkeyatlas(lua_State *L, const char *const *keys)
 {
-    char buf[255];
-    va_list ap;
-
-    va_start(ap, fmt);
-    vsnprintf(buf, 255, fmt, ap);
-    va_end(ap);
+    int n = 0;
+    int i = 0;
 
-    if (idx < 0) {
-        idx = lua_gettop(L) + idx + 1;
+    while (keys[n]) {
+        n++;
+    }
+    lua_createtable(L, n, 0);
+    for (; i < n; i++) {
+        lua_pushstring(L, keys[i]);
+        lua_rawseti(L, -2, i + 1);
     }
-
-    return lauxh_push_argerror(L, idx, buf);
 }
 
 /**
- * @brief if the condition is not true, raises an error reporting the problem
- * with an error message.
+ * @brief push the key string of the specified key id in the key atlas onto the
+ * stack.
  *
  * @param L lua state
- * @param cond condition
- * @param idx index of the argument
- * @param fmt format string for the extra error message
- * @param ... arguments for the format string
+ * @param atlas index of the key atlas
+ * @param kid key id
  */
-#define lauxh_argcheck(L, cond, idx, fmt, ...)                                 \
-    do {                                                                       \
-        if (!(cond)) {                                                         \
-            lauxh_argerror((L), (idx), (fmt), ##__VA_ARGS__);                  \
-        }                                                                      \
-        lauxh_push_argerror_init();                                            \
-    } while (0)
+static inline void lauxh_pushkey(lua_State *L, int atlas, int kid)
+{
+    lua_rawgeti(L, atlas, kid + 1);
+}
 
 /**
- * @brief checks whether the value at the specified index is luaL_Stream*
- * (userdata that has the metatable of the `LUA_FILEHANDLE`) and returns a
- * pointer of the FILE*; if not, raises an error.
+ * @brief get the value associated with the key of the specified key id from the
+ * table at the specified index. similar to `lauxh_gettblof()`.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @return FILE**
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param idx index of the table
  */
-static inline FILE **lauxh_checkfilep(lua_State *L, int idx)
+static inline void lauxh_gettblofk(lua_State *L, int atlas, int kid, int idx)
 {
-    lauxh_argcheck(L, lauxh_isfile(L, idx), idx,
-                   LUA_FILEHANDLE " expected, got %s", luaL_typename(L, idx));
-
-#if LUA_VERSION_NUM >= 502
-    luaL_Stream *stream = (luaL_Stream *)lua_touserdata(L, idx);
-    return &stream->f;
-
-#else
-    return (FILE **)lua_touserdata(L, idx);
-#endif
+    if (idx < 0) {
+        idx--;
+    }
+    lauxh_pushkey(L, atlas, kid);
+    lua_rawget(L, idx);
 }
 
 /**
- * @brief same as `lauxh_checkfilep()`, but returns a pointer of the FILE.
+ * @brief push the nil value to the key of the specified key id of the table at
+ * the specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @return FILE* pointer to the FILE
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param at index of the table
  */
-static inline FILE *lauxh_checkfile(lua_State *L, int idx)
+static inline void lauxh_pushnil2tblkat(lua_State *L, int atlas, int kid,
+                                        int at)
 {
-    return *lauxh_checkfilep(L, idx);
+    if (at < 0) {
+        at -= 2;
+    }
+    lauxh_pushkey(L, atlas, kid);
+    lua_pushnil(L);
+    lua_rawset(L, at);
 }
 
 /**
- * @brief checks whether the value at the specified index is luaL_Stream*
- * (userdata that has the metatable of the `LUA_FILEHANDLE`) and returns a
- * pointer of the FILE*; if it is nil, returns the specified default value,
- * otherwise raises an error.
+ * @brief equivalent to `lauxh_pushnil2tblkat(L, atlas, kid, -1)`.
+ */
+#define lauxh_pushnil2tblk(L, atlas, kid)                                      \
+    lauxh_pushnil2tblkat(L, atlas, kid, -1)
+
+/**
+ * @brief push the function to the key of the specified key id of the table at
+ * the specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param def default value
- * @return FILE*
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param v function
+ * @param at index of the table
  */
-static inline FILE *lauxh_optfile(lua_State *L, int idx, FILE *def)
+static inline void lauxh_pushfn2tblkat(lua_State *L, int atlas, int kid,
+                                       lua_CFunction v, int at)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
+    if (at < 0) {
+        at -= 2;
     }
-    return lauxh_checkfile(L, idx);
+    lauxh_pushkey(L, atlas, kid);
+    lua_pushcfunction(L, v);
+    lua_rawset(L, at);
 }
 
 /**
- * @brief checks whether the value at the specified index is a callable object.
- * if not, raises an error.
- *
- * @param L lua state
- * @param idx index of the value
+ * @brief equivalent to `lauxh_pushfn2tblkat(L, atlas, kid, v, -1)`.
  */
-static inline void lauxh_checkcallable(lua_State *L, int idx)
-{
-    lauxh_argcheck(L, lauxh_iscallable(L, idx), idx,
-                   "callable object expected, got %s", luaL_typename(L, idx));
-}
+#define lauxh_pushfn2tblk(L, atlas, kid, v)                                    \
+    lauxh_pushfn2tblkat(L, atlas, kid, v, -1)
 
 /**
- * @brief checks whether the value at the specified index is a callable object
- * and returns its index; if it is nil, returns the specified default value,
- * otherwise raises an error.
+ * @brief push the string to the key of the specified key id of the table at
+ * the specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param def default value
- * @return int index of the callable object
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param v string
+ * @param at index of the table
  */
-static inline int lauxh_optcallable(lua_State *L, int idx, int def)
+static inline void lauxh_pushstr2tblkat(lua_State *L, int atlas, int kid,
+                                        const char *v, int at)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
+    if (at < 0) {
+        at -= 2;
     }
-    lauxh_checkcallable(L, idx);
-    return idx;
+    lauxh_pushkey(L, atlas, kid);
+    lua_pushstring(L, v);
+    lua_rawset(L, at);
 }
 
 /**
- * @brief checks whether the value at the specified index is a function; if not,
- * raises an error.
+ * @brief equivalent to `lauxh_pushstr2tblkat(L, atlas, kid, v, -1)`.
+ */
+#define lauxh_pushstr2tblk(L, atlas, kid, v)                                   \
+    lauxh_pushstr2tblkat(L, atlas, kid, v, -1)
+
+/**
+ * @brief push the string with length to the key of the specified key id of the
+ * table at the specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param v string
+ * @param l length of the string
+ * @param at index of the table
  */
-static inline void lauxh_checkfunc(lua_State *L, int idx)
+static inline void lauxh_pushlstr2tblkat(lua_State *L, int atlas, int kid,
+                                         const char *v, size_t l, int at)
 {
-    lauxh_checktype(L, idx, LUA_TFUNCTION);
+    if (at < 0) {
+        at -= 2;
+    }
+    lauxh_pushkey(L, atlas, kid);
+    lua_pushlstring(L, v, l);
+    lua_rawset(L, at);
 }
 
 /**
- * @brief alias of the `lauxh_checkfunc()`.
+ * @brief equivalent to `lauxh_pushlstr2tblkat(L, atlas, kid, v, l, -1)`.
  */
-#define lauxh_checkfunction(L, idx) lauxh_checkfunc((L), (idx))
+#define lauxh_pushlstr2tblk(L, atlas, kid, v, l)                               \
+    lauxh_pushlstr2tblkat(L, atlas, kid, v, l, -1)
 
 /**
- * @brief checks whether the value at the specified index is a function and
- * returns its index; if it is nil, returns the specified default value,
- * otherwise raises an error.
+ * @brief push the number to the key of the specified key id of the table at
+ * the specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param def default value
- * @return int index of the function
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param v number
+ * @param at index of the table
  */
-static inline int lauxh_optfunc(lua_State *L, int idx, int def)
+static inline void lauxh_pushnum2tblkat(lua_State *L, int atlas, int kid,
+                                        lua_Number v, int at)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
+    if (at < 0) {
+        at -= 2;
     }
-    lauxh_checkfunc(L, idx);
-    return idx;
+    lauxh_pushkey(L, atlas, kid);
+    lua_pushnumber(L, v);
+    lua_rawset(L, at);
 }
 
 /**
- * @brief checks whether the value at the specified index is a lua_CFunction and
- * returns it; if it is not a lua_CFunction, raises an error report.
+ * @brief equivalent to `lauxh_pushnum2tblkat(L, atlas, kid, v, -1)`.
+ */
+#define lauxh_pushnum2tblk(L, atlas, kid, v)                                   \
+    lauxh_pushnum2tblkat(L, atlas, kid, v, -1)
+
+/**
+ * @brief push the integer to the key of the specified key id of the table at
+ * the specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @return lua_CFunction
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param v integer
+ * @param at index of the table
  */
-static inline lua_CFunction lauxh_checkcfunc(lua_State *L, int idx)
+static inline void lauxh_pushint2tblkat(lua_State *L, int atlas, int kid,
+                                        lua_Integer v, int at)
 {
-    lauxh_argcheck(L, lua_iscfunction(L, idx), idx,
-                   "cfunction expected, got %s", luaL_typename(L, idx));
-    return lua_tocfunction(L, idx);
+    if (at < 0) {
+        at -= 2;
+    }
+    lauxh_pushkey(L, atlas, kid);
+    lua_pushinteger(L, v);
+    lua_rawset(L, at);
 }
 
 /**
- * @brief alias of the `lauxh_checkcfunc()`.
+ * @brief equivalent to `lauxh_pushint2tblkat(L, atlas, kid, v, -1)`.
  */
-#define lauxh_checkcfunction(L, idx) lauxh_checkcfunc((L), (idx))
+#define lauxh_pushint2tblk(L, atlas, kid, v)                                   \
+    lauxh_pushint2tblkat(L, atlas, kid, v, -1)
 
 /**
- * @brief checks whether the value at the specified index is a lua_CFunction and
- * returns it; if it is nil, returns the specified default value, otherwise
- * raises an error.
+ * @brief push the boolean to the key of the specified key id of the table at
+ * the specified index.
  *
+ * @note this function does not call the metamethod.
  * @param L lua state
- * @param idx index of the value
- * @param def default value
- * @return lua_CFunction
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param v boolean
+ * @param at index of the table
  */
-static inline lua_CFunction lauxh_optcfunc(lua_State *L, int idx,
-                                           lua_CFunction def)
+static inline void lauxh_pushbool2tblkat(lua_State *L, int atlas, int kid,
+                                         int v, int at)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
+    if (at < 0) {
+        at -= 2;
     }
-    return lauxh_checkcfunc(L, idx);
+    lauxh_pushkey(L, atlas, kid);
+    lua_pushboolean(L, v);
+    lua_rawset(L, at);
 }
 
 /**
- * @brief checks whether the value at the specified index is a thread and
- * returns it; if it is not a thread, raises an error report.
- *
- * @param L lua state
- * @param idx index of the value
+ * @brief equivalent to `lauxh_pushbool2tblkat(L, atlas, kid, v, -1)`.
  */
-static inline lua_State *lauxh_checkthread(lua_State *L, int idx)
-{
-    lauxh_checktype(L, idx, LUA_TTHREAD);
-    return lua_tothread(L, idx);
-}
+#define lauxh_pushbool2tblk(L, atlas, kid, v)                                  \
+    lauxh_pushbool2tblkat(L, atlas, kid, v, -1)
 
 /**
- * @brief checks whether the value at the specified index is a thread and
- * returns it; if it is nil, returns the specified default value, otherwise
- * raises an error.
+ * NOTE: helper functions and macros
+ */
+
+/**
+ * @brief push the value associated with the specified key from the global scope
+ * onto the top of the stack. if the value is not found, then place the `nil`
+ * value.
  *
  * @param L lua state
- * @param idx index of the value
- * @param def default value
- * @return lua_State*
+ * @param k key string
  */
-static inline lua_State *lauxh_optthread(lua_State *L, int idx, lua_State *def)
+static inline void lauxh_getglobal(lua_State *L, const char *k)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkthread(L, idx);
+#if defined(LUA_RIDX_GLOBALS)
+    lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+    lua_getfield(L, -1, k);
+
+#else
+    lua_getfield(L, LUA_GLOBALSINDEX, k);
+
+#endif
 }
 
 /**
- * @brief checks whether the value at the specified index is a light userdata
- * and returns it; if it is not a light userdata, raises an error report.
+ * NOTE: for metatable handling.
+ */
+
+/**
+ * @brief set the metatable to the value at the top of the stack.
  *
  * @param L lua state
- * @param idx index of the value
- * @return const void* pointer to the light userdata
+ * @param tname metatable name
  */
-static inline const void *lauxh_checkpointer(lua_State *L, int idx)
+static inline void lauxh_setmetatable(lua_State *L, const char *tname)
 {
-    lauxh_checktype(L, idx, LUA_TLIGHTUSERDATA);
-    return lua_topointer(L, idx);
+    luaL_getmetatable(L, tname);
+    lua_setmetatable(L, -2);
 }
 
 /**
- * @brief checks whether the value at the specified index is a light userdata
- * and returns it; if it is nil, returns the specified default value, otherwise
- * raises an error.
+ * @brief create a new metatable of the specified name in the registry if it
+ * does not exist, and push it onto the stack. it is similar to
+ * `luaL_newmetatable()`, but returns the pointer of the metatable.
  *
+ * @note the pointer is the stable identity of the metatable while it is
+ * registered in the registry, so it can be cached in the upvalue or the module
+ * state and passed to the `lauxh_ismetatableptr()`.
  * @param L lua state
- * @param idx index of the value
- * @param def default value
- * @return const void* pointer to the light userdata
+ * @param tname metatable name
+ * @return const void* pointer of the metatable
  */
-static inline const void *lauxh_optpointer(lua_State *L, int idx,
-                                           const void *def)
+static inline const void *lauxh_newmetatable(lua_State *L, const char *tname)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkpointer(L, idx);
+    luaL_newmetatable(L, tname);
+    return lua_topointer(L, -1);
 }
 
 /**
- * @brief checks whether the value at the specified index is a userdata and
- * returns it; if it is not a userdata, raises an error report.
+ * @brief get the pointer of the metatable of the specified name from the
+ * registry.
  *
  * @param L lua state
- * @param idx index of the value
- * @return void* pointer to the userdata
+ * @param tname metatable name
+ * @return const void* pointer of the metatable, or NULL if not registered.
  */
-static inline void *lauxh_checkuserdata(lua_State *L, int idx)
+static inline const void *lauxh_getmetatableptr(lua_State *L, const char *tname)
 {
-    lauxh_checktype(L, idx, LUA_TUSERDATA);
-    return lua_touserdata(L, idx);
+    const void *mt = NULL;
+
+    luaL_getmetatable(L, tname);
+    if (lua_type(L, -1) == LUA_TTABLE) {
+        mt = lua_topointer(L, -1);
+    }
+    lua_pop(L, 1);
+    return mt;
 }
 
 /**
- * @brief checks whether the value at the specified index is a userdata and
- * returns it; if it is nil, returns the specified default value, otherwise
- * raises an error.
+ * @brief sets the functions of the array to the table at the top of the stack
+ * as the closures that hold the pointer of the metatable in the first upvalue.
+ * the functions can check their userdata with `lauxh_checkudataupv()` without
+ * accessing the registry.
  *
  * @param L lua state
- * @param idx index of the value
- * @param def default value
- * @return void* pointer to the userdata
+ * @param regs array of the functions terminated by the entry of NULL name
+ * @param mt pointer of the metatable
  */
-static inline void *lauxh_optuserdata(lua_State *L, int idx, void *def)
+static inline void lauxh_setfuncs_mtptr(lua_State *L, const luaL_Reg *regs,
+                                        const void *mt)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
+    for (; regs->name; regs++) {
+        lua_pushstring(L, regs->name);
+        lua_pushlightuserdata(L, (void *)mt);
+        lua_pushcclosure(L, regs->func, 1);
+        lua_rawset(L, -3);
     }
-    return lauxh_checkuserdata(L, idx);
 }
 
 /**
- * @brief checks whether the value at the specified index is a userdata that has
- * the metatable of the specified name and returns it; if not, raises an error
- * report.
+ * @brief create a new metatable of the specified name in the same way as
+ * `lauxh_newmetatable()`, and sets the metamethods and the `__index` table of
+ * the methods by `lauxh_setfuncs_mtptr()`. the metatable is left on the stack.
  *
  * @param L lua state
- * @param idx index of the value
  * @param tname metatable name
- * @return void* pointer to userdata
+ * @param mmethods array of the metamethods
+ * @param methods array of the methods
+ * @return const void* pointer of the metatable
  */
-static inline void *lauxh_checkudata(lua_State *L, int idx, const char *tname)
+static inline const void *lauxh_newmetatable_mtptr(lua_State *L,
+                                                   const char *tname,
+                                                   const luaL_Reg *mmethods,
+                                                   const luaL_Reg *methods)
 {
-    return luaL_checkudata(L, idx, tname);
+    const void *mt = lauxh_newmetatable(L, tname);
+
+    lauxh_setfuncs_mtptr(L, mmethods, mt);
+    lua_newtable(L);
+    lauxh_setfuncs_mtptr(L, methods, mt);
+    lua_setfield(L, -2, "__index");
+    return mt;
 }
 
 /**
- * @brief checks whether the value at the specified index is a userdata that has
- * the metatable of the specified name and returns it; if it is nil, returns the
- * specifed default value, otherwise raises an error report.
+ * NOTE: for the comparison.
+ */
+
+/**
+ * @brief determine whether the value at the specified index has a metatable of
+ * the specified name.
  *
  * @param L lua state
  * @param idx index of the value
  * @param tname metatable name
- * @param def default value
- * @return void* pointer to userdata
+ * @return int 1 if true, otherwise 0.
  */
-static inline void *lauxh_optudata(lua_State *L, int idx, const char *tname,
-                                   void *def)
+static inline int lauxh_ismetatableof(lua_State *L, int idx, const char *tname)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
+    int rc = 0;
+
+    // idx value is wrapped by metatable
+    if (lua_getmetatable(L, idx)) {
+        // get metatable from registry
+        lua_pushstring(L, tname);
+        lua_rawget(L, LUA_REGISTRYINDEX);
+        // compare
+        rc = lua_rawequal(L, -1, -2);
+        lua_pop(L, 2);
     }
 
-    return lauxh_checkudata(L, idx, tname);
+    return rc;
 }
 
 /**
- * @brief checks whether the value at the specified index is a boolean and
- * returns it; if it is not a boolean, raises an error report.
+ * @brief determine whether the value at the specified index has a metatable of
+ * the specified pointer that returned by the `lauxh_newmetatable()` or
+ * `lauxh_getmetatableptr()`.
  *
+ * @note unlike the `lauxh_ismetatableof()`, this function does not access the
+ * registry.
  * @param L lua state
  * @param idx index of the value
+ * @param mt pointer of the metatable
  * @return int 1 if true, otherwise 0.
  */
-static inline int lauxh_checkbool(lua_State *L, int idx)
+static inline int lauxh_ismetatableptr(lua_State *L, int idx, const void *mt)
 {
-    lauxh_checktype(L, idx, LUA_TBOOLEAN);
-    return lua_toboolean(L, idx);
+    int rc = 0;
+
+    if (lua_getmetatable(L, idx)) {
+        rc = lua_topointer(L, -1) == mt;
+        lua_pop(L, 1);
+    }
+
+    return rc;
 }
 
+#if LUA_VERSION_NUM >= 502
 /**
- * @brief alias of the `lauxh_checkbool()`.
+ * @brief compare the values of the specified indices. it is equivalent to
+ * `lua_compare(L, idx1, idx2, LUA_OPEQ)`.
+ *
+ * @param L lua state
+ * @param idx1 index of the value
+ * @param idx2 index of the value
+ * @return int 1 if true, otherwise 0.
  */
-#define lauxh_checkboolean(L, idx) lauxh_checkbool((L), (idx))
+# define lauxh_equal(L, idx1, idx2) lua_compare(L, idx1, idx2, LUA_OPEQ)
 
+#else
 /**
- * @brief checks whether the value at the specified index is a boolean and
- * returns it; if it is nil, returns the specified default value, otherwise
- * raises an error.
+ * @brief compare the values of the specified indices.  it is equivalent to
+ * `lua_equal(L, idx1, idx2)`.
  *
  * @param L lua state
- * @param idx index of the value
- * @param def default value
+ * @param idx1 index of the value
+ * @param idx2 index of the value
  * @return int 1 if true, otherwise 0.
  */
-static inline int lauxh_optbool(lua_State *L, int idx, int def)
-{
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkbool(L, idx);
-}
+# define lauxh_equal(L, idx1, idx2) lua_equal(L, idx1, idx2)
+#endif
 
 /**
- * @brief alias of the `lauxh_optbool()`.
+ * NOTE: for the type checking.
  */
-#define lauxh_optboolean(L, idx, def) lauxh_optbool((L), (idx), (def))
 
 /**
- * @brief checks whether the value at the specified index is a string and
- * returns it; if it is not a string, raises an error report.
+ * @brief determine whether the value at the specified index is `LUA_TNIL` or
+ * `LUA_TNONE`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param[out] len length of the string
- * @return const char* pointer to the string
+ * @return int 1 if true, otherwise 0.
  */
-static inline const char *lauxh_checklstr(lua_State *L, int idx, size_t *len)
+static inline int lauxh_isnil(lua_State *L, int idx)
 {
-    lauxh_checktype(L, idx, LUA_TSTRING);
-    return lua_tolstring(L, idx, len);
+    return lua_isnoneornil(L, idx);
 }
 
 /**
- * @brief alias of the `lauxh_checklstr()`.
- */
-#define lauxh_checklstring(L, idx, len) lauxh_checklstr((L), (idx), (len))
-
-/**
- * @brief equivalent to `lauxh_checklstr(L, idx, NULL)`.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TSSTRING`.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int 1 if true, otherwise 0.
  */
-#define lauxh_checkstr(L, idx) lauxh_checklstr((L), (idx), NULL)
+static inline int lauxh_isstr(lua_State *L, int idx)
+{
+    return lua_type(L, idx) == LUA_TSTRING;
+}
 
 /**
- * @brief alias of the `lauxh_checkstr()`.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TSTRING`. it is equivalent to `lauxh_isstr(L, idx)`.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int 1 if true, otherwise 0.
  */
-#define lauxh_checkstring(L, idx) lauxh_checkstr((L), (idx))
+#define lauxh_isstring(L, idx) lauxh_isstr((L), (idx))
 
 /**
- * @brief checks whether the value at the specified index is a string and
- * returns it; if it is nil, returns the specified default value, otherwise
- * raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TBOLLEAN`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @param[out] len length of the string
- * @return const char* pointer to the string
+ * @return int 1 if true, otherwise 0.
  */
-static inline const char *lauxh_optlstr(lua_State *L, int idx, const char *def,
-                                        size_t *len)
+static inline int lauxh_isbool(lua_State *L, int idx)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        if (len && def) {
-            *len = strlen(def);
-        }
-        return def;
-    }
-    return lauxh_checklstr(L, idx, len);
+    return lua_type(L, idx) == LUA_TBOOLEAN;
 }
 
 /**
- * @brief alias of the `lauxh_optlstr()`.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TBOLLEAN`. it is equivalent to `lauxh_isbool(L, idx)`.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int 1 if true, otherwise 0.
  */
-#define lauxh_optlstring(L, idx, def, len)                                     \
-    lauxh_optlstr((L), (idx), (def), (len))
-
-/**
- * @brief equivalent to `lauxh_optlstr(L, idx, def, NULL)`.
- */
-#define lauxh_optstr(L, idx, def) lauxh_optlstr((L), (idx), (def), NULL)
-
-/**
- * @brief alias of the `lauxh_optstr()`.
- */
-#define lauxh_optstring(L, idx, def) lauxh_optstr((L), (idx), (def))
-
-/* number/integer argument */
-
-#define CHECK_NUMTYPE(L, idx, tname, isnumfn)                                  \
-    do {                                                                       \
-        if (!isnumfn((L), (idx))) {                                            \
-            int t = lua_type((L), (idx));                                      \
-            if (t != LUA_TNUMBER) {                                            \
-                lauxh_argerror((L), (idx), tname " expected, got %s",          \
-                               lua_typename((L), t));                          \
-            }                                                                  \
-            lauxh_argerror((L), (idx),                                         \
-                           tname " expected, got an out of range value");      \
-        }                                                                      \
-        lauxh_push_argerror_init();                                            \
-    } while (0)
+#define lauxh_isboolean(L, idx) lauxh_isbool((L), (idx))
 
 /**
- * @brief checks whether the value at the specified index is the number and
- * returns it; if it is not a number, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TTABLE`.
  *
  * @param L lua state
  * @param idx index of the value
- * @return lua_Number
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Number lauxh_checknum(lua_State *L, int idx)
+static inline int lauxh_istable(lua_State *L, int idx)
 {
-    CHECK_NUMTYPE(L, idx, "number", lauxh_isnum);
-    return lua_tonumber(L, idx);
+    return lua_type(L, idx) == LUA_TTABLE;
 }
 
 /**
- * @brief alias of the `lauxh_checknum()`.
- */
-#define lauxh_checknumber(L, idx) lauxh_checknum((L), (idx))
-
-/**
- * @brief checks whether the value at the specified index is the number and
- * returns it; if it is nil, returns the specified default value, otherwise
- * raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TFUNCTION`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return lua_Number
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Number lauxh_optnum(lua_State *L, int idx, lua_Number def)
+static inline int lauxh_isfunc(lua_State *L, int idx)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checknum(L, idx);
+    return lua_type(L, idx) == LUA_TFUNCTION;
 }
 
 /**
- * @brief alias of the `lauxh_optnum()`.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TFUNCTION`. it is equivalent to `lauxh_isfunc(L, idx)`.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int 1 if true, otherwise 0.
  */
-#define lauxh_optnumber(L, idx, def) lauxh_optnum((L), (idx), (def))
+#define lauxh_isfunction(L, idx) lauxh_isfunc((L), (idx))
 
 /**
- * @brief checks whether the value at the specified index is the integer and
- * returns it; if it is not a integer, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * `lua_CFunction` type. it is equivalent to `lua_iscfunction(L, idx)`.
  *
  * @param L lua state
  * @param idx index of the value
- * @return lua_Integer
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Integer lauxh_checkint(lua_State *L, int idx)
+static inline int lauxh_iscfunc(lua_State *L, int idx)
 {
-    CHECK_NUMTYPE(L, idx, "integer", lauxh_isint);
-    return lua_tointeger(L, idx);
+    return lua_iscfunction(L, idx);
 }
 
 /**
- * @brief alias of the `lauxh_checkint()`.
+ * @brief determine whether the type of the value at the specified index is the
+ * `lua_CFunction`. it is equivalent to `lauxh_iscfunc(L, idx)`.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int 1 if true, otherwise 0.
  */
-#define lauxh_checkinteger(L, idx) lauxh_checkint((L), (idx))
+#define lauxh_iscfunction(L, idx) lauxh_iscfunc((L), (idx))
 
 /**
- * @brief checks whether the value at the specified index is the integer and
- * returns it; if it is nil, returns the specified default value, otherwise
- * raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TTHREAD`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return lua_Integer
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Integer lauxh_optint(lua_State *L, int idx, lua_Integer def)
+static inline int lauxh_isthread(lua_State *L, int idx)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkint(L, idx);
+    return lua_type(L, idx) == LUA_TTHREAD;
 }
 
 /**
- * @brief alias of the `lauxh_optint()`.
- */
-#define lauxh_optinteger(L, idx, def) lauxh_optint((L), (idx), (def))
-
-/**
- * @brief checks whether the value at the specified index is the finite number
- * and returns it; if it is not a finite number, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TUSERDATA`.
  *
  * @param L lua state
  * @param idx index of the value
- * @return lua_Integer
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Number lauxh_checkfinite(lua_State *L, int idx)
+static inline int lauxh_isuserdata(lua_State *L, int idx)
 {
-    CHECK_NUMTYPE(L, idx, "finite number", lauxh_isfinite);
-    return lua_tonumber(L, idx);
+    return lua_type(L, idx) == LUA_TUSERDATA;
 }
 
 /**
- * @brief checks whether the value at the specified index is the finite number
- * and returns it; if it is nil, returns the specified default value, otherwise
- * raises an error.
+ * @brief determine whether the value at the specified index is a userdata that
+ * has the metatable of the specified name.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return lua_Integer
+ * @param tname metatable name
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Number lauxh_optfinite(lua_State *L, int idx, lua_Number def)
+static inline int lauxh_isuserdataof(lua_State *L, int idx, const char *tname)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkfinite(L, idx);
+    return lauxh_isuserdata(L, idx) && lauxh_ismetatableof(L, idx, tname);
 }
 
 /**
- * @brief checks whether the value at the specified index is the unsigned
- * number and returns it; if it is not a unsigned number, raises an error
- * report.
+ * @brief determine whether the value at the specified index is a userdata that
+ * has the metatable of the specified pointer.
  *
  * @param L lua state
  * @param idx index of the value
- * @return lua_Number
+ * @param mt pointer of the metatable
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Number lauxh_checkunsigned(lua_State *L, int idx)
+static inline int lauxh_isuserdataptr(lua_State *L, int idx, const void *mt)
 {
-    CHECK_NUMTYPE(L, idx, "unsigned number", lauxh_isunsigned);
-    return lua_tonumber(L, idx);
+    return lauxh_isuserdata(L, idx) && lauxh_ismetatableptr(L, idx, mt);
 }
 
 /**
- * @brief checks whether the value at the specified index is the unsigned number
- * and returns it; if it is nil, returns the specified default value, otherwise
- * raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TLIGHTUSERDATA`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return lua_Number
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Number lauxh_optunsigned(lua_State *L, int idx,
-                                           lua_Number def)
+static inline int lauxh_ispointer(lua_State *L, int idx)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkunsigned(L, idx);
+    return lua_type(L, idx) == LUA_TLIGHTUSERDATA;
 }
 
 /**
- * @brief checks whether the value at the specified index is the unsigned
- * integer and returns it; if it is not a unsigned integer, raises an error
- * report.
+ * @brief determine whether the value at the specified index has a metatable of
+ * the `LUA_FILEHANDLE`.
  *
  * @param L lua state
  * @param idx index of the value
- * @return lua_Integer
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Integer lauxh_checkuint(lua_State *L, int idx)
+static inline int lauxh_isfile(lua_State *L, int idx)
 {
-    CHECK_NUMTYPE(L, idx, "unsigned integer", lauxh_isuint);
-    return lua_tointeger(L, idx);
+    return lauxh_ismetatableof(L, idx, LUA_FILEHANDLE);
 }
 
 /**
- * @brief alias of the `lauxh_checkuint()`.
- */
-#define lauxh_checkuinteger(L, idx) lauxh_checkuint((L), (idx))
-
-/**
- * @brief checks whether the value at the specified index is the unsigned
- * integer and returns it; if it is nil, returns the specified default value,
- * otherwise raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * function or it has a metatable that contains the
+ * `__call` metamethod.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return lua_Integer
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Integer lauxh_optuint(lua_State *L, int idx, lua_Integer def)
+static inline int lauxh_iscallable(lua_State *L, int idx)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
+    if (lauxh_isfunc(L, idx)) {
+        return 1;
+    } else if (lua_getmetatable(L, idx)) {
+        int isfunc = 0;
+        lua_pushliteral(L, "__call");
+        lua_rawget(L, -2);
+        isfunc = lauxh_isfunc(L, -1);
+        lua_pop(L, 2);
+        return isfunc;
     }
-    return lauxh_checkuint(L, idx);
+    return 0;
 }
 
 /**
- * @brief alias of the `lauxh_optuint()`.
- */
-#define lauxh_optuinteger(L, idx, def) lauxh_optuint((L), (idx), (def))
-
-/**
- * @brief checks whether the value at the specified index is the positive
- * integer and returns it; if it is not a positive integer, raises an error
- * report.
+ * @brief determine whether the type of the value at the specified index is the
+ * number type.
  *
  * @param L lua state
  * @param idx index of the value
- * @return lua_Integer
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Integer lauxh_checkpint(lua_State *L, int idx)
+static inline int lauxh_isnum(lua_State *L, int idx)
 {
-    CHECK_NUMTYPE(L, idx, "positive integer", lauxh_ispint);
-    return lua_tointeger(L, idx);
+    return lua_type(L, idx) == LUA_TNUMBER;
 }
 
 /**
- * @brief alias of the `lauxh_checkpint()`.
+ * @brief determine whether the type of the value at the specified index is the
+ * number type. it is equivalent to `lauxh_isnum(L, idx)`.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int 1 if true, otherwise 0.
  */
-#define lauxh_checkpinteger(L, idx) lauxh_checkpint((L), (idx))
+#define lauxh_isnumber(L, idx) lauxh_isnum((L), idx)
 
 /**
- * @brief checks whether the value at the specified index is the positive
- * integer and returns it; if it is nil, returns the specified default value,
- * otherwise raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TNUMBER` and is greater than or equal to the specified number.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return lua_Integer
+ * @param n value is greater than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Integer lauxh_optpint(lua_State *L, int idx, lua_Integer def)
+static inline int lauxh_isnum_ge(lua_State *L, int idx, lua_Number n)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkpint(L, idx);
+    return lauxh_isnum(L, idx) && lua_tonumber(L, idx) >= n;
 }
 
 /**
- * @brief alias of the `lauxh_optpint()`.
- */
-#define lauxh_optpinteger(L, idx, def) lauxh_optpint((L), (idx), (def))
-
-/**
- * @brief checks whether the value at the specified index is in the range of the
- * `int8_t` type and returns it; if it is not in the range of the `int8_t` type,
- * raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TNUMBER` and is less than or equal to the specified number.
  *
  * @param L lua state
  * @param idx index of the value
- * @return int8_t
+ * @param n value is less than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline int8_t lauxh_checkint8(lua_State *L, int idx)
+static inline int lauxh_isnum_le(lua_State *L, int idx, lua_Number n)
 {
-    CHECK_NUMTYPE(L, idx, "int8_t", lauxh_isint8);
-    return (int8_t)lua_tointeger(L, idx);
+    return lauxh_isnum(L, idx) && lua_tonumber(L, idx) <= n;
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `int8_t` type and returns it; if it is nil, returns the specified default
- * value, otherwise raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TNUMBER` and is in the specified range of numbers.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return int8_t
+ * @param min value is greater than or equal to this number
+ * @param max value is less than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline int8_t lauxh_optint8(lua_State *L, int idx, int8_t def)
+static inline int lauxh_isnum_in_range(lua_State *L, int idx, lua_Number min,
+                                       lua_Number max)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
+    if (LAUXH_UNLIKELY(!isfinite(min) || !isfinite(max) || min > max)) {
+        luaL_error(L,
+                   "min and max must be finite numbers, and min %f must be "
+                   "less than or equal to max %f",
+                   min, max);
     }
-    return lauxh_checkint8(L, idx);
+
+    if (lauxh_isnum(L, idx)) {
+        lua_Number v = lua_tonumber(L, idx);
+        return v >= min && v <= max;
+    }
+    return 0;
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `uint8_t` type and returns it; if it is not in the range of the `uint8_t`
- * type, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * `LUA_TNUMBER` and is a finite number with `isfinite()` function.
  *
  * @param L lua state
  * @param idx index of the value
- * @return uint8_t
+ * @param n value is greater than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline uint8_t lauxh_checkuint8(lua_State *L, int idx)
+static inline int lauxh_isfinite(lua_State *L, int idx)
 {
-    CHECK_NUMTYPE(L, idx, "uint8_t", lauxh_isuint8);
-    return (uint8_t)lua_tointeger(L, idx);
+    return lauxh_isnum(L, idx) && isfinite(lua_tonumber(L, idx));
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `uint8_t` type and returns it; if it is nil, returns the specified default
- * value, otherwise raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * finite number and is greater than or equal to the specified number.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return uint8_t
+ * @param n value is greater than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline uint8_t lauxh_optuint8(lua_State *L, int idx, uint8_t def)
+static inline int lauxh_isfinite_ge(lua_State *L, int idx, lua_Number n)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkuint8(L, idx);
+    return lauxh_isfinite(L, idx) && lua_tonumber(L, idx) >= n;
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `int16_t` type and returns it; if it is not in the range of the `int16_t`
- * type, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * finite number and is less than or equal to the specified number.
  *
  * @param L lua state
  * @param idx index of the value
- * @return int16_t
+ * @param n value is less than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline int16_t lauxh_checkint16(lua_State *L, int idx)
+static inline int lauxh_isfinite_le(lua_State *L, int idx, lua_Number n)
 {
-    CHECK_NUMTYPE(L, idx, "int16_t", lauxh_isint16);
-    return (int16_t)lua_tointeger(L, idx);
+    return lauxh_isfinite(L, idx) && lua_tonumber(L, idx) <= n;
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `int16_t` type and returns it; if it is nil, returns the specified default
- * value, otherwise raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * finite number and is in the specified range of numbers.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return int16_t
+ * @param min value is greater than or equal to this number
+ * @param max value is less than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline int16_t lauxh_optint16(lua_State *L, int idx, int16_t def)
+static inline int lauxh_isfinite_in_range(lua_State *L, int idx, lua_Number min,
+                                          lua_Number max)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
+    if (LAUXH_UNLIKELY(!isfinite(min) || !isfinite(max) || min > max)) {
+        luaL_error(L,
+                   "min and max must be finite numbers, and min %f must be "
+                   "less than or equal to max %f",
+                   min, max);
     }
-    return lauxh_checkint16(L, idx);
+    if (lauxh_isfinite(L, idx)) {
+        lua_Number v = lua_tonumber(L, idx);
+        return v >= min && v <= max;
+    }
+    return 0;
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `uint16_t` type and returns it; if it is not in the range of the `uint16_t`
- * type, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * unsigned number.
  *
  * @param L lua state
  * @param idx index of the value
- * @return uint16_t
+ * @return int 1 if true, otherwise 0.
+ *
+ * @note this function does not call the metamethod.
  */
-static inline uint16_t lauxh_checkuint16(lua_State *L, int idx)
+static inline lua_Number lauxh_isunsigned(lua_State *L, int idx)
 {
-    CHECK_NUMTYPE(L, idx, "uint16_t", lauxh_isuint16);
-    return (uint16_t)lua_tointeger(L, idx);
+    return lauxh_isnum(L, idx) && lua_tonumber(L, idx) >= 0;
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `uint16_t` type and returns it; if it is nil, returns the specified default
- * value, otherwise raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * unsigned number and is greater than or equal to the specified number.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return uint16_t
+ * @param n value is greater than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline uint16_t lauxh_optuint16(lua_State *L, int idx, uint16_t def)
+static inline int lauxh_isunsigned_ge(lua_State *L, int idx, lua_Number n)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkuint16(L, idx);
+    return lauxh_isunsigned(L, idx) && lua_tonumber(L, idx) >= n;
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `int32_t` type and returns it; if it is not in the range of the `int32_t`
- * type, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * unsigned number and is less than or equal to the specified number.
  *
  * @param L lua state
  * @param idx index of the value
- * @return int32_t
+ * @param n value is less than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline int32_t lauxh_checkint32(lua_State *L, int idx)
+static inline int lauxh_isunsigned_le(lua_State *L, int idx, lua_Number n)
 {
-    CHECK_NUMTYPE(L, idx, "int32_t", lauxh_isint32);
-    return (int32_t)lua_tointeger(L, idx);
+    return lauxh_isunsigned(L, idx) && lua_tonumber(L, idx) <= n;
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `int32_t` type and returns it; if it is nil, returns the specified default
- * value, otherwise raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * unsigned number and is in the specified range of numbers.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return int32_t
+ * @param min value is greater than or equal to this number
+ * @param max value is less than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline int32_t lauxh_optint32(lua_State *L, int idx, int32_t def)
+static inline int lauxh_isunsigned_in_range(lua_State *L, int idx,
+                                            lua_Number min, lua_Number max)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
+    if (LAUXH_UNLIKELY(!isfinite(min) || !isfinite(max) || min > max)) {
+        luaL_error(L,
+                   "min and max must be finite numbers, and min %f must be "
+                   "less than or equal to max %f",
+                   min, max);
     }
-    return lauxh_checkint32(L, idx);
+    if (lauxh_isunsigned(L, idx)) {
+        lua_Number v = lua_tonumber(L, idx);
+        return v >= min && v <= max;
+    }
+    return 0;
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `uint32_t` type and returns it; if it is not in the range of the `uint32_t`
- * type, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * integer.
  *
  * @param L lua state
  * @param idx index of the value
- * @return uint32_t
+ * @return int 1 if true, otherwise 0.
  */
-static inline uint32_t lauxh_checkuint32(lua_State *L, int idx)
+static inline int lauxh_isint(lua_State *L, int idx)
 {
-    CHECK_NUMTYPE(L, idx, "uint32_t", lauxh_isuint32);
-    return (uint32_t)lua_tointeger(L, idx);
+#if LUA_VERSION_NUM >= 503
+    return lua_isinteger(L, idx);
+#else
+    return lauxh_isnum(L, idx) &&
+           (lua_Number)lua_tointeger(L, idx) == lua_tonumber(L, idx);
+#endif
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `uint32_t` type and returns it; if it is nil, returns the specified default
- * value, otherwise raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * integer. it is equivalent to `lauxh_isint(L, idx)`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return uint32_t
  */
-static inline uint32_t lauxh_optuint32(lua_State *L, int idx, uint32_t def)
-{
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkuint32(L, idx);
-}
+#define lauxh_isinteger(L, idx) lauxh_isint((L), (idx))
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `int64_t` type and returns it; if it is not in the range of the `int64_t`
- * type, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * integer and is greater than or equal to the specified number.
  *
  * @param L lua state
  * @param idx index of the value
- * @return int64_t
+ * @param n value is greater than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline int64_t lauxh_checkint64(lua_State *L, int idx)
+static inline int lauxh_isint_ge(lua_State *L, int idx, lua_Integer n)
 {
-    CHECK_NUMTYPE(L, idx, "int64_t", lauxh_isint64);
-    return (int64_t)lua_tointeger(L, idx);
+    return lauxh_isint(L, idx) && lua_tointeger(L, idx) >= n;
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `int64_t` type and returns it; if it is nil, returns the specified default
- * value, otherwise raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * integer and is less than or equal to the specified number.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return int64_t
+ * @param n value is less than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline int64_t lauxh_optint64(lua_State *L, int idx, int64_t def)
+static inline int lauxh_isint_le(lua_State *L, int idx, lua_Integer n)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkint64(L, idx);
+    return lauxh_isint(L, idx) && lua_tointeger(L, idx) <= n;
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `uint64_t` type and returns it; if it is not in the range of the `uint64_t`
- * type, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * integer and is in the specified range of numbers.
  *
  * @param L lua state
  * @param idx index of the value
- * @return uint64_t
+ * @param min value is greater than or equal to this number
+ * @param max value is less than or equal to this number
+ * @return int 1 if true, otherwise 0.
  */
-static inline uint64_t lauxh_checkuint64(lua_State *L, int idx)
+static inline int lauxh_isint_in_range(lua_State *L, int idx, lua_Integer min,
+                                       lua_Integer max)
 {
-    CHECK_NUMTYPE(L, idx, "uint64_t", lauxh_isuint64);
-    return (uint64_t)lua_tointeger(L, idx);
+    if (LAUXH_UNLIKELY(min > max)) {
+        luaL_error(L, "min %d must be less than or equal to max %d", min, max);
+    }
+    if (lauxh_isint(L, idx)) {
+        lua_Integer v = lua_tointeger(L, idx);
+        return v >= min && v <= max;
+    }
+    return 0;
 }
 
 /**
- * @brief checks whether the value at the specified index is in the range of the
- * `uint64_t` type and returns it; if it is nil, returns the specified default
- * value, otherwise raises an error.
+ * @brief determine whether the type of the value at the specified index is the
+ * integer and is in the range of the `int8_t` type. it is equivalent to
+ * `lauxh_isint_in_range(L, idx, INT8_MIN, INT8_MAX)`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param def default value
- * @return uint64_t
+ * @return int 1 if true, otherwise 0.
  */
-static inline uint64_t lauxh_optuint64(lua_State *L, int idx, uint64_t def)
-{
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkuint64(L, idx);
-}
+#define lauxh_isint8(L, idx)                                                   \
+    lauxh_isint_in_range((L), (idx), INT8_MIN, INT8_MAX)
 
-#undef CHECK_NUMTYPE
+/**
+ * @brief determine whether the type of the value at the specified index is the
+ * integer and is in the range of the `int16_t` type. it is equivalent to
+ * `lauxh_isint_in_range(L, idx, INT16_MIN, INT16_MAX)`.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ */
+#define lauxh_isint16(L, idx)                                                  \
+    lauxh_isint_in_range((L), (idx), INT16_MIN, INT16_MAX)
 
-#define CHECK_NUMTYPE_GLE(L, idx, tname, cmpname, isnumfn, n, nfmt)            \
-    do {                                                                       \
-        if (!isnumfn((L), (idx), (n))) {                                       \
-            int t = lua_type((L), (idx));                                      \
-            lua_pushfstring((L),                                               \
-                            tname " " cmpname " than or equal to " nfmt        \
-                                  " expected, ",                               \
-                            (n));                                              \
-            if (t != LUA_TNUMBER) {                                            \
-                lua_pushfstring((L), "got %s", lua_typename((L), t));          \
-            } else {                                                           \
-                lua_pushliteral((L), "got an out of range value");             \
-            }                                                                  \
-            lua_concat((L), 2);                                                \
-            lauxh_push_argerror((L), (idx), lua_tostring((L), -1));            \
-        }                                                                      \
-        lauxh_push_argerror_init();                                            \
-    } while (0)
+/**
+ * @brief determine whether the type of the value at the specified index is the
+ * integer and is in the range of the `int32_t` type. it is equivalent to
+ * `lauxh_isint_in_range(L, idx, INT32_MIN, INT32_MAX)`.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ */
+#define lauxh_isint32(L, idx)                                                  \
+    lauxh_isint_in_range((L), (idx), INT32_MIN, INT32_MAX)
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * number and is greater than or equal to the specified number and returns it;
- * if not, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * integer and is in the range of the `int64_t` type. it is equivalent to the
+ * `lauxh_isint_in_range(L, idx, INT64_MIN, INT64_MAX)`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param n value is greater than or equal to this number
- * @return lua_Number
  */
-static inline lua_Number lauxh_checknum_ge(lua_State *L, int idx, lua_Number n)
-{
-    CHECK_NUMTYPE_GLE(L, idx, "number", "greater", lauxh_isnum_ge, n, "%f");
-    return lua_tonumber(L, idx);
-}
+#define lauxh_isint64(L, idx)                                                  \
+    lauxh_isint_in_range((L), (idx), INT64_MIN, INT64_MAX)
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * number and is less than or equal to the specified number and returns it;
- * if not, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * unsigned integer.
  *
  * @param L lua state
  * @param idx index of the value
- * @param n value is less than or equal to this number
- * @return lua_Number
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Number lauxh_checknum_le(lua_State *L, int idx, lua_Number n)
+static inline int lauxh_isuint(lua_State *L, int idx)
 {
-    CHECK_NUMTYPE_GLE(L, idx, "number", "less", lauxh_isnum_le, n, "%f");
-    return lua_tonumber(L, idx);
+    return lauxh_isint(L, idx) && lua_tointeger(L, idx) >= 0;
 }
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * number and is greater than or equal to the specified number and returns it;
- * if it is nil, returns the specified default value, otherwise raises an error
- * report.
+ * @brief determine whether the type of the value at the specified index is the
+ * unsigned integer and is greater than or equal to the specified number.
  *
  * @param L lua state
  * @param idx index of the value
  * @param n value is greater than or equal to this number
- * @param def default value
- * @return lua_Number
  */
-static inline lua_Number lauxh_optnum_ge(lua_State *L, int idx, lua_Number n,
-                                         lua_Number def)
+static inline int lauxh_isuint_ge(lua_State *L, int idx, uintmax_t n)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checknum_ge(L, idx, n);
+    return lauxh_isuint(L, idx) && (uintmax_t)lua_tointeger(L, idx) >= n;
 }
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * number and is less than or equal to the specified number and returns it;
- * if it is nil, returns the specified default value, otherwise raises an error
- * report.
+ * @brief determine whether the type of the value at the specified index is the
+ * unsigned integer and is less than or equal to the specified number.
  *
  * @param L lua state
  * @param idx index of the value
  * @param n value is less than or equal to this number
- * @param def default value
- * @return lua_Number
  */
-static inline lua_Number lauxh_optnum_le(lua_State *L, int idx, lua_Number n,
-                                         lua_Number def)
+static inline int lauxh_isuint_le(lua_State *L, int idx, uintmax_t n)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checknum_le(L, idx, n);
+    return lauxh_isuint(L, idx) && (uintmax_t)lua_tointeger(L, idx) <= n;
 }
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * integer and is greater than or equal to the specified number and returns it;
- * if not, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * unsigned integer and is in the specified range of numbers.
  *
  * @param L lua state
  * @param idx index of the value
- * @param n value is greater than or equal to this number
- * @return lua_Integer
+ * @param min value is greater than or equal to this number
+ * @param max value is less than or equal to this number
  */
-static inline lua_Integer lauxh_checkint_ge(lua_State *L, int idx,
-                                            lua_Integer n)
+static inline int lauxh_isuint_in_range(lua_State *L, int idx, uintmax_t min,
+                                        uintmax_t max)
 {
-    CHECK_NUMTYPE_GLE(L, idx, "integer", "greater", lauxh_isint_ge, n, "%d");
-    return lua_tointeger(L, idx);
+    if (LAUXH_UNLIKELY(min > max)) {
+        luaL_error(L, "min %d must be less than or equal to max %d", min, max);
+    }
+    if (lauxh_isuint(L, idx)) {
+        uintmax_t v = (uintmax_t)lua_tointeger(L, idx);
+        return v >= min && v <= max;
+    }
+    return 0;
 }
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * integer and is less than or equal to the specified number and returns it;
- * if not, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * unsigned integer and is in the range of the `uint8_t` type. it is equivalent
+ * to the `lauxh_isuint_in_range(L, idx, 0, UINT8_MAX)`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param n value is less than or equal to this number
- * @return lua_Integer
  */
-static inline lua_Integer lauxh_checkint_le(lua_State *L, int idx,
-                                            lua_Integer n)
-{
-    CHECK_NUMTYPE_GLE(L, idx, "integer", "less", lauxh_isint_le, n, "%d");
-    return lua_tointeger(L, idx);
-}
+#define lauxh_isuint8(L, idx) lauxh_isuint_in_range((L), (idx), 0, UINT8_MAX)
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * integer and is greater than or equal to the specified number and returns it;
- * if it is nil, returns the specified default value, otherwise raises an error
- * report.
+ * @brief determine whether the type of the value at the specified index is the
+ * unsigned integer and is in the range of the `uint16_t` type. it is equivalent
+ * to the `lauxh_isuint_in_range(L, idx, 0, UINT16_MAX)`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param n value is greater than or equal to this number
- * @param def default value
- * @return lua_Integer
  */
-static inline lua_Integer lauxh_optint_ge(lua_State *L, int idx, lua_Integer n,
-                                          lua_Integer def)
-{
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkint_ge(L, idx, n);
-}
+#define lauxh_isuint16(L, idx) lauxh_isuint_in_range((L), (idx), 0, UINT16_MAX)
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * integer and is less than or equal to the specified number and returns it;
- * if it is nil, returns the specified default value, otherwise raises an error
- * report.
+ * @brief determine whether the type of the value at the specified index is the
+ * unsigned integer and is in the range of the `uint32_t` type. it is equivalent
+ * to the `lauxh_isuint_in_range(L, idx, 0, UINT32_MAX)`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param n value is less than or equal to this number
- * @param def default value
- * @return lua_Integer
  */
-static inline lua_Integer lauxh_optint_le(lua_State *L, int idx, lua_Integer n,
-                                          lua_Integer def)
-{
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkint_le(L, idx, n);
-}
+#define lauxh_isuint32(L, idx) lauxh_isuint_in_range((L), (idx), 0, UINT32_MAX)
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * finite number and is greater than or equal to the specified number and
- * returns it; if not, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * unsigned integer and is in the range of the `uint64_t` type. it is equivalent
+ * to the `lauxh_isuint_in_range(L, idx, 0, UINT64_MAX)`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param n value is greater than or equal to this number
- * @return lua_Number
  */
-static inline lua_Number lauxh_checkfinite_ge(lua_State *L, int idx,
-                                              lua_Number n)
-{
-    CHECK_NUMTYPE_GLE(L, idx, "finite number", "greater", lauxh_isfinite_ge, n,
-                      "%f");
-    return lua_tonumber(L, idx);
-}
+#define lauxh_isuint64(L, idx) lauxh_isuint_in_range((L), (idx), 0, UINT64_MAX)
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * finite number and is less than or equal to the specified number and returns
- * it; if not, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * positive integer.
  *
  * @param L lua state
  * @param idx index of the value
- * @param n value is less than or equal to this number
- * @return lua_Number
  */
-static inline lua_Number lauxh_checkfinite_le(lua_State *L, int idx,
-                                              lua_Number n)
+static inline int lauxh_ispint(lua_State *L, int idx)
 {
-    CHECK_NUMTYPE_GLE(L, idx, "finite number", "less", lauxh_isfinite_le, n,
-                      "%f");
-    return lua_tonumber(L, idx);
+    return lauxh_isint(L, idx) && lua_tointeger(L, idx) > 0;
 }
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * finite number and is greater than or equal to the specified number and
- * returns it; if it is nil, returns the specified default value, otherwise
- * raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * positive integer and is greater than or equal to the specified number.
  *
  * @param L lua state
  * @param idx index of the value
  * @param n value is greater than or equal to this number
- * @param def default value
- * @return lua_Number
  */
-static inline lua_Number lauxh_optfinite_ge(lua_State *L, int idx, lua_Number n,
-                                            lua_Number def)
+static inline int lauxh_ispint_ge(lua_State *L, int idx, uintmax_t n)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkfinite_ge(L, idx, n);
+    return lauxh_ispint(L, idx) && (uintmax_t)lua_tointeger(L, idx) >= n;
 }
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * finite number and is less than or equal to the specified number and returns
- * it; if it is nil, returns the specified default value, otherwise raises an
- * error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * positive integer and is less than or equal to the specified number.
  *
  * @param L lua state
  * @param idx index of the value
  * @param n value is less than or equal to this number
- * @param def default value
- * @return lua_Number
  */
-static inline lua_Number lauxh_optfinite_le(lua_State *L, int idx, lua_Number n,
-                                            lua_Number def)
+static inline int lauxh_ispint_le(lua_State *L, int idx, uintmax_t n)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkfinite_le(L, idx, n);
+    return lauxh_ispint(L, idx) && (uintmax_t)lua_tointeger(L, idx) <= n;
 }
 
-#undef CHECK_NUMTYPE_GLE
-
-#define CHECK_NUMTYPE_RANGE(L, idx, tname, isnumfn, min, max, mfmt)            \
-    do {                                                                       \
-        if (!isnumfn((L), (idx), (min), (max))) {                              \
-            int t = lua_type((L), (idx));                                      \
-            lua_pushfstring((L),                                               \
-                            tname " from " mfmt " to " mfmt " expected, ",     \
-                            (min), (max));                                     \
-            if (t != LUA_TNUMBER) {                                            \
-                lua_pushfstring((L), "got %s", lua_typename((L), t));          \
-            } else {                                                           \
-                lua_pushliteral((L), "got an out of range value");             \
-            }                                                                  \
-            lua_concat((L), 2);                                                \
-            lauxh_push_argerror((L), (idx), lua_tostring((L), -1));            \
-        }                                                                      \
-        lauxh_push_argerror_init();                                            \
-    } while (0)
-
 /**
- * @brief checks whether the type of the value at the specified index is the
- * number and is in the range of the specified numbers and returns it; if not,
- * raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * positive integer and is in the specified range of numbers.
  *
  * @param L lua state
  * @param idx index of the value
  * @param min value is greater than or equal to this number
  * @param max value is less than or equal to this number
- * @return lua_Number
  */
-static inline lua_Number lauxh_checknum_in_range(lua_State *L, int idx,
-                                                 lua_Number min, lua_Number max)
+static inline int lauxh_ispint_in_range(lua_State *L, int idx, uintmax_t min,
+                                        uintmax_t max)
 {
-    CHECK_NUMTYPE_RANGE(L, idx, "number", lauxh_isnum_in_range, min, max, "%f");
-    return lua_tonumber(L, idx);
+    if (LAUXH_UNLIKELY(min > max)) {
+        luaL_error(L, "min %d must be less than or equal to max %d", min, max);
+    }
+    if (lauxh_ispint(L, idx)) {
+        uintmax_t v = (uintmax_t)lua_tointeger(L, idx);
+        return v >= min && v <= max;
+    }
+    return 0;
 }
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * number and is in the range of the specified numbers and returns it; if it is
- * nil, returns the specified default value, otherwise raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * positive integer and is in the range of the `uint8_t` type. it is equivalent
+ * to the `lauxh_ispint_in_range(L, idx, 0, UINT8_MAX)`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param min value is greater than or equal to this number
- * @param max value is less than or equal to this number
- * @param def default value
- * @return lua_Number
  */
-static inline lua_Number lauxh_optnum_in_range(lua_State *L, int idx,
-                                               lua_Number min, lua_Number max,
-                                               lua_Number def)
-{
-    if (!isfinite(min) || !isfinite(max) || min > max) {
-        luaL_error(L,
-                   "min and max must be finite numbers, and min %f must be "
-                   "less than or equal to max %f",
-                   min, max);
-    }
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checknum_in_range(L, idx, min, max);
-}
+#define lauxh_ispint8(L, idx) lauxh_ispint_in_range((L), (idx), 0, UINT8_MAX)
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * integer and is in the range of the specified numbers and returns it; if not,
- * raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * positive integer and is in the range of the `uint16_t` type. it is equivalent
+ * to the `lauxh_ispint_in_range(L, idx, 0, UINT16_MAX)`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param min value is greater than or equal to this number
- * @param max value is less than or equal to this number
- * @return lua_Integer
  */
-static inline lua_Integer lauxh_checkint_in_range(lua_State *L, int idx,
-                                                  lua_Integer min,
-                                                  lua_Integer max)
-{
-    CHECK_NUMTYPE_RANGE(L, idx, "integer", lauxh_isint_in_range, min, max,
-                        "%d");
-    return lua_tointeger(L, idx);
-}
+#define lauxh_ispint16(L, idx) lauxh_ispint_in_range((L), (idx), 0, UINT16_MAX)
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * integer and is in the range of the specified numbers and returns it; if it is
- * nil, returns the specified default value, otherwise raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * positive integer and is in the range of the `uint32_t` type. it is equivalent
+ * to the `lauxh_ispint_in_range(L, idx, 0, UINT32_MAX)`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param min value is greater than or equal to this number
- * @param max value is less than or equal to this number
- * @param def default value
- * @return lua_Integer
  */
-static inline lua_Integer lauxh_optint_in_range(lua_State *L, int idx,
-                                                lua_Integer min,
-                                                lua_Integer max,
-                                                lua_Integer def)
-{
-    if (min > max) {
-        luaL_error(L, "min %d must be less than or equal to max %d", min, max);
-    }
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
-    }
-    return lauxh_checkint_in_range(L, idx, min, max);
-}
+#define lauxh_ispint32(L, idx) lauxh_ispint_in_range((L), (idx), 0, UINT32_MAX)
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * finite number and is in the range of the specified numbers and returns it; if
- * not, raises an error report.
+ * @brief determine whether the type of the value at the specified index is the
+ * positive integer and is in the range of the `uint64_t` type. it is equivalent
+ * to the `lauxh_ispint_in_range(L, idx, 0, UINT64_MAX)`.
  *
  * @param L lua state
  * @param idx index of the value
- * @param min value is greater than or equal to this number
- * @param max value is less than or equal to this number
- * @return lua_Number
  */
-static inline lua_Number lauxh_checkfinite_in_range(lua_State *L, int idx,
-                                                    lua_Number min,
-                                                    lua_Number max)
-{
-    CHECK_NUMTYPE_RANGE(L, idx, "finite number", lauxh_isfinite_in_range, min,
-                        max, "%f");
-    return lua_tonumber(L, idx);
-}
+#define lauxh_ispint64(L, idx) lauxh_ispint_in_range((L), (idx), 0, UINT64_MAX)
 
 /**
- * @brief checks whether the type of the value at the specified index is the
- * finite number and is in the range of the specified numbers and returns it; if
- * it is nil, returns the specified default value, otherwise raises an error
- * report.
+ * NOTE: for the value checking.
+ */
+
+/**
+ * @warning DO NOT USE THIS MACRO DIRECTLY.
+ */
+#if defined(LAUXHLIB_USED_IN_LUA)
+
+/**
+ * the argument error context is held in the thread-local storage, so the
+ * states running on the different threads do not share it. the context is
+ * reset only if it has been changed, so the success path of the check
+ * functions does not write to it.
+ */
+# if defined(__cplusplus) && __cplusplus >= 201103L
+#  define LAUXH_TLS thread_local
+# elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L &&            \
+     !defined(__STDC_NO_THREADS__)
+#  define LAUXH_TLS _Thread_local
+# elif defined(__GNUC__)
+#  define LAUXH_TLS __thread
+# elif defined(_MSC_VER)
+#  define LAUXH_TLS __declspec(thread)
+# else
+#  define LAUXH_TLS
+# endif
+
+typedef struct {
+    const char *name;
+    int index;
+    int stack;
+} lauxh_argerr_t;
+
+static LAUXH_TLS lauxh_argerr_t LAUXH_ARGERR = {NULL, 0, 1};
+
+# define LAUXH_ARGERR_NAME  (LAUXH_ARGERR.name)
+# define LAUXH_ARGERR_INDEX (LAUXH_ARGERR.index)
+# define LAUXH_ARGERR_STACK (LAUXH_ARGERR.stack)
+
+# define lauxh_push_argerror_init()                                            \
+     do {                                                                      \
+         if (LAUXH_UNLIKELY(LAUXH_ARGERR.name || LAUXH_ARGERR.index ||         \
+                            LAUXH_ARGERR.stack != 1)) {                        \
+             LAUXH_ARGERR.name  = NULL;                                        \
+             LAUXH_ARGERR.index = 0;                                           \
+             LAUXH_ARGERR.stack = 1;                                           \
+         }                                                                     \
+     } while (0)
+
+/**
+ * @brief raises an error reporting a problem with the argument at the specified
+ * index.
  *
  * @param L lua state
- * @param idx index of the value
- * @param min value is greater than or equal to this number
- * @param max value is less than or equal to this number
- * @param def default value
- * @return lua_Number
+ * @param arg index of the argument
+ * @param extra extra error message
+ * @return int 1 if true, otherwise 0.
  */
-static inline lua_Number lauxh_optfinite_in_range(lua_State *L, int idx,
-                                                  lua_Number min,
-                                                  lua_Number max,
-                                                  lua_Number def)
+static LAUXH_COLD LAUXH_NOINLINE int
+lauxh_push_argerror(lua_State *L, int arg, const char *extra)
 {
-    if (!isfinite(min) || !isfinite(max) || min > max) {
-        luaL_error(L,
-                   "min and max must be finite numbers, and min %f must be "
-                   "less than or equal to max %f",
-                   min, max);
-    }
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
+    //
+    // NOTE: porting from lua source code
+    // https://github.com/lua/lua/blob/master/lauxlib.c
+    //
+    lua_Debug ar     = {};
+    int stack        = LAUXH_ARGERR_STACK;
+    const char *name = NULL;
+
+    LAUXH_ARGERR_STACK = 1;
+    if (LAUXH_ARGERR_NAME) {
+        name = lua_pushfstring(L, "'%s'", LAUXH_ARGERR_NAME);
+    } else if (LAUXH_ARGERR_INDEX > 0) {
+        name = lua_pushfstring(L, "#%d", LAUXH_ARGERR_INDEX);
+    } else {
+        name = lua_pushfstring(L, "#%d", arg);
     }
-    return lauxh_checkfinite_in_range(L, idx, min, max);
-}
+    LAUXH_ARGERR_NAME  = NULL;
+    LAUXH_ARGERR_INDEX = 0;
 
-#undef CHECK_NUMTYPE_RANGE
+    if (!lua_getstack(L, stack, &ar)) { // no stack frame?
+        return luaL_error(L, "bad argument %s (%s)", name, extra);
+    }
 
-/* treat integer arguments as bit flags  */
+    lua_getinfo(L, "n", &ar);
+    return luaL_error(L, "bad argument %s to '%s' (%s)", name,
+                      (ar.name == NULL) ? "?" : ar.name, extra);
+}
 
-static inline uint64_t lauxh_optflags(lua_State *L, int idx)
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static LAUXH_COLD LAUXH_NOINLINE int
+lauxh_typeerror(lua_State *L, int arg, int t)
 {
-    const int argc = lua_gettop(L);
-    uint64_t flg   = 0;
-
-    for (; idx <= argc; idx++) {
-        flg |= lauxh_optuint64(L, idx, 0);
+    //
+    // NOTE: porting from lua source code
+    // https://github.com/lua/lua/blob/master/lauxlib.c
+    //
+    const char *tname    = lua_typename(L, t);
+    const char *extramsg = NULL;
+    const char *typearg; // name for the type of the actual argument
+
+    if (luaL_getmetafield(L, arg, "__name") == LUA_TSTRING) {
+        typearg = lua_tostring(L, -1); // use the given type name
+    } else if (lua_type(L, arg) == LUA_TLIGHTUSERDATA) {
+        typearg = "light userdata"; // special name for messages
+    } else {
+        typearg = luaL_typename(L, arg); // standard name
     }
 
-    return flg;
+    extramsg = lua_pushfstring(L, "%s expected, got %s", tname, typearg);
+    return lauxh_push_argerror(L, arg, extramsg);
 }
 
 /**
- * @brief checks whether the value at the specified index is the table; if not,
- * raises an error report.
+ * @brief raises an error reporting a problem if the argument at the specified
+ * index is not the specified type.
  *
  * @param L lua state
- * @param idx index of the value
+ * @param arg index of the argument
+ * @param t type of the argument (LUA_TXXX)
  */
-static inline void lauxh_checktable(lua_State *L, int idx)
+static inline void lauxh_checktype(lua_State *L, int arg, int t)
 {
-    lauxh_checktype(L, idx, LUA_TTABLE);
+    if (LAUXH_UNLIKELY(lua_type(L, arg) != t)) {
+        lauxh_typeerror(L, arg, t);
+    }
+    lauxh_push_argerror_init();
 }
 
+#else
+
+# define lauxh_push_argerror_init()
+# define lauxh_push_argerror luaL_argerror
+# define lauxh_checktype     luaL_checktype
+
+#endif
+
 /**
- * @brief checks whether the value at the specified index is the table and
- * returns it index; if it is nil, returns the specified default value,
- * otherwise raises an error report.
+ * @brief raises an error reporting a problem.
  *
  * @param L lua state
- * @param idx index of the value
- * @param def default value
- * @return int index of the table
+ * @param idx index of the argument
+ * @param fmt format string for the extra error message
+ * @param ... arguments for the format string
  */
-static inline int lauxh_opttable(lua_State *L, int idx, int def)
+static LAUXH_COLD LAUXH_NOINLINE int
+lauxh_argerror(lua_State *L, int idx, const char *fmt, ...)
 {
-    if (lauxh_isnil(L, idx)) {
-        lauxh_push_argerror_init();
-        return def;
+    char buf[255];
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(buf, 255, fmt, ap);
+    va_end(ap);
+
+    if (idx < 0) {
+        idx = lua_gettop(L) + idx + 1;
     }
-    lauxh_checktable(L, idx);
-    return idx;
+
+    return lauxh_push_argerror(L, idx, buf);
 }
 
 /**
- * NOTE: for table accessors
+ * @brief if the condition is not true, raises an error reporting the problem
+ * with an error message.
+ *
+ * @param L lua state
+ * @param cond condition
+ * @param idx index of the argument
+ * @param fmt format string for the extra error message
+ * @param ... arguments for the format string
  */
+#define lauxh_argcheck(L, cond, idx, fmt, ...)                                 \
+    do {                                                                       \
+        if (LAUXH_UNLIKELY(!(cond))) {                                         \
+            lauxh_argerror((L), (idx), (fmt), ##__VA_ARGS__);                  \
+        }                                                                      \
+        lauxh_push_argerror_init();                                            \
+    } while (0)
 
 /**
- * @brief checks whether the value at the specified key of the table at the
- * specified index is the table; if not, raises an error report.
+ * @brief checks whether the value at the specified index is luaL_Stream*
+ * (userdata that has the metatable of the `LUA_FILEHANDLE`) and returns a
+ * pointer of the FILE*; if not, raises an error.
  *
  * @param L lua state
- * @param idx index of the table
- * @param k key of the value
+ * @param idx index of the value
+ * @return FILE**
  */
-static inline void lauxh_checktableof(lua_State *L, int idx, const char *k)
+static inline FILE **lauxh_checkfilep(lua_State *L, int idx)
 {
-    lua_pushstring(L, k);
-    lua_rawget(L, idx);
-    lauxh_checktable(L, -1);
-}
+    lauxh_argcheck(L, lauxh_isfile(L, idx), idx,
+                   LUA_FILEHANDLE " expected, got %s", luaL_typename(L, idx));
 
-#define CHECK_VALUE_OF_KEY_IN_TABLE(tblidx, key, vtype, checkfn, ...)          \
-    do {                                                                       \
-        vtype v;                                                               \
-        lua_pushstring(L, (key));                                              \
-        lua_rawget(L, (tblidx));                                               \
-        v = checkfn(L, -1, ##__VA_ARGS__);                                     \
-        lua_pop(L, 1);                                                         \
-        return v;                                                              \
-    } while (0)
+#if LUA_VERSION_NUM >= 502
+    luaL_Stream *stream = (luaL_Stream *)lua_touserdata(L, idx);
+    return &stream->f;
+
+#else
+    return (FILE **)lua_touserdata(L, idx);
+#endif
+}
 
 /**
- * @brief checks whether the value at the specified key of the table at the
- * specified index is the string and returns it; if not, raises an error
- * report.
+ * @brief same as `lauxh_checkfilep()`, but returns a pointer of the FILE.
  *
  * @param L lua state
- * @param idx index of the table
- * @param k key of the value
- * @param[out] len length of the value
- * @return const char* pointer to the string
+ * @param idx index of the value
+ * @return FILE* pointer to the FILE
  */
-static inline const char *lauxh_checklstringof(lua_State *L, int idx,
-                                               const char *k, size_t *len)
+static inline FILE *lauxh_checkfile(lua_State *L, int idx)
 {
-    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, const char *, lauxh_checklstr, len);
+    return *lauxh_checkfilep(L, idx);
 }
 
 /**
- * @brief checks whether the value at the specified key of the table at the
- * specified index is the string and returns it; if it is nil, returns the
- * specified default value, otherwise raises an error report.
+ * @brief checks whether the value at the specified index is luaL_Stream*
+ * (userdata that has the metatable of the `LUA_FILEHANDLE`) and returns a
+ * pointer of the FILE*; if it is nil, returns the specified default value,
+ * otherwise raises an error.
  *
  * @param L lua state
- * @param idx index of the table
- * @param k key of the value
+ * @param idx index of the value
  * @param def default value
- * @param[out] len length of the value
- * @return const char* pointer to the string
+ * @return FILE*
  */
-static inline const char *lauxh_optlstringof(lua_State *L, int idx,
-                                             const char *k, const char *def,
-                                             size_t *len)
+static inline FILE *lauxh_optfile(lua_State *L, int idx, FILE *def)
 {
-    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, const char *, lauxh_optlstr, def, len);
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkfile(L, idx);
 }
 
 /**
- * @brief checks whether the value at the specified key of the table at the
- * specified index is the string and returns it; if not, raises an error report.
+ * @brief checks whether the value at the specified index is a callable object.
+ * if not, raises an error.
  *
  * @param L lua state
- * @param idx index of the table
- * @param k key of the value
- * @return const char* pointer to the string
+ * @param idx index of the value
  */
-static inline const char *lauxh_checkstringof(lua_State *L, int idx,
-                                              const char *k)
+static inline void lauxh_checkcallable(lua_State *L, int idx)
 {
-    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, const char *, lauxh_checkstr);
+    lauxh_argcheck(L, lauxh_iscallable(L, idx), idx,
+                   "callable object expected, got %s", luaL_typename(L, idx));
 }
 
 /**
- * @brief checks whether the value at the specified key of the table at the
- * specified index is the string and returns it; if it is nil, returns the
- * specified default value, otherwise raises an error report.
+ * @brief checks whether the value at the specified index is a callable object
+ * and returns its index; if it is nil, returns the specified default value,
+ * otherwise raises an error.
  *
  * @param L lua state
- * @param idx index of the table
- * @param k key of the value
+ * @param idx index of the value
  * @param def default value
- * @return const char* pointer to the string
+ * @return int index of the callable object
  */
-static inline const char *lauxh_optstringof(lua_State *L, int idx,
-                                            const char *k, const char *def)
+static inline int lauxh_optcallable(lua_State *L, int idx, int def)
 {
-    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, const char *, lauxh_optstr, def);
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    lauxh_checkcallable(L, idx);
+    return idx;
 }
 
 /**
- * @brief checks whether the value at the specified key of the table at the
- * specified index is the number and returns it; if not, raises an error report.
+ * @brief checks whether the value at the specified index is a function; if not,
+ * raises an error.
  *
  * @param L lua state
- * @param idx index of the table
- * @param k key of the value
- * @return lua_Number
+ * @param idx index of the value
  */
-static inline lua_Number lauxh_checknumberof(lua_State *L, int idx,
-                                             const char *k)
+static inline void lauxh_checkfunc(lua_State *L, int idx)
 {
-    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, lua_Number, lauxh_checknum);
+    lauxh_checktype(L, idx, LUA_TFUNCTION);
 }
 
 /**
- * @brief checks whether the value at the specified key of the table at the
- * specified index is the number and returns it; if it is nil, returns the
- * specified default value, otherwise raises an error report.
+ * @brief alias of the `lauxh_checkfunc()`.
+ */
+#define lauxh_checkfunction(L, idx) lauxh_checkfunc((L), (idx))
+
+/**
+ * @brief checks whether the value at the specified index is a function and
+ * returns its index; if it is nil, returns the specified default value,
+ * otherwise raises an error.
  *
  * @param L lua state
- * @param idx index of the table
- * @param k key of the value
+ * @param idx index of the value
  * @param def default value
- * @return lua_Number
+ * @return int index of the function
  */
-static inline lua_Number lauxh_optnumberof(lua_State *L, int idx, const char *k,
-                                           lua_Number def)
+static inline int lauxh_optfunc(lua_State *L, int idx, int def)
 {
-    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, lua_Number, lauxh_optnum, def);
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    lauxh_checkfunc(L, idx);
+    return idx;
 }
 
 /**
- * @brief checks whether the value at the specified key of the table at the
- * specified index is the integer and returns it; if not, raises an error
- * report.
+ * @brief checks whether the value at the specified index is a lua_CFunction and
+ * returns it; if it is not a lua_CFunction, raises an error report.
  *
  * @param L lua state
- * @param idx index of the table
- * @param k key of the value
- * @return lua_Integer
+ * @param idx index of the value
+ * @return lua_CFunction
  */
-static inline lua_Integer lauxh_checkintegerof(lua_State *L, int idx,
-                                               const char *k)
+static inline lua_CFunction lauxh_checkcfunc(lua_State *L, int idx)
 {
-    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, lua_Integer, lauxh_checkint);
+    lauxh_argcheck(L, lua_iscfunction(L, idx), idx,
+                   "cfunction expected, got %s", luaL_typename(L, idx));
+    return lua_tocfunction(L, idx);
 }
 
 /**
- * @brief checks whether the value at the specified key of the table at the
- * specified index is the integer and returns it; if it is nil, returns the
- * specified default value, otherwise raises an error report.
+ * @brief alias of the `lauxh_checkcfunc()`.
+ */
+#define lauxh_checkcfunction(L, idx) lauxh_checkcfunc((L), (idx))
+
+/**
+ * @brief checks whether the value at the specified index is a lua_CFunction and
+ * returns it; if it is nil, returns the specified default value, otherwise
+ * raises an error.
  *
  * @param L lua state
- * @param idx index of the table
- * @param k key of the value
+ * @param idx index of the value
  * @param def default value
- * @return lua_Integer
+ * @return lua_CFunction
  */
-static inline lua_Integer lauxh_optintegerof(lua_State *L, int idx,
-                                             const char *k, lua_Integer def)
+static inline lua_CFunction lauxh_optcfunc(lua_State *L, int idx,
+                                           lua_CFunction def)
 {
-    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, lua_Integer, lauxh_optint, def);
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkcfunc(L, idx);
 }
 
 /**
- * @brief checks whether the value at the specified key of the table at the
- * specified index is the boolean and returns it; if not, raises an error
- * report.
+ * @brief checks whether the value at the specified index is a thread and
+ * returns it; if it is not a thread, raises an error report.
  *
- * @param L  lua state
- * @param idx index of the table
- * @param k key of the value
- * @return int 1 if true, otherwise 0
+ * @param L lua state
+ * @param idx index of the value
  */
-static inline int lauxh_checkbooleanof(lua_State *L, int idx, const char *k)
+static inline lua_State *lauxh_checkthread(lua_State *L, int idx)
 {
-    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, int, lauxh_checkbool);
+    lauxh_checktype(L, idx, LUA_TTHREAD);
+    return lua_tothread(L, idx);
 }
 
 /**
- * @brief checks whether the value at the specified key of the table at the
- * specified index is the boolean and returns it; if it is nil, returns the
- * specified default value, otherwise raises an error report.
+ * @brief checks whether the value at the specified index is a thread and
+ * returns it; if it is nil, returns the specified default value, otherwise
+ * raises an error.
  *
  * @param L lua state
- * @param idx index of the table
- * @param k key of the value
+ * @param idx index of the value
  * @param def default value
- * @return int 1 if true, otherwise 0
+ * @return lua_State*
  */
-static inline int lauxh_optbooleanof(lua_State *L, int idx, const char *k,
-                                     int def)
+static inline lua_State *lauxh_optthread(lua_State *L, int idx, lua_State *def)
 {
-    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, int, lauxh_optbool, def);
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkthread(L, idx);
 }
 
-#undef CHECK_VALUE_OF_KEY_IN_TABLE
-
 /**
- * @brief checks whether the value at the specified array index of the table at
- * the specified index is the table; if not, raises an error report.
+ * @brief checks whether the value at the specified index is a light userdata
+ * and returns it; if it is not a light userdata, raises an error report.
  *
- * @note the value is placed on the top of the stack.
  * @param L lua state
- * @param idx index of the table
- * @param row array index of the value
+ * @param idx index of the value
+ * @return const void* pointer to the light userdata
  */
-static inline void lauxh_checktableat(lua_State *L, int idx, int row)
+static inline const void *lauxh_checkpointer(lua_State *L, int idx)
 {
-    lua_rawgeti(L, idx, row);
-    lauxh_checktable(L, -1);
+    lauxh_checktype(L, idx, LUA_TLIGHTUSERDATA);
+    return lua_topointer(L, idx);
 }
 
-#define CHECK_VALUE_OF_IDX_IN_TABLE(tblidx, idx, vtype, checkfn, ...)          \
-    do {                                                                       \
-        vtype v;                                                               \
-        lua_rawgeti(L, (tblidx), (idx));                                       \
-        v = checkfn(L, -1, ##__VA_ARGS__);                                     \
-        lua_pop(L, 1);                                                         \
-        return v;                                                              \
-    } while (0)
-
 /**
- * @brief checks whether the value at the specified array index of the table at
- * the specified index is the string and returns it; if not, raises an error
- * report.
+ * @brief checks whether the value at the specified index is a light userdata
+ * and returns it; if it is nil, returns the specified default value, otherwise
+ * raises an error.
  *
  * @param L lua state
- * @param idx index of the table
- * @param row array index of the value
- * @param[out] len length of the value
- * @return const char* pointer to the string
+ * @param idx index of the value
+ * @param def default value
+ * @return const void* pointer to the light userdata
  */
-static inline const char *lauxh_checklstringat(lua_State *L, int idx, int row,
-                                               size_t *len)
+static inline const void *lauxh_optpointer(lua_State *L, int idx,
+                                           const void *def)
 {
-    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, const char *, lauxh_checklstr, len);
-}
-
-/**
- * @brief checks whether the value at the specified array index of the table at
- * the specified index is the string and returns it; if it is nil, returns the
- * specified default value, otherwise raises an error report.
- *
- * @param L lua state
- * @param idx index of the table
- * @param row array index of the value
- * @param def default value
- * @param[out] len length of the value
- * @return const char* pointer to the string
- */
-static inline const char *lauxh_optlstringat(lua_State *L, int idx, int row,
-                                             const char *def, size_t *len)
-{
-    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, const char *, lauxh_optlstr, def,
-                                len);
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkpointer(L, idx);
 }
 
 /**
- * @brief checks whether the value at the specified array index of the table at
- * the specified index is the string and returns it; if not, raises an error
- * report.
+ * @brief checks whether the value at the specified index is a userdata and
+ * returns it; if it is not a userdata, raises an error report.
  *
  * @param L lua state
- * @param idx index of the table
- * @param row array index of the value
- * @return const char* pointer to the string
+ * @param idx index of the value
+ * @return void* pointer to the userdata
  */
-static inline const char *lauxh_checkstringat(lua_State *L, int idx, int row)
+static inline void *lauxh_checkuserdata(lua_State *L, int idx)
 {
-    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, const char *, lauxh_checkstr);
+    lauxh_checktype(L, idx, LUA_TUSERDATA);
+    return lua_touserdata(L, idx);
 }
 
 /**
- * @brief checks whether the value at the specified array index of the table at
- * the specified index is the string and returns it; if it is nil, returns the
- * specified default value, otherwise raises an error report.
+ * @brief checks whether the value at the specified index is a userdata and
+ * returns it; if it is nil, returns the specified default value, otherwise
+ * raises an error.
  *
  * @param L lua state
- * @param idx index of the table
- * @param row array index of the value
+ * @param idx index of the value
  * @param def default value
- * @return const char* pointer to the string
+ * @return void* pointer to the userdata
  */
-static inline const char *lauxh_optstringat(lua_State *L, int idx, int row,
-                                            const char *def)
+static inline void *lauxh_optuserdata(lua_State *L, int idx, void *def)
 {
-    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, const char *, lauxh_optstr, def);
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkuserdata(L, idx);
 }
 
 /**
- * @brief checks whether the value at the specified array index of the table at
- * the specified index is the number and returns it; if not, raises an error
+ * @brief checks whether the value at the specified index is a userdata that has
+ * the metatable of the specified name and returns it; if not, raises an error
  * report.
  *
  * @param L lua state
- * @param idx index of the table
- * @param row array index of the value
- * @return lua_Number
+ * @param idx index of the value
+ * @param tname metatable name
+ * @return void* pointer to userdata
  */
-static inline lua_Number lauxh_checknumberat(lua_State *L, int idx, int row)
+static inline void *lauxh_checkudata(lua_State *L, int idx, const char *tname)
 {
-    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, lua_Number, lauxh_checknum);
+    return luaL_checkudata(L, idx, tname);
 }
 
 /**
- * @brief checks whether the value at the specified array index of the table at
- * the specified index is the number and returns it; if it is nil, returns the
- * specified default value, otherwise raises an error report.
+ * @brief checks whether the value at the specified index is a userdata that has
+ * the metatable of the specified name and returns it; if it is nil, returns the
+ * specifed default value, otherwise raises an error report.
  *
  * @param L lua state
- * @param idx index of the table
- * @param row array index of the value
+ * @param idx index of the value
+ * @param tname metatable name
  * @param def default value
- * @return lua_Number
+ * @return void* pointer to userdata
  */
-static inline lua_Number lauxh_optnumberat(lua_State *L, int idx, int row,
-                                           lua_Number def)
+static inline void *lauxh_optudata(lua_State *L, int idx, const char *tname,
+                                   void *def)
 {
-    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, lua_Number, lauxh_optnum, def);
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+
+    return lauxh_checkudata(L, idx, tname);
 }
 
 /**
- * @brief checks whether the value at the specified array index of the table at
- * the specified index is the integer and returns it; if not, raises an error
- * report.
+ * @brief checks whether the value at the specified index is a userdata that has
+ * the metatable of the specified pointer and returns it; if not, raises an
+ * error report.
  *
  * @param L lua state
- * @param idx index of the table
- * @param row array index of the value
- * @return lua_Integer
+ * @param idx index of the value
+ * @param mt pointer of the metatable
+ * @param tname metatable name used in the error message
+ * @return void* pointer to userdata
  */
-static inline lua_Integer lauxh_checkintegerat(lua_State *L, int idx, int row)
+static inline void *lauxh_checkudataptr(lua_State *L, int idx, const void *mt,
+                                        const char *tname)
 {
-    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, lua_Integer, lauxh_checkint);
+    lauxh_argcheck(L, lauxh_isuserdataptr(L, idx, mt), idx,
+                   "%s expected, got %s", tname, luaL_typename(L, idx));
+    return lua_touserdata(L, idx);
 }
 
 /**
- * @brief checks whether the value at the specified array index of the table at
- * the specified index is the integer and returns it; if it is nil, returns the
- * specified default value, otherwise raises an error report.
+ * @brief equivalent to `lauxh_checkudataptr()` with the pointer of the
+ * metatable that is held in the first upvalue of the running function by
+ * `lauxh_setfuncs_mtptr()`.
  *
  * @param L lua state
- * @param idx index of the table
- * @param row array index of the value
- * @param def default value
- * @return lua_Integer
+ * @param idx index of the value
+ * @param tname metatable name used in the error message
+ * @return void* pointer to userdata
  */
-static inline lua_Integer lauxh_optintegerat(lua_State *L, int idx, int row,
-                                             lua_Integer def)
-{
-    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, lua_Integer, lauxh_optint, def);
-}
+#define lauxh_checkudataupv(L, idx, tname)                                     \
+    lauxh_checkudataptr((L), (idx), lua_touserdata((L), lua_upvalueindex(1)),  \
+                        (tname))
 
 /**
- * @brief checks whether the value at the specified array index of the table at
- * the specified index is the boolean and returns it; if not, raises an error
- * report.
+ * @brief checks whether the value at the specified index is a userdata that has
+ * the metatable of the specified pointer and returns it; if it is nil, returns
+ * the specifed default value, otherwise raises an error report.
  *
- * @param L  lua state
- * @param idx index of the table
- * @param row array index of the value
- * @return int 1 if true, otherwise 0
+ * @param L lua state
+ * @param idx index of the value
+ * @param mt pointer of the metatable
+ * @param tname metatable name used in the error message
+ * @param def default value
+ * @return void* pointer to userdata
  */
-static inline int lauxh_checkbooleanat(lua_State *L, int idx, int row)
+static inline void *lauxh_optudataptr(lua_State *L, int idx, const void *mt,
+                                      const char *tname, void *def)
 {
-    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, int, lauxh_checkbool);
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+
+    return lauxh_checkudataptr(L, idx, mt, tname);
 }
 
 /**
- * @brief checks whether the value at the specified array index of the table at
- * the specified index is the boolean and returns it; if it is nil, returns the
- * specified default value, otherwise raises an error report.
+ * NOTE: for the typed userdata
  *
- * @param L lua state
- * @param idx index of the table
- * @param row array index of the value
- * @param def default value
- * @return int 1 if true, otherwise 0
+ * the userdata allocated by the `lauxh_newudtype()` carries a header that
+ * holds the magic value and the numeric type ids of the type and its base
+ * types. the type of the userdata can be verified by comparing the ids in the
+ * header without fetching the metatable or accessing the registry.
+ *
+ *  static const lauxh_udtype_t BASE_TYPE = {"my.base", 1, NULL};
+ *  static const lauxh_udtype_t DERIVED_TYPE = {"my.derived", 2, &BASE_TYPE};
+ *
+ *  derived_t *p = lauxh_newudtype(L, &DERIVED_TYPE, sizeof(derived_t));
+ *  // true
+ *  lauxh_isudtype(L, -1, &BASE_TYPE);
+ *
+ * the header does not hold any pointer, so the userdata created by other
+ * modules is never dereferenced even if its leading bytes match the magic
+ * value.
  */
-static inline int lauxh_optbooleanat(lua_State *L, int idx, int row, int def)
-{
-    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, int, lauxh_optbool, def);
-}
 
-#undef CHECK_VALUE_OF_IDX_IN_TABLE
+typedef struct lauxh_udtype_st {
+    // metatable name
+    const char *tname;
+    // numeric type id
+    uint32_t id;
+    // base type, or NULL
+    const struct lauxh_udtype_st *base;
+} lauxh_udtype_t;
+
+#define LAUXH_UDTYPE_MAGIC 0x6c617578
+
+// maximum number of the base types of the type
+#define LAUXH_UDTYPE_MAXDEPTH 16
 
 /**
- * NOTE: helper functions
+ * the header is followed by the `depth + 1` type ids from the root type to the
+ * type itself, and the whole header is padded to the multiple of 16 bytes.
  */
+typedef struct {
+    uint32_t magic;
+    // number of the base types
+    uint32_t depth;
+} lauxh_udhdr_t;
+
+#define LAUXH_UDHDR_SIZE(depth)                                                \
+    ((sizeof(lauxh_udhdr_t) + sizeof(uint32_t) * ((size_t)(depth) + 1) + 15) & \
+     ~(size_t)15)
 
 /**
- * @brief get a file descriptor from the file handle at the specified index. if
- * FILE* is NULL, returns -1, or if it is not a file handle, raises an error
- * report.
- *
- * @param L lua state
- * @param idx index of the file handle
- * @return int file descriptor
+ * @brief get the number of the base types of the type.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  */
-static inline int lauxh_fileno(lua_State *L, int idx)
+static inline uint32_t lauxh_udtype_depth(const lauxh_udtype_t *type)
 {
-    FILE *f = lauxh_checkfile(L, idx);
-    if (f) {
-        return fileno(f);
+    uint32_t depth = 0;
+
+    for (type = type->base; type; type = type->base) {
+        depth++;
     }
-    return -1;
+    return depth;
 }
 
 /**
- * @brief create a new file handle from the file descriptor and push it to the
- * top of the stack, and returns the FILE*. if failed, places nil, error message
- * and errno on the top of the stack and returns NULL.
- *
- * @param L lua state
- * @param fd file descriptor
- * @param mode mode string passed to fdopen()
- * @param fname file name if not NULL, create a file in fname
- * @return FILE*
+ * @brief get the header of the userdata created by the `lauxh_newudtype()`.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
  */
-static inline FILE *lauxh_tofile(lua_State *L, int fd, const char *mode,
-                                 const char *fname)
+static inline const lauxh_udhdr_t *lauxh_udhdrof(lua_State *L, int idx)
 {
-    int top    = lua_gettop(L);
-    FILE *fp   = NULL;
-    FILE **lfp = NULL;
-    int narg   = 0;
-
-    // push a function to create a file handle
-    if (fname) {
-        static int tofile_open_ref = LUA_NOREF;
-
-        if (tofile_open_ref == LUA_NOREF) {
-            luaL_loadstring(L, "return io.open(...)");
-            tofile_open_ref = lauxh_ref(L);
-        }
-        lauxh_pushref(L, tofile_open_ref);
-        lua_pushstring(L, fname);
-        lua_pushstring(L, mode);
-        narg = 2;
-    } else {
-        static int tofile_tmpfile_ref = LUA_NOREF;
+    if (lauxh_isuserdata(L, idx)) {
+        const lauxh_udhdr_t *hdr =
+            (const lauxh_udhdr_t *)lua_touserdata(L, idx);
+        size_t len = lauxh_rawlen(L, idx);
 
-        if (tofile_tmpfile_ref == LUA_NOREF) {
-            luaL_loadstring(L, "return io.tmpfile()");
-            tofile_tmpfile_ref = lauxh_ref(L);
+        // the ids must be in the memory block of the userdata
+        if (len >= sizeof(lauxh_udhdr_t) && hdr->magic == LAUXH_UDTYPE_MAGIC &&
+            hdr->depth <= LAUXH_UDTYPE_MAXDEPTH &&
+            len >= LAUXH_UDHDR_SIZE(hdr->depth)) {
+            return hdr;
         }
-        lauxh_pushref(L, tofile_tmpfile_ref);
     }
+    return NULL;
+}
 
-    // call function
-    if (lua_pcall(L, narg, LUA_MULTRET, 0) != 0) {
-        // runtime error
-        lua_pushnil(L);
-        lua_insert(L, top + 1);
-        return NULL;
-    } else if (lua_gettop(L) - top != 1) {
-        // got error
-        return NULL;
-    }
+/**
+ * @brief create a new userdata of the specified type and push it onto the
+ * stack. if the metatable of the `type->tname` is registered, it is set to the
+ * userdata. raises an error if the type has more than `LAUXH_UDTYPE_MAXDEPTH`
+ * base types.
+ *
+ * @param L lua state
+ * @param type type descriptor
+ * @param size size of the userdata
+ * @return void* pointer to the userdata
+ */
+static inline void *lauxh_newudtype(lua_State *L, const lauxh_udtype_t *type,
+                                    size_t size)
+{
+    const char *tname  = type->tname;
+    uint32_t depth     = lauxh_udtype_depth(type);
+    size_t hsize       = 0;
+    lauxh_udhdr_t *hdr = NULL;
+    uint32_t *ids      = NULL;
 
-    // create a new stream associated with the existing file descriptor
-    if ((fp = fdopen(fd, mode)) == NULL) {
-        lua_settop(L, top);
-        lua_pushnil(L);
-        if (fname) {
-            lua_pushfstring(L, "%s: %s", fname, strerror(errno));
-        } else {
-            lua_pushstring(L, strerror(errno));
-        }
-        lua_pushinteger(L, errno);
-        return NULL;
+    if (depth > LAUXH_UDTYPE_MAXDEPTH) {
+        luaL_error(L, "%s has too many base types", tname);
+    }
+    hsize      = LAUXH_UDHDR_SIZE(depth);
+    hdr        = (lauxh_udhdr_t *)lua_newuserdata(L, hsize + size);
+    hdr->magic = LAUXH_UDTYPE_MAGIC;
+    hdr->depth = depth;
+    ids        = (uint32_t *)(hdr + 1);
+    for (; type; type = type->base) {
+        ids[depth--] = type->id;
+    }
+    luaL_getmetatable(L, tname);
+    if (lua_type(L, -1) == LUA_TTABLE) {
+        lua_setmetatable(L, -2);
+    } else {
+        lua_pop(L, 1);
     }
 
-    // replace a stream of a file handle with a new stream
-    lfp = lauxh_checkfilep(L, -1);
-    fclose(*lfp);
-    *lfp = fp;
-
-    return fp;
+    return (char *)hdr + hsize;
 }
 
 /**
- * @brief create a traceback for the stack `src` and push it to stack `L`.
+ * @brief get the numeric type id of the userdata at the specified index.
  *
- * @param L lua state if NULL, then push the traceback to the `src` stack.
- * @param src lua state
- * @param msg error message appended to the beginning of the traceback.
- * @param lv which level to start the traceback.
+ * @param L lua state
+ * @param idx index of the value
+ * @return int64_t type id, or -1 if the value is not a userdata created by the
+ * `lauxh_newudtype()`.
  */
-static inline void lauxh_traceback(lua_State *L, lua_State *src,
-                                   const char *msg, int lv)
+static inline int64_t lauxh_udtypeid(lua_State *L, int idx)
 {
-#if LUA_VERSION_NUM >= 502
-    // push src stack trace to dst state
-    luaL_traceback((L) ? L : src, src, msg, lv);
+    const lauxh_udhdr_t *hdr = lauxh_udhdrof(L, idx);
 
+    if (hdr) {
+        return ((const uint32_t *)(hdr + 1))[hdr->depth];
+    }
+    return -1;
+}
+
+/**
+ * @brief determine whether the value at the specified index is a userdata of
+ * the specified type or its derived type.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param type type descriptor
+ * @return int 1 if true, otherwise 0.
+ */
+static inline int lauxh_isudtype(lua_State *L, int idx,
+                                 const lauxh_udtype_t *type)
+{
+    const lauxh_udhdr_t *hdr = lauxh_udhdrof(L, idx);
+    uint32_t depth           = lauxh_udtype_depth(type);
+    const uint32_t *ids      = NULL;
+
+    if (!hdr || hdr->depth < depth) {
+        return 0;
+    }
+    // compare the ids of the type and its base types at the same depth
+    ids = (const uint32_t *)(hdr + 1);
+    for (; type; type = type->base) {
+        if (ids[depth--] != type->id) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief get the pointer to the userdata at the specified index if it is the
+ * specified type or its derived type.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param type type descriptor
+ * @return void* pointer to the userdata, or NULL if not.
+ */
+static inline void *lauxh_toudtype(lua_State *L, int idx,
+                                   const lauxh_udtype_t *type)
+{
+    if (lauxh_isudtype(L, idx, type)) {
+        lauxh_udhdr_t *hdr = (lauxh_udhdr_t *)lua_touserdata(L, idx);
+        return (char *)hdr + LAUXH_UDHDR_SIZE(hdr->depth);
+    }
+    return NULL;
+}
+
+/**
+ * @brief checks whether the value at the specified index is a userdata of the
+ * specified type or its derived type and returns it; if not, raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param type type descriptor
+ * @return void* pointer to the userdata
+ */
+static inline void *lauxh_checkudtype(lua_State *L, int idx,
+                                      const lauxh_udtype_t *type)
+{
+    void *p = lauxh_toudtype(L, idx, type);
+
+    lauxh_argcheck(L, p != NULL, idx, "%s expected, got %s", type->tname,
+                   luaL_typename(L, idx));
+    return p;
+}
+
+/**
+ * @brief checks whether the value at the specified index is a userdata of the
+ * specified type or its derived type and returns it; if it is nil, returns the
+ * specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param type type descriptor
+ * @param def default value
+ * @return void* pointer to the userdata
+ */
+static inline void *lauxh_optudtype(lua_State *L, int idx,
+                                    const lauxh_udtype_t *type, void *def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkudtype(L, idx, type);
+}
+
+/**
+ * @brief checks whether the value at the specified index is a boolean and
+ * returns it; if it is not a boolean, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int 1 if true, otherwise 0.
+ */
+static inline int lauxh_checkbool(lua_State *L, int idx)
+{
+    lauxh_checktype(L, idx, LUA_TBOOLEAN);
+    return lua_toboolean(L, idx);
+}
+
+/**
+ * @brief alias of the `lauxh_checkbool()`.
+ */
+#define lauxh_checkboolean(L, idx) lauxh_checkbool((L), (idx))
+
+/**
+ * @brief checks whether the value at the specified index is a boolean and
+ * returns it; if it is nil, returns the specified default value, otherwise
+ * raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return int 1 if true, otherwise 0.
+ */
+static inline int lauxh_optbool(lua_State *L, int idx, int def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkbool(L, idx);
+}
+
+/**
+ * @brief alias of the `lauxh_optbool()`.
+ */
+#define lauxh_optboolean(L, idx, def) lauxh_optbool((L), (idx), (def))
+
+/**
+ * @brief checks whether the value at the specified index is a string and
+ * returns it; if it is not a string, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param[out] len length of the string
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_checklstr(lua_State *L, int idx, size_t *len)
+{
+    lauxh_checktype(L, idx, LUA_TSTRING);
+    return lua_tolstring(L, idx, len);
+}
+
+/**
+ * @brief alias of the `lauxh_checklstr()`.
+ */
+#define lauxh_checklstring(L, idx, len) lauxh_checklstr((L), (idx), (len))
+
+/**
+ * @brief equivalent to `lauxh_checklstr(L, idx, NULL)`.
+ */
+#define lauxh_checkstr(L, idx) lauxh_checklstr((L), (idx), NULL)
+
+/**
+ * @brief alias of the `lauxh_checkstr()`.
+ */
+#define lauxh_checkstring(L, idx) lauxh_checkstr((L), (idx))
+
+/**
+ * NOTE: for the string content validation
+ *
+ * `lauxh_span*()` functions return the length of the leading bytes that
+ * satisfy the condition, so the string is valid if it returns the length of
+ * the string. the leading ASCII bytes are scanned 16 or 32 bytes at a time
+ * with SSE2/AVX2 on x86 or NEON on aarch64, otherwise 8 bytes at a time. AVX2
+ * is selected at runtime unless the compiler already targets it. the
+ * multibyte sequences of UTF-8 are validated one by one.
+ *
+ * - ascii: 0x00-0x7F
+ * - printable: 0x20-0x7E
+ * - utf8: well-formed UTF-8 (no overlong forms, surrogates or code points
+ *   beyond U+10FFFF)
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define LAUXH_SIMD_SSE2
+# include <emmintrin.h>
+# if defined(__AVX2__)
+#  define LAUXH_SIMD_AVX2
+#  include <immintrin.h>
+# elif (defined(__GNUC__) || defined(__clang__)) &&                            \
+     (defined(__x86_64__) || defined(__i386__))
+#  define LAUXH_SIMD_AVX2_DISPATCH
+#  define LAUXH_SIMD_AVX2
+#  include <immintrin.h>
+# endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+# define LAUXH_SIMD_NEON
+# include <arm_neon.h>
+#endif
+
+#if defined(LAUXH_SIMD_AVX2_DISPATCH)
+# define LAUXH_TARGET_AVX2 __attribute__((target("avx2")))
 #else
-    lua_Debug ar;
-    luaL_Buffer b;
+# define LAUXH_TARGET_AVX2
+#endif
 
-    luaL_buffinit(src, &b);
-    if (msg) {
-        luaL_addstring(&b, msg);
-        luaL_addchar(&b, '\n');
+/* 8 bytes at a time */
+#define LAUXH_SWAR_ONES  0x0101010101010101ULL
+#define LAUXH_SWAR_HIGHS 0x8080808080808080ULL
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline size_t lauxh_spanascii_swar(const unsigned char *s, size_t len,
+                                          size_t i)
+{
+    uint64_t v = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        memcpy(&v, s + i, 8);
+        if (v & LAUXH_SWAR_HIGHS) {
+            break;
+        }
+    }
+    while (i < len && s[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline size_t lauxh_spanprintable_swar(const unsigned char *s,
+                                              size_t len, size_t i)
+{
+    uint64_t v = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        memcpy(&v, s + i, 8);
+        // has a byte less than 0x20, or greater than 0x7E
+        if (((v - LAUXH_SWAR_ONES * 0x20) & ~v & LAUXH_SWAR_HIGHS) ||
+            ((v + LAUXH_SWAR_ONES) | v) & LAUXH_SWAR_HIGHS) {
+            break;
+        }
+    }
+    while (i < len && s[i] >= 0x20 && s[i] <= 0x7E) {
+        i++;
+    }
+    return i;
+}
+
+#if defined(LAUXH_SIMD_AVX2)
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline LAUXH_TARGET_AVX2 size_t
+lauxh_spanascii_avx2(const unsigned char *s, size_t len)
+{
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(s + i));
+        if (_mm256_movemask_epi8(v)) {
+            break;
+        }
+    }
+    return lauxh_spanascii_swar(s, len, i);
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline LAUXH_TARGET_AVX2 size_t
+lauxh_spanprintable_avx2(const unsigned char *s, size_t len)
+{
+    const __m256i lo = _mm256_set1_epi8(0x1F);
+    const __m256i hi = _mm256_set1_epi8(0x7F);
+    size_t i         = 0;
+
+    // the bytes greater than 0x7F are negative as the signed char
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i m = _mm256_and_si256(_mm256_cmpgt_epi8(v, lo),
+                                     _mm256_cmpgt_epi8(hi, v));
+        if (_mm256_movemask_epi8(m) != -1) {
+            break;
+        }
+    }
+    return lauxh_spanprintable_swar(s, len, i);
+}
+#endif
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline size_t lauxh_spanascii_simd(const unsigned char *s, size_t len)
+{
+    size_t i = 0;
+
+#if defined(LAUXH_SIMD_AVX2_DISPATCH)
+    if (len >= 64 && __builtin_cpu_supports("avx2")) {
+        return lauxh_spanascii_avx2(s, len);
+    }
+#elif defined(LAUXH_SIMD_AVX2)
+    return lauxh_spanascii_avx2(s, len);
+#endif
+
+#if defined(LAUXH_SIMD_SSE2)
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        if (_mm_movemask_epi8(v)) {
+            break;
+        }
+    }
+#elif defined(LAUXH_SIMD_NEON)
+    for (; i + 16 <= len; i += 16) {
+        if (vmaxvq_u8(vld1q_u8(s + i)) & 0x80) {
+            break;
+        }
+    }
+#endif
+    return lauxh_spanascii_swar(s, len, i);
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline size_t lauxh_spanprintable_simd(const unsigned char *s,
+                                              size_t len)
+{
+    size_t i = 0;
+
+#if defined(LAUXH_SIMD_AVX2_DISPATCH)
+    if (len >= 64 && __builtin_cpu_supports("avx2")) {
+        return lauxh_spanprintable_avx2(s, len);
+    }
+#elif defined(LAUXH_SIMD_AVX2)
+    return lauxh_spanprintable_avx2(s, len);
+#endif
+
+#if defined(LAUXH_SIMD_SSE2)
+    {
+        const __m128i lo = _mm_set1_epi8(0x1F);
+        const __m128i hi = _mm_set1_epi8(0x7F);
+
+        // the bytes greater than 0x7F are negative as the signed char
+        for (; i + 16 <= len; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+            __m128i m = _mm_and_si128(_mm_cmpgt_epi8(v, lo),
+                                      _mm_cmplt_epi8(v, hi));
+            if (_mm_movemask_epi8(m) != 0xFFFF) {
+                break;
+            }
+        }
+    }
+#elif defined(LAUXH_SIMD_NEON)
+    {
+        const uint8x16_t lo = vdupq_n_u8(0x20);
+        const uint8x16_t hi = vdupq_n_u8(0x7E);
+
+        for (; i + 16 <= len; i += 16) {
+            uint8x16_t v = vld1q_u8(s + i);
+            uint8x16_t m = vandq_u8(vcgeq_u8(v, lo), vcleq_u8(v, hi));
+            if (vminvq_u8(m) != 0xFF) {
+                break;
+            }
+        }
+    }
+#endif
+    return lauxh_spanprintable_swar(s, len, i);
+}
+
+#undef LAUXH_SWAR_ONES
+#undef LAUXH_SWAR_HIGHS
+
+/**
+ * @brief returns the length of the leading ASCII bytes of the string.
+ *
+ * @param s string
+ * @param len length of the string
+ * @return size_t length of the leading ASCII bytes
+ */
+static inline size_t lauxh_spanascii(const char *s, size_t len)
+{
+    return lauxh_spanascii_simd((const unsigned char *)s, len);
+}
+
+/**
+ * @brief returns the length of the leading printable ASCII bytes (0x20-0x7E)
+ * of the string.
+ *
+ * @param s string
+ * @param len length of the string
+ * @return size_t length of the leading printable ASCII bytes
+ */
+static inline size_t lauxh_spanprintable(const char *s, size_t len)
+{
+    return lauxh_spanprintable_simd((const unsigned char *)s, len);
+}
+
+/**
+ * @brief returns the length of the leading well-formed UTF-8 sequences of the
+ * string.
+ *
+ * @param s string
+ * @param len length of the string
+ * @return size_t length of the leading well-formed UTF-8 sequences
+ */
+static inline size_t lauxh_spanutf8(const char *s, size_t len)
+{
+    const unsigned char *p = (const unsigned char *)s;
+    size_t i               = 0;
+
+    while ((i += lauxh_spanascii_simd(p + i, len - i)) < len) {
+        unsigned char c = p[i];
+        size_t n        = len - i;
+
+        // 2 bytes: C2-DF 80-BF
+        if (c >= 0xC2 && c <= 0xDF) {
+            if (n < 2 || (p[i + 1] & 0xC0) != 0x80) {
+                break;
+            }
+            i += 2;
+        }
+        // 3 bytes: E0 A0-BF 80-BF / E1-EC 80-BF 80-BF / ED 80-9F 80-BF /
+        //          EE-EF 80-BF 80-BF
+        else if (c >= 0xE0 && c <= 0xEF) {
+            if (n < 3 || (p[i + 1] & 0xC0) != 0x80 ||
+                (p[i + 2] & 0xC0) != 0x80 || (c == 0xE0 && p[i + 1] < 0xA0) ||
+                (c == 0xED && p[i + 1] > 0x9F)) {
+                break;
+            }
+            i += 3;
+        }
+        // 4 bytes: F0 90-BF 80-BF 80-BF / F1-F3 80-BF 80-BF 80-BF /
+        //          F4 80-8F 80-BF 80-BF
+        else if (c >= 0xF0 && c <= 0xF4) {
+            if (n < 4 || (p[i + 1] & 0xC0) != 0x80 ||
+                (p[i + 2] & 0xC0) != 0x80 || (p[i + 3] & 0xC0) != 0x80 ||
+                (c == 0xF0 && p[i + 1] < 0x90) ||
+                (c == 0xF4 && p[i + 1] > 0x8F)) {
+                break;
+            }
+            i += 4;
+        } else {
+            break;
+        }
+    }
+
+    return (i < len) ? i : len;
+}
+
+/**
+ * @brief checks whether the value at the specified index is a string that
+ * consists of the ASCII bytes.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int 1 if true, otherwise 0.
+ */
+static inline int lauxh_isascii(lua_State *L, int idx)
+{
+    size_t len    = 0;
+    const char *s = NULL;
+
+    if (lua_type(L, idx) != LUA_TSTRING) {
+        return 0;
+    }
+    s = lua_tolstring(L, idx, &len);
+    return lauxh_spanascii(s, len) == len;
+}
+
+/**
+ * @brief checks whether the value at the specified index is a string that
+ * consists of the printable ASCII bytes (0x20-0x7E).
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int 1 if true, otherwise 0.
+ */
+static inline int lauxh_isprintable(lua_State *L, int idx)
+{
+    size_t len    = 0;
+    const char *s = NULL;
+
+    if (lua_type(L, idx) != LUA_TSTRING) {
+        return 0;
+    }
+    s = lua_tolstring(L, idx, &len);
+    return lauxh_spanprintable(s, len) == len;
+}
+
+/**
+ * @brief checks whether the value at the specified index is a well-formed
+ * UTF-8 string.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int 1 if true, otherwise 0.
+ */
+static inline int lauxh_isutf8(lua_State *L, int idx)
+{
+    size_t len    = 0;
+    const char *s = NULL;
+
+    if (lua_type(L, idx) != LUA_TSTRING) {
+        return 0;
+    }
+    s = lua_tolstring(L, idx, &len);
+    return lauxh_spanutf8(s, len) == len;
+}
+
+#define CHECK_STRCONTENT(L, idx, len, tname, spanfn)                           \
+    do {                                                                       \
+        size_t n      = 0;                                                     \
+        size_t pos    = 0;                                                     \
+        const char *s = lauxh_checklstr((L), (idx), &n);                       \
+                                                                               \
+        pos = spanfn(s, n);                                                    \
+        lauxh_argcheck((L), pos == n, (idx),                                   \
+                       tname " expected, got invalid byte 0x%02X at %d",       \
+                       (unsigned char)s[pos], (int)pos + 1);                   \
+        if (len) {                                                             \
+            *(len) = n;                                                        \
+        }                                                                      \
+        return s;                                                              \
+    } while (0)
+
+/**
+ * @brief checks whether the value at the specified index is a string that
+ * consists of the ASCII bytes and returns it; if not, raises an error report
+ * with the position of the first invalid byte.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param[out] len length of the string
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_checkasciilstr(lua_State *L, int idx,
+                                               size_t *len)
+{
+    CHECK_STRCONTENT(L, idx, len, "ASCII string", lauxh_spanascii);
+}
+
+/**
+ * @brief equivalent to `lauxh_checkasciilstr(L, idx, NULL)`.
+ */
+#define lauxh_checkasciistr(L, idx) lauxh_checkasciilstr((L), (idx), NULL)
+
+/**
+ * @brief checks whether the value at the specified index is a string that
+ * consists of the printable ASCII bytes (0x20-0x7E) and returns it; if not,
+ * raises an error report with the position of the first invalid byte.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param[out] len length of the string
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_checkprintablelstr(lua_State *L, int idx,
+                                                   size_t *len)
+{
+    CHECK_STRCONTENT(L, idx, len, "printable string", lauxh_spanprintable);
+}
+
+/**
+ * @brief equivalent to `lauxh_checkprintablelstr(L, idx, NULL)`.
+ */
+#define lauxh_checkprintable(L, idx) lauxh_checkprintablelstr((L), (idx), NULL)
+
+/**
+ * @brief checks whether the value at the specified index is a well-formed
+ * UTF-8 string and returns it; if not, raises an error report with the
+ * position of the first invalid byte.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param[out] len length of the string
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_checkutf8lstr(lua_State *L, int idx,
+                                              size_t *len)
+{
+    CHECK_STRCONTENT(L, idx, len, "UTF-8 string", lauxh_spanutf8);
+}
+
+/**
+ * @brief equivalent to `lauxh_checkutf8lstr(L, idx, NULL)`.
+ */
+#define lauxh_checkutf8str(L, idx) lauxh_checkutf8lstr((L), (idx), NULL)
+
+#undef CHECK_STRCONTENT
+
+/**
+ * @brief checks whether the value at the specified index is a string and
+ * returns it; if it is nil, returns the specified default value, otherwise
+ * raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @param[out] len length of the string
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_optlstr(lua_State *L, int idx, const char *def,
+                                        size_t *len)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        if (len && def) {
+            *len = strlen(def);
+        }
+        return def;
+    }
+    return lauxh_checklstr(L, idx, len);
+}
+
+/**
+ * @brief alias of the `lauxh_optlstr()`.
+ */
+#define lauxh_optlstring(L, idx, def, len)                                     \
+    lauxh_optlstr((L), (idx), (def), (len))
+
+/**
+ * @brief equivalent to `lauxh_optlstr(L, idx, def, NULL)`.
+ */
+#define lauxh_optstr(L, idx, def) lauxh_optlstr((L), (idx), (def), NULL)
+
+/**
+ * @brief alias of the `lauxh_optstr()`.
+ */
+#define lauxh_optstring(L, idx, def) lauxh_optstr((L), (idx), (def))
+
+/* number/integer argument */
+
+/**
+ * @brief descriptor of the error of the numeric range check. if the `cmpname`
+ * is NULL, the error is reported as the range error.
+ */
+typedef struct {
+    const char *tname;
+    const char *cmpname;
+} lauxh_rangeerr_t;
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static LAUXH_COLD LAUXH_NOINLINE int
+lauxh_numtype_error(lua_State *L, int idx, const char *tname)
+{
+    int t = lua_type(L, idx);
+
+    if (t != LUA_TNUMBER) {
+        return lauxh_argerror(L, idx, "%s expected, got %s", tname,
+                              lua_typename(L, t));
+    }
+    return lauxh_argerror(L, idx, "%s expected, got an out of range value",
+                          tname);
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static LAUXH_COLD LAUXH_NOINLINE int
+lauxh_rangeerror(lua_State *L, int idx, const lauxh_rangeerr_t *e,
+                 const char *min, const char *max)
+{
+    int t = lua_type(L, idx);
+
+    if (e->cmpname) {
+        lua_pushfstring(L, "%s %s than or equal to %s expected, ", e->tname,
+                        e->cmpname, min);
+    } else {
+        lua_pushfstring(L, "%s from %s to %s expected, ", e->tname, min, max);
+    }
+    if (t != LUA_TNUMBER) {
+        lua_pushfstring(L, "got %s", lua_typename(L, t));
+    } else {
+        lua_pushliteral(L, "got an out of range value");
+    }
+    lua_concat(L, 2);
+    return lauxh_push_argerror(L, idx, lua_tostring(L, -1));
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static LAUXH_COLD LAUXH_NOINLINE int
+lauxh_numrange_error(lua_State *L, int idx, const lauxh_rangeerr_t *e,
+                     lua_Number min, lua_Number max)
+{
+    const char *smin = lua_pushfstring(L, "%f", min);
+    const char *smax = lua_pushfstring(L, "%f", max);
+    return lauxh_rangeerror(L, idx, e, smin, smax);
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static LAUXH_COLD LAUXH_NOINLINE int
+lauxh_intrange_error(lua_State *L, int idx, const lauxh_rangeerr_t *e,
+                     lua_Integer min, lua_Integer max)
+{
+    char smin[32];
+    char smax[32];
+
+    snprintf(smin, sizeof(smin), "%lld", (long long)min);
+    snprintf(smax, sizeof(smax), "%lld", (long long)max);
+    return lauxh_rangeerror(L, idx, e, smin, smax);
+}
+
+#define CHECK_NUMTYPE(L, idx, tname, isnumfn)                                  \
+    do {                                                                       \
+        if (LAUXH_UNLIKELY(!isnumfn((L), (idx)))) {                            \
+            lauxh_numtype_error((L), (idx), tname);                            \
+        }                                                                      \
+        lauxh_push_argerror_init();                                            \
+    } while (0)
+
+/**
+ * @brief checks whether the value at the specified index is the number and
+ * returns it; if it is not a number, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_checknum(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "number", lauxh_isnum);
+    return lua_tonumber(L, idx);
+}
+
+/**
+ * @brief alias of the `lauxh_checknum()`.
+ */
+#define lauxh_checknumber(L, idx) lauxh_checknum((L), (idx))
+
+/**
+ * @brief checks whether the value at the specified index is the number and
+ * returns it; if it is nil, returns the specified default value, otherwise
+ * raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_optnum(lua_State *L, int idx, lua_Number def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checknum(L, idx);
+}
+
+/**
+ * @brief alias of the `lauxh_optnum()`.
+ */
+#define lauxh_optnumber(L, idx, def) lauxh_optnum((L), (idx), (def))
+
+/**
+ * @brief checks whether the value at the specified index is the integer and
+ * returns it; if it is not a integer, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_checkint(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "integer", lauxh_isint);
+    return lua_tointeger(L, idx);
+}
+
+/**
+ * @brief alias of the `lauxh_checkint()`.
+ */
+#define lauxh_checkinteger(L, idx) lauxh_checkint((L), (idx))
+
+/**
+ * @brief checks whether the value at the specified index is the integer and
+ * returns it; if it is nil, returns the specified default value, otherwise
+ * raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_optint(lua_State *L, int idx, lua_Integer def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkint(L, idx);
+}
+
+/**
+ * @brief alias of the `lauxh_optint()`.
+ */
+#define lauxh_optinteger(L, idx, def) lauxh_optint((L), (idx), (def))
+
+/**
+ * @brief checks whether the value at the specified index is the finite number
+ * and returns it; if it is not a finite number, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return lua_Integer
+ */
+static inline lua_Number lauxh_checkfinite(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "finite number", lauxh_isfinite);
+    return lua_tonumber(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is the finite number
+ * and returns it; if it is nil, returns the specified default value, otherwise
+ * raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return lua_Integer
+ */
+static inline lua_Number lauxh_optfinite(lua_State *L, int idx, lua_Number def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkfinite(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is the unsigned
+ * number and returns it; if it is not a unsigned number, raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_checkunsigned(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "unsigned number", lauxh_isunsigned);
+    return lua_tonumber(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is the unsigned number
+ * and returns it; if it is nil, returns the specified default value, otherwise
+ * raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_optunsigned(lua_State *L, int idx,
+                                           lua_Number def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkunsigned(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is the unsigned
+ * integer and returns it; if it is not a unsigned integer, raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_checkuint(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "unsigned integer", lauxh_isuint);
+    return lua_tointeger(L, idx);
+}
+
+/**
+ * @brief alias of the `lauxh_checkuint()`.
+ */
+#define lauxh_checkuinteger(L, idx) lauxh_checkuint((L), (idx))
+
+/**
+ * @brief checks whether the value at the specified index is the unsigned
+ * integer and returns it; if it is nil, returns the specified default value,
+ * otherwise raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_optuint(lua_State *L, int idx, lua_Integer def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkuint(L, idx);
+}
+
+/**
+ * @brief alias of the `lauxh_optuint()`.
+ */
+#define lauxh_optuinteger(L, idx, def) lauxh_optuint((L), (idx), (def))
+
+/**
+ * @brief checks whether the value at the specified index is the positive
+ * integer and returns it; if it is not a positive integer, raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_checkpint(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "positive integer", lauxh_ispint);
+    return lua_tointeger(L, idx);
+}
+
+/**
+ * @brief alias of the `lauxh_checkpint()`.
+ */
+#define lauxh_checkpinteger(L, idx) lauxh_checkpint((L), (idx))
+
+/**
+ * @brief checks whether the value at the specified index is the positive
+ * integer and returns it; if it is nil, returns the specified default value,
+ * otherwise raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_optpint(lua_State *L, int idx, lua_Integer def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkpint(L, idx);
+}
+
+/**
+ * @brief alias of the `lauxh_optpint()`.
+ */
+#define lauxh_optpinteger(L, idx, def) lauxh_optpint((L), (idx), (def))
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `int8_t` type and returns it; if it is not in the range of the `int8_t` type,
+ * raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int8_t
+ */
+static inline int8_t lauxh_checkint8(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "int8_t", lauxh_isint8);
+    return (int8_t)lua_tointeger(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `int8_t` type and returns it; if it is nil, returns the specified default
+ * value, otherwise raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return int8_t
+ */
+static inline int8_t lauxh_optint8(lua_State *L, int idx, int8_t def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkint8(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `uint8_t` type and returns it; if it is not in the range of the `uint8_t`
+ * type, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return uint8_t
+ */
+static inline uint8_t lauxh_checkuint8(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "uint8_t", lauxh_isuint8);
+    return (uint8_t)lua_tointeger(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `uint8_t` type and returns it; if it is nil, returns the specified default
+ * value, otherwise raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return uint8_t
+ */
+static inline uint8_t lauxh_optuint8(lua_State *L, int idx, uint8_t def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkuint8(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `int16_t` type and returns it; if it is not in the range of the `int16_t`
+ * type, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int16_t
+ */
+static inline int16_t lauxh_checkint16(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "int16_t", lauxh_isint16);
+    return (int16_t)lua_tointeger(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `int16_t` type and returns it; if it is nil, returns the specified default
+ * value, otherwise raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return int16_t
+ */
+static inline int16_t lauxh_optint16(lua_State *L, int idx, int16_t def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkint16(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `uint16_t` type and returns it; if it is not in the range of the `uint16_t`
+ * type, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return uint16_t
+ */
+static inline uint16_t lauxh_checkuint16(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "uint16_t", lauxh_isuint16);
+    return (uint16_t)lua_tointeger(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `uint16_t` type and returns it; if it is nil, returns the specified default
+ * value, otherwise raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return uint16_t
+ */
+static inline uint16_t lauxh_optuint16(lua_State *L, int idx, uint16_t def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkuint16(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `int32_t` type and returns it; if it is not in the range of the `int32_t`
+ * type, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int32_t
+ */
+static inline int32_t lauxh_checkint32(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "int32_t", lauxh_isint32);
+    return (int32_t)lua_tointeger(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `int32_t` type and returns it; if it is nil, returns the specified default
+ * value, otherwise raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return int32_t
+ */
+static inline int32_t lauxh_optint32(lua_State *L, int idx, int32_t def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkint32(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `uint32_t` type and returns it; if it is not in the range of the `uint32_t`
+ * type, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return uint32_t
+ */
+static inline uint32_t lauxh_checkuint32(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "uint32_t", lauxh_isuint32);
+    return (uint32_t)lua_tointeger(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `uint32_t` type and returns it; if it is nil, returns the specified default
+ * value, otherwise raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return uint32_t
+ */
+static inline uint32_t lauxh_optuint32(lua_State *L, int idx, uint32_t def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkuint32(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `int64_t` type and returns it; if it is not in the range of the `int64_t`
+ * type, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return int64_t
+ */
+static inline int64_t lauxh_checkint64(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "int64_t", lauxh_isint64);
+    return (int64_t)lua_tointeger(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `int64_t` type and returns it; if it is nil, returns the specified default
+ * value, otherwise raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return int64_t
+ */
+static inline int64_t lauxh_optint64(lua_State *L, int idx, int64_t def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkint64(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `uint64_t` type and returns it; if it is not in the range of the `uint64_t`
+ * type, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @return uint64_t
+ */
+static inline uint64_t lauxh_checkuint64(lua_State *L, int idx)
+{
+    CHECK_NUMTYPE(L, idx, "uint64_t", lauxh_isuint64);
+    return (uint64_t)lua_tointeger(L, idx);
+}
+
+/**
+ * @brief checks whether the value at the specified index is in the range of the
+ * `uint64_t` type and returns it; if it is nil, returns the specified default
+ * value, otherwise raises an error.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return uint64_t
+ */
+static inline uint64_t lauxh_optuint64(lua_State *L, int idx, uint64_t def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkuint64(L, idx);
+}
+
+#undef CHECK_NUMTYPE
+
+#define CHECK_NUMTYPE_GLE(L, idx, tname, cmpname, isnumfn, n, errfn)           \
+    do {                                                                       \
+        if (LAUXH_UNLIKELY(!isnumfn((L), (idx), (n)))) {                       \
+            static const lauxh_rangeerr_t e = {tname, cmpname};                \
+            errfn((L), (idx), &e, (n), (n));                                   \
+        }                                                                      \
+        lauxh_push_argerror_init();                                            \
+    } while (0)
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * number and is greater than or equal to the specified number and returns it;
+ * if not, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param n value is greater than or equal to this number
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_checknum_ge(lua_State *L, int idx, lua_Number n)
+{
+    CHECK_NUMTYPE_GLE(L, idx, "number", "greater", lauxh_isnum_ge, n,
+                      lauxh_numrange_error);
+    return lua_tonumber(L, idx);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * number and is less than or equal to the specified number and returns it;
+ * if not, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param n value is less than or equal to this number
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_checknum_le(lua_State *L, int idx, lua_Number n)
+{
+    CHECK_NUMTYPE_GLE(L, idx, "number", "less", lauxh_isnum_le, n,
+                      lauxh_numrange_error);
+    return lua_tonumber(L, idx);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * number and is greater than or equal to the specified number and returns it;
+ * if it is nil, returns the specified default value, otherwise raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param n value is greater than or equal to this number
+ * @param def default value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_optnum_ge(lua_State *L, int idx, lua_Number n,
+                                         lua_Number def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checknum_ge(L, idx, n);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * number and is less than or equal to the specified number and returns it;
+ * if it is nil, returns the specified default value, otherwise raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param n value is less than or equal to this number
+ * @param def default value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_optnum_le(lua_State *L, int idx, lua_Number n,
+                                         lua_Number def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checknum_le(L, idx, n);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * integer and is greater than or equal to the specified number and returns it;
+ * if not, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param n value is greater than or equal to this number
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_checkint_ge(lua_State *L, int idx,
+                                            lua_Integer n)
+{
+    CHECK_NUMTYPE_GLE(L, idx, "integer", "greater", lauxh_isint_ge, n,
+                      lauxh_intrange_error);
+    return lua_tointeger(L, idx);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * integer and is less than or equal to the specified number and returns it;
+ * if not, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param n value is less than or equal to this number
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_checkint_le(lua_State *L, int idx,
+                                            lua_Integer n)
+{
+    CHECK_NUMTYPE_GLE(L, idx, "integer", "less", lauxh_isint_le, n,
+                      lauxh_intrange_error);
+    return lua_tointeger(L, idx);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * integer and is greater than or equal to the specified number and returns it;
+ * if it is nil, returns the specified default value, otherwise raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param n value is greater than or equal to this number
+ * @param def default value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_optint_ge(lua_State *L, int idx, lua_Integer n,
+                                          lua_Integer def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkint_ge(L, idx, n);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * integer and is less than or equal to the specified number and returns it;
+ * if it is nil, returns the specified default value, otherwise raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param n value is less than or equal to this number
+ * @param def default value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_optint_le(lua_State *L, int idx, lua_Integer n,
+                                          lua_Integer def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkint_le(L, idx, n);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * finite number and is greater than or equal to the specified number and
+ * returns it; if not, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param n value is greater than or equal to this number
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_checkfinite_ge(lua_State *L, int idx,
+                                              lua_Number n)
+{
+    CHECK_NUMTYPE_GLE(L, idx, "finite number", "greater", lauxh_isfinite_ge, n,
+                      lauxh_numrange_error);
+    return lua_tonumber(L, idx);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * finite number and is less than or equal to the specified number and returns
+ * it; if not, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param n value is less than or equal to this number
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_checkfinite_le(lua_State *L, int idx,
+                                              lua_Number n)
+{
+    CHECK_NUMTYPE_GLE(L, idx, "finite number", "less", lauxh_isfinite_le, n,
+                      lauxh_numrange_error);
+    return lua_tonumber(L, idx);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * finite number and is greater than or equal to the specified number and
+ * returns it; if it is nil, returns the specified default value, otherwise
+ * raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param n value is greater than or equal to this number
+ * @param def default value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_optfinite_ge(lua_State *L, int idx, lua_Number n,
+                                            lua_Number def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkfinite_ge(L, idx, n);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * finite number and is less than or equal to the specified number and returns
+ * it; if it is nil, returns the specified default value, otherwise raises an
+ * error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param n value is less than or equal to this number
+ * @param def default value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_optfinite_le(lua_State *L, int idx, lua_Number n,
+                                            lua_Number def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkfinite_le(L, idx, n);
+}
+
+#undef CHECK_NUMTYPE_GLE
+
+#define CHECK_NUMTYPE_RANGE(L, idx, tname, isnumfn, min, max, errfn)           \
+    do {                                                                       \
+        if (LAUXH_UNLIKELY(!isnumfn((L), (idx), (min), (max)))) {              \
+            static const lauxh_rangeerr_t e = {tname, NULL};                   \
+            errfn((L), (idx), &e, (min), (max));                               \
+        }                                                                      \
+        lauxh_push_argerror_init();                                            \
+    } while (0)
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * number and is in the range of the specified numbers and returns it; if not,
+ * raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param min value is greater than or equal to this number
+ * @param max value is less than or equal to this number
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_checknum_in_range(lua_State *L, int idx,
+                                                 lua_Number min, lua_Number max)
+{
+    CHECK_NUMTYPE_RANGE(L, idx, "number", lauxh_isnum_in_range, min, max,
+                        lauxh_numrange_error);
+    return lua_tonumber(L, idx);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * number and is in the range of the specified numbers and returns it; if it is
+ * nil, returns the specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param min value is greater than or equal to this number
+ * @param max value is less than or equal to this number
+ * @param def default value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_optnum_in_range(lua_State *L, int idx,
+                                               lua_Number min, lua_Number max,
+                                               lua_Number def)
+{
+    if (LAUXH_UNLIKELY(!isfinite(min) || !isfinite(max) || min > max)) {
+        luaL_error(L,
+                   "min and max must be finite numbers, and min %f must be "
+                   "less than or equal to max %f",
+                   min, max);
+    }
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checknum_in_range(L, idx, min, max);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * integer and is in the range of the specified numbers and returns it; if not,
+ * raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param min value is greater than or equal to this number
+ * @param max value is less than or equal to this number
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_checkint_in_range(lua_State *L, int idx,
+                                                  lua_Integer min,
+                                                  lua_Integer max)
+{
+    CHECK_NUMTYPE_RANGE(L, idx, "integer", lauxh_isint_in_range, min, max,
+                        lauxh_intrange_error);
+    return lua_tointeger(L, idx);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * integer and is in the range of the specified numbers and returns it; if it is
+ * nil, returns the specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param min value is greater than or equal to this number
+ * @param max value is less than or equal to this number
+ * @param def default value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_optint_in_range(lua_State *L, int idx,
+                                                lua_Integer min,
+                                                lua_Integer max,
+                                                lua_Integer def)
+{
+    if (LAUXH_UNLIKELY(min > max)) {
+        luaL_error(L, "min %d must be less than or equal to max %d", min, max);
+    }
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkint_in_range(L, idx, min, max);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * finite number and is in the range of the specified numbers and returns it; if
+ * not, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param min value is greater than or equal to this number
+ * @param max value is less than or equal to this number
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_checkfinite_in_range(lua_State *L, int idx,
+                                                    lua_Number min,
+                                                    lua_Number max)
+{
+    CHECK_NUMTYPE_RANGE(L, idx, "finite number", lauxh_isfinite_in_range, min,
+                        max, lauxh_numrange_error);
+    return lua_tonumber(L, idx);
+}
+
+/**
+ * @brief checks whether the type of the value at the specified index is the
+ * finite number and is in the range of the specified numbers and returns it; if
+ * it is nil, returns the specified default value, otherwise raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param min value is greater than or equal to this number
+ * @param max value is less than or equal to this number
+ * @param def default value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_optfinite_in_range(lua_State *L, int idx,
+                                                  lua_Number min,
+                                                  lua_Number max,
+                                                  lua_Number def)
+{
+    if (LAUXH_UNLIKELY(!isfinite(min) || !isfinite(max) || min > max)) {
+        luaL_error(L,
+                   "min and max must be finite numbers, and min %f must be "
+                   "less than or equal to max %f",
+                   min, max);
+    }
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkfinite_in_range(L, idx, min, max);
+}
+
+#undef CHECK_NUMTYPE_RANGE
+
+/**
+ * NOTE: for the string options
+ *
+ * the option set maps the option name to its index in O(1) by the minimal
+ * perfect hash. the FNV-1a hash value of the name is mixed with the seed of
+ * the set by the finalizer of the murmur3, the names are distributed to the
+ * buckets by the upper 32 bits of the mixed value, and each bucket has the
+ * displacement that places all its names into the distinct slots. if no
+ * displacement is found, the hash table is rebuilt with the next seed. so the
+ * lookup computes one hash value and compares the name of the slot with one
+ * memcmp.
+ *
+ * in C, the option set is declared as the mutable static variable, and the hash
+ * table must be built by `lauxh_optionset_init()` in the `luaopen_*` function
+ * before the set is used. `lauxh_optionset_init()` builds the hash table in
+ * the local copy and publishes it once, so the states on the multiple threads
+ * can load the module at the same time. `lauxh_checkoption()` raises an error
+ * if the set is not published.
+ *
+ *  enum { MODE_R, MODE_W, MODE_RW };
+ *  static lauxh_optionset_t MODES = LAUXH_OPTIONSET_INIT("r", "w", "rw");
+ *  // in luaopen_*
+ *  lauxh_optionset_init(&MODES);
+ *  // in the function
+ *  int mode = lauxh_checkoption(L, 1, &MODES);
+ *
+ * in C++17 or later, the hash table is built at compile time by
+ * `lauxh::options()`, so the set can be declared as the constant.
+ *
+ *  static constexpr lauxh_optionset_t MODES = lauxh::options("r", "w", "rw");
+ *  static_assert(MODES.ready, "invalid options");
+ */
+
+// maximum number of the options in the option set
+#define LAUXH_OPTION_MAX 64
+
+typedef struct {
+    // NULL-terminated list of the option names
+    const char *names[LAUXH_OPTION_MAX + 1];
+    int n;
+    // LAUXH_OPTIONSET_READY if the hash table is built
+    int ready;
+    // seed of the hash function
+    uint32_t seed;
+    uint16_t lens[LAUXH_OPTION_MAX];
+    // displacement of each bucket
+    uint16_t disp[LAUXH_OPTION_MAX];
+    // index of the option placed in each slot
+    uint8_t order[LAUXH_OPTION_MAX];
+} lauxh_optionset_t;
+
+#define LAUXH_OPTIONSET_INIT(...)                                              \
+    {                                                                          \
+        {__VA_ARGS__, NULL}, 0, 0, 0, {0}, {0}, {0}                            \
+    }
+
+// state of the option set that the hash table is built
+#define LAUXH_OPTIONSET_READY    1
+// state of the option set that is being built by `lauxh_optionset_init()`
+#define LAUXH_OPTIONSET_BUILDING 2
+
+// maximum number of the seeds that are tried to build the hash table
+#define LAUXH_OPTION_MAXSEED 16
+
+/**
+ * @brief calculate the 64-bit FNV-1a hash value of the string, and mix it with
+ * the seed by the 64-bit finalizer of the murmur3. the short names differ only
+ * in the lower bits of the FNV-1a hash value, so the finalizer spreads them to
+ * the upper bits that select the bucket.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline LAUXH_CONSTEXPR uint64_t lauxh_option_hash(const char *s,
+                                                         size_t len,
+                                                         uint32_t seed)
+{
+    uint64_t h = 0xCBF29CE484222325ULL;
+    size_t i   = 0;
+
+    for (; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 0x100000001B3ULL;
+    }
+    h ^= (uint64_t)seed * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * @brief map the 32-bit value to the range [0, n) without the division.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline LAUXH_CONSTEXPR int lauxh_option_reduce(uint32_t v, int n)
+{
+    return (int)(((uint64_t)v * (uint32_t)n) >> 32);
+}
+
+/**
+ * @brief get the bucket of the hash value.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline LAUXH_CONSTEXPR int lauxh_option_bucket(uint64_t h, int n)
+{
+    return lauxh_option_reduce((uint32_t)(h >> 32), n);
+}
+
+/**
+ * @brief get the slot of the hash value displaced by the specified value.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline LAUXH_CONSTEXPR int lauxh_option_slot(uint64_t h, uint32_t d,
+                                                    int n)
+{
+    uint32_t x = (uint32_t)h ^ (d * 0x9E3779B9u);
+
+    // finalizer of the murmur3
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return lauxh_option_reduce(x, n);
+}
+
+/**
+ * @brief place the names to the slots with the specified seed.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ *
+ * @param set option set that the names are counted
+ * @param seed seed of the hash function
+ * @return int 0 on success, or -1 if the displacement is not found.
+ */
+static inline LAUXH_CONSTEXPR int lauxh_optionset_place(lauxh_optionset_t *set,
+                                                        uint32_t seed)
+{
+    uint64_t h[LAUXH_OPTION_MAX]   = {0};
+    int bucket[LAUXH_OPTION_MAX]   = {0};
+    int nbucket[LAUXH_OPTION_MAX]  = {0};
+    // 0: free, 1: used, 2: tentatively used by the current bucket
+    uint8_t used[LAUXH_OPTION_MAX] = {0};
+    int n                          = set->n;
+    int maxn                       = 0;
+    int i                          = 0;
+    int j                          = 0;
+    int b                          = 0;
+    uint32_t d                     = 0;
+
+    for (i = 0; i < n; i++) {
+        h[i]      = lauxh_option_hash(set->names[i], set->lens[i], seed);
+        bucket[i] = lauxh_option_bucket(h[i], n);
+        if (++nbucket[bucket[i]] > maxn) {
+            maxn = nbucket[bucket[i]];
+        }
+    }
+
+    // place the larger buckets first
+    for (; maxn > 0; maxn--) {
+        for (b = 0; b < n; b++) {
+            if (nbucket[b] != maxn) {
+                continue;
+            }
+            for (d = 0; d <= UINT16_MAX; d++) {
+                for (i = 0; i < n; i++) {
+                    if (bucket[i] == b) {
+                        j = lauxh_option_slot(h[i], d, n);
+                        if (used[j]) {
+                            break;
+                        }
+                        used[j]       = 2;
+                        set->order[j] = (uint8_t)i;
+                    }
+                }
+                if (i == n) {
+                    break;
+                }
+                // release the slots used by this displacement
+                for (j = 0; j < n; j++) {
+                    if (used[j] == 2) {
+                        used[j] = 0;
+                    }
+                }
+            }
+            if (d > UINT16_MAX) {
+                return -1;
+            }
+            for (j = 0; j < n; j++) {
+                if (used[j] == 2) {
+                    used[j] = 1;
+                }
+            }
+            set->disp[b] = (uint16_t)d;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief build the hash table of the option set.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ *
+ * @param set option set
+ * @return int 0 on success, or -1 if the names contain the duplicates, or the
+ * displacement is not found with any seed.
+ */
+static inline LAUXH_CONSTEXPR int lauxh_optionset_build(lauxh_optionset_t *set)
+{
+    uint32_t seed = 0;
+    int n         = 0;
+    int i         = 0;
+    int j         = 0;
+    size_t len    = 0;
+
+    for (; n < LAUXH_OPTION_MAX && set->names[n]; n++) {
+        for (len = 0; set->names[n][len]; len++) {
+        }
+        if (len > UINT16_MAX) {
+            return -1;
+        }
+        set->lens[n] = (uint16_t)len;
+        // reject the duplicate names
+        for (i = 0; i < n; i++) {
+            if (set->lens[i] == len) {
+                for (j = 0;
+                     j < (int)len && set->names[i][j] == set->names[n][j];
+                     j++) {
+                }
+                if (j == (int)len) {
+                    return -1;
+                }
+            }
+        }
+    }
+    if (set->names[n]) {
+        // too many options
+        return -1;
+    }
+    set->n = n;
+    for (; seed < LAUXH_OPTION_MAXSEED; seed++) {
+        for (i = 0; i < n; i++) {
+            set->disp[i] = 0;
+        }
+        if (lauxh_optionset_place(set, seed) == 0) {
+            set->seed  = seed;
+            set->ready = LAUXH_OPTIONSET_READY;
+            return 0;
+        }
+    }
+    set->n = 0;
+    return -1;
+}
+
+/**
+ * @brief determine whether the hash table of the option set is published by
+ * `lauxh_optionset_init()` or built at compile time.
+ *
+ * @param set option set
+ * @return int 1 if true, otherwise 0.
+ */
+static inline int lauxh_optionset_isready(const lauxh_optionset_t *set)
+{
+    return __atomic_load_n(&set->ready, __ATOMIC_ACQUIRE) ==
+           LAUXH_OPTIONSET_READY;
+}
+
+/**
+ * @brief build the hash table of the option set if it is not built yet. the
+ * hash table is built in the local copy and published to the set once, and
+ * the other threads calling this function wait until it is published.
+ *
+ * @param set option set
+ * @return int 0 on success, or -1 with EINVAL if the names contain the
+ * duplicates or too many names.
+ */
+static inline int lauxh_optionset_init(lauxh_optionset_t *set)
+{
+    lauxh_optionset_t tmp = {};
+    int state             = 0;
+
+    for (;;) {
+        state = __atomic_load_n(&set->ready, __ATOMIC_ACQUIRE);
+        if (state == LAUXH_OPTIONSET_READY) {
+            return 0;
+        } else if (state == 0 &&
+                   __atomic_compare_exchange_n(
+                       &set->ready, &state, LAUXH_OPTIONSET_BUILDING, 0,
+                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            break;
+        }
+        // wait for the other thread to publish the hash table
+        sched_yield();
+    }
+
+    // the names are not changed by the other threads
+    memcpy(tmp.names, set->names, sizeof(tmp.names));
+    if (lauxh_optionset_build(&tmp) != 0) {
+        __atomic_store_n(&set->ready, 0, __ATOMIC_RELEASE);
+        errno = EINVAL;
+        return -1;
+    }
+    set->n    = tmp.n;
+    set->seed = tmp.seed;
+    memcpy(set->lens, tmp.lens, sizeof(tmp.lens));
+    memcpy(set->disp, tmp.disp, sizeof(tmp.disp));
+    memcpy(set->order, tmp.order, sizeof(tmp.order));
+    __atomic_store_n(&set->ready, LAUXH_OPTIONSET_READY, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/**
+ * @brief find the index of the option of the specified name.
+ *
+ * @param set option set that the hash table is built
+ * @param name name of the option
+ * @param len length of the name
+ * @return int index of the option, or -1 if not found.
+ */
+static inline int lauxh_optionset_find(const lauxh_optionset_t *set,
+                                       const char *name, size_t len)
+{
+    uint64_t h = 0;
+    int i      = 0;
+
+    if (LAUXH_UNLIKELY(!set->n)) {
+        return -1;
+    }
+    h = lauxh_option_hash(name, len, set->seed);
+    i = set->order[lauxh_option_slot(
+        h, set->disp[lauxh_option_bucket(h, set->n)], set->n)];
+    if (set->lens[i] == len && memcmp(set->names[i], name, len) == 0) {
+        return i;
+    }
+    return -1;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static LAUXH_COLD LAUXH_NOINLINE int lauxh_optionset_error(lua_State *L)
+{
+    return luaL_error(L, "option set is not initialized by "
+                         "lauxh_optionset_init()");
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static LAUXH_COLD LAUXH_NOINLINE int lauxh_option_error(lua_State *L, int idx,
+                                                        const char *name)
+{
+    return lauxh_argerror(L, idx, "invalid option '%s'", name);
+}
+
+/**
+ * @brief checks whether the value at the specified index is the name of the
+ * option in the option set and returns the index of the option; if not,
+ * raises an error report. it is similar to `luaL_checkoption()`.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param set option set that the hash table is built
+ * @return int index of the option
+ */
+static inline int lauxh_checkoption(lua_State *L, int idx,
+                                    const lauxh_optionset_t *set)
+{
+    size_t len       = 0;
+    const char *name = lauxh_checklstr(L, idx, &len);
+    int i            = 0;
+
+    if (LAUXH_UNLIKELY(!lauxh_optionset_isready(set))) {
+        return lauxh_optionset_error(L);
+    }
+    if (LAUXH_UNLIKELY((i = lauxh_optionset_find(set, name, len)) < 0)) {
+        return lauxh_option_error(L, idx, name);
+    }
+    return i;
+}
+
+/**
+ * @brief checks whether the value at the specified index is the name of the
+ * option in the option set and returns the index of the option; if it is nil,
+ * returns the specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param set option set
+ * @param def default value
+ * @return int index of the option
+ */
+static inline int lauxh_optoption(lua_State *L, int idx,
+                                  const lauxh_optionset_t *set, int def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    return lauxh_checkoption(L, idx, set);
+}
+
+/* treat integer arguments as bit flags  */
+
+static inline uint64_t lauxh_optflags(lua_State *L, int idx)
+{
+    const int argc = lua_gettop(L);
+    uint64_t flg   = 0;
+
+    for (; idx <= argc; idx++) {
+        flg |= lauxh_optuint64(L, idx, 0);
+    }
+
+    return flg;
+}
+
+/**
+ * flag set
+ *
+ * the flag set maps the names of the flags to the bits through the hash table
+ * of the option set, so the flags can be passed by the names instead of the
+ * bitwise OR of the integers.
+ *
+ * in C, the hash table of `opts` must be built by `lauxh_optionset_init()` in
+ * the `luaopen_*` function as well as the option set. it is published once,
+ * so the states on the multiple threads can load the module at the same time.
+ *
+ *  static lauxh_flagset_t OFLAGS = {
+ *      LAUXH_OPTIONSET_INIT("read", "write", "create"),
+ *      {O_RDONLY, O_WRONLY, O_CREAT},
+ *  };
+ *  // in luaopen_*
+ *  lauxh_optionset_init(&OFLAGS.opts);
+ *  // in the function
+ *  uint64_t flg = lauxh_optflagset(L, 2, &OFLAGS);
+ *
+ * in C++17 or later, the hash table is built at compile time by
+ * `lauxh::options()`.
+ *
+ *  static constexpr lauxh_flagset_t OFLAGS = {
+ *      lauxh::options("read", "write", "create"),
+ *      {O_RDONLY, O_WRONLY, O_CREAT},
+ *  };
+ */
+
+typedef struct {
+    lauxh_optionset_t opts;
+    // bits of each flag in the same order as the names
+    uint64_t bits[LAUXH_OPTION_MAX];
+} lauxh_flagset_t;
+
+/**
+ * @brief find the bits of the flag of the specified name.
+ *
+ * @param set flag set that the hash table is built
+ * @param name name of the flag
+ * @param len length of the name
+ * @param bits bits of the flag
+ * @return int 0 on success, or -1 if not found.
+ */
+static inline int lauxh_flagset_find(const lauxh_flagset_t *set,
+                                     const char *name, size_t len,
+                                     uint64_t *bits)
+{
+    int i = lauxh_optionset_find(&set->opts, name, len);
+
+    if (i < 0) {
+        return -1;
+    }
+    *bits = set->bits[i];
+    return 0;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static LAUXH_COLD LAUXH_NOINLINE uint64_t
+lauxh_flag_error(lua_State *L, int idx, int tidx, int row)
+{
+    if (lua_type(L, tidx) == LUA_TSTRING) {
+        if (row) {
+            lauxh_argerror(L, idx, "unknown flag '%s' at index %d",
+                           lua_tostring(L, tidx), row);
+        }
+        lauxh_argerror(L, idx, "unknown flag '%s'", lua_tostring(L, tidx));
+    } else if (row) {
+        lauxh_argerror(L, idx,
+                       "flag name or uint64_t expected at index %d, got %s",
+                       row, luaL_typename(L, tidx));
+    }
+    lauxh_argerror(L, idx, "flag name or uint64_t expected, got %s",
+                   luaL_typename(L, tidx));
+    return 0;
+}
+
+/**
+ * @brief convert the flag name or the integer at the index tidx to the bits.
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline uint64_t lauxh_flagset_tobits(lua_State *L, int idx, int tidx,
+                                            int row, const lauxh_flagset_t *set)
+{
+    uint64_t bits    = 0;
+    size_t len       = 0;
+    const char *name = NULL;
+
+    if (lua_type(L, tidx) == LUA_TSTRING) {
+        name = lua_tolstring(L, tidx, &len);
+        if (LAUXH_LIKELY(lauxh_flagset_find(set, name, len, &bits) == 0)) {
+            return bits;
+        }
+    } else if (lauxh_isuint64(L, tidx)) {
+        return (uint64_t)lua_tointeger(L, tidx);
+    }
+    return lauxh_flag_error(L, idx, tidx, row);
+}
+
+/**
+ * @brief treat the arguments from the specified index to the top of the stack
+ * as the bit flags, and returns the bitwise OR of them. each argument must be
+ * the flag name in the flag set, the `uint64_t` integer, nil, or the array of
+ * the flag names and the integers; otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the first argument
+ * @param set flag set that the hash table is built
+ * @return uint64_t
+ */
+static inline uint64_t lauxh_optflagset(lua_State *L, int idx,
+                                        const lauxh_flagset_t *set)
+{
+    const int argc = lua_gettop(L);
+    uint64_t flg   = 0;
+    int row        = 0;
+
+    if (LAUXH_UNLIKELY(!lauxh_optionset_isready(&set->opts))) {
+        lauxh_optionset_error(L);
+    }
+    for (; idx <= argc; idx++) {
+        switch (lua_type(L, idx)) {
+        case LUA_TNIL:
+            break;
+
+        case LUA_TTABLE:
+            for (row = 1;; row++) {
+                lua_rawgeti(L, idx, row);
+                if (lua_isnil(L, -1)) {
+                    lua_pop(L, 1);
+                    break;
+                }
+                flg |= lauxh_flagset_tobits(L, idx, argc + 1, row, set);
+                lua_pop(L, 1);
+            }
+            break;
+
+        default:
+            flg |= lauxh_flagset_tobits(L, idx, idx, 0, set);
+        }
+    }
+    lauxh_push_argerror_init();
+
+    return flg;
+}
+
+/**
+ * @brief checks whether the value at the specified index is the table; if not,
+ * raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ */
+static inline void lauxh_checktable(lua_State *L, int idx)
+{
+    lauxh_checktype(L, idx, LUA_TTABLE);
+}
+
+/**
+ * @brief checks whether the value at the specified index is the table and
+ * returns it index; if it is nil, returns the specified default value,
+ * otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the value
+ * @param def default value
+ * @return int index of the table
+ */
+static inline int lauxh_opttable(lua_State *L, int idx, int def)
+{
+    if (lauxh_isnil(L, idx)) {
+        lauxh_push_argerror_init();
+        return def;
+    }
+    lauxh_checktable(L, idx);
+    return idx;
+}
+
+/**
+ * NOTE: for table accessors
+ */
+
+/**
+ * @brief checks whether the value at the specified key of the table at the
+ * specified index is the table; if not, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param k key of the value
+ */
+static inline void lauxh_checktableof(lua_State *L, int idx, const char *k)
+{
+    lua_pushstring(L, k);
+    lua_rawget(L, idx);
+    lauxh_checktable(L, -1);
+}
+
+#define CHECK_VALUE_OF_KEY_IN_TABLE(tblidx, key, vtype, checkfn, ...)          \
+    do {                                                                       \
+        vtype v;                                                               \
+        lua_pushstring(L, (key));                                              \
+        lua_rawget(L, (tblidx));                                               \
+        v = checkfn(L, -1, ##__VA_ARGS__);                                     \
+        lua_pop(L, 1);                                                         \
+        return v;                                                              \
+    } while (0)
+
+/**
+ * @brief checks whether the value at the specified key of the table at the
+ * specified index is the string and returns it; if not, raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param k key of the value
+ * @param[out] len length of the value
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_checklstringof(lua_State *L, int idx,
+                                               const char *k, size_t *len)
+{
+    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, const char *, lauxh_checklstr, len);
+}
+
+/**
+ * @brief checks whether the value at the specified key of the table at the
+ * specified index is the string and returns it; if it is nil, returns the
+ * specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param k key of the value
+ * @param def default value
+ * @param[out] len length of the value
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_optlstringof(lua_State *L, int idx,
+                                             const char *k, const char *def,
+                                             size_t *len)
+{
+    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, const char *, lauxh_optlstr, def, len);
+}
+
+/**
+ * @brief checks whether the value at the specified key of the table at the
+ * specified index is the string and returns it; if not, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param k key of the value
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_checkstringof(lua_State *L, int idx,
+                                              const char *k)
+{
+    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, const char *, lauxh_checkstr);
+}
+
+/**
+ * @brief checks whether the value at the specified key of the table at the
+ * specified index is the string and returns it; if it is nil, returns the
+ * specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param k key of the value
+ * @param def default value
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_optstringof(lua_State *L, int idx,
+                                            const char *k, const char *def)
+{
+    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, const char *, lauxh_optstr, def);
+}
+
+/**
+ * @brief checks whether the value at the specified key of the table at the
+ * specified index is the number and returns it; if not, raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param k key of the value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_checknumberof(lua_State *L, int idx,
+                                             const char *k)
+{
+    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, lua_Number, lauxh_checknum);
+}
+
+/**
+ * @brief checks whether the value at the specified key of the table at the
+ * specified index is the number and returns it; if it is nil, returns the
+ * specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param k key of the value
+ * @param def default value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_optnumberof(lua_State *L, int idx, const char *k,
+                                           lua_Number def)
+{
+    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, lua_Number, lauxh_optnum, def);
+}
+
+/**
+ * @brief checks whether the value at the specified key of the table at the
+ * specified index is the integer and returns it; if not, raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param k key of the value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_checkintegerof(lua_State *L, int idx,
+                                               const char *k)
+{
+    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, lua_Integer, lauxh_checkint);
+}
+
+/**
+ * @brief checks whether the value at the specified key of the table at the
+ * specified index is the integer and returns it; if it is nil, returns the
+ * specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param k key of the value
+ * @param def default value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_optintegerof(lua_State *L, int idx,
+                                             const char *k, lua_Integer def)
+{
+    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, lua_Integer, lauxh_optint, def);
+}
+
+/**
+ * @brief checks whether the value at the specified key of the table at the
+ * specified index is the boolean and returns it; if not, raises an error
+ * report.
+ *
+ * @param L  lua state
+ * @param idx index of the table
+ * @param k key of the value
+ * @return int 1 if true, otherwise 0
+ */
+static inline int lauxh_checkbooleanof(lua_State *L, int idx, const char *k)
+{
+    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, int, lauxh_checkbool);
+}
+
+/**
+ * @brief checks whether the value at the specified key of the table at the
+ * specified index is the boolean and returns it; if it is nil, returns the
+ * specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param k key of the value
+ * @param def default value
+ * @return int 1 if true, otherwise 0
+ */
+static inline int lauxh_optbooleanof(lua_State *L, int idx, const char *k,
+                                     int def)
+{
+    CHECK_VALUE_OF_KEY_IN_TABLE(idx, k, int, lauxh_optbool, def);
+}
+
+#undef CHECK_VALUE_OF_KEY_IN_TABLE
+
+/**
+ * @brief checks whether the value at the key of the specified key id of the
+ * table at the specified index is the table; if not, raises an error report.
+ * similar to `lauxh_checktableof()`.
+ *
+ * @note the value is placed on the top of the stack.
+ * @param L lua state
+ * @param idx index of the table
+ * @param atlas index of the key atlas
+ * @param kid key id
+ */
+static inline void lauxh_checktableofk(lua_State *L, int idx, int atlas,
+                                       int kid)
+{
+    lauxh_gettblofk(L, atlas, kid, idx);
+    lauxh_checktable(L, -1);
+}
+
+#define CHECK_VALUE_OF_KID_IN_TABLE(tblidx, atlas, kid, vtype, checkfn, ...)   \
+    do {                                                                       \
+        vtype v;                                                               \
+        lauxh_gettblofk(L, (atlas), (kid), (tblidx));                          \
+        v = checkfn(L, -1, ##__VA_ARGS__);                                     \
+        lua_pop(L, 1);                                                         \
+        return v;                                                              \
+    } while (0)
+
+/**
+ * @brief checks whether the value at the key of the specified key id of the
+ * table at the specified index is the string and returns it; if not, raises an
+ * error report. similar to `lauxh_checklstringof()`.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param[out] len length of the value
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_checklstringofk(lua_State *L, int idx,
+                                                int atlas, int kid, size_t *len)
+{
+    CHECK_VALUE_OF_KID_IN_TABLE(idx, atlas, kid, const char *, lauxh_checklstr,
+                                len);
+}
+
+/**
+ * @brief checks whether the value at the key of the specified key id of the
+ * table at the specified index is the string and returns it; if it is nil,
+ * returns the specified default value, otherwise raises an error report.
+ * similar to `lauxh_optlstringof()`.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param def default value
+ * @param[out] len length of the value
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_optlstringofk(lua_State *L, int idx, int atlas,
+                                              int kid, const char *def,
+                                              size_t *len)
+{
+    CHECK_VALUE_OF_KID_IN_TABLE(idx, atlas, kid, const char *, lauxh_optlstr,
+                                def, len);
+}
+
+/**
+ * @brief checks whether the value at the key of the specified key id of the
+ * table at the specified index is the string and returns it; if not, raises an
+ * error report. similar to `lauxh_checkstringof()`.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_checkstringofk(lua_State *L, int idx,
+                                               int atlas, int kid)
+{
+    CHECK_VALUE_OF_KID_IN_TABLE(idx, atlas, kid, const char *,
+                                lauxh_checkstr);
+}
+
+/**
+ * @brief checks whether the value at the key of the specified key id of the
+ * table at the specified index is the string and returns it; if it is nil,
+ * returns the specified default value, otherwise raises an error report.
+ * similar to `lauxh_optstringof()`.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param def default value
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_optstringofk(lua_State *L, int idx, int atlas,
+                                             int kid, const char *def)
+{
+    CHECK_VALUE_OF_KID_IN_TABLE(idx, atlas, kid, const char *, lauxh_optstr,
+                                def);
+}
+
+/**
+ * @brief checks whether the value at the key of the specified key id of the
+ * table at the specified index is the number and returns it; if not, raises an
+ * error report. similar to `lauxh_checknumberof()`.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_checknumberofk(lua_State *L, int idx, int atlas,
+                                              int kid)
+{
+    CHECK_VALUE_OF_KID_IN_TABLE(idx, atlas, kid, lua_Number, lauxh_checknum);
+}
+
+/**
+ * @brief checks whether the value at the key of the specified key id of the
+ * table at the specified index is the number and returns it; if it is nil,
+ * returns the specified default value, otherwise raises an error report.
+ * similar to `lauxh_optnumberof()`.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param def default value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_optnumberofk(lua_State *L, int idx, int atlas,
+                                            int kid, lua_Number def)
+{
+    CHECK_VALUE_OF_KID_IN_TABLE(idx, atlas, kid, lua_Number, lauxh_optnum,
+                                def);
+}
+
+/**
+ * @brief checks whether the value at the key of the specified key id of the
+ * table at the specified index is the integer and returns it; if not, raises
+ * an error report. similar to `lauxh_checkintegerof()`.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_checkintegerofk(lua_State *L, int idx,
+                                                int atlas, int kid)
+{
+    CHECK_VALUE_OF_KID_IN_TABLE(idx, atlas, kid, lua_Integer, lauxh_checkint);
+}
+
+/**
+ * @brief checks whether the value at the key of the specified key id of the
+ * table at the specified index is the integer and returns it; if it is nil,
+ * returns the specified default value, otherwise raises an error report.
+ * similar to `lauxh_optintegerof()`.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param def default value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_optintegerofk(lua_State *L, int idx, int atlas,
+                                              int kid, lua_Integer def)
+{
+    CHECK_VALUE_OF_KID_IN_TABLE(idx, atlas, kid, lua_Integer, lauxh_optint,
+                                def);
+}
+
+/**
+ * @brief checks whether the value at the key of the specified key id of the
+ * table at the specified index is the boolean and returns it; if not, raises
+ * an error report. similar to `lauxh_checkbooleanof()`.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @return int 1 if true, otherwise 0
+ */
+static inline int lauxh_checkbooleanofk(lua_State *L, int idx, int atlas,
+                                        int kid)
+{
+    CHECK_VALUE_OF_KID_IN_TABLE(idx, atlas, kid, int, lauxh_checkbool);
+}
+
+/**
+ * @brief checks whether the value at the key of the specified key id of the
+ * table at the specified index is the boolean and returns it; if it is nil,
+ * returns the specified default value, otherwise raises an error report.
+ * similar to `lauxh_optbooleanof()`.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param atlas index of the key atlas
+ * @param kid key id
+ * @param def default value
+ * @return int 1 if true, otherwise 0
+ */
+static inline int lauxh_optbooleanofk(lua_State *L, int idx, int atlas, int kid,
+                                      int def)
+{
+    CHECK_VALUE_OF_KID_IN_TABLE(idx, atlas, kid, int, lauxh_optbool, def);
+}
+
+#undef CHECK_VALUE_OF_KID_IN_TABLE
+
+/**
+ * @brief checks whether the value at the specified array index of the table at
+ * the specified index is the table; if not, raises an error report.
+ *
+ * @note the value is placed on the top of the stack.
+ * @param L lua state
+ * @param idx index of the table
+ * @param row array index of the value
+ */
+static inline void lauxh_checktableat(lua_State *L, int idx, int row)
+{
+    lua_rawgeti(L, idx, row);
+    lauxh_checktable(L, -1);
+}
+
+#define CHECK_VALUE_OF_IDX_IN_TABLE(tblidx, idx, vtype, checkfn, ...)          \
+    do {                                                                       \
+        vtype v;                                                               \
+        lua_rawgeti(L, (tblidx), (idx));                                       \
+        v = checkfn(L, -1, ##__VA_ARGS__);                                     \
+        lua_pop(L, 1);                                                         \
+        return v;                                                              \
+    } while (0)
+
+/**
+ * @brief checks whether the value at the specified array index of the table at
+ * the specified index is the string and returns it; if not, raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param row array index of the value
+ * @param[out] len length of the value
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_checklstringat(lua_State *L, int idx, int row,
+                                               size_t *len)
+{
+    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, const char *, lauxh_checklstr, len);
+}
+
+/**
+ * @brief checks whether the value at the specified array index of the table at
+ * the specified index is the string and returns it; if it is nil, returns the
+ * specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param row array index of the value
+ * @param def default value
+ * @param[out] len length of the value
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_optlstringat(lua_State *L, int idx, int row,
+                                             const char *def, size_t *len)
+{
+    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, const char *, lauxh_optlstr, def,
+                                len);
+}
+
+/**
+ * @brief checks whether the value at the specified array index of the table at
+ * the specified index is the string and returns it; if not, raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param row array index of the value
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_checkstringat(lua_State *L, int idx, int row)
+{
+    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, const char *, lauxh_checkstr);
+}
+
+/**
+ * @brief checks whether the value at the specified array index of the table at
+ * the specified index is the string and returns it; if it is nil, returns the
+ * specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param row array index of the value
+ * @param def default value
+ * @return const char* pointer to the string
+ */
+static inline const char *lauxh_optstringat(lua_State *L, int idx, int row,
+                                            const char *def)
+{
+    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, const char *, lauxh_optstr, def);
+}
+
+/**
+ * @brief checks whether the value at the specified array index of the table at
+ * the specified index is the number and returns it; if not, raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param row array index of the value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_checknumberat(lua_State *L, int idx, int row)
+{
+    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, lua_Number, lauxh_checknum);
+}
+
+/**
+ * @brief checks whether the value at the specified array index of the table at
+ * the specified index is the number and returns it; if it is nil, returns the
+ * specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param row array index of the value
+ * @param def default value
+ * @return lua_Number
+ */
+static inline lua_Number lauxh_optnumberat(lua_State *L, int idx, int row,
+                                           lua_Number def)
+{
+    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, lua_Number, lauxh_optnum, def);
+}
+
+/**
+ * @brief checks whether the value at the specified array index of the table at
+ * the specified index is the integer and returns it; if not, raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param row array index of the value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_checkintegerat(lua_State *L, int idx, int row)
+{
+    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, lua_Integer, lauxh_checkint);
+}
+
+/**
+ * @brief checks whether the value at the specified array index of the table at
+ * the specified index is the integer and returns it; if it is nil, returns the
+ * specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param row array index of the value
+ * @param def default value
+ * @return lua_Integer
+ */
+static inline lua_Integer lauxh_optintegerat(lua_State *L, int idx, int row,
+                                             lua_Integer def)
+{
+    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, lua_Integer, lauxh_optint, def);
+}
+
+/**
+ * @brief checks whether the value at the specified array index of the table at
+ * the specified index is the boolean and returns it; if not, raises an error
+ * report.
+ *
+ * @param L  lua state
+ * @param idx index of the table
+ * @param row array index of the value
+ * @return int 1 if true, otherwise 0
+ */
+static inline int lauxh_checkbooleanat(lua_State *L, int idx, int row)
+{
+    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, int, lauxh_checkbool);
+}
+
+/**
+ * @brief checks whether the value at the specified array index of the table at
+ * the specified index is the boolean and returns it; if it is nil, returns the
+ * specified default value, otherwise raises an error report.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param row array index of the value
+ * @param def default value
+ * @return int 1 if true, otherwise 0
+ */
+static inline int lauxh_optbooleanat(lua_State *L, int idx, int row, int def)
+{
+    CHECK_VALUE_OF_IDX_IN_TABLE(idx, row, int, lauxh_optbool, def);
+}
+
+#undef CHECK_VALUE_OF_IDX_IN_TABLE
+
+/**
+ * NOTE: for the bulk array transfer
+ *
+ * `lauxh_toarray_<type>()` converts the elements from 1 to `n` of the table at
+ * the specified index into the C buffer in a tight loop, and returns the array
+ * index of the first invalid element, or 0 on success.
+ * `lauxh_checkarray_<type>()` raises an error report for the first invalid
+ * element instead, and `lauxh_pusharray_<type>()` pushes the new table that
+ * presized for `n` elements.
+ *
+ *  int64_t  int64_t element, the value must be integer
+ *  double   double element, the value must be number
+ *  uint8    uint8_t element, the value must be integer between 0 and 255
+ *
+ * @note these functions do not call the metamethod.
+ */
+
+#define ARRAY_CONVERTERS(name, ctype, tname, isfn, tofn, pushfn)               \
+    static inline size_t lauxh_toarray_##name(lua_State *L, int idx,          \
+                                               ctype *buf, size_t n)           \
+    {                                                                          \
+        size_t i = 0;                                                          \
+        for (; i < n; i++) {                                                   \
+            lua_rawgeti(L, idx, (int)i + 1);                                   \
+            if (!isfn(L, -1)) {                                                \
+                lua_pop(L, 1);                                                 \
+                return i + 1;                                                  \
+            }                                                                  \
+            buf[i] = (ctype)tofn(L, -1);                                       \
+            lua_pop(L, 1);                                                     \
+        }                                                                      \
+        return 0;                                                              \
+    }                                                                          \
+                                                                               \
+    static inline void lauxh_checkarray_##name(lua_State *L, int idx,          \
+                                               ctype *buf, size_t n)           \
+    {                                                                          \
+        size_t row = 0;                                                        \
+        lauxh_checktable(L, idx);                                              \
+        if (LAUXH_UNLIKELY(row = lauxh_toarray_##name(L, idx, buf, n))) {      \
+            lua_rawgeti(L, idx, (int)row);                                     \
+            lauxh_argerror(L, idx, tname " expected at index %d, got %s",      \
+                           (int)row,                                           \
+                           lua_type(L, -1) == LUA_TNUMBER ?                    \
+                               "an out of range value" :                       \
+                               luaL_typename(L, -1));                          \
+        }                                                                      \
+        lauxh_push_argerror_init();                                            \
+    }                                                                          \
+                                                                               \
+    static inline void lauxh_pusharray_##name(lua_State *L, const ctype *buf,  \
+                                              size_t n)                        \
+    {                                                                          \
+        size_t i = 0;                                                          \
+        lua_createtable(L, (int)n, 0);                                         \
+        for (; i < n; i++) {                                                   \
+            pushfn(L, buf[i]);                                                 \
+            lua_rawseti(L, -2, (int)i + 1);                                    \
+        }                                                                      \
+    }
+
+ARRAY_CONVERTERS(int64, int64_t, "int64_t", lauxh_isint, lua_tointeger,
+                 lua_pushinteger)
+ARRAY_CONVERTERS(double, double, "number", lauxh_isnum, lua_tonumber,
+                 lua_pushnumber)
+ARRAY_CONVERTERS(uint8, uint8_t, "uint8_t", lauxh_isuint8, lua_tointeger,
+                 lua_pushinteger)
+
+#undef ARRAY_CONVERTERS
+
+/**
+ * NOTE: for the argument signature
+ *
+ * `lauxh_checkargs()` validates and extracts the arguments from the index 1 in
+ * one pass over the stack according to the format string. each item of the
+ * format string consumes the output pointer(s) in order.
+ *
+ *  .       any value except none (no output)
+ *  b       boolean (int *)
+ *  n       number (lua_Number *)
+ *  f       finite number (lua_Number *)
+ *  i       integer (lua_Integer *)
+ *  i8      int8_t (int8_t *), also i16, i32 and i64
+ *  I       unsigned integer (lua_Integer *)
+ *  I8      uint8_t (uint8_t *), also I16, I32 and I64
+ *  s       string (const char **)
+ *  l       string with length (const char **, size_t *)
+ *  t       table (int *: index of the table)
+ *  F       function (int *: index of the function)
+ *  c       callable object (int *: index of the callable object)
+ *  T       thread (lua_State **)
+ *  p       light userdata (const void **)
+ *  u       userdata (void **)
+ *  u{name} userdata that has the metatable of the `name` (void **)
+ *
+ * the `?` suffix marks the item as optional, and all items after the `|` are
+ * optional. if the optional argument is nil or none, its output is left
+ * unchanged, so the output variable can be initialized with a default value.
+ * the white spaces are ignored.
+ *
+ *  const char *name = NULL;
+ *  int8_t lv        = 1;
+ *  lua_Number tmo   = -1;
+ *  void *udata      = NULL;
+ *  int tbl          = 0;
+ *  lauxh_checkargs(L, "s|i8 n? u{my.mt} t", &name, &lv, &tmo, &udata, &tbl);
+ *
+ * the format string can be compiled into the static descriptor once, and then
+ * be reused by `lauxh_checkargspec()`.
+ *
+ *  static lauxh_argspec_t spec = LAUXH_ARGSPEC_INIT;
+ *  lauxh_argspec_compile(L, &spec, "s|i8 n? u{my.mt} t");
+ *  lauxh_checkargspec(L, &spec, &name, &lv, &tmo, &udata, &tbl);
+ */
+
+enum {
+    LAUXH_ARG_ANY = 0,
+    LAUXH_ARG_BOOL,
+    LAUXH_ARG_NUM,
+    LAUXH_ARG_FINITE,
+    LAUXH_ARG_INT,
+    LAUXH_ARG_INT8,
+    LAUXH_ARG_INT16,
+    LAUXH_ARG_INT32,
+    LAUXH_ARG_INT64,
+    LAUXH_ARG_UINT,
+    LAUXH_ARG_UINT8,
+    LAUXH_ARG_UINT16,
+    LAUXH_ARG_UINT32,
+    LAUXH_ARG_UINT64,
+    LAUXH_ARG_STR,
+    LAUXH_ARG_LSTR,
+    LAUXH_ARG_TABLE,
+    LAUXH_ARG_FUNC,
+    LAUXH_ARG_CALLABLE,
+    LAUXH_ARG_THREAD,
+    LAUXH_ARG_POINTER,
+    LAUXH_ARG_USERDATA,
+    LAUXH_ARG_UDATA,
+};
+
+#define LAUXH_ARGSPEC_MAX 32
+
+typedef struct {
+    uint8_t type;
+    uint8_t opt;
+    uint16_t tnamelen;
+    // metatable name of LAUXH_ARG_UDATA (not null-terminated)
+    const char *tname;
+} lauxh_argitem_t;
+
+typedef struct {
+    // format string that compiled into this descriptor
+    const char *fmt;
+    int nitem;
+    lauxh_argitem_t item[LAUXH_ARGSPEC_MAX];
+} lauxh_argspec_t;
+
+#define LAUXH_ARGSPEC_INIT                                                     \
+    {                                                                          \
+        NULL, 0, {                                                             \
+            {0, 0, 0, NULL}                                                    \
+        }                                                                      \
+    }
+
+/**
+ * @brief compile the format string into the descriptor. if the descriptor is
+ * already compiled with the same format string, does nothing. if the format
+ * string is invalid, raises an error.
+ *
+ * @note the descriptor refers to the format string, so the format string must
+ * be alive while the descriptor is used.
+ * @param L lua state
+ * @param spec descriptor
+ * @param fmt format string
+ */
+static inline void lauxh_argspec_compile(lua_State *L, lauxh_argspec_t *spec,
+                                         const char *fmt)
+{
+    const char *p = fmt;
+    int opt       = 0;
+    int n         = 0;
+
+    if (spec->fmt == fmt) {
+        return;
+    }
+
+    while (*p) {
+        lauxh_argitem_t *item = NULL;
+        const char *head      = p;
+        int bits              = 0;
+
+        switch (*p) {
+        case ' ':
+        case '\t':
+        case '\n':
+            p++;
+            continue;
+
+        case '|':
+            opt = 1;
+            p++;
+            continue;
+        }
+
+        if (n == LAUXH_ARGSPEC_MAX) {
+            luaL_error(L, "too many items in the argument format \"%s\"", fmt);
+        }
+        item           = spec->item + n++;
+        item->opt      = opt;
+        item->tname    = NULL;
+        item->tnamelen = 0;
+
+        switch (*p++) {
+        case '.':
+            item->type = LAUXH_ARG_ANY;
+            break;
+        case 'b':
+            item->type = LAUXH_ARG_BOOL;
+            break;
+        case 'n':
+            item->type = LAUXH_ARG_NUM;
+            break;
+        case 'f':
+            item->type = LAUXH_ARG_FINITE;
+            break;
+        case 'i':
+        case 'I':
+            if (p[0] == '8') {
+                bits = 8;
+                p++;
+            } else if ((p[0] == '1' && p[1] == '6') ||
+                       (p[0] == '3' && p[1] == '2') ||
+                       (p[0] == '6' && p[1] == '4')) {
+                bits = (p[0] - '0') * 10 + (p[1] - '0');
+                p += 2;
+            }
+            switch (bits) {
+            case 8:
+                item->type = LAUXH_ARG_INT8;
+                break;
+            case 16:
+                item->type = LAUXH_ARG_INT16;
+                break;
+            case 32:
+                item->type = LAUXH_ARG_INT32;
+                break;
+            case 64:
+                item->type = LAUXH_ARG_INT64;
+                break;
+            default:
+                item->type = LAUXH_ARG_INT;
+            }
+            if (*head == 'I') {
+                // unsigned variants are placed after the signed variants
+                item->type += LAUXH_ARG_UINT - LAUXH_ARG_INT;
+            }
+            break;
+        case 's':
+            item->type = LAUXH_ARG_STR;
+            break;
+        case 'l':
+            item->type = LAUXH_ARG_LSTR;
+            break;
+        case 't':
+            item->type = LAUXH_ARG_TABLE;
+            break;
+        case 'F':
+            item->type = LAUXH_ARG_FUNC;
+            break;
+        case 'c':
+            item->type = LAUXH_ARG_CALLABLE;
+            break;
+        case 'T':
+            item->type = LAUXH_ARG_THREAD;
+            break;
+        case 'p':
+            item->type = LAUXH_ARG_POINTER;
+            break;
+        case 'u':
+            item->type = LAUXH_ARG_USERDATA;
+            if (*p == '{') {
+                const char *tail = strchr(++p, '}');
+                if (!tail || tail == p || tail - p > UINT16_MAX) {
+                    luaL_error(L,
+                               "invalid metatable name at %d in the argument "
+                               "format \"%s\"",
+                               (int)(p - fmt), fmt);
+                }
+                item->type     = LAUXH_ARG_UDATA;
+                item->tname    = p;
+                item->tnamelen = (uint16_t)(tail - p);
+                p              = tail + 1;
+            }
+            break;
+        default:
+            luaL_error(L,
+                       "invalid character '%c' at %d in the argument format "
+                       "\"%s\"",
+                       *head, (int)(head - fmt + 1), fmt);
+        }
+
+        if (*p == '?') {
+            item->opt = 1;
+            p++;
+        }
+    }
+
+    spec->nitem = n;
+    spec->fmt   = fmt;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_argspec_toint(lua_State *L, int idx, int t,
+                                      lua_Integer min, lua_Integer max,
+                                      lua_Integer *v)
+{
+    if (t == LUA_TNUMBER && lauxh_isint(L, idx)) {
+        *v = lua_tointeger(L, idx);
+        return *v >= min && *v <= max;
+    }
+    return 0;
+}
+
+/**
+ * @brief checks the arguments from the index 1 according to the compiled
+ * descriptor and stores the values to the output pointers in the `ap`.
+ *
+ * @param L lua state
+ * @param spec compiled descriptor
+ * @param ap output pointers
+ */
+static inline void lauxh_vcheckargspec(lua_State *L,
+                                       const lauxh_argspec_t *spec, va_list ap)
+{
+#define ARGSPEC_INTEGER(ctype, min, max, checkfn)                              \
+    do {                                                                       \
+        lua_Integer v = 0;                                                     \
+        ctype *out    = va_arg(ap, ctype *);                                   \
+        if (lauxh_argspec_toint(L, idx, t, (min), (max), &v)) {                \
+            *out = (ctype)v;                                                   \
+        } else {                                                               \
+            /* raises an error */                                              \
+            *out = (ctype)checkfn(L, idx);                                     \
+        }                                                                      \
+    } while (0)
+
+    const lauxh_argitem_t *item = spec->item;
+    const lauxh_argitem_t *tail = item + spec->nitem;
+    int idx                     = 1;
+
+    for (; item < tail; item++, idx++) {
+        int t = lua_type(L, idx);
+
+        if (t <= LUA_TNIL && item->opt) {
+            // skip the output pointers
+            switch (item->type) {
+            case LAUXH_ARG_ANY:
+                break;
+            case LAUXH_ARG_LSTR:
+                (void)va_arg(ap, void *);
+                // fallthrough
+            default:
+                (void)va_arg(ap, void *);
+            }
+            continue;
+        }
+
+        switch (item->type) {
+        case LAUXH_ARG_ANY:
+            if (t == LUA_TNONE) {
+                lauxh_argerror(L, idx, "value expected");
+            }
+            break;
+
+        case LAUXH_ARG_BOOL:
+            if (t != LUA_TBOOLEAN) {
+                lauxh_checktype(L, idx, LUA_TBOOLEAN);
+            }
+            *va_arg(ap, int *) = lua_toboolean(L, idx);
+            break;
+
+        case LAUXH_ARG_NUM:
+            if (t != LUA_TNUMBER) {
+                lauxh_checknum(L, idx);
+            }
+            *va_arg(ap, lua_Number *) = lua_tonumber(L, idx);
+            break;
+
+        case LAUXH_ARG_FINITE:
+            if (t != LUA_TNUMBER || !isfinite(lua_tonumber(L, idx))) {
+                lauxh_checkfinite(L, idx);
+            }
+            *va_arg(ap, lua_Number *) = lua_tonumber(L, idx);
+            break;
+
+        case LAUXH_ARG_INT:
+            if (t != LUA_TNUMBER || !lauxh_isint(L, idx)) {
+                lauxh_checkint(L, idx);
+            }
+            *va_arg(ap, lua_Integer *) = lua_tointeger(L, idx);
+            break;
+        case LAUXH_ARG_INT8:
+            ARGSPEC_INTEGER(int8_t, INT8_MIN, INT8_MAX, lauxh_checkint8);
+            break;
+        case LAUXH_ARG_INT16:
+            ARGSPEC_INTEGER(int16_t, INT16_MIN, INT16_MAX, lauxh_checkint16);
+            break;
+        case LAUXH_ARG_INT32:
+            ARGSPEC_INTEGER(int32_t, INT32_MIN, INT32_MAX, lauxh_checkint32);
+            break;
+        case LAUXH_ARG_INT64:
+            ARGSPEC_INTEGER(int64_t, INT64_MIN, INT64_MAX, lauxh_checkint64);
+            break;
+
+        case LAUXH_ARG_UINT:
+            if (t != LUA_TNUMBER || !lauxh_isuint(L, idx)) {
+                lauxh_checkuint(L, idx);
+            }
+            *va_arg(ap, lua_Integer *) = lua_tointeger(L, idx);
+            break;
+        case LAUXH_ARG_UINT8:
+            ARGSPEC_INTEGER(uint8_t, 0, UINT8_MAX, lauxh_checkuint8);
+            break;
+        case LAUXH_ARG_UINT16:
+            ARGSPEC_INTEGER(uint16_t, 0, UINT16_MAX, lauxh_checkuint16);
+            break;
+        case LAUXH_ARG_UINT32:
+            ARGSPEC_INTEGER(uint32_t, 0, UINT32_MAX, lauxh_checkuint32);
+            break;
+        case LAUXH_ARG_UINT64:
+            ARGSPEC_INTEGER(uint64_t, 0, INT64_MAX, lauxh_checkuint64);
+            break;
+
+        case LAUXH_ARG_STR:
+            if (t != LUA_TSTRING) {
+                lauxh_checktype(L, idx, LUA_TSTRING);
+            }
+            *va_arg(ap, const char **) = lua_tostring(L, idx);
+            break;
+
+        case LAUXH_ARG_LSTR: {
+            const char **str = va_arg(ap, const char **);
+            size_t *len      = va_arg(ap, size_t *);
+            if (t != LUA_TSTRING) {
+                lauxh_checktype(L, idx, LUA_TSTRING);
+            }
+            *str = lua_tolstring(L, idx, len);
+        } break;
+
+        case LAUXH_ARG_TABLE:
+            if (t != LUA_TTABLE) {
+                lauxh_checktype(L, idx, LUA_TTABLE);
+            }
+            *va_arg(ap, int *) = idx;
+            break;
+
+        case LAUXH_ARG_FUNC:
+            if (t != LUA_TFUNCTION) {
+                lauxh_checktype(L, idx, LUA_TFUNCTION);
+            }
+            *va_arg(ap, int *) = idx;
+            break;
+
+        case LAUXH_ARG_CALLABLE:
+            if (t != LUA_TFUNCTION) {
+                lauxh_checkcallable(L, idx);
+            }
+            *va_arg(ap, int *) = idx;
+            break;
+
+        case LAUXH_ARG_THREAD:
+            if (t != LUA_TTHREAD) {
+                lauxh_checktype(L, idx, LUA_TTHREAD);
+            }
+            *va_arg(ap, lua_State **) = lua_tothread(L, idx);
+            break;
+
+        case LAUXH_ARG_POINTER:
+            if (t != LUA_TLIGHTUSERDATA) {
+                lauxh_checktype(L, idx, LUA_TLIGHTUSERDATA);
+            }
+            *va_arg(ap, const void **) = lua_topointer(L, idx);
+            break;
+
+        case LAUXH_ARG_USERDATA:
+            if (t != LUA_TUSERDATA) {
+                lauxh_checktype(L, idx, LUA_TUSERDATA);
+            }
+            *va_arg(ap, void **) = lua_touserdata(L, idx);
+            break;
+
+        case LAUXH_ARG_UDATA: {
+            int ok = 0;
+            if (t == LUA_TUSERDATA && lua_getmetatable(L, idx)) {
+                lua_pushlstring(L, item->tname, item->tnamelen);
+                lua_rawget(L, LUA_REGISTRYINDEX);
+                ok = lua_rawequal(L, -1, -2);
+                lua_pop(L, 2);
+            }
+            if (!ok) {
+                // raises an error with the null-terminated name
+                lua_pushlstring(L, item->tname, item->tnamelen);
+                luaL_checkudata(L, idx, lua_tostring(L, -1));
+            }
+            *va_arg(ap, void **) = lua_touserdata(L, idx);
+        } break;
+        }
+    }
+    lauxh_push_argerror_init();
+
+#undef ARGSPEC_INTEGER
+}
+
+/**
+ * @brief checks the arguments from the index 1 according to the compiled
+ * descriptor and stores the values to the output pointers.
+ *
+ * @param L lua state
+ * @param spec compiled descriptor
+ * @param ... output pointers
+ */
+static inline void lauxh_checkargspec(lua_State *L,
+                                      const lauxh_argspec_t *spec, ...)
+{
+    va_list ap;
+
+    va_start(ap, spec);
+    lauxh_vcheckargspec(L, spec, ap);
+    va_end(ap);
+}
+
+/**
+ * @brief checks the arguments from the index 1 according to the format string
+ * and stores the values to the output pointers.
+ *
+ * @param L lua state
+ * @param fmt format string
+ * @param ... output pointers
+ */
+static inline void lauxh_checkargs(lua_State *L, const char *fmt, ...)
+{
+    lauxh_argspec_t spec = LAUXH_ARGSPEC_INIT;
+    va_list ap;
+
+    lauxh_argspec_compile(L, &spec, fmt);
+    va_start(ap, fmt);
+    lauxh_vcheckargspec(L, &spec, ap);
+    va_end(ap);
+}
+
+/**
+ * NOTE: for the struct marshalling
+ *
+ * the field descriptor describes the member of the C struct; its offset, C
+ * type, lua key and constraints. `lauxh_pushstruct()` converts the struct into
+ * the presized table in one pass, and `lauxh_checkstruct()` decodes the table
+ * into the struct in one pass and raises a single error that lists all the
+ * invalid fields. the descriptor array must be terminated by
+ * `LAUXH_FIELD_END`.
+ *
+ *  typedef struct {
+ *      int32_t port;
+ *      double timeout;
+ *      int verbose;
+ *      char host[64];
+ *  } conf_t;
+ *
+ *  static const lauxh_field_t CONF_FIELDS[] = {
+ *      LAUXH_FIELD_RANGE(conf_t, port, INT32, 1, 65535),
+ *      LAUXH_FIELD_OPT(conf_t, timeout, DOUBLE),
+ *      LAUXH_FIELD_OPT(conf_t, verbose, BOOL),
+ *      LAUXH_FIELD(conf_t, host, CHARS),
+ *      LAUXH_FIELD_END,
+ *  };
+ *
+ *  conf_t conf = {.timeout = 1.5};
+ *  lauxh_checkstruct(L, 1, CONF_FIELDS, &conf);
+ *  ...
+ *  lauxh_pushstruct(L, CONF_FIELDS, &conf);
+ *
+ * the optional field is left unchanged if the value is nil. the range
+ * constraint is applied to the numeric fields.
+ *
+ * @note the LAUXH_FTYPE_STR field points to the string in the table, so the
+ * table must be alive while the struct is used.
+ */
+
+enum {
+    LAUXH_FTYPE_BOOL = 0, // int
+    LAUXH_FTYPE_INT,      // lua_Integer
+    LAUXH_FTYPE_INT8,
+    LAUXH_FTYPE_INT16,
+    LAUXH_FTYPE_INT32,
+    LAUXH_FTYPE_INT64,
+    LAUXH_FTYPE_UINT8,
+    LAUXH_FTYPE_UINT16,
+    LAUXH_FTYPE_UINT32,
+    LAUXH_FTYPE_UINT64,
+    LAUXH_FTYPE_NUM, // lua_Number
+    LAUXH_FTYPE_FLOAT,
+    LAUXH_FTYPE_DOUBLE,
+    LAUXH_FTYPE_STR,   // const char *
+    LAUXH_FTYPE_CHARS, // char[N], null-terminated
+};
+
+#define LAUXH_FIELDF_OPT   0x1
+#define LAUXH_FIELDF_RANGE 0x2
+
+typedef struct {
+    const char *name;
+    uint8_t type;
+    uint8_t flags;
+    size_t offset;
+    size_t size;
+    lua_Number min;
+    lua_Number max;
+} lauxh_field_t;
+
+#define LAUXH_FIELD_DEF(st, m, t, flags, min, max)                             \
+    {                                                                          \
+        #m, LAUXH_FTYPE_##t, (flags), offsetof(st, m), sizeof(((st *)0)->m),   \
+            (min), (max)                                                       \
+    }
+#define LAUXH_FIELD(st, m, t)     LAUXH_FIELD_DEF(st, m, t, 0, 0, 0)
+#define LAUXH_FIELD_OPT(st, m, t)                                              \
+    LAUXH_FIELD_DEF(st, m, t, LAUXH_FIELDF_OPT, 0, 0)
+#define LAUXH_FIELD_RANGE(st, m, t, min, max)                                  \
+    LAUXH_FIELD_DEF(st, m, t, LAUXH_FIELDF_RANGE, min, max)
+#define LAUXH_FIELD_END                                                        \
+    {                                                                          \
+        NULL, 0, 0, 0, 0, 0, 0                                                 \
+    }
+
+/**
+ * @brief push the table that converted from the struct according to the field
+ * descriptors onto the stack.
+ *
+ * @param L lua state
+ * @param fields field descriptors terminated by `LAUXH_FIELD_END`
+ * @param src pointer to the struct
+ */
+static inline void lauxh_pushstruct(lua_State *L, const lauxh_field_t *fields,
+                                    const void *src)
+{
+    const lauxh_field_t *f = fields;
+    int n                  = 0;
+
+    while (f[n].name) {
+        n++;
+    }
+    lua_createtable(L, 0, n);
+
+    for (; f->name; f++) {
+        const char *p = (const char *)src + f->offset;
+
+        lua_pushstring(L, f->name);
+        switch (f->type) {
+        case LAUXH_FTYPE_BOOL:
+            lua_pushboolean(L, *(const int *)p);
+            break;
+        case LAUXH_FTYPE_INT:
+            lua_pushinteger(L, *(const lua_Integer *)p);
+            break;
+        case LAUXH_FTYPE_INT8:
+            lua_pushinteger(L, *(const int8_t *)p);
+            break;
+        case LAUXH_FTYPE_INT16:
+            lua_pushinteger(L, *(const int16_t *)p);
+            break;
+        case LAUXH_FTYPE_INT32:
+            lua_pushinteger(L, *(const int32_t *)p);
+            break;
+        case LAUXH_FTYPE_INT64:
+            lua_pushinteger(L, (lua_Integer)*(const int64_t *)p);
+            break;
+        case LAUXH_FTYPE_UINT8:
+            lua_pushinteger(L, *(const uint8_t *)p);
+            break;
+        case LAUXH_FTYPE_UINT16:
+            lua_pushinteger(L, *(const uint16_t *)p);
+            break;
+        case LAUXH_FTYPE_UINT32:
+            lua_pushinteger(L, (lua_Integer)*(const uint32_t *)p);
+            break;
+        case LAUXH_FTYPE_UINT64:
+            lua_pushinteger(L, (lua_Integer)*(const uint64_t *)p);
+            break;
+        case LAUXH_FTYPE_NUM:
+            lua_pushnumber(L, *(const lua_Number *)p);
+            break;
+        case LAUXH_FTYPE_FLOAT:
+            lua_pushnumber(L, *(const float *)p);
+            break;
+        case LAUXH_FTYPE_DOUBLE:
+            lua_pushnumber(L, *(const double *)p);
+            break;
+        case LAUXH_FTYPE_STR:
+            if (*(const char *const *)p) {
+                lua_pushstring(L, *(const char *const *)p);
+            } else {
+                lua_pushnil(L);
+            }
+            break;
+        case LAUXH_FTYPE_CHARS:
+            lua_pushlstring(L, p, strnlen(p, f->size));
+            break;
+        default:
+            luaL_error(L, "unknown field type %d of '%s'", f->type, f->name);
+        }
+        lua_rawset(L, -3);
+    }
+}
+
+/**
+ * @brief decode the table at the specified index into the struct according to
+ * the field descriptors. the error message of all the invalid fields is
+ * written to the `errbuf`.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param fields field descriptors terminated by `LAUXH_FIELD_END`
+ * @param dst pointer to the struct
+ * @param errbuf buffer for the error message
+ * @param errlen size of the errbuf
+ * @return int number of the invalid fields
+ */
+static inline int lauxh_tostruct(lua_State *L, int idx,
+                                 const lauxh_field_t *fields, void *dst,
+                                 char *errbuf, size_t errlen)
+{
+    const lauxh_field_t *f = fields;
+    size_t len             = 0;
+    int nerr               = 0;
+
+    if (errlen) {
+        *errbuf = 0;
+    }
+    if (idx < 0) {
+        idx = lua_gettop(L) + idx + 1;
+    }
+
+    for (; f->name; f++) {
+        char *p           = (char *)dst + f->offset;
+        const char *tname = NULL;
+        lua_Integer iv    = 0;
+        lua_Number nv     = 0;
+        int t             = 0;
+
+        lua_pushstring(L, f->name);
+        lua_rawget(L, idx);
+        t = lua_type(L, -1);
+        if (t == LUA_TNIL && (f->flags & LAUXH_FIELDF_OPT)) {
+            lua_pop(L, 1);
+            continue;
+        }
+
+#define TO_INT(lo, hi)                                                         \
+    do {                                                                       \
+        if (!lauxh_argspec_toint(L, -1, t, (lo), (hi), &iv) ||                 \
+            ((f->flags & LAUXH_FIELDF_RANGE) &&                                \
+             ((lua_Number)iv < f->min || (lua_Number)iv > f->max))) {          \
+            goto INVALID;                                                      \
+        }                                                                      \
+    } while (0)
+
+#define TO_NUM()                                                               \
+    do {                                                                       \
+        if (t != LUA_TNUMBER) {                                                \
+            goto INVALID;                                                      \
+        }                                                                      \
+        nv = lua_tonumber(L, -1);                                              \
+        if ((f->flags & LAUXH_FIELDF_RANGE) && (nv < f->min || nv > f->max)) { \
+            goto INVALID;                                                      \
+        }                                                                      \
+    } while (0)
+
+        switch (f->type) {
+        case LAUXH_FTYPE_BOOL:
+            tname = "boolean";
+            if (t != LUA_TBOOLEAN) {
+                goto INVALID;
+            }
+            *(int *)p = lua_toboolean(L, -1);
+            break;
+        case LAUXH_FTYPE_INT:
+            tname = "integer";
+            TO_INT(INT64_MIN, INT64_MAX);
+            *(lua_Integer *)p = iv;
+            break;
+        case LAUXH_FTYPE_INT8:
+            tname = "int8_t";
+            TO_INT(INT8_MIN, INT8_MAX);
+            *(int8_t *)p = (int8_t)iv;
+            break;
+        case LAUXH_FTYPE_INT16:
+            tname = "int16_t";
+            TO_INT(INT16_MIN, INT16_MAX);
+            *(int16_t *)p = (int16_t)iv;
+            break;
+        case LAUXH_FTYPE_INT32:
+            tname = "int32_t";
+            TO_INT(INT32_MIN, INT32_MAX);
+            *(int32_t *)p = (int32_t)iv;
+            break;
+        case LAUXH_FTYPE_INT64:
+            tname = "int64_t";
+            TO_INT(INT64_MIN, INT64_MAX);
+            *(int64_t *)p = (int64_t)iv;
+            break;
+        case LAUXH_FTYPE_UINT8:
+            tname = "uint8_t";
+            TO_INT(0, UINT8_MAX);
+            *(uint8_t *)p = (uint8_t)iv;
+            break;
+        case LAUXH_FTYPE_UINT16:
+            tname = "uint16_t";
+            TO_INT(0, UINT16_MAX);
+            *(uint16_t *)p = (uint16_t)iv;
+            break;
+        case LAUXH_FTYPE_UINT32:
+            tname = "uint32_t";
+            TO_INT(0, (lua_Integer)UINT32_MAX);
+            *(uint32_t *)p = (uint32_t)iv;
+            break;
+        case LAUXH_FTYPE_UINT64:
+            tname = "uint64_t";
+            TO_INT(0, INT64_MAX);
+            *(uint64_t *)p = (uint64_t)iv;
+            break;
+        case LAUXH_FTYPE_NUM:
+            tname = "number";
+            TO_NUM();
+            *(lua_Number *)p = nv;
+            break;
+        case LAUXH_FTYPE_FLOAT:
+            tname = "float";
+            TO_NUM();
+            *(float *)p = (float)nv;
+            break;
+        case LAUXH_FTYPE_DOUBLE:
+            tname = "double";
+            TO_NUM();
+            *(double *)p = (double)nv;
+            break;
+        case LAUXH_FTYPE_STR:
+            tname = "string";
+            if (t != LUA_TSTRING) {
+                goto INVALID;
+            }
+            *(const char **)p = lua_tostring(L, -1);
+            break;
+        case LAUXH_FTYPE_CHARS: {
+            size_t slen   = 0;
+            const char *s = NULL;
+
+            tname = "string";
+            if (t != LUA_TSTRING ||
+                (s = lua_tolstring(L, -1, &slen), slen >= f->size)) {
+                goto INVALID;
+            }
+            memcpy(p, s, slen + 1);
+        } break;
+        default:
+            luaL_error(L, "unknown field type %d of '%s'", f->type, f->name);
+        }
+
+#undef TO_INT
+#undef TO_NUM
+
+        lua_pop(L, 1);
+        continue;
+
+INVALID:
+        nerr++;
+        if (len < errlen) {
+            const char *sep = (nerr > 1) ? ", " : "";
+            const char *got = lua_typename(L, t);
+            int rv          = 0;
+
+            if (t == LUA_TNUMBER) {
+                got = "an out of range value";
+            } else if (t == LUA_TSTRING && f->type == LAUXH_FTYPE_CHARS) {
+                got = "too long string";
+            }
+            if (f->flags & LAUXH_FIELDF_RANGE) {
+                rv = snprintf(errbuf + len, errlen - len,
+                              "%sfield '%s' %s in range %g to %g expected, "
+                              "got %s",
+                              sep, f->name, tname, (double)f->min,
+                              (double)f->max, got);
+            } else {
+                rv = snprintf(errbuf + len, errlen - len,
+                              "%sfield '%s' %s expected, got %s", sep, f->name,
+                              tname, got);
+            }
+            if (rv > 0) {
+                len += (size_t)rv;
+            }
+        }
+        lua_pop(L, 1);
+    }
+
+    return nerr;
+}
+
+/**
+ * @brief checks whether the value at the specified index is the table and
+ * decodes it into the struct according to the field descriptors; if not, or
+ * if any of the fields is invalid, raises a single error report that lists
+ * all the invalid fields.
+ *
+ * @param L lua state
+ * @param idx index of the table
+ * @param fields field descriptors terminated by `LAUXH_FIELD_END`
+ * @param dst pointer to the struct
+ */
+static inline void lauxh_checkstruct(lua_State *L, int idx,
+                                     const lauxh_field_t *fields, void *dst)
+{
+    char buf[255];
+
+    lauxh_checktable(L, idx);
+    if (lauxh_tostruct(L, idx, fields, dst, buf, sizeof(buf))) {
+        lauxh_argerror(L, idx, "%s", buf);
+    }
+    lauxh_push_argerror_init();
+}
+
+/**
+ * NOTE: helper functions
+ */
+
+/**
+ * @brief get a file descriptor from the file handle at the specified index. if
+ * FILE* is NULL, returns -1, or if it is not a file handle, raises an error
+ * report.
+ *
+ * @param L lua state
+ * @param idx index of the file handle
+ * @return int file descriptor
+ */
+static inline int lauxh_fileno(lua_State *L, int idx)
+{
+    FILE *f = lauxh_checkfile(L, idx);
+    if (f) {
+        return fileno(f);
+    }
+    return -1;
+}
+
+/**
+ * @brief create a new file handle from the file descriptor and push it to the
+ * top of the stack, and returns the FILE*. if failed, places nil, error message
+ * and errno on the top of the stack and returns NULL.
+ *
+ * @param L lua state
+ * @param fd file descriptor
+ * @param mode mode string passed to fdopen()
+ * @param fname file name if not NULL, create a file in fname
+ * @return FILE*
+ */
+static inline FILE *lauxh_tofile(lua_State *L, int fd, const char *mode,
+                                 const char *fname)
+{
+    int top    = lua_gettop(L);
+    FILE *fp   = NULL;
+    FILE **lfp = NULL;
+    int narg   = 0;
+
+    // push a function to create a file handle
+    if (fname) {
+        static int tofile_open_ref = LUA_NOREF;
+
+        if (tofile_open_ref == LUA_NOREF) {
+            luaL_loadstring(L, "return io.open(...)");
+            tofile_open_ref = lauxh_ref(L);
+        }
+        lauxh_pushref(L, tofile_open_ref);
+        lua_pushstring(L, fname);
+        lua_pushstring(L, mode);
+        narg = 2;
+    } else {
+        static int tofile_tmpfile_ref = LUA_NOREF;
+
+        if (tofile_tmpfile_ref == LUA_NOREF) {
+            luaL_loadstring(L, "return io.tmpfile()");
+            tofile_tmpfile_ref = lauxh_ref(L);
+        }
+        lauxh_pushref(L, tofile_tmpfile_ref);
+    }
+
+    // call function
+    if (lua_pcall(L, narg, LUA_MULTRET, 0) != 0) {
+        // runtime error
+        lua_pushnil(L);
+        lua_insert(L, top + 1);
+        return NULL;
+    } else if (lua_gettop(L) - top != 1) {
+        // got error
+        return NULL;
+    }
+
+    // create a new stream associated with the existing file descriptor
+    if ((fp = fdopen(fd, mode)) == NULL) {
+        lua_settop(L, top);
+        lua_pushnil(L);
+        if (fname) {
+            lua_pushfstring(L, "%s: %s", fname, strerror(errno));
+        } else {
+            lua_pushstring(L, strerror(errno));
+        }
+        lua_pushinteger(L, errno);
+        return NULL;
+    }
+
+    // replace a stream of a file handle with a new stream
+    lfp = lauxh_checkfilep(L, -1);
+    fclose(*lfp);
+    *lfp = fp;
+
+    return fp;
+}
+
+/**
+ * @brief create a traceback for the stack `src` and push it to stack `L`.
+ *
+ * @param L lua state if NULL, then push the traceback to the `src` stack.
+ * @param src lua state
+ * @param msg error message appended to the beginning of the traceback.
+ * @param lv which level to start the traceback.
+ */
+static inline void lauxh_traceback(lua_State *L, lua_State *src,
+                                   const char *msg, int lv)
+{
+#if LUA_VERSION_NUM >= 502
+    // push src stack trace to dst state
+    luaL_traceback((L) ? L : src, src, msg, lv);
+
+#else
+    lua_Debug ar;
+    luaL_Buffer b;
+
+    luaL_buffinit(src, &b);
+    if (msg) {
+        luaL_addstring(&b, msg);
+        luaL_addchar(&b, '\n');
+    }
+
+    // get stackinfo
+    luaL_addstring(&b, "stack traceback:");
+    while (lua_getstack(src, lv++, &ar)) {
+        lua_getinfo(src, "Sln", &ar);
+        if (ar.currentline <= 0) {
+            lua_pushfstring(src, "\n\t%s: in ", ar.short_src);
+        } else {
+            lua_pushfstring(src, "\n\t%s:%d: in ", ar.short_src,
+                            ar.currentline);
+        }
+        luaL_addvalue(&b);
+
+        // is there a name from code?
+        if (*ar.namewhat != '\0') {
+            lua_pushfstring(src, "%s '%s'", ar.namewhat, ar.name);
+        }
+        // main
+        else if (*ar.what == 'm') {
+            lua_pushliteral(src, "main chunk");
+        }
+        // not C function, use <file:line>
+        else if (*ar.what == 'C') {
+            lua_pushliteral(src, "?");
+        } else {
+            lua_pushfstring(src, "function <%s:%d>", ar.short_src,
+                            ar.linedefined);
+        }
+        luaL_addvalue(&b);
+
+        if (*ar.what == 't') {
+            luaL_addstring(&b, "\n\t(...tail calls...)");
+        }
+    }
+
+    luaL_pushresult(&b);
+    if (L) {
+        lua_xmove(src, L, 1);
+    }
+#endif
+}
+
+typedef struct {
+    // index of the table that maps the pointer of the source table to the
+    // destination table in the `to` state
+    int visited;
+    // index of the work stack of the destination tables in the `to` state
+    int pending;
+    // index of the work stack of the source tables in the `from` state
+    int fpending;
+    // number of the pending tables
+    int npending;
+} lauxh_xcopy_ctx_t;
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_xcopy_value(lua_State *from, lua_State *to, int idx,
+                                    const int allow_nil,
+                                    lauxh_xcopy_ctx_t *ctx)
+{
+    switch (lua_type(from, idx)) {
+    case LUA_TBOOLEAN:
+        lua_pushboolean(to, lua_toboolean(from, idx));
+        return LUA_TBOOLEAN;
+
+    case LUA_TLIGHTUSERDATA:
+        lua_pushlightuserdata(to, lua_touserdata(from, idx));
+        return LUA_TLIGHTUSERDATA;
+
+    case LUA_TNUMBER:
+        lua_pushnumber(to, lua_tonumber(from, idx));
+        return LUA_TNUMBER;
+
+    case LUA_TSTRING: {
+        size_t len      = 0;
+        const char *str = lua_tolstring(from, idx, &len);
+        lua_pushlstring(to, str, len);
+        return LUA_TSTRING;
+    }
+
+    case LUA_TTABLE:
+        // already copied
+        lua_pushlightuserdata(to, (void *)lua_topointer(from, idx));
+        lua_rawget(to, ctx->visited);
+        if (lua_type(to, -1) == LUA_TTABLE) {
+            return LUA_TTABLE;
+        }
+        lua_pop(to, 1);
+
+        // create a destination table and push the pair of tables to the work
+        // stack
+        lua_newtable(to);
+        lua_pushlightuserdata(to, (void *)lua_topointer(from, idx));
+        lua_pushvalue(to, -2);
+        lua_rawset(to, ctx->visited);
+        ctx->npending++;
+        lua_pushvalue(to, -1);
+        lua_rawseti(to, ctx->pending, ctx->npending);
+        lua_pushvalue(from, idx);
+        lua_rawseti(from, ctx->fpending, ctx->npending);
+        return LUA_TTABLE;
+
+    case LUA_TNIL:
+        if (allow_nil) {
+            lua_pushnil(to);
+            return LUA_TNIL;
+        }
+
+    // ignore unsupported values
+    // LUA_TNONE
+    // LUA_TFUNCTION
+    // LUA_TUSERDATA
+    // LUA_TTHREAD
+    default:
+        return LUA_TNONE;
+    }
+}
+
+/**
+ * @brief copy a value at the specified index of the state `from` to the state
+ * `to` and returns the type of the copied value. if the value is not supported,
+ * returns LUA_TNONE.
+ *
+ * the nested tables are copied iteratively with the work stack, so the depth
+ * of the tables does not consume the C stack. the table that referenced more
+ * than once (including the cyclic reference) is copied only once, and the
+ * references to it are preserved in the copied value.
+ *
+ * @note supported types are: LUA_TBOOLEAN, LUA_TLIGHTUSERDATA, LUA_TNUMBER,
+ * LUA_TSTRING, LUA_TTABLE and LUA_TNIL.
+ * @param from source lua state
+ * @param to destination lua state
+ * @param idx index of the value
+ * @param allow_nil if true, push nil to the `to` state if the value is nil.
+ * @return int type of the value
+ */
+static inline int lauxh_xcopy(lua_State *from, lua_State *to, int idx,
+                              const int allow_nil)
+{
+    lauxh_xcopy_ctx_t ctx = {0, 0, 0, 0};
+
+    if (lua_type(from, idx) != LUA_TTABLE) {
+        return lauxh_xcopy_value(from, to, idx, allow_nil, NULL);
+    }
+
+    // to positive number
+    if (idx < 0) {
+        idx = lua_gettop(from) + idx + 1;
+    }
+    lua_newtable(to);
+    ctx.visited = lua_gettop(to);
+    lua_newtable(to);
+    ctx.pending = lua_gettop(to);
+    lua_newtable(from);
+    ctx.fpending = lua_gettop(from);
+
+    // push the root table
+    lauxh_xcopy_value(from, to, idx, 0, &ctx);
+
+    while (ctx.npending) {
+        int src = 0;
+        int dst = 0;
+
+        // pop the pair of tables from the work stack
+        lua_rawgeti(from, ctx.fpending, ctx.npending);
+        src = lua_gettop(from);
+        lua_pushnil(from);
+        lua_rawseti(from, ctx.fpending, ctx.npending);
+        lua_rawgeti(to, ctx.pending, ctx.npending);
+        dst = lua_gettop(to);
+        lua_pushnil(to);
+        lua_rawseti(to, ctx.pending, ctx.npending);
+        ctx.npending--;
+
+        lua_pushnil(from);
+        while (lua_next(from, src)) {
+            if (lauxh_xcopy_value(from, to, -2, 0, &ctx) != LUA_TNONE) {
+                if (lauxh_xcopy_value(from, to, -1, 0, &ctx) != LUA_TNONE) {
+                    lua_rawset(to, dst);
+                } else {
+                    lua_pop(to, 1);
+                }
+            }
+            lua_pop(from, 1);
+        }
+        lua_pop(from, 1);
+        lua_pop(to, 1);
+    }
+
+    // remove the work stacks
+    lua_pop(from, 1);
+    lua_replace(to, ctx.visited);
+    lua_settop(to, ctx.visited);
+    return LUA_TTABLE;
+}
+
+/**
+ * NOTE: for the binary serialization
+ *
+ * `lauxh_xencode()` serializes the value into the self-describing binary
+ * format, and `lauxh_xdecode()` deserializes it into the other state. unlike
+ * `lauxh_xcopy()`, the encoder and the decoder do not need to access both
+ * states at the same time, so the states can run in the different threads and
+ * only exchange the bytes.
+ *
+ *  blob  = version value *body
+ *  value = NIL | FALSE | TRUE | INT varint | NUM f64 | STR varint bytes |
+ *          TABLE | REF varint | LIGHTUD u64
+ *  body  = *(value value) END
+ *
+ * the integer is encoded as the zigzag varint, and the number is encoded as
+ * the 8 bytes of IEEE 754 double in the little endian. each table is assigned
+ * the sequential id from 1 at the first appearance as the TABLE tag, and the
+ * later appearances are encoded as the REF tag with its id. the key/value pairs
+ * of the tables are encoded after the root value as `body` in order of the id,
+ * so neither the encoder nor the decoder recurses into the nested tables.
+ *
+ * @note supported types are same as `lauxh_xcopy()`. the unsupported keys and
+ * values in the table are ignored.
+ */
+
+#define LAUXH_XENCODE_VERSION 1
+
+enum {
+    LAUXH_XTAG_NIL = 0,
+    LAUXH_XTAG_FALSE,
+    LAUXH_XTAG_TRUE,
+    LAUXH_XTAG_INT,
+    LAUXH_XTAG_NUM,
+    LAUXH_XTAG_STR,
+    LAUXH_XTAG_TABLE,
+    LAUXH_XTAG_REF,
+    LAUXH_XTAG_LIGHTUD,
+    LAUXH_XTAG_END,
+};
+
+typedef struct {
+    unsigned char *data;
+    size_t len;
+    size_t cap;
+} lauxh_xbuf_t;
+
+#define LAUXH_XBUF_INIT                                                        \
+    {                                                                          \
+        NULL, 0, 0                                                             \
+    }
+
+/**
+ * @brief release the memory of the buffer.
+ *
+ * @param buf buffer
+ */
+static inline void lauxh_xbuf_free(lauxh_xbuf_t *buf)
+{
+    free(buf->data);
+    buf->data = NULL;
+    buf->len  = 0;
+    buf->cap  = 0;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_xbuf_reserve(lauxh_xbuf_t *buf, size_t n)
+{
+    if (buf->cap - buf->len < n) {
+        size_t cap = (buf->cap) ? buf->cap : 64;
+        void *data = NULL;
+
+        while (cap - buf->len < n) {
+            cap *= 2;
+        }
+        if (!(data = realloc(buf->data, cap))) {
+            return -1;
+        }
+        buf->data = (unsigned char *)data;
+        buf->cap  = cap;
+    }
+    return 0;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_xbuf_puttag(lauxh_xbuf_t *buf, int tag)
+{
+    if (lauxh_xbuf_reserve(buf, 1) != 0) {
+        return -1;
+    }
+    buf->data[buf->len++] = (unsigned char)tag;
+    return 0;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_xbuf_putvarint(lauxh_xbuf_t *buf, int tag, uint64_t v)
+{
+    if (lauxh_xbuf_reserve(buf, 11) != 0) {
+        return -1;
+    }
+    buf->data[buf->len++] = (unsigned char)tag;
+    while (v >= 0x80) {
+        buf->data[buf->len++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    buf->data[buf->len++] = (unsigned char)v;
+    return 0;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_xbuf_putu64(lauxh_xbuf_t *buf, int tag, uint64_t v)
+{
+    int i = 0;
+
+    if (lauxh_xbuf_reserve(buf, 9) != 0) {
+        return -1;
+    }
+    buf->data[buf->len++] = (unsigned char)tag;
+    for (; i < 8; i++) {
+        buf->data[buf->len++] = (unsigned char)(v >> (i * 8));
+    }
+    return 0;
+}
+
+typedef struct {
+    // index of the table that maps the pointer of the table to its id
+    int visited;
+    // index of the array of the tables in order of the id
+    int tables;
+    // number of the tables
+    int ntable;
+} lauxh_xenc_ctx_t;
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_xencode_issupported(lua_State *L, int idx)
+{
+    switch (lua_type(L, idx)) {
+    case LUA_TBOOLEAN:
+    case LUA_TLIGHTUSERDATA:
+    case LUA_TNUMBER:
+    case LUA_TSTRING:
+    case LUA_TTABLE:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_xencode_value(lua_State *L, int idx,
+                                      lauxh_xbuf_t *buf, lauxh_xenc_ctx_t *ctx)
+{
+    // to positive number
+    if (idx < 0) {
+        idx = lua_gettop(L) + idx + 1;
+    }
+
+    switch (lua_type(L, idx)) {
+    case LUA_TNIL:
+        return lauxh_xbuf_puttag(buf, LAUXH_XTAG_NIL);
+
+    case LUA_TBOOLEAN:
+        return lauxh_xbuf_puttag(buf, (lua_toboolean(L, idx)) ?
+                                          LAUXH_XTAG_TRUE :
+                                          LAUXH_XTAG_FALSE);
+
+    case LUA_TLIGHTUSERDATA:
+        return lauxh_xbuf_putu64(buf, LAUXH_XTAG_LIGHTUD,
+                                 (uint64_t)(uintptr_t)lua_touserdata(L, idx));
+
+    case LUA_TNUMBER:
+        if (lauxh_isint(L, idx)) {
+            int64_t v = (int64_t)lua_tointeger(L, idx);
+            // zigzag encoding
+            return lauxh_xbuf_putvarint(buf, LAUXH_XTAG_INT,
+                                        ((uint64_t)v << 1) ^
+                                            (uint64_t)(v >> 63));
+        } else {
+            double v   = (double)lua_tonumber(L, idx);
+            uint64_t u = 0;
+            memcpy(&u, &v, sizeof(u));
+            return lauxh_xbuf_putu64(buf, LAUXH_XTAG_NUM, u);
+        }
+
+    case LUA_TSTRING: {
+        size_t len      = 0;
+        const char *str = lua_tolstring(L, idx, &len);
+
+        if (lauxh_xbuf_putvarint(buf, LAUXH_XTAG_STR, len) != 0 ||
+            lauxh_xbuf_reserve(buf, len) != 0) {
+            return -1;
+        }
+        memcpy(buf->data + buf->len, str, len);
+        buf->len += len;
+        return 0;
+    }
+
+    case LUA_TTABLE: {
+        lua_Integer id = 0;
+
+        lua_pushlightuserdata(L, (void *)lua_topointer(L, idx));
+        lua_rawget(L, ctx->visited);
+        id = lua_tointeger(L, -1);
+        lua_pop(L, 1);
+        if (id) {
+            return lauxh_xbuf_putvarint(buf, LAUXH_XTAG_REF, (uint64_t)id);
+        }
+
+        // assign the new id
+        ctx->ntable++;
+        lua_pushlightuserdata(L, (void *)lua_topointer(L, idx));
+        lua_pushinteger(L, ctx->ntable);
+        lua_rawset(L, ctx->visited);
+        lua_pushvalue(L, idx);
+        lua_rawseti(L, ctx->tables, ctx->ntable);
+        return lauxh_xbuf_puttag(buf, LAUXH_XTAG_TABLE);
+    }
+
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @brief serialize the value at the specified index into the buffer and returns
+ * the type of the value. the previous contents of the buffer are discarded. if
+ * the value is not supported or failed to allocate the memory, returns
+ * LUA_TNONE and sets the errno to ENOTSUP or ENOMEM.
+ *
+ * @note the buffer must be released by `lauxh_xbuf_free()`.
+ * @param L lua state
+ * @param idx index of the value
+ * @param buf buffer
+ * @return int type of the value
+ */
+static inline int lauxh_xencode(lua_State *L, int idx, lauxh_xbuf_t *buf)
+{
+    lauxh_xenc_ctx_t ctx = {};
+    int t                = lua_type(L, idx);
+    int top              = lua_gettop(L);
+    int cur              = 1;
+
+    buf->len = 0;
+    if (t != LUA_TNIL && !lauxh_xencode_issupported(L, idx)) {
+        errno = ENOTSUP;
+        return LUA_TNONE;
+    }
+
+    // to positive number
+    if (idx < 0) {
+        idx = top + idx + 1;
+    }
+    lua_newtable(L);
+    ctx.visited = lua_gettop(L);
+    lua_newtable(L);
+    ctx.tables = lua_gettop(L);
+
+    if (lauxh_xbuf_puttag(buf, LAUXH_XENCODE_VERSION) != 0 ||
+        lauxh_xencode_value(L, idx, buf, &ctx) != 0) {
+        goto NOMEM;
+    }
+
+    // encode the key/value pairs of the tables in order of the id
+    for (; cur <= ctx.ntable; cur++) {
+        int src = 0;
+
+        lua_rawgeti(L, ctx.tables, cur);
+        src = lua_gettop(L);
+        lua_pushnil(L);
+        while (lua_next(L, src)) {
+            if (lauxh_xencode_issupported(L, -2) &&
+                lauxh_xencode_issupported(L, -1) &&
+                (lauxh_xencode_value(L, -2, buf, &ctx) != 0 ||
+                 lauxh_xencode_value(L, -1, buf, &ctx) != 0)) {
+                goto NOMEM;
+            }
+            lua_pop(L, 1);
+        }
+        lua_pop(L, 1);
+        if (lauxh_xbuf_puttag(buf, LAUXH_XTAG_END) != 0) {
+            goto NOMEM;
+        }
+    }
+
+    lua_settop(L, top);
+    return t;
+
+NOMEM:
+    lua_settop(L, top);
+    buf->len = 0;
+    errno    = ENOMEM;
+    return LUA_TNONE;
+}
+
+typedef struct {
+    const unsigned char *cur;
+    const unsigned char *end;
+    // index of the array of the tables in order of the id
+    int tables;
+    // number of the tables
+    int ntable;
+} lauxh_xdec_ctx_t;
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_xdecode_varint(lauxh_xdec_ctx_t *ctx, uint64_t *v)
+{
+    int shift = 0;
+
+    *v = 0;
+    while (ctx->cur < ctx->end && shift < 64) {
+        unsigned char c = *ctx->cur++;
+        *v |= (uint64_t)(c & 0x7f) << shift;
+        if (!(c & 0x80)) {
+            return 0;
+        }
+        shift += 7;
+    }
+    return -1;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_xdecode_u64(lauxh_xdec_ctx_t *ctx, uint64_t *v)
+{
+    int i = 0;
+
+    if (ctx->end - ctx->cur < 8) {
+        return -1;
+    }
+    *v = 0;
+    for (; i < 8; i++) {
+        *v |= (uint64_t)ctx->cur[i] << (i * 8);
+    }
+    ctx->cur += 8;
+    return 0;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_xdecode_value(lua_State *L, lauxh_xdec_ctx_t *ctx)
+{
+    uint64_t v = 0;
+
+    if (ctx->cur >= ctx->end) {
+        return LUA_TNONE;
+    }
+
+    switch (*ctx->cur++) {
+    case LAUXH_XTAG_NIL:
+        lua_pushnil(L);
+        return LUA_TNIL;
+
+    case LAUXH_XTAG_FALSE:
+    case LAUXH_XTAG_TRUE:
+        lua_pushboolean(L, ctx->cur[-1] == LAUXH_XTAG_TRUE);
+        return LUA_TBOOLEAN;
+
+    case LAUXH_XTAG_INT:
+        if (lauxh_xdecode_varint(ctx, &v) != 0) {
+            return LUA_TNONE;
+        }
+        // zigzag decoding
+        lua_pushinteger(L, (lua_Integer)(int64_t)((v >> 1) ^ -(v & 1)));
+        return LUA_TNUMBER;
+
+    case LAUXH_XTAG_NUM: {
+        double n = 0;
+
+        if (lauxh_xdecode_u64(ctx, &v) != 0) {
+            return LUA_TNONE;
+        }
+        memcpy(&n, &v, sizeof(n));
+        lua_pushnumber(L, (lua_Number)n);
+        return LUA_TNUMBER;
+    }
+
+    case LAUXH_XTAG_STR:
+        if (lauxh_xdecode_varint(ctx, &v) != 0 ||
+            v > (uint64_t)(ctx->end - ctx->cur)) {
+            return LUA_TNONE;
+        }
+        lua_pushlstring(L, (const char *)ctx->cur, (size_t)v);
+        ctx->cur += v;
+        return LUA_TSTRING;
+
+    case LAUXH_XTAG_TABLE:
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_rawseti(L, ctx->tables, ++ctx->ntable);
+        return LUA_TTABLE;
+
+    case LAUXH_XTAG_REF:
+        if (lauxh_xdecode_varint(ctx, &v) != 0 || v < 1 ||
+            v > (uint64_t)ctx->ntable) {
+            return LUA_TNONE;
+        }
+        lua_rawgeti(L, ctx->tables, (int)v);
+        return LUA_TTABLE;
+
+    case LAUXH_XTAG_LIGHTUD:
+        if (lauxh_xdecode_u64(ctx, &v) != 0) {
+            return LUA_TNONE;
+        }
+        lua_pushlightuserdata(L, (void *)(uintptr_t)v);
+        return LUA_TLIGHTUSERDATA;
+
+    default:
+        return LUA_TNONE;
+    }
+}
+
+/**
+ * @brief deserialize the value from the data that serialized by
+ * `lauxh_xencode()`, push it onto the stack and returns the type of the value.
+ * if the data is malformed, pushes nothing and returns LUA_TNONE and sets the
+ * errno to EILSEQ.
+ *
+ * @param L lua state
+ * @param data serialized data
+ * @param len length of the data
+ * @return int type of the value
+ */
+static inline int lauxh_xdecode(lua_State *L, const void *data, size_t len)
+{
+    lauxh_xdec_ctx_t ctx = {};
+    int top              = lua_gettop(L);
+    int cur              = 1;
+    int t                = LUA_TNONE;
+
+    ctx.cur = (const unsigned char *)data;
+    ctx.end = ctx.cur + len;
+    if (len < 2 || *ctx.cur++ != LAUXH_XENCODE_VERSION) {
+        errno = EILSEQ;
+        return LUA_TNONE;
     }
 
-    // get stackinfo
-    luaL_addstring(&b, "stack traceback:");
-    while (lua_getstack(src, lv++, &ar)) {
-        lua_getinfo(src, "Sln", &ar);
-        if (ar.currentline <= 0) {
-            lua_pushfstring(src, "\n\t%s: in ", ar.short_src);
-        } else {
-            lua_pushfstring(src, "\n\t%s:%d: in ", ar.short_src,
-                            ar.currentline);
-        }
-        luaL_addvalue(&b);
+    lua_newtable(L);
+    ctx.tables = lua_gettop(L);
+    if ((t = lauxh_xdecode_value(L, &ctx)) == LUA_TNONE) {
+        goto MALFORMED;
+    }
 
-        // is there a name from code?
-        if (*ar.namewhat != '\0') {
-            lua_pushfstring(src, "%s '%s'", ar.namewhat, ar.name);
+    // decode the key/value pairs of the tables in order of the id
+    for (; cur <= ctx.ntable; cur++) {
+        int dst = 0;
+
+        lua_rawgeti(L, ctx.tables, cur);
+        dst = lua_gettop(L);
+        while (ctx.cur < ctx.end && *ctx.cur != LAUXH_XTAG_END) {
+            int kt = lauxh_xdecode_value(L, &ctx);
+
+            if (kt == LUA_TNONE) {
+                goto MALFORMED;
+            } else if (kt == LUA_TNIL ||
+                       (kt == LUA_TNUMBER &&
+                        lua_tonumber(L, -1) != lua_tonumber(L, -1)) ||
+                       lauxh_xdecode_value(L, &ctx) <= LUA_TNIL) {
+                // invalid key or value
+                goto MALFORMED;
+            }
+            lua_rawset(L, dst);
         }
-        // main
-        else if (*ar.what == 'm') {
-            lua_pushliteral(src, "main chunk");
+        if (ctx.cur >= ctx.end) {
+            goto MALFORMED;
         }
-        // not C function, use <file:line>
-        else if (*ar.what == 'C') {
-            lua_pushliteral(src, "?");
+        ctx.cur++;
+        lua_pop(L, 1);
+    }
+    if (ctx.cur != ctx.end) {
+        goto MALFORMED;
+    }
+
+    // remove the array of the tables
+    lua_replace(L, ctx.tables);
+    return t;
+
+MALFORMED:
+    lua_settop(L, top);
+    errno = EILSEQ;
+    return LUA_TNONE;
+}
+
+/**
+ * NOTE: for the message channel
+ *
+ * the channel is the bounded ring buffer that carries the values serialized by
+ * `lauxh_xencode()` between the states running on the different threads. the
+ * ring buffer is the lock-free multi-producer/multi-consumer queue, and the
+ * mutex and the condition variables are used only to sleep when the blocking
+ * send/recv cannot proceed. define `LAUXHLIB_USE_CHANNEL` before including
+ * this header and link with `-lpthread` to use it.
+ *
+ *  // sender thread
+ *  lauxh_xbuf_t buf = LAUXH_XBUF_INIT;
+ *  lauxh_xencode(L, 1, &buf);
+ *  lauxh_channel_send(ch, &buf, -1);
+ *
+ *  // receiver thread
+ *  lauxh_xbuf_t buf = LAUXH_XBUF_INIT;
+ *  lauxh_channel_recv(ch, &buf, -1);
+ *  lauxh_xdecode(L, buf.data, buf.len);
+ *  lauxh_xbuf_free(&buf);
+ */
+#if defined(LAUXHLIB_USE_CHANNEL)
+
+# include <pthread.h>
+# include <sys/time.h>
+
+# define LAUXH_CACHELINE_SIZE 64
+
+typedef struct {
+    size_t seq;
+    unsigned char *data;
+    size_t len;
+} lauxh_chslot_t;
+
+typedef struct {
+    // enqueue position
+    size_t head;
+    char pad_head[LAUXH_CACHELINE_SIZE - sizeof(size_t)];
+    // dequeue position
+    size_t tail;
+    char pad_tail[LAUXH_CACHELINE_SIZE - sizeof(size_t)];
+    // number of the threads waiting in the blocking send/recv
+    int nsender;
+    int nreceiver;
+    int refcnt;
+    size_t mask;
+    pthread_mutex_t mutex;
+    pthread_cond_t sendable;
+    pthread_cond_t recvable;
+    lauxh_chslot_t *slots;
+} lauxh_channel_t;
+
+/**
+ * @brief create a new channel that can hold the specified number of messages.
+ * the capacity is rounded up to the power of 2. the reference counter of the
+ * channel is initialized to 1.
+ *
+ * @param capacity capacity of the channel
+ * @return lauxh_channel_t* pointer to the channel, or NULL with errno on
+ * failure. errno is EINVAL if the capacity cannot be rounded up to the power
+ * of 2.
+ */
+static inline lauxh_channel_t *lauxh_channel_new(size_t capacity)
+{
+    lauxh_channel_t *ch = NULL;
+    size_t cap          = 1;
+    size_t i            = 0;
+    int rc              = 0;
+
+    if (capacity > SIZE_MAX / 2 + 1) {
+        errno = EINVAL;
+        return NULL;
+    }
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+    if (!(ch = (lauxh_channel_t *)calloc(1, sizeof(lauxh_channel_t)))) {
+        return NULL;
+    } else if (!(ch->slots =
+                     (lauxh_chslot_t *)calloc(cap, sizeof(lauxh_chslot_t)))) {
+        free(ch);
+        return NULL;
+    }
+    for (; i < cap; i++) {
+        ch->slots[i].seq = i;
+    }
+    ch->mask   = cap - 1;
+    ch->refcnt = 1;
+    if ((rc = pthread_mutex_init(&ch->mutex, NULL)) != 0) {
+        goto FAIL;
+    } else if ((rc = pthread_cond_init(&ch->sendable, NULL)) != 0) {
+        pthread_mutex_destroy(&ch->mutex);
+        goto FAIL;
+    } else if ((rc = pthread_cond_init(&ch->recvable, NULL)) != 0) {
+        pthread_cond_destroy(&ch->sendable);
+        pthread_mutex_destroy(&ch->mutex);
+        goto FAIL;
+    }
+    return ch;
+
+FAIL:
+    free(ch->slots);
+    free(ch);
+    errno = rc;
+    return NULL;
+}
+
+/**
+ * @brief increment the reference counter of the channel.
+ *
+ * @param ch channel
+ * @return lauxh_channel_t* the channel
+ */
+static inline lauxh_channel_t *lauxh_channel_retain(lauxh_channel_t *ch)
+{
+    __atomic_fetch_add(&ch->refcnt, 1, __ATOMIC_RELAXED);
+    return ch;
+}
+
+/**
+ * @brief decrement the reference counter of the channel, and release the
+ * channel and the remaining messages if it reaches 0.
+ *
+ * @param ch channel
+ */
+static inline void lauxh_channel_release(lauxh_channel_t *ch)
+{
+    size_t i = 0;
+
+    if (__atomic_sub_fetch(&ch->refcnt, 1, __ATOMIC_ACQ_REL) > 0) {
+        return;
+    }
+    for (; i <= ch->mask; i++) {
+        free(ch->slots[i].data);
+    }
+    pthread_cond_destroy(&ch->recvable);
+    pthread_cond_destroy(&ch->sendable);
+    pthread_mutex_destroy(&ch->mutex);
+    free(ch->slots);
+    free(ch);
+}
+
+/**
+ * @brief get the capacity of the channel.
+ *
+ * @param ch channel
+ * @return size_t capacity of the channel
+ */
+static inline size_t lauxh_channel_cap(lauxh_channel_t *ch)
+{
+    return ch->mask + 1;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline void lauxh_channel_wakeup(lauxh_channel_t *ch, int *nwait,
+                                        pthread_cond_t *cond)
+{
+    // pairs with the increment of the waiter
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(nwait, __ATOMIC_RELAXED) > 0) {
+        pthread_mutex_lock(&ch->mutex);
+        pthread_cond_signal(cond);
+        pthread_mutex_unlock(&ch->mutex);
+    }
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_channel_enqueue(lauxh_channel_t *ch, lauxh_xbuf_t *buf)
+{
+    size_t pos           = __atomic_load_n(&ch->head, __ATOMIC_RELAXED);
+    lauxh_chslot_t *slot = NULL;
+
+    for (;;) {
+        size_t seq = 0;
+        intptr_t diff;
+
+        slot = &ch->slots[pos & ch->mask];
+        seq  = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ch->head, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            errno = EAGAIN;
+            return -1;
         } else {
-            lua_pushfstring(src, "function <%s:%d>", ar.short_src,
-                            ar.linedefined);
+            pos = __atomic_load_n(&ch->head, __ATOMIC_RELAXED);
         }
-        luaL_addvalue(&b);
+    }
 
-        if (*ar.what == 't') {
-            luaL_addstring(&b, "\n\t(...tail calls...)");
+    slot->data = buf->data;
+    slot->len  = buf->len;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+    buf->data = NULL;
+    buf->len  = 0;
+    buf->cap  = 0;
+    return 0;
+}
+
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_channel_dequeue(lauxh_channel_t *ch, lauxh_xbuf_t *buf)
+{
+    size_t pos           = __atomic_load_n(&ch->tail, __ATOMIC_RELAXED);
+    lauxh_chslot_t *slot = NULL;
+
+    for (;;) {
+        size_t seq = 0;
+        intptr_t diff;
+
+        slot = &ch->slots[pos & ch->mask];
+        seq  = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ch->tail, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            errno = EAGAIN;
+            return -1;
+        } else {
+            pos = __atomic_load_n(&ch->tail, __ATOMIC_RELAXED);
         }
     }
 
-    luaL_pushresult(&b);
-    if (L) {
-        lua_xmove(src, L, 1);
+    lauxh_xbuf_free(buf);
+    buf->data  = slot->data;
+    buf->len   = slot->len;
+    buf->cap   = slot->len;
+    slot->data = NULL;
+    slot->len  = 0;
+    __atomic_store_n(&slot->seq, pos + ch->mask + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/**
+ * @brief move the message in the buffer to the channel without blocking. on
+ * success, the ownership of the buffer memory is transferred to the channel
+ * and the buffer is reset.
+ *
+ * @param ch channel
+ * @param buf buffer that contains the message
+ * @return int 0 on success, or -1 with errno EAGAIN if the channel is full.
+ */
+static inline int lauxh_channel_trysend(lauxh_channel_t *ch, lauxh_xbuf_t *buf)
+{
+    if (lauxh_channel_enqueue(ch, buf) != 0) {
+        return -1;
     }
-#endif
+    lauxh_channel_wakeup(ch, &ch->nreceiver, &ch->recvable);
+    return 0;
 }
 
 /**
- * @brief copy a value at the specified index of the state `from` to the state
- * `to` and returns the type of the copied value. if the value is not supported,
- * returns LUA_TNONE.
+ * @brief move the message in the channel to the buffer without blocking. the
+ * previous memory of the buffer is released.
  *
- * @note supported types are: LUA_TBOOLEAN, LUA_TLIGHTUSERDATA, LUA_TNUMBER,
- * LUA_TSTRING, LUA_TTABLE and LUA_TNIL.
- * @param from source lua state
- * @param to destination lua state
- * @param idx index of the value
- * @param allow_nil if true, push nil to the `to` state if the value is nil.
- * @return int type of the value
+ * @param ch channel
+ * @param buf buffer that receives the message
+ * @return int 0 on success, or -1 with errno EAGAIN if the channel is empty.
  */
-static inline int lauxh_xcopy(lua_State *from, lua_State *to, int idx,
-                              const int allow_nil)
+static inline int lauxh_channel_tryrecv(lauxh_channel_t *ch, lauxh_xbuf_t *buf)
 {
-    switch (lua_type(from, idx)) {
-    case LUA_TBOOLEAN:
-        lua_pushboolean(to, lua_toboolean(from, idx));
-        return LUA_TBOOLEAN;
+    if (lauxh_channel_dequeue(ch, buf) != 0) {
+        return -1;
+    }
+    lauxh_channel_wakeup(ch, &ch->nsender, &ch->sendable);
+    return 0;
+}
 
-    case LUA_TLIGHTUSERDATA:
-        lua_pushlightuserdata(to, lua_touserdata(from, idx));
-        return LUA_TLIGHTUSERDATA;
+/**
+ * @warning DO NOT USE THIS FUNCTION DIRECTLY.
+ */
+static inline int lauxh_channel_wait(lauxh_channel_t *ch, lauxh_xbuf_t *buf,
+                                     int msec, int *nwait, pthread_cond_t *cond,
+                                     int (*tryfn)(lauxh_channel_t *,
+                                                  lauxh_xbuf_t *))
+{
+    struct timespec deadline = {};
+    int rv                   = 0;
 
-    case LUA_TNUMBER:
-        lua_pushnumber(to, lua_tonumber(from, idx));
-        return LUA_TNUMBER;
+    if (tryfn(ch, buf) == 0) {
+        return 0;
+    } else if (msec == 0) {
+        errno = EAGAIN;
+        return -1;
+    } else if (msec > 0) {
+        struct timeval now = {};
 
-    case LUA_TSTRING: {
-        size_t len      = 0;
-        const char *str = lua_tolstring(from, idx, &len);
-        lua_pushlstring(to, str, len);
-        return LUA_TSTRING;
+        gettimeofday(&now, NULL);
+        deadline.tv_sec  = now.tv_sec + msec / 1000;
+        deadline.tv_nsec = now.tv_usec * 1000 + (long)(msec % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
     }
 
-    case LUA_TTABLE:
-        lua_newtable(to);
-        // to positive number
-        if (idx < 0) {
-            idx = lua_gettop(from) + idx + 1;
-        }
-        lua_pushnil(from);
-        while (lua_next(from, idx)) {
-            if (lauxh_xcopy(from, to, -2, 0) != LUA_TNONE) {
-                if (lauxh_xcopy(from, to, -1, 0) != LUA_TNONE) {
-                    lua_rawset(to, -3);
-                } else {
-                    lua_pop(to, 1);
-                }
-            }
-            lua_pop(from, 1);
+    pthread_mutex_lock(&ch->mutex);
+    __atomic_fetch_add(nwait, 1, __ATOMIC_SEQ_CST);
+    while ((rv = tryfn(ch, buf)) != 0) {
+        if (msec < 0) {
+            pthread_cond_wait(cond, &ch->mutex);
+        } else if (pthread_cond_timedwait(cond, &ch->mutex, &deadline) ==
+                   ETIMEDOUT) {
+            rv = tryfn(ch, buf);
+            break;
         }
-        return LUA_TTABLE;
+    }
+    __atomic_fetch_sub(nwait, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&ch->mutex);
 
-    case LUA_TNIL:
-        if (allow_nil) {
-            lua_pushnil(to);
-            return LUA_TNIL;
-        }
+    if (rv != 0) {
+        errno = ETIMEDOUT;
+    }
+    return rv;
+}
 
-    // ignore unsupported values
-    // LUA_TNONE
-    // LUA_TFUNCTION
-    // LUA_TUSERDATA
-    // LUA_TTHREAD
-    default:
-        return LUA_TNONE;
+/**
+ * @brief move the message in the buffer to the channel. if the channel is
+ * full, waits until the channel becomes sendable or the timeout expires.
+ *
+ * @param ch channel
+ * @param buf buffer that contains the message
+ * @param msec timeout in milliseconds. 0 does not wait, and the negative value
+ * waits forever.
+ * @return int 0 on success, or -1 with errno EAGAIN or ETIMEDOUT.
+ */
+static inline int lauxh_channel_send(lauxh_channel_t *ch, lauxh_xbuf_t *buf,
+                                     int msec)
+{
+    if (lauxh_channel_wait(ch, buf, msec, &ch->nsender, &ch->sendable,
+                           lauxh_channel_enqueue) != 0) {
+        return -1;
+    }
+    lauxh_channel_wakeup(ch, &ch->nreceiver, &ch->recvable);
+    return 0;
+}
+
+/**
+ * @brief move the message in the channel to the buffer. if the channel is
+ * empty, waits until the channel becomes receivable or the timeout expires.
+ *
+ * @param ch channel
+ * @param buf buffer that receives the message
+ * @param msec timeout in milliseconds. 0 does not wait, and the negative value
+ * waits forever.
+ * @return int 0 on success, or -1 with errno EAGAIN or ETIMEDOUT.
+ */
+static inline int lauxh_channel_recv(lauxh_channel_t *ch, lauxh_xbuf_t *buf,
+                                     int msec)
+{
+    if (lauxh_channel_wait(ch, buf, msec, &ch->nreceiver, &ch->recvable,
+                           lauxh_channel_dequeue) != 0) {
+        return -1;
     }
+    lauxh_channel_wakeup(ch, &ch->nsender, &ch->sendable);
+    return 0;
 }
 
+#endif
+
 /**
  * NOTE: for backword compatibility
  */
@@ -3711,4 +9667,259 @@ static inline int lauxh_resume(lua_State *L, lua_State *from, int narg)
 # define lauxh_resume(L, from, narg) lua_resume(L, narg)
 #endif
 
+/**
+ * NOTE: for C++
+ */
+
+#if defined(__cplusplus) && __cplusplus >= 201703L
+# include <cstddef>
+# include <limits>
+# include <optional>
+# include <string_view>
+# include <tuple>
+# include <type_traits>
+# include <utility>
+
+namespace lauxh
+{
+
+/**
+ * @brief specialize this template to associate the metatable name with the
+ * type `T` that is used by `Udata<T>`.
+ *
+ *  template <> struct udata_traits<Foo> {
+ *      static constexpr const char *tname = "my.foo";
+ *  };
+ */
+template <typename T> struct udata_traits;
+
+/**
+ * @brief userdata that has the metatable of the `udata_traits<T>::tname`.
+ */
+template <typename T> struct Udata {
+    T *ptr;
+
+    T *operator->() const
+    {
+        return ptr;
+    }
+    T &operator*() const
+    {
+        return *ptr;
+    }
+};
+
+/**
+ * @brief index of the table, function or callable object argument.
+ */
+struct Table {
+    int idx;
+};
+struct Func {
+    int idx;
+};
+struct Callable {
+    int idx;
+};
+
+/**
+ * @brief checker of the argument of the type `T`. it is selected at compile
+ * time by `args()`.
+ */
+template <typename T, typename Enable = void> struct arg;
+
+template <> struct arg<bool> {
+    static bool check(lua_State *L, int idx)
+    {
+        return lauxh_checkbool(L, idx);
+    }
+};
+
+template <typename T>
+struct arg<T, std::enable_if_t<std::is_integral_v<T> &&
+                               !std::is_same_v<T, bool>>> {
+    using limits = std::numeric_limits<T>;
+    using ilimits = std::numeric_limits<lua_Integer>;
+
+    // range of the type `T` that can be represented by the lua_Integer
+    static constexpr lua_Integer min =
+        (std::is_signed_v<T> && sizeof(T) < sizeof(lua_Integer)) ?
+            static_cast<lua_Integer>(limits::min()) :
+        std::is_signed_v<T> ? ilimits::min() :
+                              0;
+    static constexpr lua_Integer max =
+        (sizeof(T) < sizeof(lua_Integer) ||
+         (std::is_signed_v<T> && sizeof(T) == sizeof(lua_Integer))) ?
+            static_cast<lua_Integer>(limits::max()) :
+            ilimits::max();
+
+    // raises an error with the message of the corresponding checker
+    static T error(lua_State *L, int idx)
+    {
+        if constexpr (std::is_signed_v<T>) {
+            if constexpr (sizeof(T) == 1) {
+                return static_cast<T>(lauxh_checkint8(L, idx));
+            } else if constexpr (sizeof(T) == 2) {
+                return static_cast<T>(lauxh_checkint16(L, idx));
+            } else if constexpr (sizeof(T) == 4) {
+                return static_cast<T>(lauxh_checkint32(L, idx));
+            } else {
+                return static_cast<T>(lauxh_checkint64(L, idx));
+            }
+        } else {
+            if constexpr (sizeof(T) == 1) {
+                return static_cast<T>(lauxh_checkuint8(L, idx));
+            } else if constexpr (sizeof(T) == 2) {
+                return static_cast<T>(lauxh_checkuint16(L, idx));
+            } else if constexpr (sizeof(T) == 4) {
+                return static_cast<T>(lauxh_checkuint32(L, idx));
+            } else {
+                return static_cast<T>(lauxh_checkuint64(L, idx));
+            }
+        }
+    }
+
+    static T check(lua_State *L, int idx)
+    {
+        if (lua_type(L, idx) == LUA_TNUMBER && lauxh_isint(L, idx)) {
+            lua_Integer v = lua_tointeger(L, idx);
+            // the comparison against the bounds of lua_Integer is folded
+            if ((min == ilimits::min() || v >= min) &&
+                (max == ilimits::max() || v <= max)) {
+                return static_cast<T>(v);
+            }
+        }
+        return error(L, idx);
+    }
+};
+
+template <typename T>
+struct arg<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static T check(lua_State *L, int idx)
+    {
+        return static_cast<T>(lauxh_checknum(L, idx));
+    }
+};
+
+template <> struct arg<std::string_view> {
+    static std::string_view check(lua_State *L, int idx)
+    {
+        size_t len      = 0;
+        const char *str = lauxh_checklstr(L, idx, &len);
+        return std::string_view(str, len);
+    }
+};
+
+template <> struct arg<const char *> {
+    static const char *check(lua_State *L, int idx)
+    {
+        return lauxh_checkstr(L, idx);
+    }
+};
+
+template <> struct arg<lua_State *> {
+    static lua_State *check(lua_State *L, int idx)
+    {
+        return lauxh_checkthread(L, idx);
+    }
+};
+
+template <> struct arg<Table> {
+    static Table check(lua_State *L, int idx)
+    {
+        lauxh_checktable(L, idx);
+        return Table{idx};
+    }
+};
+
+template <> struct arg<Func> {
+    static Func check(lua_State *L, int idx)
+    {
+        lauxh_checkfunc(L, idx);
+        return Func{idx};
+    }
+};
+
+template <> struct arg<Callable> {
+    static Callable check(lua_State *L, int idx)
+    {
+        lauxh_checkcallable(L, idx);
+        return Callable{idx};
+    }
+};
+
+template <typename T> struct arg<Udata<T>> {
+    static Udata<T> check(lua_State *L, int idx)
+    {
+        return Udata<T>{static_cast<T *>(
+            lauxh_checkudata(L, idx, udata_traits<T>::tname))};
+    }
+};
+
+template <typename T> struct arg<std::optional<T>> {
+    static std::optional<T> check(lua_State *L, int idx)
+    {
+        if (lauxh_isnil(L, idx)) {
+            return std::nullopt;
+        }
+        return arg<T>::check(L, idx);
+    }
+};
+
+template <typename... Ts, std::size_t... Is>
+inline std::tuple<Ts...> args_impl(lua_State *L, int base,
+                                   std::index_sequence<Is...>)
+{
+    // the braced initializer evaluates the checkers from left to right
+    std::tuple<Ts...> v{arg<Ts>::check(L, base + static_cast<int>(Is))...};
+    lauxh_push_argerror_init();
+    return v;
+}
+
+/**
+ * @brief checks the arguments from the index `base` according to the types
+ * `Ts` and returns them as a tuple.
+ *
+ *  auto [name, lv, tmo, foo] =
+ *      lauxh::args<std::string_view, int8_t, std::optional<double>,
+ *                  lauxh::Udata<Foo>>(L);
+ *
+ * @param L lua state
+ * @param base index of the first argument
+ * @return std::tuple<Ts...>
+ */
+template <typename... Ts>
+inline std::tuple<Ts...> args(lua_State *L, int base = 1)
+{
+    return args_impl<Ts...>(L, base, std::index_sequence_for<Ts...>{});
+}
+
+// it is not constexpr, so the invalid option set fails to compile
+inline void invalid_options() {}
+
+/**
+ * @brief create the option set of the specified names, and build its hash
+ * table at compile time.
+ *
+ *  static constexpr lauxh_optionset_t MODES = lauxh::options("r", "w", "rw");
+ *  int mode = lauxh_checkoption(L, 1, &MODES);
+ *
+ * @param names names of the options
+ * @return lauxh_optionset_t
+ */
+template <typename... S> constexpr lauxh_optionset_t options(S... names)
+{
+    static_assert(sizeof...(S) <= LAUXH_OPTION_MAX, "too many options");
+    lauxh_optionset_t set = LAUXH_OPTIONSET_INIT(names...);
+
+    if (lauxh_optionset_build(&set) != 0) {
+        invalid_options();
+    }
+    return set;
+}
+
+} // namespace lauxh
+
+#endif
+
 #endif
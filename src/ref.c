@@ -25,9 +25,11 @@
 
 #define LAUXHLIB_REF_MT "lauxhlib.ref"
 
+#define checkself(L) ((int *)lauxh_checkudataupv((L), 1, LAUXHLIB_REF_MT))
+
 static int get_lua(lua_State *L)
 {
-    int *ref = (int *)lauxh_checkudata(L, 1, LAUXHLIB_REF_MT);
+    int *ref = checkself(L);
     lua_settop(L, 1);
     lauxh_pushref(L, *ref);
     return 1;
@@ -35,7 +37,7 @@ static int get_lua(lua_State *L)
 
 static int unref_lua(lua_State *L)
 {
-    int *ref = (int *)lauxh_checkudata(L, 1, LAUXHLIB_REF_MT);
+    int *ref = checkself(L);
     if (lauxh_isref(*ref)) {
         *ref = lauxh_unref(L, *ref);
         lua_pushboolean(L, 1);
@@ -47,14 +49,14 @@ static int unref_lua(lua_State *L)
 
 static int tostring_lua(lua_State *L)
 {
-    int *ref = (int *)lauxh_checkudata(L, 1, LAUXHLIB_REF_MT);
+    int *ref = checkself(L);
     lua_pushfstring(L, LAUXHLIB_REF_MT ": %d", *ref);
     return 1;
 }
 
 static int gc_lua(lua_State *L)
 {
-    int *ref = (int *)lauxh_checkudata(L, 1, LAUXHLIB_REF_MT);
+    int *ref = checkself(L);
     lauxh_unref(L, *ref);
     return 0;
 }
@@ -70,6 +72,24 @@ static int ref_lua(lua_State *L)
     return 1;
 }
 
+static int call_lua(lua_State *L)
+{
+    // remove the module table
+    lua_remove(L, 1);
+    return ref_lua(L);
+}
+
+static int stats_lua(lua_State *L)
+{
+#if defined(LAUXHLIB_REF_TRACKING)
+    lauxh_reftrack_pushstats(L);
+#else
+    // the references are not tracked
+    lua_pushnil(L);
+#endif
+    return 1;
+}
+
 static void create_mt(lua_State *L)
 {
     struct luaL_Reg mmethod[] = {
@@ -83,15 +103,7 @@ static void create_mt(lua_State *L)
         {NULL,    NULL     }
     };
 
-    luaL_newmetatable(L, LAUXHLIB_REF_MT);
-    for (struct luaL_Reg *ptr = mmethod; ptr->name; ptr++) {
-        lauxh_pushfn2tbl(L, ptr->name, ptr->func);
-    }
-    lua_newtable(L);
-    for (struct luaL_Reg *ptr = method; ptr->name; ptr++) {
-        lauxh_pushfn2tbl(L, ptr->name, ptr->func);
-    }
-    lua_setfield(L, -2, "__index");
+    lauxh_newmetatable_mtptr(L, LAUXHLIB_REF_MT, mmethod, method);
     lua_pop(L, 1);
 }
 
@@ -102,7 +114,12 @@ extern "C" {
 LUALIB_API int luaopen_lauxhlib_ref(lua_State *L)
 {
     create_mt(L);
-    lua_pushcfunction(L, ref_lua);
+    lua_createtable(L, 0, 1);
+    lauxh_pushfn2tbl(L, "stats", stats_lua);
+    // the module table can be called to create a reference
+    lua_createtable(L, 0, 1);
+    lauxh_pushfn2tbl(L, "__call", call_lua);
+    lua_setmetatable(L, -2);
     return 1;
 }
 
@@ -0,0 +1,229 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#define LAUXHLIB_USED_IN_LUA
+#include "lauxhlib.h"
+
+#define LAUXHLIB_REFPOOL_MT "lauxhlib.refpool"
+
+#define checkself(L)                                                           \
+    ((lauxh_refpool_t **)lauxh_checkudataupv((L), 1, LAUXHLIB_REFPOOL_MT))
+
+static int ref_lua(lua_State *L)
+{
+    lauxh_refpool_t *pool = *checkself(L);
+    int ref               = LUA_NOREF;
+
+    lua_settop(L, 2);
+    lauxh_getuservalue(L, 1);
+    lua_insert(L, 2);
+    if ((ref = lauxh_refpool_ref_tbl(L, pool, 2)) == LUA_NOREF) {
+        return luaL_error(L, "failed to create a reference: %s",
+                          strerror(errno));
+    }
+    lua_pushinteger(L, ref);
+    return 1;
+}
+
+static int get_lua(lua_State *L)
+{
+    lauxh_refpool_t *pool = *checkself(L);
+    int ref               = (int)lauxh_checkint(L, 2);
+
+    lauxh_getuservalue(L, 1);
+    lauxh_refpool_pushref_tbl(L, pool, -1, ref);
+    return 1;
+}
+
+static int isref_lua(lua_State *L)
+{
+    lauxh_refpool_t *pool = *checkself(L);
+    int ref               = (int)lauxh_checkint(L, 2);
+
+    lua_pushboolean(L, lauxh_refpool_isref(pool, ref));
+    return 1;
+}
+
+static int unref_lua(lua_State *L)
+{
+    lauxh_refpool_t *pool = *checkself(L);
+    int ref               = (int)lauxh_checkint(L, 2);
+
+    if (lauxh_refpool_isref(pool, ref)) {
+        lauxh_getuservalue(L, 1);
+        lauxh_refpool_unref_tbl(L, pool, -1, ref);
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+    lua_pushboolean(L, 0);
+    return 1;
+}
+
+static int refhandle_lua(lua_State *L)
+{
+    lauxh_refpool_t *pool = *checkself(L);
+    lauxh_refhandle_t h   = LAUXH_REFHANDLE_NONE;
+
+    lua_settop(L, 2);
+    if (lua_isnil(L, 2)) {
+        lua_pushnil(L);
+        return 1;
+    } else if (!pool->gen) {
+        errno = EINVAL;
+    } else {
+        lauxh_getuservalue(L, 1);
+        lua_insert(L, 2);
+        h = lauxh_refpool_handle(pool, lauxh_refpool_ref_tbl(L, pool, 2));
+    }
+    if (h == LAUXH_REFHANDLE_NONE) {
+        return luaL_error(L, "failed to create a reference: %s",
+                          strerror(errno));
+    }
+    lauxh_pushrefhandle(L, h);
+    return 1;
+}
+
+static int getchecked_lua(lua_State *L)
+{
+    lauxh_refpool_t *pool = *checkself(L);
+    lauxh_refhandle_t h   = (lauxh_refhandle_t)lauxh_checkuint64(L, 2);
+
+    if (lauxh_refpool_ishandle(pool, h)) {
+        lauxh_getuservalue(L, 1);
+        lauxh_refpool_pushref_tbl(L, pool, -1, lauxh_refhandle_ref(h));
+        lua_pushboolean(L, 1);
+        return 2;
+    }
+    lua_pushnil(L);
+    lua_pushboolean(L, 0);
+    return 2;
+}
+
+static int unrefhandle_lua(lua_State *L)
+{
+    lauxh_refpool_t *pool = *checkself(L);
+    lauxh_refhandle_t h   = (lauxh_refhandle_t)lauxh_checkuint64(L, 2);
+
+    if (lauxh_refpool_ishandle(pool, h)) {
+        lauxh_getuservalue(L, 1);
+        lauxh_refpool_unref_tbl(L, pool, -1, lauxh_refhandle_ref(h));
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+    lua_pushboolean(L, 0);
+    return 1;
+}
+
+static int gen_lua(lua_State *L)
+{
+    lauxh_refpool_t *pool = *checkself(L);
+    int ref               = (int)lauxh_checkint(L, 2);
+
+    lua_pushinteger(L, (lua_Integer)lauxh_refpool_gen(pool, ref));
+    return 1;
+}
+
+static int len_lua(lua_State *L)
+{
+    lauxh_refpool_t *pool = *checkself(L);
+    lua_pushinteger(L, lauxh_refpool_len(pool));
+    return 1;
+}
+
+static int cap_lua(lua_State *L)
+{
+    lauxh_refpool_t *pool = *checkself(L);
+    lua_pushinteger(L, pool->cap);
+    return 1;
+}
+
+static int tostring_lua(lua_State *L)
+{
+    lauxh_refpool_t *pool = *checkself(L);
+    lua_pushfstring(L, LAUXHLIB_REFPOOL_MT ": %p", pool);
+    return 1;
+}
+
+static int gc_lua(lua_State *L)
+{
+    lauxh_refpool_t **ptr = checkself(L);
+    if (*ptr) {
+        lauxh_refpool_free(L, *ptr);
+        *ptr = NULL;
+    }
+    return 0;
+}
+
+static int new_lua(lua_State *L)
+{
+    int cap   = (int)lauxh_optint_in_range(L, 1, 1, INT_MAX, 16);
+    int flags = 0;
+
+    if (lauxh_optbool(L, 2, 0)) {
+        flags |= LAUXH_REFPOOL_GENERATION;
+    }
+    if (!lauxh_refpool_newudata(L, cap, flags, LAUXHLIB_REFPOOL_MT)) {
+        return luaL_error(L, "failed to create a reference pool: %s",
+                          strerror(errno));
+    }
+    return 1;
+}
+
+static void create_mt(lua_State *L)
+{
+    struct luaL_Reg mmethod[] = {
+        {"__gc",       gc_lua      },
+        {"__tostring", tostring_lua},
+        {NULL,         NULL        }
+    };
+    struct luaL_Reg method[] = {
+        {"ref",         ref_lua        },
+        {"get",         get_lua        },
+        {"isref",       isref_lua      },
+        {"unref",       unref_lua      },
+        {"refhandle",   refhandle_lua  },
+        {"getchecked",  getchecked_lua },
+        {"unrefhandle", unrefhandle_lua},
+        {"gen",         gen_lua        },
+        {"len",         len_lua        },
+        {"cap",         cap_lua        },
+        {NULL,          NULL           }
+    };
+
+    lauxh_newmetatable_mtptr(L, LAUXHLIB_REFPOOL_MT, mmethod, method);
+    lua_pop(L, 1);
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+LUALIB_API int luaopen_lauxhlib_refpool(lua_State *L)
+{
+    create_mt(L);
+    lua_pushcfunction(L, new_lua);
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
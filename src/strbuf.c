@@ -0,0 +1,90 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+
+#define LAUXHLIB_USED_IN_LUA
+#include "lauxhlib.h"
+
+// small enough to exercise the move from the stack memory to the heap
+#define STRBUF_MEMSIZE 16
+
+static int concat_lua(lua_State *L)
+{
+    int top = lua_gettop(L);
+    char mem[STRBUF_MEMSIZE];
+    lauxh_strbuf_t b = LAUXH_STRBUF_INIT;
+
+    lauxh_strbuf_init(&b, mem, sizeof(mem));
+    for (int i = 1; i <= top; i++) {
+        if (lauxh_strbuf_appendtostr(L, &b, i) != 0) {
+            lauxh_strbuf_free(&b);
+            return luaL_error(L, "failed to append: %s", strerror(errno));
+        }
+    }
+    lauxh_strbuf_push(L, &b);
+    lauxh_strbuf_free(&b);
+    return 1;
+}
+
+static int format_lua(lua_State *L)
+{
+    lua_Integer n    = lauxh_checkpint(L, 1);
+    const char *sep  = lauxh_optstr(L, 2, ",");
+    char mem[STRBUF_MEMSIZE];
+    lauxh_strbuf_t b = LAUXH_STRBUF_INIT;
+
+    lauxh_strbuf_init(&b, mem, sizeof(mem));
+    for (lua_Integer i = 1; i <= n; i++) {
+        if (lauxh_strbuf_appendf(&b, "%s%d", (i > 1) ? sep : "", (int)i) !=
+            0) {
+            lauxh_strbuf_free(&b);
+            return luaL_error(L, "failed to append: %s", strerror(errno));
+        }
+    }
+    lauxh_strbuf_push(L, &b);
+    lauxh_strbuf_free(&b);
+    return 1;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+LUALIB_API int luaopen_lauxhlib_strbuf(lua_State *L)
+{
+    struct luaL_Reg method[] = {
+        {"concat", concat_lua},
+        {"format", format_lua},
+        {NULL,     NULL      }
+    };
+
+    lua_newtable(L);
+    for (struct luaL_Reg *ptr = method; ptr->name; ptr++) {
+        lauxh_pushfn2tbl(L, ptr->name, ptr->func);
+    }
+
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,100 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#define LAUXHLIB_USED_IN_LUA
+#include "lauxhlib.h"
+
+static int ref_lua(lua_State *L)
+{
+    lauxh_refhandle_t h = LAUXH_REFHANDLE_NONE;
+
+    lua_settop(L, 1);
+    if (lua_isnil(L, 1)) {
+        lua_pushnil(L);
+        return 1;
+    } else if ((h = lauxh_weakref(L)) == LAUXH_REFHANDLE_NONE) {
+        return luaL_error(L, "failed to create a weak reference: %s",
+                          strerror(errno));
+    }
+    lauxh_pushrefhandle(L, h);
+    return 1;
+}
+
+static int get_lua(lua_State *L)
+{
+    lauxh_refhandle_t h = (lauxh_refhandle_t)lauxh_checkuint64(L, 1);
+
+    lauxh_pushweakref(L, h);
+    return 1;
+}
+
+static int unref_lua(lua_State *L)
+{
+    lauxh_refhandle_t h   = (lauxh_refhandle_t)lauxh_checkuint64(L, 1);
+    lauxh_refpool_t *pool = lauxh_weakref_pool(L);
+
+    if (lauxh_refpool_ishandle(pool, h)) {
+        lauxh_unweakref(L, h);
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+    lua_pushboolean(L, 0);
+    return 1;
+}
+
+static int sweep_lua(lua_State *L)
+{
+    lua_pushinteger(L, lauxh_weakref_sweep(L));
+    return 1;
+}
+
+static int len_lua(lua_State *L)
+{
+    lua_pushinteger(L, lauxh_refpool_len(lauxh_weakref_pool(L)));
+    return 1;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+LUALIB_API int luaopen_lauxhlib_weakref(lua_State *L)
+{
+    struct luaL_Reg method[] = {
+        {"ref",   ref_lua  },
+        {"get",   get_lua  },
+        {"unref", unref_lua},
+        {"sweep", sweep_lua},
+        {"len",   len_lua  },
+        {NULL,    NULL     }
+    };
+
+    lua_newtable(L);
+    for (struct luaL_Reg *ptr = method; ptr->name; ptr++) {
+        lauxh_pushfn2tbl(L, ptr->name, ptr->func);
+    }
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
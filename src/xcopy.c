@@ -0,0 +1,60 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+
+#define LAUXHLIB_USED_IN_LUA
+#include "lauxhlib.h"
+
+static int xcopy_lua(lua_State *L)
+{
+    lua_State *to = luaL_newstate();
+    int t         = LUA_TNONE;
+
+    if (!to) {
+        return luaL_error(L, "failed to create a new state");
+    }
+    lua_settop(L, 1);
+
+    // copy the value to the new state and copy it back
+    if (lauxh_xcopy(L, to, 1, 1) == LUA_TNONE ||
+        (t = lauxh_xcopy(to, L, 1, 1)) == LUA_TNONE) {
+        lua_close(to);
+        return 0;
+    }
+    lua_close(to);
+    lua_pushstring(L, lua_typename(L, t));
+    return 2;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+LUALIB_API int luaopen_lauxhlib_xcopy(lua_State *L)
+{
+    lua_pushcfunction(L, xcopy_lua);
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
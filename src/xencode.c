@@ -0,0 +1,80 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+
+#define LAUXHLIB_USED_IN_LUA
+#include "lauxhlib.h"
+
+static int decode_lua(lua_State *L)
+{
+    size_t len       = 0;
+    const char *data = lauxh_checklstr(L, 1, &len);
+
+    lua_settop(L, 1);
+    if (lauxh_xdecode(L, data, len) == LUA_TNONE) {
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+    return 1;
+}
+
+static int encode_lua(lua_State *L)
+{
+    lauxh_xbuf_t buf = LAUXH_XBUF_INIT;
+
+    lua_settop(L, 1);
+    if (lauxh_xencode(L, 1, &buf) == LUA_TNONE) {
+        int err = errno;
+        lauxh_xbuf_free(&buf);
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(err));
+        return 2;
+    }
+    lua_pushlstring(L, (const char *)buf.data, buf.len);
+    lauxh_xbuf_free(&buf);
+    return 1;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+LUALIB_API int luaopen_lauxhlib_xencode(lua_State *L)
+{
+    struct luaL_Reg method[] = {
+        {"encode", encode_lua},
+        {"decode", decode_lua},
+        {NULL,     NULL      }
+    };
+
+    lua_newtable(L);
+    for (struct luaL_Reg *ptr = method; ptr->name; ptr++) {
+        lauxh_pushfn2tbl(L, ptr->name, ptr->func);
+    }
+
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,213 @@
+local pcall = pcall
+local clock = os.clock
+local assert = require('assert')
+
+local function printf(...)
+    print(string.format(...))
+end
+
+local testfuncs = {}
+local testcase = setmetatable({}, {
+    __newindex = function(_, name, func)
+        assert.is_string(name)
+        assert.is_function(func)
+        if testfuncs[name] then
+            error(string.format('testcase.%s already defined', name), 2)
+        end
+
+        local case = {
+            name = name,
+            func = func,
+        }
+        testfuncs[#testfuncs + 1] = case
+        testfuncs[name] = case
+    end,
+})
+
+local channel = require('lauxhlib.channel')
+
+local STR = 'str'
+local INT = 1
+local FLOAT = 1.1
+local FUNC = function()
+end
+
+function testcase.channel_new()
+    -- test that create a new channel with capacity
+    local ch = channel.new()
+    assert.match(tostring(ch), '^lauxhlib.channel: ', false)
+    assert.equal(ch:cap(), 1)
+    assert.equal(channel.new(3):cap(), 4)
+
+    -- test that throws an error if capacity is invalid
+    local err = assert.throws(channel.new, 0)
+    assert.match(err, 'bad argument #1')
+
+    -- test that throws an error if the slots cannot be allocated
+    err = assert.throws(channel.new, 2 ^ 52)
+    assert.match(err, 'failed to create a channel')
+end
+
+function testcase.channel_send_recv()
+    local ch = channel.new(2)
+
+    -- test that send values without blocking
+    assert.is_true(ch:send(STR, 0))
+    assert.is_true(ch:send({
+        INT,
+        foo = {
+            bar = FLOAT,
+        },
+    }, 0))
+
+    -- test that returns false if channel is full
+    assert.is_false(ch:send(INT, 0))
+    assert.is_false(ch:send(INT, 10))
+
+    -- test that receive values in order
+    local ok, v = ch:recv(0)
+    assert.is_true(ok)
+    assert.equal(v, STR)
+    ok, v = ch:recv(0)
+    assert.is_true(ok)
+    assert.equal(v, {
+        INT,
+        foo = {
+            bar = FLOAT,
+        },
+    })
+
+    -- test that returns false if channel is empty
+    assert.is_false(ch:recv(0))
+    assert.is_false(ch:recv(10))
+
+    -- test that nil can be sent
+    assert.is_true(ch:send(nil, 0))
+    ok, v = ch:recv(0)
+    assert.is_true(ok)
+    assert.is_nil(v)
+
+    -- test that throws an error if value is not supported
+    local err = assert.throws(ch.send, ch, FUNC)
+    assert.match(err, 'bad argument #2')
+end
+
+function testcase.channel_export_import()
+    local ch = channel.new(4)
+
+    -- test that imported channel shares the ring buffer
+    local ch2 = channel.import(ch:export())
+    assert.is_true(ch:send(STR, 0))
+    local ok, v = ch2:recv(0)
+    assert.is_true(ok)
+    assert.equal(v, STR)
+
+    -- test that imported channel is available after the original is released
+    ch = nil
+    collectgarbage('collect')
+    assert.is_true(ch2:send(INT, 0))
+    ok, v = ch2:recv(0)
+    assert.is_true(ok)
+    assert.equal(v, INT)
+
+    -- test that the token can be imported only once
+    local token = ch2:export()
+    assert.is_number(token)
+    local ch3 = channel.import(token)
+    assert.is_true(ch3:send(STR, 0))
+    ok, v = ch2:recv(0)
+    assert.is_true(ok)
+    assert.equal(v, STR)
+    local err = assert.throws(channel.import, token)
+    assert.match(err, 'unknown or already imported token')
+
+    -- test that throws an error if token is unknown
+    err = assert.throws(channel.import, token + 1000)
+    assert.match(err, 'unknown or already imported token')
+
+    -- test that throws an error if argument is not a token
+    err = assert.throws(channel.import, {})
+    assert.match(err, 'positive integer expected, got table')
+end
+
+function testcase.channel_relay()
+    if not channel.relay then
+        -- built without LAUXHLIB_TEST
+        if os.getenv('LAUXHLIB_TEST') then
+            error('LAUXHLIB_TEST is set, but the relay thread is not built')
+        end
+        return
+    end
+
+    local src = channel.new(2)
+    local dst = channel.new(128)
+
+    -- test that the relay thread wakes up the blocking recv
+    local th = channel.relay(src:export(), dst:export(), 50)
+    assert.is_true(src:send(STR, 0))
+    local ok, v = dst:recv(-1)
+    assert.is_true(ok)
+    assert.equal(v, STR)
+
+    -- test that the relay thread wakes up the blocking send and forwards
+    -- the messages in order
+    for i = 1, 100 do
+        assert.is_true(src:send({
+            i,
+            foo = FLOAT,
+        }, -1))
+    end
+    for i = 1, 100 do
+        ok, v = dst:recv(-1)
+        assert.is_true(ok)
+        assert.equal(v, {
+            i,
+            foo = FLOAT,
+        })
+    end
+
+    -- test that the relay thread exits after forwarding nil
+    assert.is_true(src:send(nil, -1))
+    ok, v = dst:recv(-1)
+    assert.is_true(ok)
+    assert.is_nil(v)
+    assert.is_true(th:join())
+
+    -- test that throws an error if the thread is already joined
+    local err = assert.throws(th.join, th)
+    assert.match(err, 'relay thread is already joined')
+
+    -- test that the relay thread fails if token is already imported
+    local token = src:export()
+    channel.import(token)
+    th = channel.relay(token, dst:export())
+    local res
+    ok, res = th:join()
+    assert.is_false(ok)
+    assert.match(res, 'failed to import the channels')
+end
+
+-- run test cases
+do
+    local errors = {}
+    for _, case in ipairs(testfuncs) do
+        local t = clock()
+        local ok, err = pcall(case.func)
+        t = clock() - t
+        if ok then
+            printf('testcase.%s ... ok (%f sec)', case.name, t)
+        else
+            err = string.gsub(err, '\n', {
+                ['\n'] = '\n  > ',
+            })
+            local msg = string.format('testcase.%s ... failed (%f sec)\n  > %s',
+                                      case.name, t, err)
+            errors[#errors + 1] = err
+            print(msg)
+        end
+    end
+
+    if #errors > 0 then
+        error(table.concat(errors, '\n'))
+    end
+end
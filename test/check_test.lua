@@ -1,6 +1,7 @@
 local pcall = pcall
 local clock = os.clock
 local assert = require('assert')
+local unpack = unpack or table.unpack
 
 local function printf(...)
     print(string.format(...))
@@ -187,6 +188,124 @@ function testcase.check_str()
     assert.match(err, '(string expected, ')
 end
 
+function testcase.check_ascii()
+    local char = string.char
+
+    -- test that return argument
+    assert.equal(check.ascii(STR), STR)
+    assert.equal(check.ascii(char(0, 0x7F)), char(0, 0x7F))
+
+    -- test that throws an error with the position of the invalid byte
+    local err = assert.throws(check.ascii, 'foo' .. char(0x80))
+    assert.match(err, 'ASCII string expected, got invalid byte 0x80 at 4')
+    err = assert.throws(check.ascii, INT)
+    assert.match(err, '(string expected, ')
+end
+
+function testcase.check_printable()
+    -- test that return argument
+    assert.equal(check.printable(STR), STR)
+
+    -- test that throws an error with the position of the invalid byte
+    local err = assert.throws(check.printable, 'foo\r\n')
+    assert.match(err, 'printable string expected, got invalid byte 0x0D at 4')
+    err = assert.throws(check.printable, TBL)
+    assert.match(err, '(string expected, ')
+end
+
+function testcase.check_utf8()
+    local char = string.char
+    local s = 'abc' .. char(0xE3, 0x81, 0x82)
+
+    -- test that return argument
+    assert.equal(check.utf8(s), s)
+
+    -- test that throws an error with the position of the invalid byte
+    local err = assert.throws(check.utf8, s .. char(0xED, 0xA0, 0x80))
+    assert.match(err, 'UTF-8 string expected, got invalid byte 0xED at 7')
+    err = assert.throws(check.utf8, INT)
+    assert.match(err, '(string expected, ')
+
+    -- test that the argument name is used in the error message
+    err = assert.throws(check.utf8, char(0xFF), 'name')
+    assert.match(err, "bad argument 'name'")
+end
+
+function testcase.check_option()
+    local options = {
+        'r',
+        'w',
+        'rw',
+        'GET',
+        'HEAD',
+        'POST',
+        'PUT',
+        'DELETE',
+        'CONNECT',
+        'OPTIONS',
+        'TRACE',
+        'PATCH',
+        'PROPFIND',
+        'PROPPATCH',
+        'MKCOL',
+        'COPY',
+        'MOVE',
+        'LOCK',
+        'UNLOCK',
+        'SEARCH',
+        'BIND',
+        'UNBIND',
+        'REBIND',
+        'ACL',
+    }
+
+    -- test that return the index of the option
+    for i, v in ipairs(options) do
+        assert.equal(check.option(v), i - 1)
+    end
+
+    -- test that throws an error if value is not an option
+    for _, v in ipairs({
+        '',
+        'get',
+        'GETX',
+        'rww',
+        'r' .. string.char(0),
+    }) do
+        local err = assert.throws(check.option, v)
+        assert.match(err, "#1 .+[(]invalid option '", false)
+    end
+
+    -- test that throws an error if value is not a string
+    for _, v in ipairs({
+        true,
+        TBL,
+        INT,
+    }) do
+        local err = assert.throws(check.option, v)
+        assert.match(err, '(string expected, ')
+    end
+
+    -- test that the single-letter names are placed in the distinct slots
+    for i = 1, 16 do
+        assert.equal(check.shortopt(string.char(96 + i)), i - 1)
+    end
+    local err = assert.throws(check.shortopt, 'q')
+    assert.match(err, "invalid option 'q'")
+
+    -- test that the maximum number of the names are placed
+    for i = 0, 63 do
+        local name = string.char(97 + math.floor(i / 10)) .. (i % 10)
+        assert.equal(check.wideopt(name), i)
+    end
+    err = assert.throws(check.wideopt, 'g4')
+    assert.match(err, "invalid option 'g4'")
+
+    -- test that throws an error if the option set is not built
+    err = assert.throws(check.noinitopt, 'foo')
+    assert.match(err, 'option set is not initialized')
+end
+
 function testcase.check_table()
     -- test that return argument
     assert.equal(TBL, check.table(TBL))
@@ -307,6 +426,66 @@ function testcase.check_userdata()
     end
 end
 
+function testcase.check_udtype()
+    local base = check.newudtype('base', 1)
+    local derived = check.newudtype('derived', 2)
+    local other = check.newudtype('other', 3)
+
+    -- test that return the userdata of the type or its derived type
+    assert.equal(check.udtype(base, 'base'), 1)
+    assert.equal(check.udtype(derived, 'derived'), 2)
+    assert.equal(check.udtype(derived, 'base'), 2)
+    assert.equal(check.udtype(other, 'other'), 3)
+
+    -- test that return the type id
+    assert.equal(check.udtypeid(base), 1)
+    assert.equal(check.udtypeid(derived), 2)
+    assert.equal(check.udtypeid(other), 2)
+    assert.equal(check.udtypeid(FILE), -1)
+    assert.equal(check.udtypeid(STR), -1)
+
+    -- test that throws an error if value is not the userdata of the type
+    for _, v in ipairs({
+        {
+            base,
+            'derived',
+        },
+        {
+            other,
+            'derived',
+        },
+        {
+            derived,
+            'other',
+        },
+        {
+            other,
+            'base',
+        },
+        {
+            FILE,
+            'base',
+        },
+        {
+            STR,
+            'base',
+        },
+    }) do
+        local err = assert.throws(check.udtype, v[1], v[2])
+        assert.match(err, '#1 .+[(]lauxhlib.check.' .. v[2] .. ' expected, ',
+                     false)
+    end
+
+    -- test that the header of the userdata created by other modules is
+    -- accepted only if the ids are in the memory block of the userdata
+    assert.is_true(check.isudtype(check.rawudtype(0, 16, 1), 'base'))
+    assert.is_false(check.isudtype(check.rawudtype(1, 12, 1), 'derived'))
+    assert.is_false(check.isudtype(check.rawudtype(1, 12, 1), 'base'))
+    assert.is_false(check.isudtype(check.rawudtype(0xFFFFFFFF, 16, 1), 'base'))
+    assert.is_false(check.isudtype(check.rawudtype(17, 128, 1), 'base'))
+    assert.equal(check.udtypeid(check.rawudtype(1, 12, 1)), -1)
+end
+
 function testcase.check_finite()
     -- test that return argument
     for _, v in ipairs({
@@ -766,6 +945,249 @@ function testcase.check_flags()
     end
 end
 
+function testcase.check_flagset()
+    -- test that return the bits of the flag names
+    assert.equal(0x1, check.flagset('read'))
+    assert.equal(0x243, check.flagset('read', 'write', 'create', 'trunc'))
+    assert.equal(0xC00, check.flagset('append', nil, 'nonblock'))
+    assert.equal(0, check.flagset())
+    assert.equal(0, check.flagset(nil, {}))
+
+    -- test that the array of the flag names and integers
+    assert.equal(0x643, check.flagset({
+        'read',
+        'write',
+        'create',
+    }, 0x200, {
+        'append',
+    }))
+    assert.equal(0x8003, check.flagset({
+        'read',
+        0x8000,
+    }, 'write'))
+
+    -- test that throws an error if name is unknown
+    for _, v in ipairs({
+        '',
+        'READ',
+        'reads',
+        'rea',
+        'read' .. string.char(0),
+    }) do
+        local err = assert.throws(check.flagset, 'read', v)
+        assert.match(err, "#2 .+[(]unknown flag '", false)
+    end
+
+    -- test that throws an error with the position in the array
+    local err = assert.throws(check.flagset, {
+        'read',
+        'foo',
+    })
+    assert.match(err, "#1 .+[(]unknown flag 'foo' at index 2[)]", false)
+
+    -- test that throws an error if value is invalid
+    for _, v in ipairs({
+        FILE,
+        FUNC,
+        CFUNC,
+        THREAD,
+        -INT,
+        FLOAT,
+        true,
+    }) do
+        err = assert.throws(check.flagset, 'read', v)
+        assert.match(err, '#2 .+[(]flag name or uint64_t expected, ', false)
+        err = assert.throws(check.flagset, {
+            'read',
+            v,
+        })
+        assert.match(err,
+                     '#1 .+[(]flag name or uint64_t expected at index 2, ',
+                     false)
+    end
+
+    -- test that throws an error if the flag set is not built
+    err = assert.throws(check.noinitflagset, 'read')
+    assert.match(err, 'option set is not initialized')
+end
+
+function testcase.check_args()
+    -- test that return extracted arguments
+    local a, b, c, d, e, f = check.args('s|i8 n? t F b', STR, -INT, nil, TBL)
+    assert.equal(a, STR)
+    assert.equal(b, -INT)
+    assert.is_nil(c)
+    assert.equal(d, TBL)
+    assert.is_nil(e)
+    assert.is_nil(f)
+
+    -- test that integer variants
+    a, b, c, d = check.args('i I8 i16? I64', -INT, 255, nil, INTMAX)
+    assert.equal(a, -INT)
+    assert.equal(b, 255)
+    assert.is_nil(c)
+    assert.equal(d, INTMAX)
+
+    -- test that string with length, callable, thread and any value
+    a, b, c, d = check.args('l c T .', STR, CFUNC, THREAD, FILE)
+    assert.equal(a, STR)
+    assert.equal(b, CFUNC)
+    assert.equal(c, THREAD)
+    assert.equal(d, FILE)
+
+    -- test that userdata with metatable name
+    a = check.args('u{FILE*}', FILE)
+    assert.equal(a, FILE)
+
+    -- test that throws an error if value is invalid
+    for _, v in ipairs({
+        {
+            fmt = 's',
+            args = {
+                INT,
+            },
+            err = '#1 .+[(]string expected, got number',
+        },
+        {
+            fmt = 's i8',
+            args = {
+                STR,
+                128,
+            },
+            err = '#2 .+[(]int8_t expected, got an out of range value',
+        },
+        {
+            fmt = 's|n? I',
+            args = {
+                STR,
+                FLOAT,
+                -INT,
+            },
+            err = '#3 .+[(]unsigned integer expected, ',
+        },
+        {
+            fmt = 'f',
+            args = {
+                INF,
+            },
+            err = '#1 .+[(]finite number expected, ',
+        },
+        {
+            fmt = 'u{FILE*}',
+            args = {
+                TBL,
+            },
+            err = '#1 .+FILE[*] expected, ',
+        },
+        {
+            fmt = '.',
+            args = {},
+            err = '#1 .+[(]value expected',
+        },
+    }) do
+        local err = assert.throws(check.args, v.fmt, unpack(v.args))
+        assert.match(err, v.err, false)
+    end
+
+    -- test that throws an error if format is invalid
+    for _, fmt in ipairs({
+        'x',
+        'u{',
+        'u{}',
+    }) do
+        local err = assert.throws(check.args, fmt)
+        assert.match(err, 'in the argument format')
+    end
+end
+
+function testcase.check_struct()
+    -- test that decode table into struct and push it back
+    local res = check.struct({
+        name = 'foo',
+        port = 8080,
+        verbose = true,
+        tag = 'bar',
+    })
+    assert.equal(res, {
+        name = 'foo',
+        port = 8080,
+        timeout = 1.5,
+        verbose = true,
+        level = 1,
+        tag = 'bar',
+    })
+
+    -- test that throws an error if value is not table
+    local err = assert.throws(check.struct, STR)
+    assert.match(err, '#1 .+[(]table expected, got string', false)
+
+    -- test that throws a single error that lists all invalid fields
+    err = assert.throws(check.struct, {
+        name = string.rep('x', 16),
+        port = 0,
+        level = 256,
+        tag = INT,
+    })
+    assert.match(err, "field 'name' string expected, got too long string")
+    assert.match(err, "field 'port' int32_t in range 1 to 65535 expected, " ..
+                     "got an out of range value")
+    assert.match(err,
+                 "field 'level' uint8_t expected, got an out of range value")
+    assert.match(err, "field 'tag' string expected, got number")
+
+    -- test that required field cannot be nil
+    err = assert.throws(check.struct, {
+        port = 80,
+    })
+    assert.match(err, "field 'name' string expected, got nil")
+end
+
+function testcase.check_array()
+    -- test that convert the array elements and push them back
+    local arr = {
+        1,
+        -2,
+        INTMAX,
+    }
+    local res = check.array(arr, 'int64')
+    assert.equal(res, arr)
+    assert.equal(check.array({
+        1,
+        FLOAT,
+        -INF,
+    }, 'double'), {
+        1,
+        FLOAT,
+        -INF,
+    })
+    assert.equal(check.array({
+        0,
+        255,
+    }, 'uint8'), {
+        0,
+        255,
+    })
+    assert.equal(check.array({}, 'double'), {})
+
+    -- test that throws an error with the index of the first invalid element
+    local err = assert.throws(check.array, {
+        1,
+        FLOAT,
+        STR,
+    }, 'int64')
+    assert.match(err, 'int64_t expected at index 2, got an out of range value')
+    err = assert.throws(check.array, {
+        1,
+        2,
+        STR,
+    }, 'double')
+    assert.match(err, 'number expected at index 3, got string')
+    err = assert.throws(check.array, {
+        -1,
+    }, 'uint8')
+    assert.match(err, 'uint8_t expected at index 1, got an out of range value')
+end
+
 function testcase.check_with_argname()
     -- test that call without argument name
     local err = assert.throws(check.none, true)
@@ -211,6 +211,25 @@ function testcase.checkopt_str()
     end
 end
 
+function testcase.checkopt_option()
+    -- test that return the index of the option
+    assert.equal(checkopt.option('r'), 0)
+    assert.equal(checkopt.option('ACL'), 23)
+    assert.equal(checkopt.option('rw', 1), 2)
+
+    -- test that return the default value if value is nil
+    assert.equal(checkopt.option(nil, 1), 1)
+    assert.equal(checkopt.option(), -1)
+
+    -- test that throws an error if value is not an option
+    local err = assert.throws(checkopt.option, 'x', 1)
+    assert.match(err, "#1 .+[(]invalid option 'x'", false)
+
+    -- test that throws an error if value is not a string
+    err = assert.throws(checkopt.option, true)
+    assert.match(err, '#1 .+[(]string expected, ', false)
+end
+
 function testcase.checkopt_table()
     -- test that return argument
     for _, v in ipairs({
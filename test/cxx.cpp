@@ -0,0 +1,158 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+
+// C++ API test module; built by `make test-cxx`
+
+#define LAUXHLIB_USED_IN_LUA
+#include "lauxhlib.h"
+
+// the ranges of the integer types are computed at compile time
+static_assert(lauxh::arg<int8_t>::min == INT8_MIN &&
+                  lauxh::arg<int8_t>::max == INT8_MAX,
+              "invalid range of int8_t");
+static_assert(lauxh::arg<uint16_t>::min == 0 &&
+                  lauxh::arg<uint16_t>::max == UINT16_MAX,
+              "invalid range of uint16_t");
+static_assert(lauxh::arg<uint64_t>::min == 0 &&
+                  lauxh::arg<uint64_t>::max ==
+                      std::numeric_limits<lua_Integer>::max(),
+              "invalid range of uint64_t");
+
+// the hash table of the option set is built at compile time
+static constexpr lauxh_optionset_t OPTIONS =
+    lauxh::options("r", "w", "rw", "GET", "HEAD", "POST", "PUT", "DELETE");
+static_assert(OPTIONS.ready && OPTIONS.n == 8, "invalid option set");
+
+// the single-letter names that differ only in the lowest bits of the hash
+static constexpr lauxh_optionset_t SHORT_OPTIONS =
+    lauxh::options("a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l",
+                   "m", "n", "o", "p");
+static_assert(SHORT_OPTIONS.ready && SHORT_OPTIONS.n == 16,
+              "invalid short option set");
+
+// the maximum number of the two-letter names from "a0" to "g3"
+static constexpr lauxh_optionset_t WIDE_OPTIONS = lauxh::options(
+    "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7", "a8", "a9", "b0", "b1",
+    "b2", "b3", "b4", "b5", "b6", "b7", "b8", "b9", "c0", "c1", "c2", "c3",
+    "c4", "c5", "c6", "c7", "c8", "c9", "d0", "d1", "d2", "d3", "d4", "d5",
+    "d6", "d7", "d8", "d9", "e0", "e1", "e2", "e3", "e4", "e5", "e6", "e7",
+    "e8", "e9", "f0", "f1", "f2", "f3", "f4", "f5", "f6", "f7", "f8", "f9",
+    "g0", "g1", "g2", "g3");
+static_assert(WIDE_OPTIONS.ready && WIDE_OPTIONS.n == LAUXH_OPTION_MAX,
+              "invalid wide option set");
+
+// the mode strings of fopen()
+static constexpr lauxh_optionset_t FOPEN_MODES =
+    lauxh::options("r", "w", "a", "r+", "w+", "a+", "rb", "wb", "ab", "rb+",
+                   "wb+", "ab+", "r+b", "w+b", "a+b", "x");
+static_assert(FOPEN_MODES.ready && FOPEN_MODES.n == 16,
+              "invalid fopen mode set");
+
+struct Foo {
+    lua_Integer value;
+};
+
+#define FOO_MT "lauxhlib.cxx.foo"
+
+template <> struct lauxh::udata_traits<Foo> {
+    static constexpr const char *tname = FOO_MT;
+};
+
+template <typename T> static int integer_lua(lua_State *L)
+{
+    auto [v] = lauxh::args<T>(L);
+    lua_pushinteger(L, static_cast<lua_Integer>(v));
+    return 1;
+}
+
+static int args_lua(lua_State *L)
+{
+    auto [str, i8, num, tbl, flg] =
+        lauxh::args<std::string_view, int8_t, std::optional<double>,
+                    lauxh::Table, bool>(L);
+
+    lua_pushlstring(L, str.data(), str.size());
+    lua_pushinteger(L, i8);
+    if (num) {
+        lua_pushnumber(L, *num);
+    } else {
+        lua_pushnil(L);
+    }
+    lua_pushinteger(L, tbl.idx);
+    lua_pushboolean(L, flg);
+    return 5;
+}
+
+static int new_foo_lua(lua_State *L)
+{
+    lua_Integer value = lauxh_checkinteger(L, 1);
+    Foo *foo          = static_cast<Foo *>(lua_newuserdata(L, sizeof(Foo)));
+
+    foo->value = value;
+    lauxh_setmetatable(L, FOO_MT);
+    return 1;
+}
+
+static int foo_lua(lua_State *L)
+{
+    auto [foo] = lauxh::args<lauxh::Udata<Foo>>(L);
+    lua_pushinteger(L, foo->value);
+    return 1;
+}
+
+template <const lauxh_optionset_t *SET> static int option_lua(lua_State *L)
+{
+    lua_pushinteger(L, lauxh_checkoption(L, 1, SET));
+    return 1;
+}
+
+extern "C" {
+
+LUALIB_API int luaopen_test_cxx(lua_State *L)
+{
+    struct luaL_Reg method[] = {
+        {"int8",         integer_lua<int8_t>       },
+        {"uint16",       integer_lua<uint16_t>     },
+        {"int64",        integer_lua<int64_t>      },
+        {"uint64",       integer_lua<uint64_t>     },
+        {"args",         args_lua                  },
+        {"new_foo",      new_foo_lua               },
+        {"foo",          foo_lua                   },
+        {"option",       option_lua<&OPTIONS>      },
+        {"short_option", option_lua<&SHORT_OPTIONS>},
+        {"wide_option",  option_lua<&WIDE_OPTIONS> },
+        {"fopen_mode",   option_lua<&FOPEN_MODES>  },
+        {NULL,           NULL                      }
+    };
+
+    luaL_newmetatable(L, FOO_MT);
+    lua_pop(L, 1);
+
+    lua_newtable(L);
+    for (struct luaL_Reg *ptr = method; ptr->name; ptr++) {
+        lauxh_pushfn2tbl(L, ptr->name, ptr->func);
+    }
+    return 1;
+}
+
+}
@@ -0,0 +1,171 @@
+local pcall = pcall
+local clock = os.clock
+local assert = require('assert')
+
+local function printf(...)
+    print(string.format(...))
+end
+
+local testfuncs = {}
+local testcase = setmetatable({}, {
+    __newindex = function(_, name, func)
+        assert.is_string(name)
+        assert.is_function(func)
+        if testfuncs[name] then
+            error(string.format('testcase.%s already defined', name), 2)
+        end
+
+        local case = {
+            name = name,
+            func = func,
+        }
+        testfuncs[#testfuncs + 1] = case
+        testfuncs[name] = case
+    end,
+})
+
+local cxx = require('test.cxx')
+
+function testcase.integer()
+    -- test that return the integer in the range of the type
+    assert.equal(cxx.int8(-128), -128)
+    assert.equal(cxx.int8(127), 127)
+    assert.equal(cxx.uint16(0), 0)
+    assert.equal(cxx.uint16(65535), 65535)
+    assert.equal(cxx.int64(-1), -1)
+    assert.equal(cxx.uint64(1), 1)
+
+    -- test that throws the error of the corresponding checker
+    local err = assert.throws(cxx.int8, 128)
+    assert.match(err, '#1 .+[(]int8_t expected, ', false)
+    err = assert.throws(cxx.int8, 1.5)
+    assert.match(err, '#1 .+[(]int8_t expected, ', false)
+    err = assert.throws(cxx.uint16, -1)
+    assert.match(err, '#1 .+[(]uint16_t expected, ', false)
+    err = assert.throws(cxx.uint16, 65536)
+    assert.match(err, '#1 .+[(]uint16_t expected, ', false)
+    err = assert.throws(cxx.uint64, -1)
+    assert.match(err, '#1 .+[(]uint64_t expected, ', false)
+    err = assert.throws(cxx.int64, 'foo')
+    assert.match(err, '#1 .+[(]int64_t expected, ', false)
+end
+
+function testcase.args()
+    -- test that return the checked arguments
+    local s, i, n, t, b = cxx.args('foo', -1, 1.5, {}, true)
+    assert.equal(s, 'foo')
+    assert.equal(i, -1)
+    assert.equal(n, 1.5)
+    assert.equal(t, 4)
+    assert.is_true(b)
+
+    -- test that the optional argument can be nil
+    s, i, n, t, b = cxx.args('bar', 0, nil, {}, false)
+    assert.equal(s, 'bar')
+    assert.equal(i, 0)
+    assert.is_nil(n)
+    assert.equal(t, 4)
+    assert.is_false(b)
+
+    -- test that throws an error with the index of the invalid argument
+    local err = assert.throws(cxx.args, 'foo', 128, nil, {}, true)
+    assert.match(err, '#2 .+[(]int8_t expected, ', false)
+    err = assert.throws(cxx.args, 'foo', 1, 'bar', {}, true)
+    assert.match(err, '#3 .+[(]number expected, ', false)
+    err = assert.throws(cxx.args, 'foo', 1, nil, 'baz', true)
+    assert.match(err, '#4 .+[(]table expected, ', false)
+    err = assert.throws(cxx.args, 'foo', 1, nil, {})
+    assert.match(err, '#5 .+[(]boolean expected, ', false)
+end
+
+function testcase.udata()
+    -- test that return the userdata of the type
+    assert.equal(cxx.foo(cxx.new_foo(123)), 123)
+
+    -- test that throws an error if userdata is not of the type
+    local err = assert.throws(cxx.foo, io.stdout)
+    assert.match(err, '#1 .+[(]lauxhlib.cxx.foo expected, ', false)
+end
+
+function testcase.option()
+    -- test that return the index of the option
+    for i, v in ipairs({
+        'r',
+        'w',
+        'rw',
+        'GET',
+        'HEAD',
+        'POST',
+        'PUT',
+        'DELETE',
+    }) do
+        assert.equal(cxx.option(v), i - 1)
+    end
+
+    -- test that throws an error if value is not an option
+    local err = assert.throws(cxx.option, 'PATCH')
+    assert.match(err, "#1 .+[(]invalid option 'PATCH'", false)
+
+    -- test that the short names are placed in the hash table built at
+    -- compile time
+    for i = 1, 16 do
+        assert.equal(cxx.short_option(string.char(96 + i)), i - 1)
+    end
+    err = assert.throws(cxx.short_option, 'q')
+    assert.match(err, "invalid option 'q'")
+
+    -- test that the maximum number of the names are placed
+    for i = 0, 63 do
+        local name = string.char(97 + math.floor(i / 10)) .. (i % 10)
+        assert.equal(cxx.wide_option(name), i)
+    end
+    err = assert.throws(cxx.wide_option, 'g4')
+    assert.match(err, "invalid option 'g4'")
+
+    -- test that the mode strings of fopen() are placed
+    for i, v in ipairs({
+        'r',
+        'w',
+        'a',
+        'r+',
+        'w+',
+        'a+',
+        'rb',
+        'wb',
+        'ab',
+        'rb+',
+        'wb+',
+        'ab+',
+        'r+b',
+        'w+b',
+        'a+b',
+        'x',
+    }) do
+        assert.equal(cxx.fopen_mode(v), i - 1)
+    end
+end
+
+-- run test cases
+do
+    local errors = {}
+    for _, case in ipairs(testfuncs) do
+        local t = clock()
+        local ok, err = pcall(case.func)
+        t = clock() - t
+        if ok then
+            printf('testcase.%s ... ok (%f sec)', case.name, t)
+        else
+            err = string.gsub(err, '\n', {
+                ['\n'] = '\n  > ',
+            })
+            local msg = string.format('testcase.%s ... failed (%f sec)\n  > %s',
+                                      case.name, t, err)
+            errors[#errors + 1] = err
+            print(msg)
+        end
+    end
+
+    if #errors > 0 then
+        error(table.concat(errors, '\n'))
+    end
+end
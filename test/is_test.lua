@@ -120,6 +120,105 @@ function testcase.is_str()
     end
 end
 
+local char = string.char
+local LONG_ASCII = string.rep('0123456789abcdef', 16)
+local VALID_UTF8 = {
+    '',
+    LONG_ASCII,
+    -- U+00E9, U+0800, U+FFFD, U+10000, U+10FFFF
+    char(0xC3, 0xA9),
+    char(0xE0, 0xA0, 0x80),
+    char(0xEF, 0xBF, 0xBD),
+    char(0xF0, 0x90, 0x80, 0x80),
+    char(0xF4, 0x8F, 0xBF, 0xBF),
+    LONG_ASCII .. char(0xE3, 0x81, 0x82) .. LONG_ASCII,
+}
+local INVALID_UTF8 = {
+    -- unexpected continuation byte
+    char(0x80),
+    -- overlong forms
+    char(0xC0, 0xAF),
+    char(0xE0, 0x80, 0xAF),
+    char(0xF0, 0x80, 0x80, 0xAF),
+    -- surrogate
+    char(0xED, 0xA0, 0x80),
+    -- beyond U+10FFFF
+    char(0xF4, 0x90, 0x80, 0x80),
+    char(0xF5, 0x80, 0x80, 0x80),
+    -- truncated sequences
+    char(0xC3),
+    char(0xE3, 0x81),
+    LONG_ASCII .. char(0xF0, 0x90, 0x80),
+    LONG_ASCII .. char(0xFF) .. LONG_ASCII,
+}
+
+function testcase.is_ascii()
+    -- test that return true
+    for _, v in ipairs({
+        '',
+        STR,
+        LONG_ASCII,
+        LONG_ASCII .. char(0, 0x7F),
+    }) do
+        assert.is_true(is.ascii(v))
+    end
+
+    -- test that return false
+    for _, v in ipairs({
+        char(0x80),
+        LONG_ASCII .. char(0xC3, 0xA9),
+        INT,
+        TBL,
+    }) do
+        assert.is_false(is.ascii(v))
+    end
+    assert.is_false(is.ascii())
+end
+
+function testcase.is_printable()
+    -- test that return true
+    for _, v in ipairs({
+        '',
+        STR,
+        LONG_ASCII,
+        ' ~',
+    }) do
+        assert.is_true(is.printable(v))
+    end
+
+    -- test that return false
+    for _, v in ipairs({
+        char(0x1F),
+        char(0x7F),
+        LONG_ASCII .. '\t' .. LONG_ASCII,
+        LONG_ASCII .. char(0xC3, 0xA9),
+        INT,
+        TBL,
+    }) do
+        assert.is_false(is.printable(v))
+    end
+    assert.is_false(is.printable())
+end
+
+function testcase.is_utf8()
+    -- test that return true
+    for _, v in ipairs(VALID_UTF8) do
+        assert.is_true(is.utf8(v))
+    end
+
+    -- test that return false
+    for _, v in ipairs(INVALID_UTF8) do
+        assert.is_false(is.utf8(v))
+    end
+    for _, v in ipairs({
+        INT,
+        TBL,
+    }) do
+        assert.is_false(is.utf8(v))
+    end
+    assert.is_false(is.utf8())
+end
+
 function testcase.is_table()
     -- test that return true
     assert.is_true(is.table(TBL))
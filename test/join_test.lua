@@ -0,0 +1,182 @@
+local pcall = pcall
+local clock = os.clock
+local assert = require('assert')
+
+local function printf(...)
+    print(string.format(...))
+end
+
+local testfuncs = {}
+local testcase = setmetatable({}, {
+    __newindex = function(_, name, func)
+        assert.is_string(name)
+        assert.is_function(func)
+        if testfuncs[name] then
+            error(string.format('testcase.%s already defined', name), 2)
+        end
+
+        local case = {
+            name = name,
+            func = func,
+        }
+        testfuncs[#testfuncs + 1] = case
+        testfuncs[name] = case
+    end,
+})
+local join = require('lauxhlib.join')
+
+function testcase.join()
+    -- test that joins the values in the same format as tostring()
+    local tbl = {}
+    local values = {
+        'foo',
+        1,
+        -1.5,
+        0.1,
+        1e100,
+        true,
+        false,
+        tbl,
+        '',
+        string.rep('x', 1000),
+    }
+    local list = {}
+    for i, v in ipairs(values) do
+        list[i] = tostring(v)
+    end
+    assert.equal(join(values), table.concat(list))
+    assert.equal(join(values, ', '), table.concat(list, ', '))
+
+    -- test that returns an empty string
+    assert.equal(join({}), '')
+    assert.equal(join({}, ','), '')
+
+    -- test that joins the numbers beyond the stack memory
+    list = {}
+    for i = 1, 1000 do
+        list[i] = i / 3
+    end
+    local exp = {}
+    for i, v in ipairs(list) do
+        exp[i] = tostring(v)
+    end
+    assert.equal(join(list, ' '), table.concat(exp, ' '))
+
+    -- test that calls the __tostring metamethod
+    local obj = setmetatable({}, {
+        __tostring = function()
+            return string.rep('obj', 200)
+        end,
+    })
+    assert.equal(join({
+        'a',
+        obj,
+        'b',
+    }, '|'), 'a|' .. string.rep('obj', 200) .. '|b')
+
+    -- test that throw error if __tostring metamethod return non-string value
+    local err = assert.throws(join, {
+        setmetatable({}, {
+            __tostring = function()
+                return {}
+            end,
+        }),
+    })
+    assert.match(err, 'must return a string')
+
+    -- test that throw error if __tostring metamethod raises an error after
+    -- the buffer is grown
+    local errobj = setmetatable({}, {
+        __tostring = function()
+            error('tostring error')
+        end,
+    })
+    for _ = 1, 100 do
+        err = assert.throws(join, {
+            string.rep('x', 1000),
+            obj,
+            errobj,
+        })
+        assert.match(err, 'tostring error')
+    end
+    collectgarbage('collect')
+
+    -- test that the buffer grows if __tostring metamethod returns a long string
+    local long = setmetatable({}, {
+        __tostring = function()
+            return string.rep('y', 5000)
+        end,
+    })
+    assert.equal(join({
+        'a',
+        long,
+        long,
+        1,
+    }, ','), 'a,' .. string.rep('y', 5000) .. ',' .. string.rep('y', 5000) ..
+                     ',1')
+
+    -- test that the buffer grows if __tostring metamethod makes the later
+    -- elements longer
+    for _, n in ipairs({
+        100,
+        1000,
+        10000,
+    }) do
+        local elms = {}
+        elms[1] = setmetatable({}, {
+            __tostring = function()
+                elms[2] = string.rep('x', n)
+                elms[3] = string.rep('y', n)
+                return ''
+            end,
+        })
+        elms[2] = 1
+        elms[3] = 2
+        assert.equal(join(elms, string.rep('-', 2)),
+                     '--' .. string.rep('x', n) .. '--' .. string.rep('y', n))
+    end
+    collectgarbage('collect')
+
+    -- test that the separator created at runtime is kept while joining
+    list = {}
+    exp = {}
+    for i = 1, 100 do
+        list[i] = setmetatable({}, {
+            __tostring = function()
+                collectgarbage('collect')
+                return tostring(i)
+            end,
+        })
+        exp[i] = tostring(i)
+    end
+    assert.equal(join(list, string.rep('-', 2)), table.concat(exp, '--'))
+
+    -- test that throw error if argument is not a table
+    err = assert.throws(join, 'foo')
+    assert.match(err, 'table expected, got string')
+end
+
+-- run test cases
+do
+    local errors = {}
+    for _, case in ipairs(testfuncs) do
+        local t = clock()
+        local ok, err = pcall(case.func)
+        t = clock() - t
+        if ok then
+            printf('testcase.%s ... ok (%f sec)', case.name, t)
+        else
+            err = string.gsub(err, '\n', {
+                ['\n'] = '\n  > ',
+            })
+            local msg = string.format('testcase.%s ... failed (%f sec)\n  > %s',
+                                      case.name, t, err)
+            errors[#errors + 1] = err
+            print(msg)
+        end
+    end
+
+    if #errors > 0 then
+        error(table.concat(errors, '\n'))
+    end
+end
@@ -0,0 +1,166 @@
+local pcall = pcall
+local clock = os.clock
+local assert = require('assert')
+
+local function printf(...)
+    print(string.format(...))
+end
+
+local testfuncs = {}
+local testcase = setmetatable({}, {
+    __newindex = function(_, name, func)
+        assert.is_string(name)
+        assert.is_function(func)
+        if testfuncs[name] then
+            error(string.format('testcase.%s already defined', name), 2)
+        end
+
+        local case = {
+            name = name,
+            func = func,
+        }
+        testfuncs[#testfuncs + 1] = case
+        testfuncs[name] = case
+    end,
+})
+
+local keyatlas = require('lauxhlib.keyatlas')
+
+function testcase.key()
+    -- test that push the interned key string of the key id
+    for _, k in ipairs({
+        'str',
+        'lstr',
+        'num',
+        'int',
+        'bool',
+        'fn',
+        'tbl',
+        'nil',
+    }) do
+        assert.equal(keyatlas.key(k), k)
+    end
+end
+
+function testcase.fill()
+    -- test that set the values with the keys in the key atlas
+    local tbl = keyatlas.fill({
+        ['nil'] = 'removed',
+    })
+    assert.equal(tbl.str, 'foo')
+    assert.equal(tbl.lstr, 'bar\0baz')
+    assert.equal(tbl.num, 1.5)
+    assert.equal(tbl.int, 123)
+    assert.is_true(tbl.bool)
+    assert.equal(tbl.fn, keyatlas.fill)
+    assert.equal(tbl.tbl, {
+        int = 1,
+    })
+    assert.is_nil(tbl['nil'])
+end
+
+function testcase.get()
+    local tbl = keyatlas.fill({})
+
+    -- test that get the value with the key in the key atlas
+    assert.equal(keyatlas.get(tbl, 'str'), 'foo')
+    assert.equal(keyatlas.get(tbl, 'int'), 123)
+    assert.is_nil(keyatlas.get(tbl, 'nil'))
+
+    -- test that does not call the metamethod
+    tbl = setmetatable({}, {
+        __index = function()
+            return 'bar'
+        end,
+    })
+    assert.is_nil(keyatlas.get(tbl, 'str'))
+end
+
+function testcase.check_of_key()
+    local tbl = keyatlas.fill({})
+
+    -- test that return the value of the key
+    assert.equal(keyatlas.checktable(tbl, 'tbl'), {
+        int = 1,
+    })
+    assert.equal(keyatlas.checkstring(tbl, 'str'), 'foo')
+    assert.equal({
+        keyatlas.checklstring(tbl, 'lstr'),
+    }, {
+        'bar\0baz',
+        7,
+    })
+    assert.equal(keyatlas.checknumber(tbl, 'num'), 1.5)
+    assert.equal(keyatlas.checkinteger(tbl, 'int'), 123)
+    assert.is_true(keyatlas.checkboolean(tbl, 'bool'))
+
+    -- test that throws an error if the value is not the expected type
+    for fn, exp in pairs({
+        checktable = 'table',
+        checkstring = 'string',
+        checklstring = 'string',
+        checknumber = 'number',
+        checkinteger = 'integer',
+        checkboolean = 'boolean',
+    }) do
+        local err = assert.throws(keyatlas[fn], tbl, 'nil')
+        assert.match(err, '(' .. exp .. ' expected, ')
+        err = assert.throws(keyatlas[fn], tbl, 'fn')
+        assert.match(err, '(' .. exp .. ' expected, ')
+    end
+end
+
+function testcase.opt_of_key()
+    local tbl = keyatlas.fill({})
+
+    -- test that return the value of the key
+    assert.equal(keyatlas.optstring(tbl, 'str', 'def'), 'foo')
+    assert.equal(keyatlas.optlstring(tbl, 'lstr', 'def'), 'bar\0baz')
+    assert.equal(keyatlas.optnumber(tbl, 'num', 2.5), 1.5)
+    assert.equal(keyatlas.optinteger(tbl, 'int', 2), 123)
+    assert.is_true(keyatlas.optboolean(tbl, 'bool', false))
+
+    -- test that return the default value if the value is nil
+    assert.equal(keyatlas.optstring(tbl, 'nil', 'def'), 'def')
+    assert.equal(keyatlas.optlstring(tbl, 'nil', 'def'), 'def')
+    assert.equal(keyatlas.optnumber(tbl, 'nil', 2.5), 2.5)
+    assert.equal(keyatlas.optinteger(tbl, 'nil', 2), 2)
+    assert.is_true(keyatlas.optboolean(tbl, 'nil', true))
+
+    -- test that throws an error if the value is not the expected type
+    for fn, exp in pairs({
+        optstring = 'string',
+        optlstring = 'string',
+        optnumber = 'number',
+        optinteger = 'integer',
+        optboolean = 'boolean',
+    }) do
+        local err = assert.throws(keyatlas[fn], tbl, 'fn')
+        assert.match(err, '(' .. exp .. ' expected, ')
+    end
+end
+
+-- run test cases
+do
+    local errors = {}
+    for _, case in ipairs(testfuncs) do
+        local t = clock()
+        local ok, err = pcall(case.func)
+        t = clock() - t
+        if ok then
+            printf('testcase.%s ... ok (%f sec)', case.name, t)
+        else
+            err = string.gsub(err, '\n', {
+                ['\n'] = '\n  > ',
+            })
+            local msg = string.format('testcase.%s ... failed (%f sec)\n  > %s',
+                                      case.name, t, err)
+            errors[#errors + 1] = err
+            print(msg)
+        end
+    end
+
+    if #errors > 0 then
+        error(table.concat(errors, '\n'))
+    end
+end
@@ -80,6 +80,61 @@ function testcase.ref_getref_unref()
     end
 end
 
+function testcase.ref_method_with_invalid_self()
+    local refv = assert(ref(STR))
+
+    -- test that throws an error if self is not a lauxhlib.ref
+    for _, v in ipairs({
+        STR,
+        TBL,
+        FILE,
+    }) do
+        local err = assert.throws(refv.get, v)
+        assert.match(err, 'lauxhlib.ref expected, got ')
+        err = assert.throws(refv.unref, v)
+        assert.match(err, 'lauxhlib.ref expected, got ')
+    end
+    assert.equal(refv:get(), STR)
+end
+
+function testcase.stats()
+    if not ref.stats() then
+        -- built without LAUXHLIB_REF_TRACKING
+        if os.getenv('LAUXHLIB_REF_TRACKING') then
+            error('LAUXHLIB_REF_TRACKING is set, but reference tracking ' ..
+                      'is not compiled in')
+        end
+        return
+    end
+
+    -- count the live references created by this module
+    local function count()
+        local n = 0
+        for site, v in pairs(ref.stats()) do
+            assert.match(site, '^.+:%d+$', false)
+            assert.greater(v.count, 0)
+            assert.is_true(v.oldest <= os.time())
+            n = n + v.count
+        end
+        return n
+    end
+    collectgarbage('collect')
+    local base = count()
+
+    -- test that the references are grouped by the call site
+    local refs = {}
+    for i = 1, 3 do
+        refs[i] = ref(i)
+    end
+    assert.equal(count(), base + 3)
+
+    -- test that the released references are removed
+    for _, v in ipairs(refs) do
+        v:unref()
+    end
+    assert.equal(count(), base)
+end
+
 -- run test cases
 do
     local errors = {}
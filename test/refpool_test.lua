@@ -0,0 +1,251 @@
+local pcall = pcall
+local clock = os.clock
+local assert = require('assert')
+
+local function printf(...)
+    print(string.format(...))
+end
+
+local testfuncs = {}
+local testcase = setmetatable({}, {
+    __newindex = function(_, name, func)
+        assert.is_string(name)
+        assert.is_function(func)
+        if testfuncs[name] then
+            error(string.format('testcase.%s already defined', name), 2)
+        end
+
+        local case = {
+            name = name,
+            func = func,
+        }
+        testfuncs[#testfuncs + 1] = case
+        testfuncs[name] = case
+    end,
+})
+
+local refpool = require('lauxhlib.refpool')
+
+function testcase.ref_get_unref()
+    local pool = refpool(2)
+    assert.match(pool, '^lauxhlib.refpool: ', false)
+    assert.equal(pool:cap(), 2)
+
+    -- test that create references and grow the pool
+    local tbl = {}
+    local vals = {
+        true,
+        false,
+        1,
+        1.5,
+        'str',
+        tbl,
+        pool,
+    }
+    local refs = {}
+    for i, v in ipairs(vals) do
+        refs[i] = pool:ref(v)
+        assert.equal(refs[i], i)
+        assert.is_true(pool:isref(refs[i]))
+    end
+    assert.equal(pool:len(), #vals)
+    assert.equal(pool:cap(), 8)
+
+    -- test that get referenced value
+    for i, ref in ipairs(refs) do
+        assert.equal(pool:get(ref), vals[i])
+    end
+
+    -- test that unref
+    assert.is_true(pool:unref(refs[3]))
+    assert.is_false(pool:unref(refs[3]))
+    assert.is_false(pool:isref(refs[3]))
+    assert.is_nil(pool:get(refs[3]))
+    assert.equal(pool:len(), #vals - 1)
+
+    -- test that the released slot is reused
+    assert.equal(pool:ref('reused'), refs[3])
+    assert.equal(pool:get(refs[3]), 'reused')
+
+    -- test that nil is not referenced
+    assert.equal(pool:ref(nil), -1)
+    assert.equal(pool:len(), #vals)
+
+    -- test that invalid reference is ignored
+    for _, ref in ipairs({
+        -2,
+        -1,
+        0,
+        100,
+    }) do
+        assert.is_false(pool:isref(ref))
+        assert.is_false(pool:unref(ref))
+        assert.is_nil(pool:get(ref))
+    end
+end
+
+function testcase.generation()
+    -- test that generation counter is always 0 without generation flag
+    local pool = refpool()
+    local ref = pool:ref('foo')
+    assert.equal(pool:gen(ref), 0)
+    pool:unref(ref)
+    assert.equal(pool:gen(ref), 0)
+
+    -- test that generation counter is incremented at every unref
+    pool = refpool(1, true)
+    ref = pool:ref('foo')
+    assert.equal(pool:gen(ref), 0)
+    for i = 1, 3 do
+        pool:unref(ref)
+        assert.equal(pool:gen(ref), i)
+        assert.equal(pool:ref('bar'), ref)
+    end
+    -- test that the counters of the grown slots are initialized with 0
+    assert.equal(pool:ref('baz'), 2)
+    assert.equal(pool:gen(2), 0)
+end
+
+function testcase.refhandle()
+    local pool = refpool(1, true)
+
+    -- test that create a handle of the reference
+    local h1 = pool:refhandle('foo')
+    assert.equal(h1, 1)
+    local v, ok = pool:getchecked(h1)
+    assert.equal(v, 'foo')
+    assert.is_true(ok)
+
+    -- test that nil is not referenced
+    assert.is_nil(pool:refhandle(nil))
+
+    -- test that the handle of the released reference is stale
+    assert.is_true(pool:unrefhandle(h1))
+    assert.is_false(pool:unrefhandle(h1))
+    v, ok = pool:getchecked(h1)
+    assert.is_nil(v)
+    assert.is_false(ok)
+
+    -- test that the stale handle does not refer to the reused slot
+    local h2 = pool:refhandle('bar')
+    assert.not_equal(h2, h1)
+    assert.equal(pool:get(1), 'bar')
+    v, ok = pool:getchecked(h1)
+    assert.is_nil(v)
+    assert.is_false(ok)
+    assert.is_false(pool:unrefhandle(h1))
+    v, ok = pool:getchecked(h2)
+    assert.equal(v, 'bar')
+    assert.is_true(ok)
+
+    -- test that invalid handle does not refer to any value
+    for _, h in ipairs({
+        0,
+        2,
+        h2 + 1,
+    }) do
+        v, ok = pool:getchecked(h)
+        assert.is_nil(v)
+        assert.is_false(ok)
+    end
+end
+
+function testcase.refhandle_large_generation()
+    local pool = refpool(1, true)
+
+    -- test that the handle is positive and refers to the value even if the
+    -- generation counter of the slot is large
+    local genbits = 0x200000
+    for _ = 1, genbits - 1 do
+        pool:unrefhandle(pool:refhandle('foo'))
+    end
+    assert.equal(pool:gen(1), genbits - 1)
+    local h = pool:refhandle('bar')
+    assert.equal(h, (genbits - 1) * 0x100000000 + 1)
+    local v, ok = pool:getchecked(h)
+    assert.equal(v, 'bar')
+    assert.is_true(ok)
+    assert.is_true(pool:unrefhandle(h))
+
+    -- test that the counter of the handle wraps around
+    assert.equal(pool:gen(1), genbits)
+    h = pool:refhandle('baz')
+    assert.equal(h, 1)
+    v, ok = pool:getchecked(h)
+    assert.equal(v, 'baz')
+    assert.is_true(ok)
+end
+
+function testcase.refhandle_without_generation()
+    local pool = refpool(1)
+
+    -- test that throws an error if the pool has no generation counter
+    local err = assert.throws(pool.refhandle, pool, 'foo')
+    assert.match(err, 'failed to create a reference: ')
+    assert.equal(pool:len(), 0)
+end
+
+function testcase.gc()
+    -- test that the pool is collected even if the values refer to the pool
+    local values = setmetatable({}, {
+        __mode = 'v',
+    })
+    local function refcycle()
+        local pool = refpool(1, true)
+        values[1] = pool
+        values[2] = {
+            pool = pool,
+        }
+        pool:ref(pool)
+        pool:refhandle(values[2])
+    end
+    refcycle()
+    collectgarbage('collect')
+    collectgarbage('collect')
+    assert.is_nil(next(values))
+end
+
+function testcase.invalid_arguments()
+    -- test that throws an error if capacity is less than 1
+    local err = assert.throws(refpool, 0)
+    assert.match(err, '#1 .+integer from 1 to ', false)
+
+    -- test that throws an error if self is not a lauxhlib.refpool
+    local pool = refpool()
+    for _, v in ipairs({
+        'str',
+        {},
+    }) do
+        err = assert.throws(pool.ref, v, 'foo')
+        assert.match(err, 'lauxhlib.refpool expected, got ')
+    end
+
+    -- test that throws an error if reference is not integer
+    err = assert.throws(pool.get, pool, 'foo')
+    assert.match(err, '#2 .+integer expected', false)
+end
+
+-- run test cases
+do
+    local errors = {}
+    for _, case in ipairs(testfuncs) do
+        local t = clock()
+        local ok, err = pcall(case.func)
+        t = clock() - t
+        if ok then
+            printf('testcase.%s ... ok (%f sec)', case.name, t)
+        else
+            err = string.gsub(err, '\n', {
+                ['\n'] = '\n  > ',
+            })
+            local msg = string.format('testcase.%s ... failed (%f sec)\n  > %s',
+                                      case.name, t, err)
+            errors[#errors + 1] = err
+            print(msg)
+        end
+    end
+
+    if #errors > 0 then
+        error(table.concat(errors, '\n'))
+    end
+end
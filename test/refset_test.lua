@@ -0,0 +1,171 @@
+local pcall = pcall
+local clock = os.clock
+local assert = require('assert')
+
+local function printf(...)
+    print(string.format(...))
+end
+
+local testfuncs = {}
+local testcase = setmetatable({}, {
+    __newindex = function(_, name, func)
+        assert.is_string(name)
+        assert.is_function(func)
+        if testfuncs[name] then
+            error(string.format('testcase.%s already defined', name), 2)
+        end
+
+        local case = {
+            name = name,
+            func = func,
+        }
+        testfuncs[#testfuncs + 1] = case
+        testfuncs[name] = case
+    end,
+})
+
+local refset = require('lauxhlib.refset')
+
+function testcase.add_get_remove()
+    local set = refset(2)
+    assert.match(set, '^lauxhlib.refset: ', false)
+
+    -- test that add values and return the small integer handles
+    local tbl = {}
+    local vals = {
+        true,
+        false,
+        1,
+        'str',
+        tbl,
+        set,
+    }
+    local hs = {}
+    for i, v in ipairs(vals) do
+        hs[i] = set:add(v)
+        assert.equal(hs[i], i)
+    end
+    assert.equal(set:len(), #vals)
+    assert.equal(#set, #vals)
+
+    -- test that nil is not added
+    assert.is_nil(set:add(nil))
+    assert.equal(set:len(), #vals)
+
+    -- test that get the values
+    for i, h in ipairs(hs) do
+        assert.equal(set:get(h), vals[i])
+    end
+
+    -- test that remove the value
+    assert.is_true(set:remove(hs[2]))
+    assert.is_false(set:remove(hs[2]))
+    assert.is_nil(set:get(hs[2]))
+    assert.equal(set:len(), #vals - 1)
+
+    -- test that the handle of the removed value is reused
+    assert.equal(set:add('reused'), hs[2])
+    assert.equal(set:get(hs[2]), 'reused')
+
+    -- test that invalid handle is ignored
+    for _, h in ipairs({
+        -1,
+        0,
+        100,
+    }) do
+        assert.is_nil(set:get(h))
+        assert.is_false(set:remove(h))
+    end
+end
+
+function testcase.clear()
+    local set = refset()
+    for i = 1, 100 do
+        set:add(i)
+    end
+    assert.equal(set:len(), 100)
+
+    -- test that remove all values at once
+    set:clear()
+    assert.equal(set:len(), 0)
+    assert.is_nil(set:get(1))
+    assert.is_nil(set:get(100))
+
+    -- test that handles are reused from the beginning
+    assert.equal(set:add('foo'), 1)
+    assert.equal(set:get(1), 'foo')
+end
+
+function testcase.gc()
+    -- test that the values are released when the set is collected
+    local values = setmetatable({}, {
+        __mode = 'v',
+    })
+    local function addvalues()
+        local set = refset()
+        for i = 1, 10 do
+            local v = {}
+            values[i] = v
+            set:add(v)
+        end
+    end
+    addvalues()
+    collectgarbage('collect')
+    collectgarbage('collect')
+    assert.is_nil(next(values))
+
+    -- test that the set is collected even if the values refer to the set
+    local function addcycle()
+        local set = refset()
+        values[1] = set
+        values[2] = {
+            set = set,
+        }
+        set:add(set)
+        set:add(values[2])
+    end
+    addcycle()
+    collectgarbage('collect')
+    collectgarbage('collect')
+    assert.is_nil(next(values))
+end
+
+function testcase.invalid_arguments()
+    -- test that throws an error if capacity is less than 1
+    local err = assert.throws(refset, 0)
+    assert.match(err, '#1 .+integer from 1 to ', false)
+
+    -- test that throws an error if self is not a lauxhlib.refset
+    local set = refset()
+    err = assert.throws(set.add, {}, 'foo')
+    assert.match(err, 'lauxhlib.refset expected, got ')
+
+    -- test that throws an error if handle is not integer
+    err = assert.throws(set.get, set, 'foo')
+    assert.match(err, '#2 .+integer expected', false)
+end
+
+-- run test cases
+do
+    local errors = {}
+    for _, case in ipairs(testfuncs) do
+        local t = clock()
+        local ok, err = pcall(case.func)
+        t = clock() - t
+        if ok then
+            printf('testcase.%s ... ok (%f sec)', case.name, t)
+        else
+            err = string.gsub(err, '\n', {
+                ['\n'] = '\n  > ',
+            })
+            local msg = string.format('testcase.%s ... failed (%f sec)\n  > %s',
+                                      case.name, t, err)
+            errors[#errors + 1] = err
+            print(msg)
+        end
+    end
+
+    if #errors > 0 then
+        error(table.concat(errors, '\n'))
+    end
+end
@@ -0,0 +1,112 @@
+local pcall = pcall
+local clock = os.clock
+local unpack = unpack or table.unpack
+local assert = require('assert')
+
+local function printf(...)
+    print(string.format(...))
+end
+
+local testfuncs = {}
+local testcase = setmetatable({}, {
+    __newindex = function(_, name, func)
+        assert.is_string(name)
+        assert.is_function(func)
+        if testfuncs[name] then
+            error(string.format('testcase.%s already defined', name), 2)
+        end
+
+        local case = {
+            name = name,
+            func = func,
+        }
+        testfuncs[#testfuncs + 1] = case
+        testfuncs[name] = case
+    end,
+})
+local strbuf = require('lauxhlib.strbuf')
+
+function testcase.concat()
+    -- test that concatenates the values in the same format as tostring()
+    local tbl = {}
+    local values = {
+        'foo',
+        1,
+        -1.5,
+        0.1,
+        true,
+        false,
+        tbl,
+        string.rep('x', 100),
+    }
+    local list = {}
+    for i, v in ipairs(values) do
+        list[i] = tostring(v)
+    end
+    assert.equal(strbuf.concat(unpack(values)), table.concat(list))
+    assert.equal(strbuf.concat(nil), 'nil')
+
+    -- test that returns an empty string
+    assert.equal(strbuf.concat(), '')
+
+    -- test that calls the __tostring metamethod
+    local obj = setmetatable({}, {
+        __tostring = function()
+            return 'obj'
+        end,
+    })
+    assert.equal(strbuf.concat('<', obj, '>'), '<obj>')
+
+    -- test that throw error if __tostring metamethod return non-string value
+    local err = assert.throws(strbuf.concat, setmetatable({}, {
+        __tostring = function()
+            return {}
+        end,
+    }))
+    assert.match(err, 'must return a string')
+end
+
+function testcase.format()
+    -- test that appends the formatted strings beyond the initial memory
+    for _, n in ipairs({
+        1,
+        3,
+        100,
+        10000,
+    }) do
+        local list = {}
+        for i = 1, n do
+            list[i] = tostring(i)
+        end
+        assert.equal(strbuf.format(n), table.concat(list, ','))
+        assert.equal(strbuf.format(n, ' -- '), table.concat(list, ' -- '))
+    end
+
+    -- test that returns an empty string
+    assert.equal(strbuf.format(0), '')
+end
+
+-- run test cases
+do
+    local errors = {}
+    for _, case in ipairs(testfuncs) do
+        local t = clock()
+        local ok, err = pcall(case.func)
+        t = clock() - t
+        if ok then
+            printf('testcase.%s ... ok (%f sec)', case.name, t)
+        else
+            err = string.gsub(err, '\n', {
+                ['\n'] = '\n  > ',
+            })
+            local msg = string.format('testcase.%s ... failed (%f sec)\n  > %s',
+                                      case.name, t, err)
+            errors[#errors + 1] = err
+            print(msg)
+        end
+    end
+
+    if #errors > 0 then
+        error(table.concat(errors, '\n'))
+    end
+end
@@ -4,12 +4,21 @@ _G.package.cpath = '.libs/?.so;' .. _G.package.cpath
 
 local errors = {}
 for _, pathname in ipairs({
+    'test/channel_test.lua',
     'test/check_test.lua',
     'test/checkopt_test.lua',
     'test/file_test.lua',
     'test/is_test.lua',
+    'test/join_test.lua',
+    'test/keyatlas_test.lua',
     'test/ref_test.lua',
+    'test/refpool_test.lua',
+    'test/refset_test.lua',
+    'test/strbuf_test.lua',
     'test/tostring_test.lua',
+    'test/weakref_test.lua',
+    'test/xcopy_test.lua',
+    'test/xencode_test.lua',
 }) do
     print(string.rep('-', 70))
     print(pathname)
@@ -120,6 +120,56 @@ function testcase.tostr()
     assert.match(err, 'must return a string')
 end
 
+function testcase.tostr_number()
+    -- test that returns the same string as tostring()
+    local values = {
+        0,
+        -0.0,
+        1,
+        -1,
+        9,
+        10,
+        99,
+        100,
+        12345678901234,
+        -12345678901234,
+        99999999999999,
+        1e14,
+        1e15,
+        2 ^ 53,
+        100.0,
+        -100.0,
+        0.1,
+        0.1 + 0.2,
+        1 / 3,
+        -1.5,
+        2.5,
+        12.00000000000001,
+        0.0001,
+        0.00001234,
+        123456.789,
+        1e-300,
+        1e300,
+        INF,
+        -INF,
+    }
+    if math.maxinteger then
+        values[#values + 1] = math.maxinteger
+        values[#values + 1] = math.mininteger
+    end
+    for i = 1, 1000 do
+        values[#values + 1] = i * 7919
+        values[#values + 1] = -i * 1.37
+        values[#values + 1] = i / 7
+    end
+    for _, v in ipairs(values) do
+        assert.equal(tostr(v), tostring(v))
+    end
+
+    -- test that returns the pointer in hex
+    assert.match(tostr(TBL), '^table: 0x%x+$', false)
+end
+
 -- run test cases
 do
     for _, case in ipairs(testfuncs) do
@@ -0,0 +1,148 @@
+local pcall = pcall
+local clock = os.clock
+local assert = require('assert')
+
+local function printf(...)
+    print(string.format(...))
+end
+
+local testfuncs = {}
+local testcase = setmetatable({}, {
+    __newindex = function(_, name, func)
+        assert.is_string(name)
+        assert.is_function(func)
+        if testfuncs[name] then
+            error(string.format('testcase.%s already defined', name), 2)
+        end
+
+        local case = {
+            name = name,
+            func = func,
+        }
+        testfuncs[#testfuncs + 1] = case
+        testfuncs[name] = case
+    end,
+})
+
+local weakref = require('lauxhlib.weakref')
+
+-- create the weak references of the new tables, and keep the even-numbered
+-- tables alive
+local function newrefs(n)
+    local refs = {}
+    local keep = {}
+    for i = 1, n do
+        local v = {}
+        refs[i] = weakref.ref(v)
+        if i % 2 == 0 then
+            keep[i] = v
+        end
+    end
+    return refs, keep
+end
+
+function testcase.ref_get_unref()
+    -- test that create weak reference
+    local tbl = {}
+    local ref = weakref.ref(tbl)
+    assert.equal(weakref.get(ref), tbl)
+
+    -- test that nil is not referenced
+    assert.is_nil(weakref.ref(nil))
+
+    -- test that unref
+    assert.is_true(weakref.unref(ref))
+    assert.is_false(weakref.unref(ref))
+    assert.is_nil(weakref.get(ref))
+
+    -- test that throws an error if reference is not integer
+    local err = assert.throws(weakref.get, 'foo')
+    assert.match(err, '#1 .+uint64_t expected', false)
+end
+
+function testcase.collect_and_sweep()
+    local len = weakref.len()
+    local refs, keep = newrefs(10)
+    local str = weakref.ref('str')
+    assert.equal(weakref.len(), len + 11)
+
+    -- test that the collected values are not referenced
+    collectgarbage('collect')
+    collectgarbage('collect')
+    for i, ref in ipairs(refs) do
+        if keep[i] then
+            assert.equal(weakref.get(ref), keep[i])
+        else
+            assert.is_nil(weakref.get(ref))
+        end
+    end
+    -- test that the string is never collected
+    assert.equal(weakref.get(str), 'str')
+
+    -- test that the slots of the collected values are reclaimed by sweep
+    assert.equal(weakref.len(), len + 11)
+    assert.equal(weakref.sweep(), 5)
+    assert.equal(weakref.len(), len + 6)
+    assert.equal(weakref.sweep(), 0)
+    for i, ref in ipairs(refs) do
+        assert.equal(weakref.unref(ref), keep[i] ~= nil)
+    end
+    assert.is_true(weakref.unref(str))
+    assert.equal(weakref.len(), len)
+end
+
+function testcase.stale_ref_after_sweep()
+    local refs, keep = newrefs(10)
+
+    -- test that the references of the collected values are stale after their
+    -- slots are reused by the new references
+    collectgarbage('collect')
+    collectgarbage('collect')
+    assert.equal(weakref.sweep(), 5)
+    local values = {}
+    local renewed = {}
+    for i = 1, 5 do
+        values[i] = {}
+        renewed[i] = weakref.ref(values[i])
+    end
+    for i, ref in ipairs(refs) do
+        if keep[i] then
+            assert.equal(weakref.get(ref), keep[i])
+        else
+            assert.is_nil(weakref.get(ref))
+            assert.is_false(weakref.unref(ref))
+        end
+    end
+    for i, ref in ipairs(renewed) do
+        assert.equal(weakref.get(ref), values[i])
+        assert.is_true(weakref.unref(ref))
+    end
+    for i, ref in ipairs(refs) do
+        assert.equal(weakref.unref(ref), keep[i] ~= nil)
+    end
+end
+
+-- run test cases
+do
+    local errors = {}
+    for _, case in ipairs(testfuncs) do
+        local t = clock()
+        local ok, err = pcall(case.func)
+        t = clock() - t
+        if ok then
+            printf('testcase.%s ... ok (%f sec)', case.name, t)
+        else
+            err = string.gsub(err, '\n', {
+                ['\n'] = '\n  > ',
+            })
+            local msg = string.format('testcase.%s ... failed (%f sec)\n  > %s',
+                                      case.name, t, err)
+            errors[#errors + 1] = err
+            print(msg)
+        end
+    end
+
+    if #errors > 0 then
+        error(table.concat(errors, '\n'))
+    end
+end
@@ -0,0 +1,165 @@
+local pcall = pcall
+local clock = os.clock
+local assert = require('assert')
+
+local function printf(...)
+    print(string.format(...))
+end
+
+local testfuncs = {}
+local testcase = setmetatable({}, {
+    __newindex = function(_, name, func)
+        assert.is_string(name)
+        assert.is_function(func)
+        if testfuncs[name] then
+            error(string.format('testcase.%s already defined', name), 2)
+        end
+
+        local case = {
+            name = name,
+            func = func,
+        }
+        testfuncs[#testfuncs + 1] = case
+        testfuncs[name] = case
+    end,
+})
+
+local xcopy = require('lauxhlib.xcopy')
+
+local FILE = assert(io.tmpfile())
+local STR = 'str'
+local INT = 1
+local FLOAT = 1.1
+local FUNC = function()
+end
+local THREAD = coroutine.create(FUNC)
+
+function testcase.xcopy_value()
+    -- test that copy supported values
+    for _, v in ipairs({
+        {
+            val = true,
+            typ = 'boolean',
+        },
+        {
+            val = INT,
+            typ = 'number',
+        },
+        {
+            val = FLOAT,
+            typ = 'number',
+        },
+        {
+            val = STR,
+            typ = 'string',
+        },
+    }) do
+        local val, typ = xcopy(v.val)
+        assert.equal(val, v.val)
+        assert.equal(typ, v.typ)
+    end
+    local val, typ = xcopy(nil)
+    assert.is_nil(val)
+    assert.equal(typ, 'nil')
+
+    -- test that unsupported values are not copied
+    for _, v in ipairs({
+        FUNC,
+        THREAD,
+        FILE,
+    }) do
+        assert.is_nil(xcopy(v))
+    end
+end
+
+function testcase.xcopy_table()
+    -- test that copy nested table and ignore unsupported values
+    local src = {
+        INT,
+        STR,
+        FUNC,
+        foo = {
+            bar = {
+                baz = FLOAT,
+                [FUNC] = true,
+            },
+        },
+    }
+    local dst, typ = xcopy(src)
+    assert.equal(typ, 'table')
+    assert.not_rawequal(dst, src)
+    assert.equal(dst, {
+        INT,
+        STR,
+        foo = {
+            bar = {
+                baz = FLOAT,
+            },
+        },
+    })
+
+    -- test that shared subtables are copied only once
+    local shared = {
+        STR,
+    }
+    dst = xcopy({
+        a = shared,
+        b = shared,
+        [shared] = shared,
+    })
+    assert.rawequal(dst.a, dst.b)
+    assert.rawequal(dst[dst.a], dst.a)
+
+    -- test that cyclic tables can be copied
+    src = {
+        name = STR,
+    }
+    src.self = src
+    src.child = {
+        parent = src,
+    }
+    dst = xcopy(src)
+    assert.equal(dst.name, STR)
+    assert.rawequal(dst.self, dst)
+    assert.rawequal(dst.child.parent, dst)
+
+    -- test that deeply nested table can be copied
+    src = {}
+    local tail = src
+    for i = 1, 100000 do
+        tail.v = i
+        tail.next = {}
+        tail = tail.next
+    end
+    dst = xcopy(src)
+    for i = 1, 100000 do
+        assert.equal(dst.v, i)
+        dst = dst.next
+    end
+    assert.equal(dst, {})
+end
+
+-- run test cases
+do
+    local errors = {}
+    for _, case in ipairs(testfuncs) do
+        local t = clock()
+        local ok, err = pcall(case.func)
+        t = clock() - t
+        if ok then
+            printf('testcase.%s ... ok (%f sec)', case.name, t)
+        else
+            err = string.gsub(err, '\n', {
+                ['\n'] = '\n  > ',
+            })
+            local msg = string.format('testcase.%s ... failed (%f sec)\n  > %s',
+                                      case.name, t, err)
+            errors[#errors + 1] = err
+            print(msg)
+        end
+    end
+
+    if #errors > 0 then
+        error(table.concat(errors, '\n'))
+    end
+end
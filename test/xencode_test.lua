@@ -0,0 +1,191 @@
+local pcall = pcall
+local clock = os.clock
+local assert = require('assert')
+
+local function printf(...)
+    print(string.format(...))
+end
+
+local testfuncs = {}
+local testcase = setmetatable({}, {
+    __newindex = function(_, name, func)
+        assert.is_string(name)
+        assert.is_function(func)
+        if testfuncs[name] then
+            error(string.format('testcase.%s already defined', name), 2)
+        end
+
+        local case = {
+            name = name,
+            func = func,
+        }
+        testfuncs[#testfuncs + 1] = case
+        testfuncs[name] = case
+    end,
+})
+
+local xencode = require('lauxhlib.xencode')
+local encode = xencode.encode
+local decode = xencode.decode
+
+local FILE = assert(io.tmpfile())
+local STR = 'str'
+local INT = 1
+local FLOAT = 1.1
+local INF = 1 / 0
+local FUNC = function()
+end
+local THREAD = coroutine.create(FUNC)
+
+function testcase.encode_decode_value()
+    -- test that encode and decode supported values
+    for _, v in ipairs({
+        true,
+        false,
+        0,
+        INT,
+        -INT,
+        0x7FFFFFFF,
+        -0x80000000,
+        FLOAT,
+        -INF,
+        STR,
+        '',
+        string.rep('x', 1000),
+    }) do
+        local data = assert(encode(v))
+        assert.is_string(data)
+        assert.equal(decode(data), v)
+    end
+    assert.is_nil(decode(assert(encode(nil))))
+
+    -- test that nan is decoded as nan
+    local nan = decode(assert(encode(0 / 0)))
+    assert.is_true(nan ~= nan)
+
+    -- test that unsupported values cannot be encoded
+    for _, v in ipairs({
+        FUNC,
+        THREAD,
+        FILE,
+    }) do
+        local data, err = encode(v)
+        assert.is_nil(data)
+        assert.is_string(err)
+    end
+end
+
+function testcase.encode_decode_table()
+    -- test that encode and decode nested table and ignore unsupported values
+    local data = assert(encode({
+        INT,
+        STR,
+        FUNC,
+        foo = {
+            bar = {
+                baz = FLOAT,
+                [FUNC] = true,
+            },
+        },
+        [true] = false,
+    }))
+    assert.equal(decode(data), {
+        INT,
+        STR,
+        foo = {
+            bar = {
+                baz = FLOAT,
+            },
+        },
+        [true] = false,
+    })
+
+    -- test that shared subtables are decoded as the same table
+    local shared = {
+        STR,
+    }
+    local dst = decode(assert(encode({
+        a = shared,
+        b = {
+            c = shared,
+        },
+        [shared] = shared,
+    })))
+    assert.rawequal(dst.a, dst.b.c)
+    assert.rawequal(dst[dst.a], dst.a)
+
+    -- test that cyclic tables can be encoded
+    local src = {
+        name = STR,
+    }
+    src.self = src
+    src.child = {
+        parent = src,
+    }
+    dst = decode(assert(encode(src)))
+    assert.equal(dst.name, STR)
+    assert.rawequal(dst.self, dst)
+    assert.rawequal(dst.child.parent, dst)
+
+    -- test that deeply nested table can be encoded
+    src = {}
+    local tail = src
+    for i = 1, 100000 do
+        tail.v = i
+        tail.next = {}
+        tail = tail.next
+    end
+    dst = decode(assert(encode(src)))
+    for i = 1, 100000 do
+        assert.equal(dst.v, i)
+        dst = dst.next
+    end
+    assert.equal(dst, {})
+end
+
+function testcase.decode_malformed()
+    local data = assert(encode({
+        foo = STR,
+        bar = {
+            FLOAT,
+        },
+    }))
+
+    -- test that returns an error if data is truncated or has trailing bytes
+    for _, v in ipairs({
+        '',
+        string.sub(data, 1, 1),
+        string.sub(data, 1, #data - 1),
+        data .. '\0',
+        '\255' .. string.sub(data, 2),
+    }) do
+        local val, err = decode(v)
+        assert.is_nil(val)
+        assert.is_string(err)
+    end
+end
+
+-- run test cases
+do
+    local errors = {}
+    for _, case in ipairs(testfuncs) do
+        local t = clock()
+        local ok, err = pcall(case.func)
+        t = clock() - t
+        if ok then
+            printf('testcase.%s ... ok (%f sec)', case.name, t)
+        else
+            err = string.gsub(err, '\n', {
+                ['\n'] = '\n  > ',
+            })
+            local msg = string.format('testcase.%s ... failed (%f sec)\n  > %s',
+                                      case.name, t, err)
+            errors[#errors + 1] = err
+            print(msg)
+        end
+    end
+
+    if #errors > 0 then
+        error(table.concat(errors, '\n'))
+    end
+end